@@ -4,6 +4,8 @@
  *               可透過藍牙接收指令控制板載 LED 與繼電器，並定期上傳溫濕度資料至藍牙裝置
  * 硬體需求：     BMDuino-UNO (相容 Arduino UNO)、DHT 溫濕度感測器、0.96 吋 OLED 顯示器、HC-05 藍牙模組、繼電器模組
  * 通訊協定：     序列埠 (UART)、軟體序列埠 (SoftwareSerial)、I2C (OLED、DHT)
+ * I2C 排程：     OLED、DHT、繼電器共用 Wire1，由 I2CBusLib.h 排程：
+ *               繼電器指令優先，OLED 畫面分頁傳送，每 60 秒印出各模組佔用匯流排的時間
  * 藍牙指令對應： 
  *               0x4f ('O')：關閉板載 LED
  *               0x50 ('P')：開啟板載 LED
@@ -20,6 +22,8 @@
 #include "OledLib.h"    // OLED 顯示器控制函式庫
 #include "DHTLib.h"     // DHT 溫濕度感測器函式庫
 #include "RelayLib.h"   // 繼電器模組控制函式庫
+#include "TaskLib.h"    // 協同式任務排程函式庫（取代 loop() 中的 delay()）
+#include "I2CBusLib.h"  // Wire1 交易排程與匯流排時間統計
 
 // 引用 SoftwareSerial 函式庫，用於在非硬體序列埠腳位上模擬序列通訊
 // 此函式庫允許我們使用任意數位腳位進行序列通訊（本例用於藍牙 HC-05 模組）
@@ -33,7 +37,19 @@
 // ================== 腳位設定 (請依 BMCOM2 實際接線調整) ==================
 #define BT_RX_PIN 23   // Arduino 的接收腳位，接 HC-05 的 TX 腳（接收來自藍牙模組的資料）
 #define BT_TX_PIN 24   // Arduino 的傳送腳位，接 HC-05 的 RX 腳（傳送資料至藍牙模組）
-int loopcnt = 0;      // 延遲計數器，用於控制每 30 秒更新一次溫濕度資料並傳送至藍牙
+
+// ================== 任務排程設定 (毫秒) ==================
+#define BT_POLL_INTERVAL 20       // 藍牙任務：每 20ms 檢查一次（9600 bps 約可收 19 個位元組，不會溢出 64 位元組緩衝區）
+#define BT_POLL_DEADLINE 20
+#define DHT_INTERVAL 30000        // 溫濕度任務：每 30 秒更新一次
+#define DHT_DEADLINE 1000
+#define BUS_REPORT_INTERVAL 60000 // 匯流排統計：每 60 秒印出一次
+#define BUS_REPORT_DEADLINE 1000
+
+// ================== Wire1 裝置編號 (I2CBusLib.h) ==================
+int oledBus = BUS_NONE;    // OLED 顯示器
+int dhtBus = BUS_NONE;     // 溫濕度感測器
+int relayBus = BUS_NONE;   // 繼電器模組
 
 // ================================================================
 // =============== 感測器物件實例化區 (Sensor Object) =============
@@ -48,79 +64,134 @@ void initAll();                // 初始化整體系統（序列埠、藍牙、
 void showTemperatureonOled(float ss);  // 在 OLED 上顯示溫度數值
 void showHumidityonOled(float ss);     // 在 OLED 上顯示濕度數值
 void judgeKeyCommand(unsigned char kk) ;// 參數：kk - 接收到的無符號字元資料（來自藍牙）
+void bluetoothTask();          // 任務：讀取藍牙指令並執行
+void dhtTask();                // 任務：讀取溫濕度，顯示於 OLED 並傳送至藍牙
+void busReportTask();          // 任務：印出各模組佔用 Wire1 的時間
+bool relayStep(int arg, uint8_t step);    // Wire1 交易：切換繼電器（arg = 編號 * 2 + 開關）
+bool showDHTStep(int arg, uint8_t step);  // Wire1 交易：在 OLED 上清空並顯示溫度、濕度（分 4 步）
 
 
 // ================== 初始化設定 (setup) ==================
 // 此函式在 Arduino 啟動時執行一次，用於初始化設定硬體與通訊介面
 void setup()
 {
+    // 登錄共用 Wire1 的裝置，之後各自累計佔用匯流排的時間
+    oledBus = busAddDevice("oled");
+    dhtBus = busAddDevice("dht");
+    relayBus = busAddDevice("relay");
+
     initAll();          // 初始化整體系統（啟動序列埠、藍牙通訊、感測器模組）
     delay(200);         // 延遲 200ms，確保硬體模組穩定啟動
 
-    // 顯示 BEST MODULES 的 LOGO 於 OLED 上
-    clearScreen();      // 清除 OLED 螢幕
-    drawPicture(0, 0, BestModule_LOGO, 128, 64); // 在 (0,0) 位置繪製 128x64 像素的 LOGO
+    // 顯示 BEST MODULES 的 LOGO 於 OLED 上（分頁傳送，setup() 中直接等到送完）
+    oledPicture = BestModule_LOGO;  // 128x64 像素的 LOGO
+    busSubmit(oledBus, BUS_PRIO_DISPLAY, oledPictureStep, 0);
+    busFlush();
     delay(3000);        // LOGO 顯示 3 秒
-    clearScreen();      // 再次清除螢幕，準備顯示溫濕度資料
+    busSubmit(oledBus, BUS_PRIO_DISPLAY, oledClearStep, 0);  // 清除螢幕，準備顯示溫濕度資料
+    busFlush();
+
+    // 登錄任務：藍牙指令與溫濕度更新各自依週期執行，互不等待
+    taskAddPeriodic("bluetooth", bluetoothTask, BT_POLL_INTERVAL, BT_POLL_DEADLINE);
+    taskAddPeriodic("dht", dhtTask, DHT_INTERVAL, DHT_DEADLINE);
+    taskAddPeriodic("busreport", busReportTask, BUS_REPORT_INTERVAL, BUS_REPORT_DEADLINE);
 
     // 提示已經進入主迴圈 loop()
     Serial.println("Enter Loop()"); 
-    loopcnt = 0;        // 初始化迴圈計數器
 }
 
 // ================== 主迴圈，持續執行 (loop) ==================
-// 此函式會不斷重複執行，主要功能為：
-// 1. 監聽藍牙指令並執行對應控制動作
-// 2. 每 30 秒讀取一次溫濕度並顯示於 OLED 與序列埠，同時傳送至藍牙裝置
+// 此函式會不斷重複執行，由 TaskLib.h 執行已到期的任務：
+// 1. bluetoothTask：每 20ms 監聽藍牙指令並執行對應控制動作（原本最慢要等 1 秒）
+// 2. dhtTask：每 30 秒讀取一次溫濕度並顯示於 OLED 與序列埠，同時傳送至藍牙裝置
+// 再由 I2CBusLib.h 執行一步 Wire1 交易（繼電器優先，OLED 一次一小段）
 void loop()
+{
+    taskRun();
+    busRun();
+}
+
+// ================== 任務：讀取藍牙指令 ==================
+// 週期：BT_POLL_INTERVAL
+void bluetoothTask()
 {
     // ---------- 檢查藍牙序列埠是否有資料可讀 ----------
-    // 判斷 HC-05 藍牙模組是否接收到來自外部裝置（如手機、電腦）的資料
-    if (btSerial.available())
+    // 當藍牙序列埠的接收緩衝區中有資料時，持續讀取直到清空緩衝區
+    while (btSerial.available() > 0)
     {
-        // 當藍牙序列埠的接收緩衝區中有資料時，持續讀取直到清空緩衝區
-        while (btSerial.available() > 0)
-        {
-            // 讀取一個位元組的資料（以無符號字元形式儲存）
-            unsigned char btData = btSerial.read();
-            // 將讀取到的資料轉為字元形式，顯示於序列埠監控視窗（用於除錯）
-            Serial.print(char(btData));   // 以可視字元形式印出
-            // 呼叫自訂函式，根據接收到的資料執行對應控制命令（如控制 LED、繼電器）
-            judgeKeyCommand(btData);
-        }
+        // 讀取一個位元組的資料（以無符號字元形式儲存）
+        unsigned char btData = btSerial.read();
+        // 將讀取到的資料轉為字元形式，顯示於序列埠監控視窗（用於除錯）
+        Serial.print(char(btData));   // 以可視字元形式印出
+        // 呼叫自訂函式，根據接收到的資料執行對應控制命令（如控制 LED、繼電器）
+        judgeKeyCommand(btData);
     }
+}
 
-    // 每 30 秒（loopcnt 從 0 到 30，每次 loop 延遲 1 秒）更新一次溫濕度資料
-    if (loopcnt == 0)
-    {
-        // ---------- 讀取並顯示濕度數值 ----------
-        HValue = readHumidity();        // 呼叫 DHT 函式讀取濕度值
-        Serial.print("Humidity : ");
-        Serial.print(HValue);          // 顯示濕度值於序列埠
-        Serial.print(" %    ");
-
-        // ---------- 讀取並顯示溫度數值 ----------
-        TValue = readTemperature();    // 呼叫 DHT 函式讀取溫度值
-        Serial.print("Temperature : ");
-        Serial.print(TValue);          // 顯示溫度值於序列埠（註：此處原程式碼誤寫為 BMht.readTemperature()，已修正為 TValue）
-        Serial.println(" °C ");        // 顯示溫度單位 °C
-
-        // ---------- 顯示溫濕度資訊於 OLED ----------
-        showTemperatureonOled(TValue); // 在 OLED 上顯示溫度
-        showHumidityonOled(HValue);    // 在 OLED 上顯示濕度
-
-        // ---------- 傳送溫濕度資訊到藍芽裝置 ----------
-        btSerial.println("Temperature:  " + String(TValue) + " °C");  // 傳送溫度資料至藍牙裝置
-        btSerial.println("Humidity:  " + String(HValue) + " %");      // 傳送濕度資料至藍牙裝置
-    }
+// ================== 任務：更新溫濕度 ==================
+// 週期：DHT_INTERVAL（登錄後立即執行第一次）
+void dhtTask()
+{
+    // ---------- 讀取並顯示濕度數值 ----------
+    busBegin(dhtBus);               // 讀值須立即取得，直接使用 Wire1 並計入 dht 的匯流排時間
+    HValue = readHumidity();        // 呼叫 DHT 函式讀取濕度值
+    Serial.print("Humidity : ");
+    Serial.print(HValue);          // 顯示濕度值於序列埠
+    Serial.print(" %    ");
+
+    // ---------- 讀取並顯示溫度數值 ----------
+    TValue = readTemperature();    // 呼叫 DHT 函式讀取溫度值
+    busEnd(dhtBus);
+    Serial.print("Temperature : ");
+    Serial.print(TValue);          // 顯示溫度值於序列埠（註：此處原程式碼誤寫為 BMht.readTemperature()，已修正為 TValue）
+    Serial.println(" °C ");        // 顯示溫度單位 °C
 
-    // 主迴圈每次執行後延遲 1 秒，並更新計數器
-    delay(1000);
-    loopcnt++;
+    // ---------- 顯示溫濕度資訊於 OLED ----------
+    // 交給 Wire1 排程，繼電器指令可以插在溫度與濕度之間
+    busSubmit(oledBus, BUS_PRIO_DISPLAY, showDHTStep, 0);
 
-    // 當計數器超過 30 秒（即 30 次迴圈）時重置，實現每 30 秒更新一次溫濕度
-    if (loopcnt >= 30)
-        loopcnt = 0;
+    // ---------- 傳送溫濕度資訊到藍芽裝置 ----------
+    btSerial.println("Temperature:  " + String(TValue) + " °C");  // 傳送溫度資料至藍牙裝置
+    btSerial.println("Humidity:  " + String(HValue) + " %");      // 傳送濕度資料至藍牙裝置
+}
+
+// ================== 任務：匯流排統計 ==================
+// 週期：BUS_REPORT_INTERVAL，欄位說明見 I2CBusLib.h 的 busReport()
+void busReportTask()
+{
+    busReport();
+}
+
+// ================== Wire1 交易：切換繼電器 ==================
+// arg：繼電器編號 * 2 + 開關（RelayON / RelayOFF），只有一步
+bool relayStep(int arg, uint8_t step)
+{
+    if (arg & 1)
+        TurnonRelay(arg >> 1);
+    else
+        TurnoffRelay(arg >> 1);
+    return false;
+}
+
+// ================== Wire1 交易：在 OLED 上顯示溫濕度 ==================
+// 清空與顯示分成 4 步，每一步之間可讓繼電器指令先執行
+bool showDHTStep(int arg, uint8_t step)
+{
+    switch (step)
+    {
+    case 0:
+        printText(0, 4, "              ");  // 清空 OLED 上溫度的顯示區域
+        return true;
+    case 1:
+        showTemperatureonOled(TValue);      // 在 OLED 上顯示溫度
+        return true;
+    case 2:
+        printText(62, 4, "         ");      // 清空 OLED 上濕度的顯示區域
+        return true;
+    default:
+        showHumidityonOled(HValue);         // 在 OLED 上顯示濕度
+        return false;
+    }
 }
 
 // ================== 自訂函式：判斷指令並執行對應動作 ==================
@@ -147,7 +218,7 @@ void judgeKeyCommand(unsigned char kk)  // 參數：kk - 接收到的無符號
     if (kk == 0x51)
     {
         Serial.println("開啟第 1 個繼電器");
-        TurnonRelay(1);  // 開啟第 1 個繼電器（依 RelayLib 實作而定）
+        busSubmit(relayBus, BUS_PRIO_URGENT, relayStep, 1 * 2 + RelayON);  // 開啟第 1 個繼電器（優先於 OLED 更新）
         btSerial.println("開啟第 1 個繼電器");
     }
 
@@ -155,7 +226,7 @@ void judgeKeyCommand(unsigned char kk)  // 參數：kk - 接收到的無符號
     if (kk == 0x52)
     {
         Serial.println("關閉第 1 個繼電器");
-        TurnoffRelay(1); // 關閉第 1 個繼電器（依 RelayLib 實作而定）
+        busSubmit(relayBus, BUS_PRIO_URGENT, relayStep, 1 * 2 + RelayOFF); // 關閉第 1 個繼電器（優先於 OLED 更新）
         btSerial.println("關閉第 1 個繼電器");
     }
 }
@@ -188,9 +259,9 @@ void initAll()
 
 // ================== 自訂函式：在 OLED 上顯示溫度 ==================
 // 參數：ss - 溫度數值（浮點數）
+// 顯示區域由 showDHTStep() 先清空
 void showTemperatureonOled(float ss)
 {
-    printText(0, 4, "              ");  // 清空 OLED 上對應的顯示區域
     printText(0, 4, String(ss) + " °C"); // 將溫度轉為字串並顯示於 OLED (x=0, y=4)
     Serial.print("Temperature on OLED:(");
     Serial.print(ss);
@@ -199,9 +270,9 @@ void showTemperatureonOled(float ss)
 
 // ================== 自訂函式：在 OLED 上顯示濕度 ==================
 // 參數：ss - 濕度數值（浮點數）
+// 顯示區域由 showDHTStep() 先清空
 void showHumidityonOled(float ss)
 {
-    printText(62, 4, "         ");     // 清空 OLED 上對應的顯示區域
     printText(62, 4, String(ss) + " %"); // 將濕度轉為字串並顯示於 OLED (x=62, y=4)
     Serial.print("Humidity on OLED:(");
     Serial.print(ss);
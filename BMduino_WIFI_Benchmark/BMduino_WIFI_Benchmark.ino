@@ -0,0 +1,297 @@
+// ================================================================
+// 檔案名稱：BMduino_WIFI_Benchmark.ino
+// 描述：BMC81M001 網路操作基準測試
+// 功能：在 9600 ~ 921600 鮑率下量測每一種網路操作
+//       connectToAP、configMqtt、http_get、writeString、writeBytes、readIotData
+//       http_get 另以同一條連線連續查詢 BENCH_BATCH 筆（keep-alive），
+//       與 http_getPipelined() 一次送出 BENCH_BATCH 筆比較
+//       （驅動程式以 BMC81M001_USE_HTTP_PIPELINE=1 編譯時）
+//       的 p50 / p99 延遲、線路上的位元組數與堆積使用量（BenchLib.h）
+//       writeString 分別以 String 組合（舊寫法）與字元陣列（不配置動態記憶體）測試
+//       結果以 CSV 由序列埠輸出，保存成基準檔即可比對每次驅動程式的修改
+// 執行環境：
+//       - 開發板：BMC81M001 接在 Serial2
+//       - 電腦端：cd HostEmulator && make run SKETCH=../BMduino_WIFI_Benchmark
+//         由 ESP-AT 模擬器扮演模組，兩者使用同一份程式與同一個驅動程式介面
+// ================================================================
+
+// ================================================================
+// =============== 函式庫引入區 ===============
+// ================================================================
+#include "BMC81M001.h"   // BMC81M001 WiFi 模組控制函式庫
+
+// ================================================================
+// =============== 測試設定常數區 ===============
+// ================================================================
+#define WIFI_SSID "NCNUIOT"                 // WiFi 網路名稱
+#define WIFI_PASS "0123456789"              // WiFi 密碼
+#define MQTT_HOST "broker.emqx.io"          // MQTT 伺服器主機名稱
+#define SERVER_PORT 1883                    // MQTT 通訊埠
+#define HTTP_URL "http://httpbin.org"       // http_get 測試用網站
+#define HTTP_PORT 80                        // http_get 測試用通訊埠
+#define HTTP_PATH "/get"                    // http_get 測試用路徑
+#define BENCH_TOPIC "/arduino/bench/%s"     // 測試用發佈主題格式
+#define BENCH_ROUNDS 20                     // 發佈類操作每種的次數
+#define BENCH_SLOW_ROUNDS 5                 // 連線類操作每種的次數（每次要數秒）
+#define BENCH_READ_TIMEOUT 5000             // 等待訂閱訊息送回的時間上限（毫秒）
+#define BENCH_DEFAULT_BAUD 115200           // 模組開機時的鮑率
+#define BENCH_BATCH 4                       // keep-alive / 管線化每次查詢的筆數
+#define BENCH_MAX_OPS 10                    // BenchLib.h：本測試的操作種類
+
+const uint32_t benchBauds[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
+#define BENCH_BAUD_COUNT (sizeof(benchBauds) / sizeof(benchBauds[0]))
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+BMC81M001 Wifi(&Serial2);        // 使用 BMduino 的 Serial2 硬體序列埠
+
+#include "BenchLib.h"            // 基準測試函式庫（使用 Wifi 物件）
+
+char topicBuffer[60];            // 發佈主題緩衝區
+char echoTopicBuffer[60];        // 訂閱後送回的主題（量測 readIotData）
+char payloadBuffer[80];          // 發佈資料緩衝區
+uint32_t currentBaud = BENCH_DEFAULT_BAUD;   // 目前模組與序列埠的鮑率
+bool benchDone = false;          // 全部鮑率是否已測完
+
+// ------- 自定義函式宣告區 -----------
+void runSuite(uint32_t baud);    // 在一種鮑率下量測所有操作
+void benchConnectToAP();         // 量測 connectToAP()
+void benchConfigMqtt();          // 量測 configMqtt()
+void benchStringPublish();       // 量測以 String 組合的 writeString()
+void benchBufferPublish();       // 量測以字元陣列組合的 writeString()
+void benchWriteBytes();          // 量測 writeBytes()
+void benchReadIotData();         // 量測 readIotData()：發佈到已訂閱主題後等待送回
+void benchHttpGet();             // 量測 http_begin() + http_get() + http_end()
+void benchHttpKeepAlive();       // 量測同一條連線上連續 BENCH_BATCH 次 http_get()
+#if BMC81M001_USE_HTTP_PIPELINE
+void benchHttpPipelined();       // 量測 http_getPipelined() 一次送出 BENCH_BATCH 筆
+#endif
+
+// ------------------ 初始化函式 setup() ------------------
+void setup()
+{
+    Serial.begin(9600);
+    Wifi.begin(BENCH_DEFAULT_BAUD);
+    Wifi.reset();
+    delay(1000);
+
+    if (!Wifi.connectToAP(WIFI_SSID, WIFI_PASS)) {
+        Serial.println("WIFI fail");
+        while(1);
+    }
+    sprintf(topicBuffer, BENCH_TOPIC, "pub");
+    sprintf(echoTopicBuffer, BENCH_TOPIC, "echo");
+    Serial.println("Benchmark start");
+}
+
+// ------------------ 主迴圈函式 loop() ------------------
+void loop()
+{
+    if (!benchDone) {
+        for (uint8_t i = 0; i < BENCH_BAUD_COUNT; i++) runSuite(benchBauds[i]);
+        if (currentBaud != BENCH_DEFAULT_BAUD && Wifi.setBaudRate(BENCH_DEFAULT_BAUD)) {
+            currentBaud = BENCH_DEFAULT_BAUD;
+        }
+        Serial.println("Benchmark done");
+        benchDone = true;
+    }
+    delay(10000);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：runSuite()
+// 功能：切換鮑率後依序量測所有操作，印出這一組的結果
+// 參數：baud - 模組與序列埠的鮑率
+// 說明：模組不支援的鮑率會切換失敗，印出訊息後略過
+// ---------------------------------------------------------------
+void runSuite(uint32_t baud)
+{
+    if (baud != currentBaud) {
+        if (!Wifi.setBaudRate(baud)) {
+            Serial.print("BENCH,");
+            Serial.print(baud);
+            Serial.println(",baud change failed");
+            return;
+        }
+        currentBaud = baud;
+    }
+    benchClear();
+    benchConnectToAP();
+    benchConfigMqtt();
+    benchStringPublish();
+    benchBufferPublish();
+    benchWriteBytes();
+    benchReadIotData();
+    benchHttpGet();
+    benchHttpKeepAlive();
+#if BMC81M001_USE_HTTP_PIPELINE
+    benchHttpPipelined();
+#endif
+    benchReport(baud);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchConnectToAP()
+// 功能：重複加入同一個基地台
+// ---------------------------------------------------------------
+void benchConnectToAP()
+{
+    int op = benchOp("connectToAP");
+    for (int i = 0; i < BENCH_SLOW_ROUNDS; i++) {
+        benchStart();
+        bool ok = Wifi.connectToAP(WIFI_SSID, WIFI_PASS);
+        benchStop(op, ok);
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchConfigMqtt()
+// 功能：重複設定並連線 MQTT 伺服器
+// 說明：已連線時模組不接受新的設定，先以 AT+MQTTCLEAN 中斷（不計時）
+//       結束後訂閱送回主題，供 benchReadIotData() 使用
+// ---------------------------------------------------------------
+void benchConfigMqtt()
+{
+    int op = benchOp("configMqtt");
+    for (int i = 0; i < BENCH_SLOW_ROUNDS; i++) {
+        Wifi.sendATCommand("AT+MQTTCLEAN=0", 1000, 1);
+        benchStart();
+        bool ok = Wifi.configMqtt("twbench", "", "", MQTT_HOST, SERVER_PORT);
+        benchStop(op, ok);
+    }
+    Wifi.setSubscribetopic(echoTopicBuffer);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchStringPublish()
+// 功能：舊寫法，每次發佈都以 String 組合資料與主題（組合時間一併計入）
+// ---------------------------------------------------------------
+void benchStringPublish()
+{
+    int op = benchOp("writeString(String)");
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        benchStart();
+        String payload = "{\\\"Seq\\\":" + String(i) + "\\,\\\"Heap\\\":" + String(benchHeapUsed()) + "}";
+        bool ok = Wifi.writeString(payload, String(topicBuffer));
+        benchStop(op, ok);
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchBufferPublish()
+// 功能：新寫法，資料以 sprintf 寫入固定緩衝區後直接發佈
+//       驅動程式分段寫出主題與資料，不會建立任何副本
+// ---------------------------------------------------------------
+void benchBufferPublish()
+{
+    int op = benchOp("writeString(char*)");
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        benchStart();
+        sprintf(payloadBuffer, "{\\\"Seq\\\":%d\\,\\\"Heap\\\":%ld}", i, benchHeapUsed());
+        bool ok = Wifi.writeString(payloadBuffer, topicBuffer);
+        benchStop(op, ok);
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchWriteBytes()
+// 功能：以 AT+MQTTPUBRAW 發佈同樣大小的資料（不需轉譯）
+// ---------------------------------------------------------------
+void benchWriteBytes()
+{
+    int op = benchOp("writeBytes");
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        benchStart();
+        int len = sprintf(payloadBuffer, "{\"Seq\":%d,\"Heap\":%ld}", i, benchHeapUsed());
+        bool ok = Wifi.writeBytes((const char *)payloadBuffer, len, topicBuffer);
+        benchStop(op, ok);
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchReadIotData()
+// 功能：發佈到已訂閱的主題（不計時），量測伺服器送回到
+//       readIotData() 取得資料的時間
+// ---------------------------------------------------------------
+void benchReadIotData()
+{
+    int op = benchOp("readIotData");
+    String data, topic;
+    int len;
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        Wifi.readIotData(&data, &len, &topic);     // 清除上一輪殘留的訊息
+        sprintf(payloadBuffer, "echo%d", i);
+        if (!Wifi.writeString(payloadBuffer, echoTopicBuffer)) {
+            benchStart();
+            benchStop(op, false);
+            continue;
+        }
+        benchStart();
+        unsigned long start = millis();
+        do {
+            Wifi.readIotData(&data, &len, &topic);
+        } while (len == 0 && millis() - start < BENCH_READ_TIMEOUT);
+        benchStop(op, len > 0);
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchHttpGet()
+// 功能：量測一次完整的 HTTP GET（連線、送出請求、收完回應、關閉）
+// ---------------------------------------------------------------
+void benchHttpGet()
+{
+    int op = benchOp("http_get");
+    for (int i = 0; i < BENCH_SLOW_ROUNDS; i++) {
+        benchStart();
+        bool ok = Wifi.http_begin(HTTP_URL, HTTP_PORT, HTTP_PATH) == HTTP_GET_BEGIN_SUCCESS
+               && Wifi.http_get() == 200;
+        Wifi.http_end();
+        benchStop(op, ok);
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchHttpKeepAlive()
+// 功能：keep-alive 連線上依序查詢 BENCH_BATCH 筆，每筆等回應收完才送下一筆
+// 說明：連線在第一輪建立（計時），之後各輪沿用
+// ---------------------------------------------------------------
+void benchHttpKeepAlive()
+{
+    int op = benchOp("http_get x4 keep-alive");
+    Wifi.http_setKeepAlive(true);
+    for (int i = 0; i < BENCH_SLOW_ROUNDS; i++) {
+        benchStart();
+        bool ok = Wifi.http_begin(HTTP_URL, HTTP_PORT, HTTP_PATH) == HTTP_GET_BEGIN_SUCCESS;
+        for (int j = 0; j < BENCH_BATCH && ok; j++) {
+            ok = Wifi.http_get() == 200;
+        }
+        benchStop(op, ok);
+    }
+    Wifi.http_setKeepAlive(false);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchHttpPipelined()
+// 功能：http_getPipelined() 以一個 AT+CIPSEND 送出 BENCH_BATCH 筆，
+//       回應依序取回，不必每筆等一次網路往返
+// 說明：連線在第一輪建立（計時），之後各輪沿用
+// ---------------------------------------------------------------
+#if BMC81M001_USE_HTTP_PIPELINE
+void benchHttpPipelined()
+{
+    int op = benchOp("http_getPipelined x4");
+    Wifi.http_setKeepAlive(true);
+    for (int i = 0; i < BENCH_SLOW_ROUNDS; i++) {
+        benchStart();
+        bool ok = Wifi.http_begin(HTTP_URL, HTTP_PORT) == HTTP_GET_BEGIN_SUCCESS;
+        for (int j = 0; j < BENCH_BATCH && ok; j++) {
+            ok = Wifi.http_addRequest(HTTP_PATH);
+        }
+        ok = ok && Wifi.http_getPipelined(NULL) == HTTP_GET_OP_SUCCESS;
+        benchStop(op, ok);
+    }
+    Wifi.http_setKeepAlive(false);
+}
+#endif
@@ -0,0 +1,221 @@
+// ================================================================
+// 檔案名稱：BenchLib.h
+// 描述：BMC81M001 網路操作基準測試函式庫
+// 功能：量測每一種操作的延遲、線路上的位元組數與堆積使用量
+//       - 每次呼叫的時間以 micros() 記錄，報告 p50 / p99
+//       - 位元組數取自驅動程式的 bytesSent() / bytesReceived()
+//       - 堆積：開發板以 mallinfo() 取得使用中位元組，
+//         電腦端（HostEmulator，HOST_BUILD）以 new/delete 計數，可得到真正的峰值
+// 使用方式：
+//   int op = benchOp("writeString");
+//   benchStart();  bool ok = Wifi.writeString(...);  benchStop(op, ok);
+//   benchReport(115200);   // 以 CSV 印出，可與基準結果比對
+// 注意：需在建立 Wifi 物件之後引入
+// ================================================================
+
+#ifndef HOST_BUILD
+#include <malloc.h>      // mallinfo()：開發板的堆積使用量
+#endif
+
+// ================================================================
+// =============== 基準測試設定常數區 ===============
+// ================================================================
+#ifndef BENCH_MAX_OPS
+#define BENCH_MAX_OPS 8            // 最多可量測的操作種類
+#endif
+#ifndef BENCH_MAX_SAMPLES
+#define BENCH_MAX_SAMPLES 32       // 每種操作最多保留的樣本數（超過時只累計位元組）
+#endif
+
+// ================================================================
+// =============== 資料結構宣告區 ===============
+// ================================================================
+
+// 一種操作的量測結果
+typedef struct
+{
+    const char *name;                 // 操作名稱（字串常數，不複製）
+    uint32_t us[BENCH_MAX_SAMPLES];   // 每次呼叫的時間（微秒）
+    uint8_t count;                    // 已記錄的樣本數
+    uint16_t calls;                   // 呼叫次數（含未保留時間的呼叫）
+    uint16_t okCount;                 // 成功次數
+    uint32_t txBytes;                 // 送往模組的位元組總數
+    uint32_t rxBytes;                 // 由模組收到的位元組總數
+    long heapPeak;                    // 單次呼叫中堆積最多增加的位元組數
+} BenchOp;
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+BenchOp benchOps[BENCH_MAX_OPS];       // 各操作的量測結果
+uint8_t benchOpCount = 0;              // 已登錄的操作數
+unsigned long benchStartUs = 0;        // 目前這次呼叫的開始時間
+uint32_t benchStartTx = 0;             // 開始時已送出的位元組數
+uint32_t benchStartRx = 0;             // 開始時已收到的位元組數
+long benchStartHeap = 0;               // 開始時的堆積使用量
+bool benchHeaderDone = false;          // CSV 標題列是否已印出
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+int  benchOp(const char *name);                  // 取得（或登錄）操作編號
+void benchStart();                               // 開始量測一次呼叫
+void benchStop(int op, bool ok);                 // 結束量測並記錄結果
+uint32_t benchPercentile(int op, uint8_t pct);   // 時間百分位數（微秒）
+void benchReport(uint32_t baud);                 // 以 CSV 印出所有操作的結果
+void benchClear();                               // 清除結果，準備下一組測試
+long benchHeapUsed();                            // 目前的堆積使用量（位元組）
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：benchOp()
+// 功能：依名稱找到操作編號，第一次使用時登錄
+// 參數：name - 操作名稱（須為字串常數）
+// 回傳：操作編號，已滿時回傳 -1
+// ---------------------------------------------------------------
+int benchOp(const char *name)
+{
+    for (int i = 0; i < benchOpCount; i++) {
+        if (strcmp(benchOps[i].name, name) == 0) return i;
+    }
+    if (benchOpCount >= BENCH_MAX_OPS) return -1;
+    BenchOp *o = &benchOps[benchOpCount];
+    memset(o, 0, sizeof(BenchOp));
+    o->name = name;
+    return benchOpCount++;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchHeapUsed()
+// 功能：目前使用中的堆積位元組數
+// ---------------------------------------------------------------
+long benchHeapUsed()
+{
+#ifdef HOST_BUILD
+    return (long)hostHeapInUse();
+#else
+    struct mallinfo mi = mallinfo();
+    return mi.uordblks;
+#endif
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchStart()
+// 功能：記錄開始時間、位元組計數與堆積使用量
+// ---------------------------------------------------------------
+void benchStart()
+{
+    benchStartTx = Wifi.bytesSent();
+    benchStartRx = Wifi.bytesReceived();
+    benchStartHeap = benchHeapUsed();
+#ifdef HOST_BUILD
+    hostHeapResetPeak();
+#endif
+    benchStartUs = micros();
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchStop()
+// 功能：結束一次呼叫的量測
+// 參數：op - benchOp() 傳回的編號
+//       ok - 這次呼叫是否成功
+// 說明：開發板上只看得到呼叫前後的差值，呼叫中暫時配置的
+//       String 只有在電腦端才量得到
+// ---------------------------------------------------------------
+void benchStop(int op, bool ok)
+{
+    unsigned long elapsed = micros() - benchStartUs;
+    if (op < 0 || op >= benchOpCount) return;
+    BenchOp *o = &benchOps[op];
+#ifdef HOST_BUILD
+    long heap = (long)hostHeapPeak() - benchStartHeap;
+#else
+    long heap = benchHeapUsed() - benchStartHeap;
+#endif
+    if (o->count < BENCH_MAX_SAMPLES) o->us[o->count++] = elapsed;
+    o->calls++;
+    if (ok) o->okCount++;
+    o->txBytes += Wifi.bytesSent() - benchStartTx;
+    o->rxBytes += Wifi.bytesReceived() - benchStartRx;
+    if (heap > o->heapPeak) o->heapPeak = heap;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchPercentile()
+// 功能：以最近排名法計算時間百分位數
+// 參數：op - 操作編號
+//       pct - 百分位（50、99 ...）
+// 回傳：微秒，沒有樣本時回傳 0
+// 說明：在副本上做插入排序，樣本數很少，不需要更快的排序
+// ---------------------------------------------------------------
+uint32_t benchPercentile(int op, uint8_t pct)
+{
+    BenchOp *o = &benchOps[op];
+    if (o->count == 0) return 0;
+    uint32_t sorted[BENCH_MAX_SAMPLES];
+    for (uint8_t i = 0; i < o->count; i++) {
+        uint32_t v = o->us[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    int rank = ((uint16_t)pct * o->count + 99) / 100;   // 無條件進位
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchReport()
+// 功能：每種操作印出一列 CSV
+// 欄位：BENCH,鮑率,操作,呼叫次數,成功次數,p50(us),p99(us),
+//       每次送出位元組,每次收到位元組,堆積峰值(bytes)
+// 說明：電腦端與開發板的輸出格式相同，可直接比對基準檔
+// ---------------------------------------------------------------
+void benchReport(uint32_t baud)
+{
+    if (!benchHeaderDone) {
+        Serial.println("BENCH,baud,op,calls,ok,p50_us,p99_us,tx_bytes,rx_bytes,heap_bytes");
+        benchHeaderDone = true;
+    }
+    for (int i = 0; i < benchOpCount; i++) {
+        BenchOp *o = &benchOps[i];
+        if (o->calls == 0) continue;
+        Serial.print("BENCH,");
+        Serial.print(baud);
+        Serial.print(",");
+        Serial.print(o->name);
+        Serial.print(",");
+        Serial.print(o->calls);
+        Serial.print(",");
+        Serial.print(o->okCount);
+        Serial.print(",");
+        Serial.print(benchPercentile(i, 50));
+        Serial.print(",");
+        Serial.print(benchPercentile(i, 99));
+        Serial.print(",");
+        Serial.print(o->txBytes / o->calls);
+        Serial.print(",");
+        Serial.print(o->rxBytes / o->calls);
+        Serial.print(",");
+        Serial.println(o->heapPeak);
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：benchClear()
+// 功能：清除所有操作的結果（名稱保留，編號不變）
+// ---------------------------------------------------------------
+void benchClear()
+{
+    for (int i = 0; i < benchOpCount; i++) {
+        const char *name = benchOps[i].name;
+        memset(&benchOps[i], 0, sizeof(BenchOp));
+        benchOps[i].name = name;
+    }
+}
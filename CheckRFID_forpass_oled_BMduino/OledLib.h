@@ -52,8 +52,11 @@ uint8_t t = ' ';  // 宣告變數 t，初始化為空格字元，用於測試時
 // 創建 BMD31M090 顯示模組的物件，並使用 HW Wire 進行通訊
 //BMD31M090 BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire);
 BMD31M090 BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire1); // 使用硬體 Wire1 介面 (BMduino 適用)
+TwoWire *oledWire = &Wire1;   // updateScreen() 直接送出畫面緩衝區使用的 I2C 介面，須與上一行相同
 //BMD31M090 BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire2); // 使用硬體 Wire2 介面
 
+#include "OledFrame.h"   // 畫面緩衝區與只送出變動部分的更新（LIB/OledFrame）
+
 //----------自定義函式區宣告--------------
 void initOled();                                         // 初始化 OLED12864，0.96 吋 OLED 顯示模組 BMD31M090
 void drawPicture(int x, int y, const uint8_t *pp, int width, int height); // 在指定位置繪製點陣圖（白色）
@@ -138,6 +141,8 @@ void initOled()  // OLED 物件初始化區
 {
   // 初始化 BMD31M090 顯示模組，使用指定的 I2C 地址進行通訊
   BMD31.begin(BMD31M090_ADDRESS);
+  setFont(FontTable_8X16);   // BMD31 預設的字型，同步記錄字型大小
+  oledClearFrame();
   delay(100);  // 建議的初始化延遲，確保模組穩定
   Serial.println("init OLED12864 OK");
 }
@@ -148,12 +153,11 @@ void setFont(const unsigned char* font)   // 設定字形
   // font：字體格式選擇
   // FontTable_6X8、FontTable_8X16、FontTable_16X32、FontTable_32X64
   BMD31.setFont(font);
-}
-
-//----------顯示當前緩衝區的內容------------------
-void updateScreen()  // 將緩衝區內容更新到螢幕硬體
-{
-  BMD31.display();
+  // 記錄字型大小，printText() 依此記錄文字占用的欄
+  if (font == FontTable_6X8) { oledFontWidth = 6; oledFontPages = 1; }
+  else if (font == FontTable_16X32) { oledFontWidth = 16; oledFontPages = 4; }
+  else if (font == FontTable_32X64) { oledFontWidth = 32; oledFontPages = 8; }
+  else { oledFontWidth = 8; oledFontPages = 2; }
 }
 
 //--------指定位置印出文字函式--------
@@ -161,12 +165,15 @@ void printText(int x, int y, String str)  // 在 (x, y) 位置印出字串
 {
   // 將 String 轉換為 C 字串後傳入底層繪製函式
   BMD31.drawString((uint8_t)x, (uint8_t)y, (uint8_t*)str.c_str());
+  oledMarkText(x, y, str.c_str());   // 記錄文字占用的欄，updateScreen() 不會蓋掉文字
 }
 
 //-----------指定位置印出字元函式------------
 void printChar(int x, int y, char str)  // 在 (x, y) 位置印出單一字元
 {
   BMD31.drawChar((uint8_t)x, (uint8_t)y, (uint8_t)str);
+  char text[2] = { str, 0 };
+  oledMarkText(x, y, text);
 }
 
 //--------指定位置印出整數-----------
@@ -174,6 +181,7 @@ void printNumber(int x, int y, int num)  // 在 (x, y) 位置印出整數
 {
   // 利用 String 長度決定數字位數，傳入繪製函式
   BMD31.drawNum((uint8_t)x, (uint8_t)y, (uint32_t)num, (uint8_t)(String(num).length()));
+  oledMarkText(x, y, String(num).c_str());
 }
 
 //-----------指定位置印出浮點數-----------
@@ -185,29 +193,40 @@ void printFloat(int x, int y, float num)  // 在 (x, y) 位置印出浮點數
 //--------指定位置繪出一點-----------
 void drawPoint(int x, int y, int pixelColor) // 在 (x, y) 位置繪製一個像素點
 {
-  BMD31.drawPixel((uint8_t)x, (uint8_t)y, (uint8_t)pixelColor);
-  BMD31.display();  // 立即更新顯示
+  oledSetPixel(x, y, pixelColor);
+  oledFlushIfImmediate();  // 立即模式只送出這一點所在的一個位元組
 }
 
 //---------在兩點畫一條直線------------
 void drawLine(int x1, int y1, int x2, int y2, int pixelColor) // 繪製從 (x1,y1) 到 (x2,y2) 的直線
 {
-  BMD31.drawLine((uint8_t)x1, (uint8_t)y1, (uint8_t)x2, (uint8_t)y2, (uint8_t)pixelColor);
-  BMD31.display();
+  // Bresenham 直線演算法，只用整數運算
+  int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+  int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+  int err = dx + dy;
+  while (true)
+  {
+    oledSetPixel(x1, y1, pixelColor);
+    if (x1 == x2 && y1 == y2) break;
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x1 += sx; }
+    if (e2 <= dx) { err += dx; y1 += sy; }
+  }
+  oledFlushIfImmediate();
 }
 
 //-----在一點畫一條垂直線（指定高度）-------
 void drawfastVline(int x, int y, int width, int pixelColor)  // 從 (x, y) 向下繪製垂直線，長度 width
 {
-  BMD31.drawFastVLine((uint8_t)x, (uint8_t)y, (uint8_t)width, (uint8_t)pixelColor);
-  BMD31.display();
+  for (int i = 0; i < width; i++) oledSetPixel(x, y + i, pixelColor);
+  oledFlushIfImmediate();
 }
 
 //---------在一點畫一條水平線（指定寬度）---------
 void drawfastHline(int x, int y, int width, int pixelColor)  // 從 (x, y) 向右繪製水平線，長度 width
 {
-  BMD31.drawFastHLine((uint8_t)x, (uint8_t)y, (uint8_t)width, (uint8_t)pixelColor);
-  BMD31.display();
+  for (int i = 0; i < width; i++) oledSetPixel(x + i, y, pixelColor);
+  oledFlushIfImmediate();
 }
 
 //---------垂直線相容性函式（同 drawfastVline）-------
@@ -225,15 +244,20 @@ void drawHline(int x, int y, int width, int pixelColor)
 //-------以兩點為對角繪製一個矩形-------
 void drawBox(int x1, int y1, int x2, int y2, int pixelColor) // 繪製矩形邊框
 {
-  // 上邊線
-  BMD31.drawLine((uint8_t)x1, (uint8_t)y1, (uint8_t)x2, (uint8_t)y1, (uint8_t)pixelColor);
-  // 右邊線
-  BMD31.drawLine((uint8_t)x2, (uint8_t)y1, (uint8_t)x2, (uint8_t)y2, (uint8_t)pixelColor);
-  // 左邊線
-  BMD31.drawLine((uint8_t)x1, (uint8_t)y1, (uint8_t)x1, (uint8_t)y2, (uint8_t)pixelColor);
-  // 下邊線
-  BMD31.drawLine((uint8_t)x1, (uint8_t)y2, (uint8_t)x2, (uint8_t)y2, (uint8_t)pixelColor);
-  BMD31.display();
+  // 四條邊先全部畫進緩衝區，再一次送出變動部分（反轉顏色時四個角只反轉一次）
+  if (x1 > x2) { int tmp = x1; x1 = x2; x2 = tmp; }
+  if (y1 > y2) { int tmp = y1; y1 = y2; y2 = tmp; }
+  for (int x = x1; x <= x2; x++)
+  {
+    oledSetPixel(x, y1, pixelColor);                  // 上邊線
+    if (y2 != y1) oledSetPixel(x, y2, pixelColor);    // 下邊線
+  }
+  for (int y = y1 + 1; y < y2; y++)
+  {
+    oledSetPixel(x1, y, pixelColor);                  // 左邊線
+    if (x2 != x1) oledSetPixel(x2, y, pixelColor);    // 右邊線
+  }
+  oledFlushIfImmediate();
 }
 
 //--------清除螢幕-----------
@@ -241,22 +265,27 @@ void clearScreen()    // 清除螢幕所有內容
 {
   BMD31.clearDisplay(); // 清除記憶體緩衝區
   BMD31.display();      // 將清除結果更新到螢幕
+  oledClearFrame();  // 螢幕已全部清除，畫面緩衝區與文字記錄同步清除
 }
 
 //-------在指定位置以黑色繪製點陣圖（反白效果）---------
 void invdrawPicture(int x, int y, const uint8_t *pp, int width, int height)
 {
-  BMD31.clearDisplay();
-  BMD31.drawBitmap((uint8_t)x, (uint8_t)y, pp, (uint8_t)width, (uint8_t)height, pixelColor_BLACK);
-  BMD31.display();
+  BMD31.clearDisplay();  // BMD31 的緩衝區也清除，之後 display() 不會蓋回舊畫面
+  oledClearFrame();
+  oledDrawBitmap(x, y, pp, width, height, pixelColor_BLACK);
+  for (uint8_t page = 0; page < OLED_PAGES; page++) oledMarkDirty(page, 0, BMD31M090_WIDTH - 1);  // 整個畫面重畫，文字也一併蓋掉
+  updateScreen();
 }
 
 //-------------在指定位置以白色繪製點陣圖-------------
 void drawPicture(int x, int y, const uint8_t *pp, int width, int height)  // 使用白色繪製點陣圖
 {
-  BMD31.clearDisplay();
-  BMD31.drawBitmap((uint8_t)x, (uint8_t)y, pp, (uint8_t)width, (uint8_t)height, pixelColor_WHITE);
-  BMD31.display();
+  BMD31.clearDisplay();  // BMD31 的緩衝區也清除，之後 display() 不會蓋回舊畫面
+  oledClearFrame();
+  oledDrawBitmap(x, y, pp, width, height, pixelColor_WHITE);
+  for (uint8_t page = 0; page < OLED_PAGES; page++) oledMarkDirty(page, 0, BMD31M090_WIDTH - 1);  // 整個畫面重畫，文字也一併蓋掉
+  updateScreen();
 }
 
 //----------設定省電模式（降低亮度）-------------
@@ -395,7 +424,7 @@ void test_drawString_6x8(void)  // 測試 6x8 字型顯示字串
   BMD31.clearDisplay();
   BMD31.display();
 
-  BMD31.setFont(FontTable_6X8);  // 設定 6x8 字型
+  setFont(FontTable_6X8);  // 設定 6x8 字型
   uint8_t col = (128 - (6 * sizeof("Hello World!"))) / 2;  // 計算水平置中位置
 
   for (uint8_t row = 0; row < 8; row++)
@@ -410,7 +439,7 @@ void test_drawString_8x16(void) // 測試 8x16 字型顯示字串
   BMD31.clearDisplay();
   BMD31.display();
 
-  BMD31.setFont(FontTable_8X16);  // 設定 8x16 字型
+  setFont(FontTable_8X16);  // 設定 8x16 字型
   uint8_t col = (128 - (8 * sizeof("Hello World!"))) / 2;  // 水平置中
 
   for (uint8_t row = 0; row < 8; row += 2)  // 每兩行顯示一次（因為字型高度為 16）
@@ -431,13 +460,13 @@ void test_drawString_drawChar_drawNum(void) // 同時測試字串、字元、數
   // 依序顯示 ASCII 從 32 (空白) 到 126 (~) 的字元
   do
   {
-    BMD31.setFont(FontTable_6X8);
+    setFont(FontTable_6X8);
     BMD31.drawString(0, displayROW5, (u8*)"ASCII:");
     BMD31.drawString(63, displayROW5, (u8*)"CODE:");
     BMD31.drawChar(48, displayROW5, t);
     BMD31.drawNum(103, displayROW5, t, 3);
 
-    BMD31.setFont(FontTable_8X16);
+    setFont(FontTable_8X16);
     BMD31.drawString(0, displayROW6, (u8*)"ASCII:");
     BMD31.drawString(63, displayROW6, (u8*)"CODE:");
     BMD31.drawChar(48, displayROW6, t);
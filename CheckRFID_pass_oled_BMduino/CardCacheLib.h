@@ -0,0 +1,174 @@
+// ================================================================
+// 檔案名稱：CardCacheLib.h
+// 描述：RFID 授權卡號快取（allow-list cache）函式庫
+// 功能：在開發板上記住雲端驗證過的卡號，刷卡時直接由快取決定是否開門，
+//       不必等待 WiFi 與 checkpass.php 的 HTTP 往返
+//       - 以開放定址（open addressing）雜湊表保存 32 位元卡號，查詢只需幾次比較
+//       - 授權（ALLOW）與拒絕（DENY）結果各有存活時間（TTL），
+//         拒絕結果也會快取（negative caching），避免同一張無效卡反覆查詢雲端
+//       - 表格滿了時覆蓋探查範圍內最舊的項目
+// 使用方式：
+//   cardLookup() 查詢 → 依結果開門 → 雲端確認後以 cardUpdate() 更新
+// ================================================================
+
+// ================================================================
+// =============== 快取設定常數區 ===============
+// ================================================================
+#ifndef CARD_CACHE_BITS
+#define CARD_CACHE_BITS 6              // 雜湊表大小為 2^6 = 64 筆（每筆 12 位元組）
+#endif
+#define CARD_CACHE_SIZE (1 << CARD_CACHE_BITS)
+#ifndef CARD_PROBE_LIMIT
+#define CARD_PROBE_LIMIT 8             // 線性探查的最大次數
+#endif
+#ifndef CARD_ALLOW_TTL
+#define CARD_ALLOW_TTL 3600000UL       // 授權結果的存活時間（毫秒，1 小時）
+#endif
+#ifndef CARD_DENY_TTL
+#define CARD_DENY_TTL 60000UL          // 拒絕結果的存活時間（毫秒，1 分鐘）
+#endif
+
+// 快取項目狀態與查詢結果
+#define CARD_EMPTY    0                // 空位
+#define CARD_ALLOW    1                // 已授權，可以開門
+#define CARD_DENY     2                // 未授權，不開門
+#define CARD_DELETED  3                // 已刪除（保留探查鏈，不能當成空位）
+#define CARD_UNKNOWN  4                // 查詢結果：快取中沒有這張卡
+#define CARD_OFFLINE  5                // 雲端查詢結果：WiFi 斷線，沒有送出查詢
+
+// ================================================================
+// =============== 資料結構宣告區 ===============
+// ================================================================
+typedef struct
+{
+    uint32_t uid;        // 卡號（readRFIDUIDValue() 的 32 位元數值）
+    uint32_t stamp;      // 寫入快取時的 millis()
+    uint8_t state;       // CARD_EMPTY / CARD_ALLOW / CARD_DENY / CARD_DELETED
+} CardEntry;
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+CardEntry cardCache[CARD_CACHE_SIZE];  // 雜湊表（全域變數初始值為 0，即全部為 CARD_EMPTY）
+uint32_t cardHits = 0;                 // 快取命中次數（有效的 ALLOW / DENY）
+uint32_t cardMisses = 0;               // 快取未命中或已過期次數
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+uint8_t cardLookup(uint32_t uid, bool *expired);  // 查詢卡號，傳回 CARD_ALLOW / CARD_DENY / CARD_UNKNOWN
+void cardUpdate(uint32_t uid, uint8_t state);     // 寫入或更新一筆雲端驗證結果
+void cardForget(uint32_t uid);                    // 從快取移除一張卡
+void cardClear();                                 // 清空快取
+uint16_t cardHash(uint32_t uid);                  // 計算卡號在雜湊表中的起始位置
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：cardHash()
+// 功能：以乘法雜湊（Knuth）計算卡號的起始位置
+// 說明：卡號的低位元常常很接近，取乘積的高位元分布較平均
+// ---------------------------------------------------------------
+uint16_t cardHash(uint32_t uid)
+{
+    return (uint16_t)((uid * 2654435761UL) >> (32 - CARD_CACHE_BITS));
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：cardLookup()
+// 功能：查詢卡號的快取結果
+// 參數：
+//   - uid: 卡號
+//   - expired: 傳回該筆結果是否已超過存活時間（可為 NULL）
+// 傳回值：
+//   CARD_ALLOW / CARD_DENY：快取中的結果（已過期時 *expired 為 true）
+//   CARD_UNKNOWN：快取中沒有這張卡
+// 說明：已過期的結果仍然傳回，由呼叫端決定離線時是否採用
+// ---------------------------------------------------------------
+uint8_t cardLookup(uint32_t uid, bool *expired)
+{
+    uint16_t slot = cardHash(uid);
+    for (int i = 0; i < CARD_PROBE_LIMIT; i++) {
+        CardEntry *e = &cardCache[(slot + i) & (CARD_CACHE_SIZE - 1)];
+        if (e->state == CARD_EMPTY) break;           // 探查鏈結束
+        if (e->state == CARD_DELETED || e->uid != uid) continue;
+        unsigned long ttl = e->state == CARD_ALLOW ? CARD_ALLOW_TTL : CARD_DENY_TTL;
+        bool old = millis() - e->stamp > ttl;
+        if (expired != NULL) *expired = old;
+        if (old) cardMisses++; else cardHits++;
+        return e->state;
+    }
+    if (expired != NULL) *expired = true;
+    cardMisses++;
+    return CARD_UNKNOWN;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：cardUpdate()
+// 功能：寫入或更新一筆雲端驗證結果，並重新計算存活時間
+// 參數：
+//   - uid: 卡號
+//   - state: CARD_ALLOW 或 CARD_DENY（其他值視為無法驗證，不更新）
+// 傳回值：無
+// 說明：
+//   1. 卡號已存在時直接更新
+//   2. 否則放到探查範圍內第一個空位或已刪除的位置
+//   3. 探查範圍內都被佔用時，覆蓋其中最早寫入的項目
+// ---------------------------------------------------------------
+void cardUpdate(uint32_t uid, uint8_t state)
+{
+    if (state != CARD_ALLOW && state != CARD_DENY) return;
+
+    uint16_t slot = cardHash(uid);
+    CardEntry *target = NULL;      // 第一個可用的位置
+    CardEntry *oldest = NULL;      // 最早寫入的項目（表格滿時覆蓋）
+    unsigned long now = millis();
+    for (int i = 0; i < CARD_PROBE_LIMIT; i++) {
+        CardEntry *e = &cardCache[(slot + i) & (CARD_CACHE_SIZE - 1)];
+        if (e->state == CARD_EMPTY) {
+            if (target == NULL) target = e;
+            break;                 // 後面不會再有這張卡
+        }
+        if (e->state == CARD_DELETED) {
+            if (target == NULL) target = e;
+            continue;
+        }
+        if (e->uid == uid) {
+            target = e;            // 已存在：原地更新
+            break;
+        }
+        if (oldest == NULL || now - e->stamp > now - oldest->stamp) oldest = e;
+    }
+    if (target == NULL) target = oldest;
+    target->uid = uid;
+    target->stamp = now;
+    target->state = state;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：cardForget()
+// 功能：從快取移除一張卡（標記為已刪除，保留探查鏈）
+// ---------------------------------------------------------------
+void cardForget(uint32_t uid)
+{
+    uint16_t slot = cardHash(uid);
+    for (int i = 0; i < CARD_PROBE_LIMIT; i++) {
+        CardEntry *e = &cardCache[(slot + i) & (CARD_CACHE_SIZE - 1)];
+        if (e->state == CARD_EMPTY) return;
+        if (e->state != CARD_DELETED && e->uid == uid) {
+            e->state = CARD_DELETED;
+            return;
+        }
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：cardClear()
+// 功能：清空快取（例如伺服器端大量變更卡片權限後）
+// ---------------------------------------------------------------
+void cardClear()
+{
+    memset(cardCache, 0, sizeof(cardCache));
+}
@@ -0,0 +1,349 @@
+// ================================================================
+// 檔案名稱：CardSyncLib.h
+// 描述：RFID 卡片清單增量同步（delta sync）函式庫
+// 功能：定期向雲端索取「某版本之後」的卡片狀態變更，分頁套用到
+//       開發板上的卡號索引，並存入 EEPROM，斷電後仍然有效
+//       - 每次同步只需一個小請求（每頁最多 CARDSYNC_PAGE_SIZE 筆變更），
+//         不必每張卡各查一次
+//       - 每頁套用完才更新版本號，同步中斷後由上一個完成的版本繼續
+//       - 寫入 EEPROM 途中斷電時，開機會發現索引不完整並從頭重新同步
+//       - 定義 CARDSYNC_FILE_NAME 時改用檔案儲存（電腦端測試用）
+// 雲端介面（參考實作：Python/disDBAgent/cardSyncServer.py）：
+//   GET /bmduino/rfid/cardsync.php?MAC=<MAC>&SINCE=<版本>&LIMIT=<筆數>
+//   回應（純文字，一行一筆）：
+//     V <新版本> <是否還有下一頁 0/1>
+//     A <10 位數卡號>     已註冊或已啟用（可開門）
+//     D <10 位數卡號>     已停用或已失效（不可開門）
+// 注意：需在 clouding.h 之後引入（使用 ServerURL、ServerPort、MacData）
+// ================================================================
+
+// ================================================================
+// =============== 函式庫引入區 ===============
+// ================================================================
+#ifdef CARDSYNC_FILE_NAME
+#include <stdio.h>       // 電腦端測試：以檔案模擬 EEPROM
+#else
+#include <EEPROM.h>      // 開發板：索引寫入 EEPROM，斷電不會遺失
+#endif
+
+// ================================================================
+// =============== 同步設定常數區 ===============
+// ================================================================
+#ifndef CARDSYNC_CAPACITY
+#define CARDSYNC_CAPACITY 128          // 索引最多保存的卡片數（每筆 5 位元組）
+#endif
+#ifndef CARDSYNC_BASE_ADDRESS
+#define CARDSYNC_BASE_ADDRESS 0        // 索引在 EEPROM 中的起始位址
+#endif
+#ifndef CARDSYNC_PAGE_SIZE
+#define CARDSYNC_PAGE_SIZE 16          // 每頁最多的變更筆數
+#endif
+#ifndef CARDSYNC_INTERVAL
+#define CARDSYNC_INTERVAL 60000UL      // 同步間隔（毫秒）
+#endif
+#define CARDSYNC_MAGIC 0x43534E31      // 索引識別碼 "CSN1"，不符時重新建立
+
+// 同步請求路徑：依序填入 MAC 位址、目前版本、每頁筆數
+#define cardsyncagent "/bmduino/rfid/cardsync.php?MAC=%s&SINCE=%lu&LIMIT=%d"
+
+// ================================================================
+// =============== 資料結構宣告區 ===============
+// ================================================================
+
+// 索引標頭，存在索引區最前面
+typedef struct
+{
+    uint32_t magic;      // CARDSYNC_MAGIC
+    uint32_t version;    // 已套用的雲端變更版本
+    uint16_t count;      // 索引中的卡片數
+    uint16_t capacity;   // 建立時的容量
+    uint8_t dirty;       // 1：正在寫入索引（開機時仍為 1 代表寫入中斷）
+    uint8_t reserved[3]; // 保留（對齊用）
+} CardSyncHeader;
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+CardSyncHeader syncHeader;                   // 索引標頭（RAM 中的副本）
+uint32_t syncUid[CARDSYNC_CAPACITY];         // 卡號，由小到大排序（二分搜尋）
+uint8_t syncState[CARDSYNC_CAPACITY];        // 對應卡號的狀態：CARD_ALLOW / CARD_DENY
+unsigned long syncLast = 0;                  // 上次同步的 millis()
+bool syncStarted = false;                    // 開機後是否已同步過
+bool syncMore = false;                       // 還有下一頁：下次呼叫立即接續，不等同步間隔
+uint32_t syncOverflow = 0;                   // 索引已滿而無法加入的卡片數
+char syncPath[120];                          // 同步請求路徑
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+void initCardSync();                         // 載入或建立卡號索引
+uint8_t cardIndexLookup(uint32_t uid);       // 查詢索引，傳回 CARD_ALLOW / CARD_DENY / CARD_UNKNOWN
+bool cardIndexSet(uint32_t uid, uint8_t state);  // 在 RAM 索引中加入或更新一張卡，傳回索引是否改變
+int  cardSyncApply(const char *body, int length);  // 套用一頁變更，傳回 1 還有下一頁、0 已同步完成、-1 格式錯誤
+int  cardSyncPage();                         // 索取並套用一頁變更
+void cardSyncPoll();                         // 同步間隔到了就索取一頁變更，在 loop() 中呼叫
+void cardSyncSave();                         // 把 RAM 索引寫入儲存區
+void syncRead(int address, void *data, int length);        // 讀取儲存區
+void syncWrite(int address, const void *data, int length); // 寫入儲存區
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：syncRead() / syncWrite()
+// 功能：讀寫儲存區（EEPROM 或測試用檔案）
+// 說明：以 EEPROM.update() 只改寫內容不同的位元組，減少 EEPROM 磨損
+// ---------------------------------------------------------------
+void syncRead(int address, void *data, int length)
+{
+    uint8_t *p = (uint8_t *)data;
+#ifdef CARDSYNC_FILE_NAME
+    memset(p, 0xFF, length);     // 檔案不存在時等同於全新的 EEPROM
+    FILE *f = fopen(CARDSYNC_FILE_NAME, "rb");
+    if (f == NULL) return;
+    fseek(f, CARDSYNC_BASE_ADDRESS + address, SEEK_SET);
+    fread(p, 1, length, f);
+    fclose(f);
+#else
+    for (int i = 0; i < length; i++) {
+        p[i] = EEPROM.read(CARDSYNC_BASE_ADDRESS + address + i);
+    }
+#endif
+}
+
+void syncWrite(int address, const void *data, int length)
+{
+    const uint8_t *p = (const uint8_t *)data;
+#ifdef CARDSYNC_FILE_NAME
+    FILE *f = fopen(CARDSYNC_FILE_NAME, "r+b");
+    if (f == NULL) f = fopen(CARDSYNC_FILE_NAME, "w+b");
+    if (f == NULL) return;
+    fseek(f, CARDSYNC_BASE_ADDRESS + address, SEEK_SET);
+    fwrite(p, 1, length, f);
+    fclose(f);
+#else
+    for (int i = 0; i < length; i++) {
+        EEPROM.update(CARDSYNC_BASE_ADDRESS + address + i, p[i]);
+    }
+#endif
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：initCardSync()
+// 功能：由儲存區載入卡號索引，識別碼不符或上次寫入中斷時重新建立
+// 參數：無
+// 傳回值：無
+// 說明：開機時呼叫一次；重新建立的索引版本為 0，下次同步會從頭分頁索取
+// ---------------------------------------------------------------
+void initCardSync()
+{
+    syncRead(0, &syncHeader, sizeof(syncHeader));
+    if (syncHeader.magic != CARDSYNC_MAGIC || syncHeader.capacity != CARDSYNC_CAPACITY ||
+        syncHeader.count > CARDSYNC_CAPACITY || syncHeader.dirty != 0) {
+        syncHeader.magic = CARDSYNC_MAGIC;
+        syncHeader.version = 0;
+        syncHeader.count = 0;
+        syncHeader.capacity = CARDSYNC_CAPACITY;
+        syncHeader.dirty = 0;
+        memset(syncHeader.reserved, 0, sizeof(syncHeader.reserved));
+        syncWrite(0, &syncHeader, sizeof(syncHeader));
+    } else {
+        syncRead(sizeof(syncHeader), syncUid, syncHeader.count * sizeof(uint32_t));
+        syncRead(sizeof(syncHeader) + sizeof(syncUid), syncState, syncHeader.count);
+    }
+
+    Serial.print("Card index:(");
+    Serial.print(syncHeader.count);
+    Serial.print(" cards, version ");
+    Serial.print(syncHeader.version);
+    Serial.print(")\n");
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：cardIndexLookup()
+// 功能：以二分搜尋查詢卡號在索引中的狀態
+// 參數：
+//   - uid: 卡號（readRFIDUIDValue() 的數值）
+// 傳回值：CARD_ALLOW / CARD_DENY，索引中沒有這張卡時傳回 CARD_UNKNOWN
+// ---------------------------------------------------------------
+uint8_t cardIndexLookup(uint32_t uid)
+{
+    int lo = 0;
+    int hi = syncHeader.count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (syncUid[mid] == uid) return syncState[mid];
+        if (syncUid[mid] < uid) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return CARD_UNKNOWN;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：cardIndexSet()
+// 功能：在 RAM 索引中加入或更新一張卡，維持由小到大排序
+// 參數：
+//   - uid: 卡號
+//   - state: CARD_ALLOW 或 CARD_DENY
+// 傳回值：true 加入新卡或狀態改變、false 索引不變（狀態相同或索引已滿）
+// 說明：索引已滿時無法加入新卡（累計 syncOverflow），這些卡仍由雲端查詢決定
+// ---------------------------------------------------------------
+bool cardIndexSet(uint32_t uid, uint8_t state)
+{
+    int lo = 0;
+    int hi = syncHeader.count;
+    while (lo < hi) {                        // 找出第一個 >= uid 的位置
+        int mid = (lo + hi) / 2;
+        if (syncUid[mid] < uid) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < syncHeader.count && syncUid[lo] == uid) {
+        if (syncState[lo] == state) return false;
+        syncState[lo] = state;               // 已存在：更新狀態
+        return true;
+    }
+    if (syncHeader.count >= CARDSYNC_CAPACITY) {
+        syncOverflow++;
+        return false;
+    }
+    // 後面的卡號往後移一格，空出插入位置
+    for (int i = syncHeader.count; i > lo; i--) {
+        syncUid[i] = syncUid[i - 1];
+        syncState[i] = syncState[i - 1];
+    }
+    syncUid[lo] = uid;
+    syncState[lo] = state;
+    syncHeader.count++;
+    return true;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：cardSyncSave()
+// 功能：把 RAM 索引與標頭寫入儲存區
+// 說明：先標記 dirty 再寫入卡號資料，最後寫入新的版本並清除 dirty，
+//       寫到一半斷電時開機會重新建立索引，而不會使用不完整的資料
+// ---------------------------------------------------------------
+void cardSyncSave()
+{
+    syncHeader.dirty = 1;
+    syncWrite(0, &syncHeader, sizeof(syncHeader));
+    syncWrite(sizeof(syncHeader), syncUid, syncHeader.count * sizeof(uint32_t));
+    syncWrite(sizeof(syncHeader) + sizeof(syncUid), syncState, syncHeader.count);
+    syncHeader.dirty = 0;
+    syncWrite(0, &syncHeader, sizeof(syncHeader));
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：cardSyncApply()
+// 功能：解析一頁同步回應並套用到索引
+// 參數：
+//   - body: 回應內容（不需要以 '\0' 結尾）
+//   - length: 回應長度
+// 傳回值：1 還有下一頁、0 已同步完成、-1 格式錯誤（索引不變）
+// 說明：
+//   1. 第一行必須是「V <新版本> <0/1>」，新版本不可小於目前版本
+//   2. 每一筆變更同時清除授權快取中的舊結果，下次刷卡改以索引為準
+//   3. 整頁套用完才寫入儲存區，版本號與卡號資料一起更新
+//   4. 索引與版本都沒有改變時（例如「V <目前版本> 0」）不寫入儲存區，
+//      每次輪詢都沒有變更時不會磨損 EEPROM
+// ---------------------------------------------------------------
+int cardSyncApply(const char *body, int length)
+{
+    const char *p = body;
+    const char *end = body + length;
+    unsigned long version = 0;
+    int more = 0;
+    bool header = false;
+    bool changed = false;                    // 這一頁是否改變了索引
+
+    while (p < end) {
+        // 取出一行（去掉 \r\n）
+        const char *eol = p;
+        while (eol < end && *eol != '\n') eol++;
+        const char *next = eol < end ? eol + 1 : end;
+        if (eol > p && eol[-1] == '\r') eol--;
+
+        if (eol - p >= 3 && p[1] == ' ') {
+            char *num;
+            if (!header) {
+                if (p[0] != 'V') return -1;
+                version = strtoul(p + 2, &num, 10);
+                more = (num < eol && strtol(num, NULL, 10) != 0) ? 1 : 0;
+                if (version < syncHeader.version) return -1;
+                header = true;
+            } else if (p[0] == 'A' || p[0] == 'D') {
+                uint32_t uid = strtoul(p + 2, &num, 10);
+                uint8_t state = p[0] == 'A' ? CARD_ALLOW : CARD_DENY;
+                if (cardIndexSet(uid, state)) changed = true;
+                cardForget(uid);             // 快取中的舊結果作廢
+            }
+            // 不認得的行略過，保留日後擴充的空間
+        } else if (eol > p && !header) {
+            return -1;                       // 第一行不是版本行
+        }
+        p = next;
+    }
+    if (!header) return -1;
+
+    if (changed || version != syncHeader.version) {
+        syncHeader.version = version;
+        cardSyncSave();
+    }
+    return more;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：cardSyncPage()
+// 功能：向雲端索取目前版本之後的一頁變更並套用
+// 參數：無
+// 傳回值：1 還有下一頁、0 已同步完成、-1 連線或格式錯誤
+// 說明：與 SendtoClouding() 共用 keep-alive 連線；
+//       下一頁的請求要帶這一頁回傳的版本，送出前無法得知，
+//       所以不使用 http_getPipelined() 一次送出多頁
+// ---------------------------------------------------------------
+int cardSyncPage()
+{
+    sprintf(syncPath, cardsyncagent, MacData.c_str(), (unsigned long)syncHeader.version, CARDSYNC_PAGE_SIZE);
+    Serial.println(syncPath);
+
+    Wifi.http_setKeepAlive(true);
+    Wifi.http_begin(ServerURL, ServerPort, syncPath);
+    int httpCode = Wifi.http_get();
+    Wifi.http_end();
+    if (httpCode != 200) {
+        Serial.print("Card sync failed:(");
+        Serial.print(httpCode);
+        Serial.print(")\n");
+        return -1;
+    }
+    // 回應內容由驅動程式收集在 BMC81M001Response 中
+    return cardSyncApply(Wifi.BMC81M001Response, Wifi.resLength);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：cardSyncPoll()
+// 功能：開機後第一次呼叫或同步間隔到了，就索取一頁變更
+// 參數：無
+// 傳回值：無
+// 說明：每次呼叫只發出一個 HTTP 請求，請求之間回到 loop()，
+//       讀卡與關門不必等整份清單同步完成；
+//       還有下一頁時，下次呼叫立即接續（由已儲存的版本繼續）
+// ---------------------------------------------------------------
+void cardSyncPoll()
+{
+    if (syncStarted && !syncMore && millis() - syncLast < CARDSYNC_INTERVAL) return;
+    if (!WifiOnline()) return;               // 離線時不同步，下次再試（見 TCP.h）
+    syncStarted = true;
+    syncLast = millis();
+
+    int more = cardSyncPage();
+    syncMore = more > 0;                     // 失敗時等下一個同步間隔，由已儲存的版本重試
+    if (more != 0) return;                   // 還沒同步完成
+
+    Serial.print("Card index:(");
+    Serial.print(syncHeader.count);
+    Serial.print(" cards, version ");
+    Serial.print(syncHeader.version);
+    Serial.print(")\n");
+}
@@ -29,9 +29,11 @@
  *      a. 呼叫 checkReadRFIDSuccess() 檢查是否有 RFID 卡片靠近
  *      b. 若偵測到卡片，呼叫 readRFIDUIDString() 讀取卡片 UID
  *      c. 將讀取到的卡號顯示於序列監控視窗與 OLED 螢幕
- *      d. 檢查 Wi-Fi 連線狀態（Wifi.getStatus()）
- *      e. 若 Wi-Fi 連線正常，呼叫 SendtoClouding() 將卡號傳送至雲端
- *      f. 延遲 2 秒後重複執行，避免過度頻繁讀取
+ *      d. 呼叫 checkCard()，先查授權快取（CardCacheLib.h）決定是否開門
+ *      e. 快取沒有或已過期時，呼叫 SendtoClouding() 將卡號傳送至雲端驗證；
+ *         快取命中時則在關門後向雲端確認
+ *      f. 每次 loop() 呼叫 doorPoll()，開門滿 DOOR_OPEN_TIME 就關門，
+ *         開門期間不讀卡、不同步，讀卡間隔為 RFID_READ_INTERVAL（2 秒）
  * 
  * 【資料傳輸】
  *   - 使用 HTTP GET 方式將卡號資料傳送至雲端伺服器
@@ -68,6 +70,8 @@
 String SSIDData ;           // 儲存所連接的 Wi-Fi AP（無線基地台）的 SSID 名稱
 String IPData ;             // 儲存開發板取得的 IP 位址字串（例如 "192.168.1.100"）
 String MacData ;            // 儲存開發板的 MAC 位址字串（例如 "AA:BB:CC:DD:EE:FF"）
+unsigned long lastRead = 0; // 上次讀卡的 millis()
+#define RFID_READ_INTERVAL 2000    // 讀卡間隔（毫秒），避免重複讀取同一張卡片
 //String uidStr ;             // 儲存讀取到的 RFID 卡片 UID 字串
 
 // ========================================
@@ -76,9 +80,11 @@ String MacData ;            // 儲存開發板的 MAC 位址字串（例如 "AA:
 #include <String.h>         // 引入字串處理函式庫，用於字串的儲存與操作
 #include "RelayLib.h"       // 引入繼電器控制函式庫，包含繼電器初始化、Wi-Fi 初始化及 MAC 位址取得等功能
 #include "TCP.h"            // 引入 TCP 通訊函式庫，包含網路連線相關的函式
+#include "MetricsLib.h"     // 引入執行期量測函式庫，記錄 AT 指令、HTTP、讀卡時間，序列埠送入 'm' 即可查看
 #include "OledLib.h"        // 引入 OLED 顯示模組自訂函式庫，提供螢幕顯示相關函式
 #include "RFIDLib.h"        // 引入 RFID 讀卡模組函式庫，用於 BMC11T001 RFID 讀寫模組的通訊控制
 #include "clouding.h"       // 引入雲端通訊函式庫，提供 HTTP GET 方式將資料傳送至雲端伺服器的功能
+#include "CardSyncLib.h"    // 引入卡片清單增量同步函式庫，定期由雲端取得卡片變更並存入 EEPROM
 
 // ========================================
 // 函式前置宣告
@@ -96,6 +102,7 @@ void PrintmsgonOLED(String ss);    // 在 OLED 螢幕上顯示系統訊息或結
 // ========================================
 void setup() 
 {
+  metricsBegin();     // 開始量測（AT 指令與 http_get() 由驅動程式自動回報）
   initAll();          // 初始化整體系統（序列埠、繼電器、OLED、Wi-Fi、RFID 等模組）
 
   Serial.println("");                 // 輸出空行，讓序列監控視窗的顯示更美觀
@@ -114,6 +121,9 @@ void setup()
 
   initAll();                          // 再次初始化整體系統，確保所有模組穩定運作
 
+  initjson();                         // 登錄雲端回應要取出的 JSON 欄位（只能執行一次）
+  initCardSync();                     // 載入上次同步並保存在 EEPROM 中的卡號索引
+
   drawPicture(0, 0, BestModule_LOGO, 128, 64); // 在 OLED 螢幕上顯示廠商 LOGO 點陣圖
                                               // 參數說明：(x座標, y座標, 圖案陣列, 寬度, 高度)
   delay(2000);                        // 延遲 2 秒鐘，讓 LOGO 有足夠時間顯示
@@ -129,10 +139,27 @@ void setup()
 // ========================================
 void loop()
 {
+  // 開門滿 DOOR_OPEN_TIME 就關門，關門後才向雲端確認（見 clouding.h）
+  // 門開著的期間不讀卡、不同步，任何網路請求都不會延後關門
+  doorPoll();
+  metricsSerialPoll();                // 序列埠送入 'm' 時印出所有量測數值，'r' 時清除
+  if (doorBusy()) return;
+
+  // 每隔 RFID_READ_INTERVAL 才讀卡一次
+  // 避免因程式循環過快導致重複讀取同一張卡片，或造成雲端伺服器過度負載
+  if (millis() - lastRead < RFID_READ_INTERVAL) return;
+  lastRead = millis();
+
   // 檢查是否有 RFID 卡片靠近並成功讀取
   // checkReadRFIDSuccess() 回傳 true 表示偵測到卡片且讀取成功
-  if (checkReadRFIDSuccess())
+  // 每次讀卡的時間記錄在 rfid_read，讀到的卡片數記錄在 rfid_card
+  unsigned long start = metricStart();
+  bool found = checkReadRFIDSuccess();
+  metricStop(metricHistogram("rfid_read"), start);
+  if (found)
   {
+    metricInc(metricCounter("rfid_card"));
+    uidValue = readRFIDUIDValue();    // 讀取 RFID 卡片的 UID 數值（授權快取的鍵值）
     uidStr = readRFIDUIDString();     // 讀取 RFID 卡片的 UID 並轉換為字串格式
 
     // 將讀取到的卡號輸出至序列監控視窗，供除錯檢視
@@ -142,23 +169,15 @@ void loop()
 
     PrintCardonOLED(uidStr);          // 在 OLED 螢幕上顯示讀取到的卡號（第 4 行）
 
-    // 檢查 Wi-Fi 連線狀態是否正常
-    // Wifi.getStatus() 回傳 true 表示 Wi-Fi 已連線且運作正常
-    if (Wifi.getStatus())
-    {
-      Serial.println("WIFI OK");      // 輸出 Wi-Fi 連線正常訊息至序列監控視窗
-      SendtoClouding();               // 呼叫 SendtoClouding() 函式，將感測資料（卡號）透過 HTTP 傳送至雲端伺服器
-    }
-    else
-    {
-      // 若 Wi-Fi 連線異常，可在此處加入錯誤處理邏輯（例如顯示錯誤訊息）
-      // 本程式目前未實作此部分的處理
-    }
+    // 由授權快取立即決定是否開門，需要時才向雲端查詢，
+    // 快取命中時雲端確認在關門後進行（Wi-Fi 斷線時沿用快取結果）
+    start = metricStart();
+    checkCard();
+    metricStop(metricHistogram("card_check"), start);
   }
 
-  // 延遲 2 秒鐘（2000 毫秒）再進行下一次的讀卡動作
-  // 避免因程式循環過快導致重複讀取同一張卡片，或造成雲端伺服器過度負載
-  delay(2000);
+  // 門沒有開時，依同步間隔向雲端索取卡片清單的變更
+  if (!doorBusy()) cardSyncPoll();
 }
 
 // ========================================
@@ -1,10 +1,15 @@
 /*
-這段程式碼的註解說明了如何使用 ArduinoJson 庫，
-將回傳的資料序列化成 JSON 格式。
+這段程式碼的註解說明了如何從雲端回傳的資料中取出 JSON 欄位。
+改用 BMC81M001 驅動程式內建的 JSONScanner：HTTP 回應在接收時就逐字元解析，
+只把需要的欄位值複製到下列固定大小的緩衝區，不再建立整份 JSON 文件與 String 副本。
  */
  //---------外部函式宣告區--------
-#include <ArduinoJson.h>  // Json 使用元件
-StaticJsonDocument<200> doc; // 建立 JSON 文件物件
+JSONScanner jsonScanner;     // JSON 欄位掃描器（依序解析 HTTP 回應內容）
+
+char jsonDevice[16];         // "Device" 欄位值（裝置 MAC 位址，12 字元）
+char jsonCard[16];           // "Card" 欄位值（RFID 卡號，10 字元）
+char jsonResult[12];         // "Result" 欄位值（"Find"、"notFind" 等）
+char jsonSystime[16];        // "Systime" 欄位值（伺服器時間，14 字元）
 
 /*
 {
@@ -19,7 +24,11 @@ StaticJsonDocument<200> doc; // 建立 JSON 文件物件
 }
 */
 
-void initjson()   // 初始化 JSON 資料
+void initjson()   // 初始化 JSON 資料：登錄要取出的欄位，並交給 Wi-Fi 模組在接收 HTTP 回應時使用
 {
-
+  jsonScanner.addField("Device", jsonDevice, sizeof(jsonDevice));
+  jsonScanner.addField("Card", jsonCard, sizeof(jsonCard));
+  jsonScanner.addField("Result", jsonResult, sizeof(jsonResult));
+  jsonScanner.addField("Systime", jsonSystime, sizeof(jsonSystime));
+  Wifi.http_setJsonScanner(&jsonScanner);
 }
@@ -163,6 +163,10 @@ String readRFIDUUIDString();
 // 與 readRFIDUUID() 功能類似，但使用不同的資料來源
 String readRFIDUIDString();
 
+// 與 readRFIDUIDString() 相同的卡號，但直接傳回 32 位元數值（不建立 String）
+// 供 CardCacheLib.h 的授權快取查詢使用
+unsigned long readRFIDUIDValue();
+
 // ========================================
 // initRFID() 函式：初始化 RFID 讀卡模組
 // ========================================
@@ -424,4 +428,30 @@ String readRFIDUIDString()
     return tmp;
   }
   return tmp;  // 備援回傳（理論上不會執行到此）
-}
\ No newline at end of file
+}
+
+// ========================================
+// readRFIDUIDValue() 函式：取得與 readRFIDUIDString() 相同的卡號數值
+// ========================================
+// 功能說明：
+//   將 uid_buf[4]~uid_buf[11] 的 8 個 HEX 字元直接轉成 32 位元整數，
+//   與 readRFIDUIDString() 相同，第一組兩位 HEX 為最低位元組
+//   （例如 "12345678" → 0x78563412 → "2018915346"）
+// 輸入參數：無（使用全域變數 uid_buf）
+// 回傳值：32 位元卡號數值
+// 說明：不配置 String，刷卡時可在微秒內完成授權快取查詢
+// ========================================
+unsigned long readRFIDUIDValue()
+{
+  unsigned long value = 0;
+  for (int i = 0; i < 8; i++) {
+    char c = (char)uid_buf[4 + i];
+    unsigned long d = 0;
+    if (c >= '0' && c <= '9') d = c - '0';
+    else if (c >= 'A' && c <= 'F') d = c - 'A' + 10;
+    else if (c >= 'a' && c <= 'f') d = c - 'a' + 10;
+    // 第 i 個字元屬於第 i/2 個位元組，偶數位置為該位元組的高 4 位元
+    value |= d << ((i / 2) * 8 + (i % 2 == 0 ? 4 : 0));
+  }
+  return value;
+}
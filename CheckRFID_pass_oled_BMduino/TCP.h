@@ -184,6 +184,9 @@ BMC81M001 Wifi(&Serial2);  // 使用 BMduino 的 Serial2 硬體序列埠
 void initWiFi();        // 初始化 WiFi 模組並連線到指定熱點
                         // 此函式應在 setup() 中呼叫
 
+bool WifiOnline();      // 判斷 WiFi 是否已取得 IP 可連上網路（AT+CIPSTATUS 為 2、3、4）
+                        // getStatus() 失敗時傳回負值，不可直接當成 true/false 使用
+
 // ---------- 網路資訊取得函式 ----------
 String GetMAC();        // 取得 WiFi 模組的 MAC 位址（硬體唯一識別碼）
                         // 回傳格式：連續 12 個大寫字母數字（如 "D8BFC0123456"）
@@ -279,6 +282,28 @@ void initWiFi()
     delay(500);
 }
 
+// ---------------------------------------------------------------
+// 函式名稱：WifiOnline()
+// 功能：判斷 WiFi 模組目前是否可連上網路
+// 參數：無
+// 傳回值：bool - true：已取得 IP，可以送出 HTTP 請求；false：離線或模組沒有回應
+// 說明：
+//   getStatus() 傳回 AT+CIPSTATUS 的狀態碼，失敗時為負值（COMMUNICAT_ERROR），
+//   永遠不會是 0，因此 if (!Wifi.getStatus()) 無法偵測斷線
+//     2 (WIFI_STATUS_GOT_IP)       ：已取得 IP
+//     3 (WIFI_STATUS_CONNETED)     ：已取得 IP，且有 TCP 連線（keep-alive 連線保持時）
+//     4 (WIFI_STATUS_DISCONNETED)  ：已取得 IP，TCP 連線剛被關閉
+//     5 (WIFI_STATUS_NO_CONNET)    ：未連上熱點
+//   3 與 4 仍然有 IP，只是多了 TCP 連線的狀態，所以也視為可連線；
+//   若只接受 2，keep-alive 連線保持開啟時會被誤判為離線
+// ---------------------------------------------------------------
+bool WifiOnline()
+{
+    int status = Wifi.getStatus();
+    return status == WIFI_STATUS_GOT_IP || status == WIFI_STATUS_CONNETED ||
+           status == WIFI_STATUS_DISCONNETED;
+}
+
 // ---------------------------------------------------------------
 // 函式名稱：GetMAC()
 // 功能：取得 WiFi 模組的 MAC 位址（硬體唯一識別碼）
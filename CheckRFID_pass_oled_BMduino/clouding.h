@@ -38,23 +38,41 @@
  *     "Result": "Find"        // "Find" 表示卡號已註冊，"notFind" 表示未註冊
  *   }
  * 
+ * 【授權快取】
+ *   主程式刷卡時呼叫 checkCard()，先查 CardCacheLib.h 的授權快取：
+ *   - 快取中已授權：立即開門，關門後再呼叫 SendtoClouding() 向雲端確認，
+ *     雲端回報已撤銷時更新快取，下次刷卡就不再開門
+ *   - 快取中已拒絕：立即顯示 notFind，不查詢雲端（negative caching）
+ *   - 快取中沒有或已過期：先查 CardSyncLib.h 同步下來的卡號索引，
+ *     索引中也沒有才呼叫 SendtoClouding() 查詢雲端，結果寫入快取
+ *   - WiFi 斷線時：沿用已過期的快取結果（CARD_OFFLINE_STALE 為 1 時）
+ *   門禁反應時間因此不再受 WiFi 與伺服器負載影響
+ * 
+ * 【開門計時】
+ *   openDoorTimed() 開門後立即返回，主程式每次 loop() 呼叫 doorPoll()，
+ *   開門滿 DOOR_OPEN_TIME 毫秒就關門。開門時間只由計時決定，
+ *   不會因為等待雲端回應（最長約 30 秒）而讓門一直開著；
+ *   需要向雲端確認的卡片，在關門之後才由 doorPoll() 送出查詢
+ * 
  * 【運作流程】
- *   1. 外部程式（主程式）呼叫 SendtoClouding() 函式
+ *   1. checkCard() 需要雲端結果時呼叫 SendtoClouding() 函式
  *   2. 使用 sprintf() 將 MAC 位址與卡號組合成完整請求路徑
- *   3. 檢查 Wi-Fi 連線狀態（Wifi.getStatus()）
+ *   3. 檢查 Wi-Fi 連線狀態（TCP.h 的 WifiOnline()）
  *   4. 若 Wi-Fi 已連線，透過 HTTP GET 方式傳送請求
- *   5. 接收伺服器回應，並儲存於 webresponse 字串
- *   6. 呼叫 getjson() 函式解析 JSON 資料（或直接使用 ArduinoJson 解析）
- *   7. 使用 deserializeJson() 解析 JSON 字串
- *   8. 提取 Device、Card、Result 三個欄位的值
+ *   5. 接收伺服器回應，同時由 jsonScanner 逐字元解析 JSON 內容
+ *   6. （已不再需要）getjson() 與 deserializeJson() 的二次複製與解析
+ *   7. 確認回應中有 Device 與 Result 欄位
+ *   8. 取得 Device、Card、Result 三個欄位的值
  *   9. 比對 Device 是否與本機 MAC 位址相符
- *   10. 根據 Result 值決定門禁權限：
- *        - 若 Result 為 "Find"：卡號已註冊，開啟門鎖 2 秒後關閉
- *        - 若 Result 為 "notFind"：卡號未註冊，不開啟門鎖
- *   11. 將驗證結果顯示於 OLED 螢幕
+ *   10. 根據 Result 值傳回驗證結果（開關門由 checkCard() 負責）：
+ *        - 若 Result 為 "Find"：卡號已註冊，傳回 CARD_ALLOW
+ *        - 若 Result 為 "notFind"：卡號未註冊，傳回 CARD_DENY
+ *        - Wi-Fi 斷線：傳回 CARD_OFFLINE
+ *        - 其他情況（HTTP 錯誤、格式錯誤、MAC 不符）：傳回 CARD_UNKNOWN
+ *   11. checkCard() 開門並將結果顯示於 OLED 螢幕，doorPoll() 於 DOOR_OPEN_TIME 毫秒後關門
  * 
  * 【相依函式庫】
- *   - JSONLib.h：JSON 解析函式庫（可能為 ArduinoJson 的封裝）
+ *   - JSONLib.h：JSON 欄位掃描器與欄位值緩衝區（使用 BMC81M001 的 JSONScanner）
  *   - Wifi 物件：來自 RelayLib 或 TCP.h，提供網路連線功能
  * 
  * 【全域變數說明】
@@ -62,11 +80,10 @@
  *   - uidStr：儲存讀取到的 RFID 卡號字串
  *   - dbagentstr：sprintf 組合字串時的暫存區
  *   - connectstr：組合完成的完整 HTTP 請求路徑
- *   - webresponse：儲存伺服器回傳的原始回應字串
  *   - jsonresult：儲存解析後的 JSON 結果（Result 欄位值）
  * 
  * 【注意事項】
- *   - 使用前需確保 MacData 與 uidStr 已正確賦值
+ *   - 使用前需確保 MacData 已正確賦值，卡號由呼叫端以參數傳入
  *   - Wi-Fi 模組需已完成初始化並成功連線
  *   - 伺服器端需正確佈署 checkpass.php 程式
  *   - JSON 解析失敗時會輸出錯誤訊息至序列監控視窗
@@ -86,6 +103,7 @@
 // #include "commlib.h"  // common lib 元件（註解狀態，未使用）
 #include "JSONLib.h"          // 引入 JSON 解析函式庫，用於處理伺服器回傳的 JSON 資料
                               // 此函式庫可能封裝了 ArduinoJson 的相關功能
+#include "CardCacheLib.h"     // 引入授權卡號快取函式庫，刷卡時不必等待雲端回應
 
 // ========================================
 // 常數與巨集定義
@@ -97,17 +115,27 @@
 String ServerURL = "http://iot.arduino.org.tw";  // 雲端伺服器的基礎網址
 
 // dbagent：API 路徑與參數的格式字串
-// %s 為格式化的佔位符，會依序被 MacData 與 uidStr 取代
+// %s 為格式化的佔位符，會依序被 MacData 與卡號取代
 #define dbagent "/bmduino/rfid/checkpass.php?MAC=%s&KEY=%s"
 
+#define DOOR_OPEN_TIME 2000        // 開門持續時間（毫秒）
+#ifndef CARD_OFFLINE_STALE
+#define CARD_OFFLINE_STALE 1       // 1：WiFi 斷線時沿用已過期的快取結果；0：斷線時一律不開門
+#endif
+
 // ========================================
 // 全域變數定義
 // ========================================
 char dbagentstr[300];              // sprintf() 組合字串時的暫存區，儲存完整的 API 路徑
 String connectstr;                 // 一個空的字串變數，後續用來動態組成完整的 RESTful 請求參數
 String uidStr = "";                // 儲存讀取到的 RFID 卡號字串（例如 "0079262864"）
-String webresponse;                // 儲存 HTTP GET 請求後，伺服器回傳的原始回應字串
 String jsonresult;                 // 儲存解析後的 JSON 結果（例如 "Find" 或 "notFind"）
+unsigned long uidValue = 0;        // 讀取到的 RFID 卡號數值（readRFIDUIDValue()），作為快取的鍵值
+bool doorOpened = false;           // 門鎖目前是否開啟（由 doorPoll() 計時關閉）
+unsigned long doorOpenedAt = 0;    // 開門時的 millis()
+bool confirmPending = false;       // 關門後是否要向雲端確認（快取命中開門時）
+unsigned long confirmUid = 0;      // 要向雲端確認的卡號數值（快取鍵值）
+String confirmUidStr = "";         // 要向雲端確認的卡號字串（查詢參數）
 
 /*
  * HTTP 請求結構說明：
@@ -126,37 +154,163 @@ String jsonresult;                 // 儲存解析後的 JSON 結果（例如 "F
 // ========================================
 // 函式前置宣告
 // ========================================
-void SendtoClouding();             // 傳送感測資料（RFID 卡號）到雲端伺服器
+void checkCard();                  // 刷卡處理：依授權快取開門，必要時向雲端查詢或確認
+void openDoorTimed();              // 開門並開始計時，不等待關門
+void doorPoll();                   // 開門時間到就關門，關門後再進行待確認的雲端查詢，在 loop() 中呼叫
+bool doorBusy();                   // 門鎖開啟中或還有待確認的卡片時傳回 true
+uint8_t SendtoClouding(const String &uid);  // 傳送 RFID 卡號到雲端伺服器驗證，傳回 CARD_ALLOW / CARD_DENY / CARD_UNKNOWN / CARD_OFFLINE
+uint8_t cardIndexLookup(uint32_t uid);  // 查詢同步下來的卡號索引（在 CardSyncLib.h 中實作）
 void PrintCardonOLED(String ss);   // 顯示卡號在 OLED 螢幕上（此函式應由主程式實作）
 void PrintmsgonOLED(String ss);    // 顯示結果資訊在 OLED 螢幕上（此函式應由主程式實作）
 
+// ========================================
+// checkCard() 函式：刷卡處理，由授權快取決定是否開門
+// ========================================
+// 使用全域變數 uidValue（快取鍵值）與 uidStr（雲端查詢用的卡號字串）
+void checkCard()
+{
+  bool expired = true;
+  uint8_t cached = cardLookup(uidValue, &expired);
+
+  // ========================================
+  // 情況 1：快取中已授權 → 立即開門，關門後再向雲端確認
+  // ========================================
+  if (cached == CARD_ALLOW && !expired)
+  {
+    metricInc(metricCounter("card_cache_hit"));
+    Serial.println("Card cache: PASS");
+    PrintmsgonOLED("Find");
+    openDoorTimed();                     // 不等待網路，立即開門，由 doorPoll() 計時關門
+
+    // 已同步到索引的卡片，變更會由 cardSyncPoll() 取得，直接更新快取的存活時間；
+    // 其他卡片等關門後由 doorPoll() 向雲端確認
+    uint8_t confirmed = cardIndexLookup(uidValue);
+    if (confirmed != CARD_UNKNOWN)
+    {
+      cardUpdate(uidValue, confirmed);
+    }
+    else
+    {
+      confirmPending = true;
+      confirmUid = uidValue;
+      confirmUidStr = uidStr;
+    }
+    return;
+  }
+
+  // ========================================
+  // 情況 2：快取中已拒絕 → 立即拒絕，不查詢雲端
+  // ========================================
+  if (cached == CARD_DENY && !expired)
+  {
+    metricInc(metricCounter("card_cache_hit"));
+    Serial.println("Card cache: NO PASS");
+    PrintmsgonOLED("notFind");
+    return;
+  }
+
+  // ========================================
+  // 情況 3：快取中沒有或已過期 → 先查同步索引，索引中沒有才查詢雲端
+  //         （斷線時沿用過期結果）
+  // ========================================
+  metricInc(metricCounter("card_cache_miss"));
+  uint8_t result = cardIndexLookup(uidValue);
+  if (result == CARD_UNKNOWN)
+  {
+    result = SendtoClouding(uidStr);     // Wi-Fi 斷線時傳回 CARD_OFFLINE
+  }
+  cardUpdate(uidValue, result);
+  bool offline = result == CARD_OFFLINE;
+  if (offline && CARD_OFFLINE_STALE)
+  {
+    // 只有斷線才沿用過期的快取結果；伺服器錯誤、格式錯誤或 MAC 不符
+    // 代表雲端有回應但無法確認，不開門
+    result = cached;
+  }
+
+  if (result == CARD_ALLOW)
+  {
+    PrintmsgonOLED("Find");
+    openDoorTimed();                     // 開啟門鎖，DOOR_OPEN_TIME 毫秒後由 doorPoll() 關閉
+  }
+  else if (result == CARD_DENY)
+  {
+    PrintmsgonOLED("notFind");           // 注意：此處未呼叫 openDoor()，因此門鎖保持關閉狀態
+  }
+  else
+  {
+    PrintmsgonOLED(offline ? "Offline" : "Error");  // 無法驗證，為安全起見不開門
+  }
+}
+
+// ========================================
+// openDoorTimed() 函式：開門並開始計時
+// ========================================
+// 開門後立即返回，關門由 doorPoll() 依 DOOR_OPEN_TIME 決定
+void openDoorTimed()
+{
+  openDoor();                            // 控制門鎖繼電器，設定為開啟狀態
+  doorOpened = true;
+  doorOpenedAt = millis();
+}
+
+// ========================================
+// doorPoll() 函式：開門時間到就關門，關門後再向雲端確認
+// ========================================
+// 在 loop() 中每次呼叫。關門只看計時，與網路狀態無關；
+// 快取命中時的雲端確認在關門之後才送出，確認期間門已經關上。
+// 雲端回報已撤銷時更新快取，這張卡下次刷卡就不再開門。
+// 確認仍是阻塞的 http_get()，期間 loop() 不讀卡，最長到 HTTP 逾時為止
+void doorPoll()
+{
+  if (doorOpened)
+  {
+    if (millis() - doorOpenedAt < DOOR_OPEN_TIME) return;
+    closeDoor();                         // 控制門鎖繼電器，設定為關閉狀態
+    doorOpened = false;
+  }
+  if (!confirmPending) return;
+  confirmPending = false;
+
+  // 確認的是開門那張卡，不依賴 uidStr 目前的內容
+  uint8_t confirmed = SendtoClouding(confirmUidStr);
+  cardUpdate(confirmUid, confirmed);     // 無法驗證時 cardUpdate() 不會改變快取
+  if (confirmed == CARD_DENY)
+  {
+    Serial.println("Card revoked by cloud");
+    PrintmsgonOLED("Revoked");
+  }
+}
+
+// ========================================
+// doorBusy() 函式：門鎖是否開啟中或還有待確認的卡片
+// ========================================
+// 主程式在此期間不讀卡、不同步，避免網路請求延後關門
+bool doorBusy()
+{
+  return doorOpened || confirmPending;
+}
+
 // ========================================
 // SendtoClouding() 函式：將 RFID 卡號傳送至雲端伺服器進行驗證
-// 此函式為本檔案的核心功能，負責 HTTP 通訊與 JSON 解析
+// 此函式負責 HTTP 通訊與 JSON 解析，開關門由 checkCard() 決定
 // ========================================
-void SendtoClouding()     
+uint8_t SendtoClouding(const String &uid)
 {
   // 函式說明：
-  //   此函式將讀取到的 RFID 卡號（uidStr）與設備 MAC 位址（MacData）
-  //   透過 HTTP GET 請求傳送到雲端伺服器，並根據回傳結果控制門鎖動作。
+  //   此函式將參數 uid 指定的 RFID 卡號與設備 MAC 位址（MacData）
+  //   透過 HTTP GET 請求傳送到雲端伺服器，並傳回驗證結果。
 
   // ========================================
   // 步驟 1：組成 HTTP GET 請求的參數字串
   // ========================================
-  // 使用 sprintf() 將 MacData 與 uidStr 填入 dbagent 的格式字串中
+  // 使用 sprintf() 將 MacData 與 uid 填入 dbagent 的格式字串中
   // dbagentstr 會儲存完整路徑，例如：
   //   "/bmduino/rfid/checkpass.php?MAC=112233445566&KEY=0079262864"
-  sprintf(dbagentstr, dbagent, MacData.c_str(), uidStr.c_str());
+  sprintf(dbagentstr, dbagent, MacData.c_str(), uid.c_str());
   
   // 將組合好的路徑字串轉換為 String 型態，儲存於 connectstr
   connectstr = String(dbagentstr);
-  
-  /*
-   * 組成 GET 格式的 RESTful 請求參數字串
-   * connectstr：動態組成 RESTful 請求的參數部分
-   * MacData：設備的 MAC 位址
-   * uidStr：讀取到的 RFID 卡號
-   */
 
   // 將組合好的參數字串輸出至序列監控視窗，用於除錯
   Serial.println(connectstr);
@@ -164,113 +318,90 @@ void SendtoClouding()
   // ========================================
   // 步驟 2：檢查 Wi-Fi 連線狀態
   // ========================================
-  if (Wifi.getStatus())  // 若 Wi-Fi 連線正常，回傳 true
+  if (!WifiOnline())      // Wi-Fi 未連線，無法驗證（見 TCP.h 的 WifiOnline()）
   {
-    // ========================================
-    // 步驟 3：執行 HTTP GET 請求
-    // ========================================
-    // 開始 HTTP 連線，參數說明：
-    //   ServerURL：伺服器基礎網址（http://iot.arduino.org.tw）
-    //   ServerPort：伺服器埠號（8888）
-    //   connectstr：完整的 API 路徑與參數
-    Wifi.http_begin(ServerURL, ServerPort, connectstr);
+    return CARD_OFFLINE;
+  }
+  Serial.println("WIFI OK");
 
-    // 執行 HTTP GET 操作
-    Wifi.http_get();
-    
-    // 延遲 500 毫秒，等待伺服器回應
-    delay(500);
-    
-    // 取得 HTTP 回應內容（伺服器回傳的 JSON 字串）
-    webresponse = Wifi.http_getString();
-    
-    // 輸出伺服器回應內容至序列監控視窗（除錯用）
-    Serial.print("web response:[");
-    Serial.print(webresponse);
-    Serial.print("]\n");
-    
-    // 輸出回應字串的長度（除錯用）
-    Serial.print("webresponse len is :(");
-    Serial.print(webresponse.length());
-    Serial.print(")\n");
-    
-    // ========================================
-    // 步驟 4：處理 JSON 回應資料
-    // ========================================
-    // 呼叫 getjson() 函式過濾或提取 JSON 內容
-    // 註：getjson() 可能定義於 JSONLib.h 中，用於純化 JSON 字串
-    webresponse = getjson(webresponse);
-    
-    // 輸出處理後的 JSON 字串長度（除錯用）
-    Serial.print("New webresponse len is :(");
-    Serial.print(webresponse);
+  // ========================================
+  // 步驟 3：執行 HTTP GET 請求
+  // ========================================
+  // 開始 HTTP 連線，參數說明：
+  //   ServerURL：伺服器基礎網址（http://iot.arduino.org.tw）
+  //   ServerPort：伺服器埠號（8888）
+  //   connectstr：完整的 API 路徑與參數
+  // 啟用連線保持（keep-alive）：與伺服器的 TCP 連線在多次請求間重複使用，
+  // 只有在伺服器或模組回報 CLOSED 時才重新連線，省去每次刷卡的連線時間
+  // 每次刷卡只有一張卡要查詢，沒有其他請求可以一起送出，
+  // 因此不使用 http_getPipelined()（驅動程式預設也不編譯管線化）
+  Wifi.http_setKeepAlive(true);
+  Wifi.http_begin(ServerURL, ServerPort, connectstr);
+
+  // 執行 HTTP GET 操作
+  // http_get() 依 Content-Length 或 chunked 格式判斷回應結束，收完即返回，
+  // 傳回值為 HTTP 狀態碼（例如 200），負值表示逾時或連線錯誤
+  int httpCode = Wifi.http_get();
+  
+  // 結束本次 HTTP 請求（keep-alive 模式下連線保持開啟，供下次刷卡使用）
+  Wifi.http_end();
+
+  if (httpCode != 200)
+  {
+    Serial.print("HTTP GET failed:(");
+    Serial.print(httpCode);
     Serial.print(")\n");
-    
-    // 結束 HTTP 連線，釋放資源
-    Wifi.http_end();
+    return CARD_UNKNOWN;  // 伺服器未正確回應，無法驗證
+  }
 
-    // ========================================
-    // 步驟 5：解析 JSON 資料
-    // ========================================
-    // 使用 ArduinoJson 函式庫解析 JSON 字串
-    // doc 物件應已在其他地方宣告（例如 StaticJsonDocument 或 DynamicJsonDocument）
-    DeserializationError error = deserializeJson(doc, webresponse);
+  // ========================================
+  // 步驟 4～6：取出 JSON 欄位值
+  // ========================================
+  // http_get() 接收回應時已由 jsonScanner（見 JSONLib.h）逐字元解析，
+  // Device、Card、Result 欄位值直接存放在 jsonDevice、jsonCard、jsonResult 中，
+  // 不需要再把整份回應複製成 String 後用 getjson()/deserializeJson() 解析
+  if (!jsonScanner.found("Device") || !jsonScanner.found("Result")) {
+    // 回應中沒有需要的欄位（格式錯誤或伺服器異常）
+    Serial.println("JSON parsing failed");
+    return CARD_UNKNOWN;
+  }
 
-    // 檢查 JSON 解析是否成功
-    if (error) {
-      // 解析失敗，輸出錯誤訊息
-      Serial.print("JSON parsing failed: ");
-      Serial.println(error.c_str());
-      return;  // 結束函式，不繼續執行後續門鎖控制
-    }
+  const char* device = jsonDevice;   // "Device" 欄位（應為 MAC 位址）
+  const char* Card = jsonCard;       // "Card" 欄位（應為 RFID 卡號）
+  const char* result = jsonResult;   // "Result" 欄位（"Find" 或 "notFind"）
 
-    // ========================================
-    // 步驟 6：提取 JSON 欄位值
-    // ========================================
-    // 從解析後的 JSON 文件中提取各欄位的值
-    const char* device = doc["Device"];   // 提取 "Device" 欄位（應為 MAC 位址）
-    const char* Card = doc["Card"];       // 提取 "Card" 欄位（應為 RFID 卡號）
-    const char* result = doc["Result"];   // 提取 "Result" 欄位（"Find" 或 "notFind"）
-    
-    // 將 Result 欄位轉換為 String 型態，儲存於全域變數
-    jsonresult = String(result);
+  Serial.print("Device:(");
+  Serial.print(device);
+  Serial.print(") Card:(");
+  Serial.print(Card);
+  Serial.print(") Result:(");
+  Serial.print(result);
+  Serial.print(")\n");
+  
+  // 將 Result 欄位轉換為 String 型態，儲存於全域變數
+  jsonresult = String(result);
 
-    // ========================================
-    // 步驟 7：根據驗證結果控制門鎖
-    // ========================================
-    // 判斷條件：Device 欄位與本機 MAC 位址相符，且 Result 為 "Find"
-    if (String(device) == MacData && String(result) == "Find") 
-    {
-      // 卡號已註冊，允許通行
-      Serial.print("RFID LOCK DEVICE:()");
-      Serial.print(MacData);
-      Serial.print(") Registered and PASS\n");
-      
-      // 在 OLED 螢幕上顯示驗證結果 "Find"
-      PrintmsgonOLED("Find");
-      
-      // 開啟門鎖（控制繼電器）
-      openDoor();      // 控制門鎖繼電器，設定為開啟狀態
-      
-      // 延遲 2 秒鐘，讓門鎖保持開啟狀態足夠時間讓人員通過
-      delay(2000);
-      
-      // 關閉門鎖
-      closeDoor();     // 控制門鎖繼電器，設定為關閉狀態
-    }
-    
-    // 判斷條件：Device 欄位與本機 MAC 位址相符，但 Result 為 "notFind"
-    if (String(device) == MacData && String(result) == "notFind") 
-    {
-      // 卡號未註冊，拒絕通行
-      Serial.print("RFID LOCK DEVICE:()");
-      Serial.print(MacData);
-      Serial.print(") is not Registered and NO PASS \n");
-      
-      // 在 OLED 螢幕上顯示驗證結果 "notFind"
-      PrintmsgonOLED("notFind");
-      // 注意：此處未呼叫 openDoor()，因此門鎖保持關閉狀態
-    }
+  // ========================================
+  // 步驟 7：傳回驗證結果
+  // ========================================
+  // Device 欄位必須與本機 MAC 位址相符，否則視為無法驗證
+  if (MacData != device) return CARD_UNKNOWN;
+
+  if (strcmp(result, "Find") == 0) 
+  {
+    // 卡號已註冊，允許通行
+    Serial.print("RFID LOCK DEVICE:()");
+    Serial.print(MacData);
+    Serial.print(") Registered and PASS\n");
+    return CARD_ALLOW;
+  }
+  if (strcmp(result, "notFind") == 0) 
+  {
+    // 卡號未註冊，拒絕通行
+    Serial.print("RFID LOCK DEVICE:()");
+    Serial.print(MacData);
+    Serial.print(") is not Registered and NO PASS \n");
+    return CARD_DENY;
   }
-  // 若 Wi-Fi 未連線，則不執行任何操作（可依需求加入錯誤處理）
-}
\ No newline at end of file
+  return CARD_UNKNOWN;
+}
@@ -0,0 +1,1157 @@
+/*************************************************
+File:             ATEmulator.cpp
+Description:      Scriptable emulator of the ESP-AT firmware of the
+                  BMC81M001 for the host build
+version:          V1.0.0
+**************************************************/
+#include "ATEmulator.h"
+
+#define EMU_NEVER 0xFFFFFFFFFFFFFFFFULL
+#define EMU_LINE_MAX_LENGTH 2048
+#define EMU_PAYLOAD_MAX_LENGTH 8192
+
+#define EMU_PAYLOAD_TCP  1
+#define EMU_PAYLOAD_MQTT 2
+
+static const char *EMU_OK = "\r\nOK\r\n";
+static const char *EMU_ERROR = "\r\nERROR\r\n";
+
+/* the emulator runs inside the calls of the sketch, its own
+   allocations must not show up in the heap use of the sketch */
+struct EmuHeapMute
+{
+  EmuHeapMute() { hostHeapMute(true); }
+  ~EmuHeapMute() { hostHeapMute(false); }
+};
+
+/**********************************************************
+Description: Constructor
+Parameters:
+Return:
+Others:      Any SSID is accepted until setAccessPoint() is called
+**********************************************************/
+ATEmulator::ATEmulator()
+{
+  memset(&_stats,0,sizeof(_stats));
+}
+
+//----------------------serial side----------------------------
+/**********************************************************
+Description: the board opened its serial port
+Parameters:  baud: rate given to begin()
+Return:
+Others:      the line runs at this rate unless setBaudRate() fixed it
+**********************************************************/
+void ATEmulator::begin(unsigned long baud)
+{
+  EmuHeapMute mute;
+  if(!_fixedBaud && baud > 0) _baud = baud;
+}
+/**********************************************************
+Description: bytes waiting in the UART buffer of the board
+Parameters:
+Return:      number of bytes
+Others:      An empty poll lets the virtual clock run to the next
+             byte, at most one idle step, so that waiting loops of
+             the driver take as long as on the board
+**********************************************************/
+int ATEmulator::available(void)
+{
+  EmuHeapMute mute;
+  uint64_t t = now();
+  update(t);
+  if(_uart.empty())
+  {
+    uint64_t next = EMU_NEVER;
+    if(!_toHost.empty()) next = _toHost.front().first;
+    if(!_events.empty() && _events.begin()->first < next) next = _events.begin()->first;
+    if(!_toModule.empty() && _toModule.front().first < next) next = _toModule.front().first;
+    uint64_t step = (uint64_t)_idleStep * 1000;
+    if(next > t && next - t < step) step = next - t;
+    hostAdvance((step + 999) / 1000);
+    update(now());
+  }
+  return _uart.size();
+}
+
+int ATEmulator::read(void)
+{
+  if(available() == 0) return -1;
+  uint8_t c = _uart.front();
+  _uart.pop_front();
+  return c;
+}
+
+int ATEmulator::peek(void)
+{
+  EmuHeapMute mute;
+  update(now());
+  return _uart.empty() ? -1 : _uart.front();
+}
+/**********************************************************
+Description: the board writes one byte to the module
+Parameters:  c: byte
+Return:      1
+Others:      Blocks (moves the clock) while more than the transmit
+             buffer of the board is waiting for the line
+**********************************************************/
+size_t ATEmulator::write(uint8_t c)
+{
+  EmuHeapMute mute;
+  uint64_t t = now();
+  update(t);
+  uint64_t byteTime = 10000000000ULL / _baud;
+  uint64_t start = _toModuleFree > t ? _toModuleFree : t;
+  _toModuleFree = start + byteTime;
+  _toModule.push_back(std::make_pair(_toModuleFree,c));
+  _stats.bytesToModule++;
+  uint64_t backlog = _toModuleFree - t;
+  uint64_t limit = (uint64_t)_txBufferSize * byteTime;
+  if(backlog > limit) hostAdvance((backlog - limit + 999) / 1000);
+  return 1;
+}
+
+//----------------------configuration----------------------------
+/**********************************************************
+Description: fix the baud rate of the line
+Parameters:  baud: bit/s, 0 to use the rate of begin() again
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setBaudRate(unsigned long baud)
+{
+  _fixedBaud = baud > 0;
+  _baud = baud > 0 ? baud : EMU_BAUD_RATE;
+}
+/**********************************************************
+Description: size of the UART receive buffer of the board
+Parameters:  size: bytes, 0 for no limit (default)
+Return:
+Others:      bytes arriving while it is full are lost and counted
+             in statistics().rxOverruns
+**********************************************************/
+void ATEmulator::setRxBufferSize(int size)
+{
+  _rxBufferSize = size;
+}
+
+void ATEmulator::setTxBufferSize(int size)
+{
+  _txBufferSize = size > 0 ? size : 1;
+}
+/**********************************************************
+Description: echo command lines like ATE1 (default on)
+Parameters:  enable
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setEcho(bool enable)
+{
+  _echo = enable;
+}
+
+void ATEmulator::setIdleStep(unsigned long us)
+{
+  _idleStep = us > 0 ? us : 1;
+}
+/**********************************************************
+Description: processing time of commands without own latency
+Parameters:  us
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setCommandLatency(unsigned long us)
+{
+  _commandLatency = us;
+}
+/**********************************************************
+Description: processing time of the commands starting with prefix
+Parameters:  prefix: e.g. "AT+CWJAP=", the longest match is used
+             us: time from the end of the command line to the answer
+Return:
+Others:      replaces the built-in latency (network included)
+**********************************************************/
+void ATEmulator::setLatency(const char *prefix,unsigned long us)
+{
+  for(size_t i = 0; i < _latency.size(); i++)
+  {
+    if(_latency[i].first == prefix)
+    {
+      _latency[i].second = us;
+      return;
+    }
+  }
+  _latency.push_back(std::make_pair(std::string(prefix),us));
+}
+/**********************************************************
+Description: timing of the servers behind the module
+Parameters:  rtt: round trip time in us
+             server: time a server needs for a request in us
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setNetworkLatency(unsigned long rtt,unsigned long server)
+{
+  _rtt = rtt;
+  _serverLatency = server;
+}
+/**********************************************************
+Description: the only access point that accepts AT+CWJAP
+Parameters:  ssid, pass
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setAccessPoint(const char *ssid,const char *pass)
+{
+  _apSsid = ssid;
+  _apPass = pass;
+}
+/**********************************************************
+Description: switch the access point on or off
+Parameters:  up: false drops the WiFi connection now and makes
+                 AT+CWJAP fail until it is switched on again
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setAccessPointUp(bool up)
+{
+  _apUp = up;
+  if(!up) disconnectWifi(0);
+}
+/**********************************************************
+Description: let AT+CIPSTART and AT+MQTTCONN fail
+Parameters:  reachable
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setServerReachable(bool reachable)
+{
+  _reachable = reachable;
+}
+
+void ATEmulator::setMacAddress(const char *mac)
+{
+  _mac = mac;
+}
+/**********************************************************
+Description: largest +IPD frame, longer server replies are split
+Parameters:  size: bytes, 0 for one frame per reply
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setIpdChunk(int size)
+{
+  _ipdChunk = size;
+}
+/**********************************************************
+Description: print every command and answer with its time
+Parameters:  out: e.g. stderr, NULL to stop
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setTrace(FILE *out)
+{
+  _trace = out;
+}
+
+//----------------------scripting----------------------------
+/**********************************************************
+Description: answer the commands starting with prefix
+Parameters:  prefix: e.g. "AT+CIPSTART="
+             handler: see EmuCommandHandler
+Return:
+Others:      Handlers are asked in the order they were added,
+             before the built-in firmware
+**********************************************************/
+void ATEmulator::on(const char *prefix,EmuCommandHandler handler)
+{
+  _handlers.push_back(std::make_pair(std::string(prefix),handler));
+}
+/**********************************************************
+Description: serve the TCP/SSL link
+Parameters:  handler: see EmuTcpHandler, NULL for the built-in
+                      server (http reply, any other data echoed)
+Return:
+Others:
+**********************************************************/
+void ATEmulator::onTcpData(EmuTcpHandler handler)
+{
+  _tcpHandler = handler;
+}
+/**********************************************************
+Description: reply of the built-in http server
+Parameters:  status: e.g. 200
+             body: sent with Content-Length
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setHttpReply(int status,const char *body)
+{
+  _httpStatus = status;
+  _httpBody = body;
+}
+/**********************************************************
+Description: send text to the board
+Parameters:  text
+             delay: us after the answer time of the command being
+                    handled, or after now outside of a handler
+Return:
+Others:
+**********************************************************/
+void ATEmulator::reply(const std::string &text,unsigned long delay)
+{
+  uint64_t base = _inCommand ? _replyAt : now();
+  emit(base + (uint64_t)delay * 1000,text);
+}
+/**********************************************************
+Description: data from the server on the open link
+Parameters:  data
+             delay: us, see reply()
+Return:
+Others:      split into frames of setIpdChunk() bytes, dropped if
+             the link is closed by then
+**********************************************************/
+void ATEmulator::sendIpd(const std::string &data,unsigned long delay)
+{
+  uint64_t t = (_inCommand ? _replyAt : now()) + (uint64_t)delay * 1000;
+  at(t,[this,t,data]()
+  {
+    if(!_link) return;
+    size_t chunk = _ipdChunk > 0 ? _ipdChunk : data.size();
+    for(size_t i = 0; i < data.size() || i == 0; i += chunk)
+    {
+      std::string part = data.substr(i,chunk);
+      emitNow(t,"\r\n+IPD," + std::to_string(part.size()) + ":" + part);
+      if(data.empty()) break;
+    }
+  });
+}
+/**********************************************************
+Description: the server closes the link
+Parameters:  delay: us, see reply()
+Return:
+Others:
+**********************************************************/
+void ATEmulator::closeLink(unsigned long delay)
+{
+  uint64_t t = (_inCommand ? _replyAt : now()) + (uint64_t)delay * 1000;
+  at(t,[this,t]() { dropLink(t); });
+}
+/**********************************************************
+Description: the broker forwards a message to the board
+Parameters:  topic, data
+             delay: us, see reply()
+Return:
+Others:      only received if the board subscribed the topic
+**********************************************************/
+void ATEmulator::publishToDevice(const char *topic,const std::string &data,unsigned long delay)
+{
+  uint64_t t = (_inCommand ? _replyAt : now()) + (uint64_t)delay * 1000;
+  std::string name = topic;
+  at(t,[this,t,name,data]()
+  {
+    if(!_mqtt || !subscribed(name)) return;
+    emitNow(t,"+MQTTSUBRECV:0,\"" + name + "\"," + std::to_string(data.size()) + "," + data + "\r\n");
+  });
+}
+/**********************************************************
+Description: the access point drops the board
+Parameters:  delay: us, see reply()
+Return:
+Others:      the board sees CLOSED, +MQTTDISCONNECTED and
+             WIFI DISCONNECT like on a real loss of the signal
+**********************************************************/
+void ATEmulator::disconnectWifi(unsigned long delay)
+{
+  uint64_t t = (_inCommand ? _replyAt : now()) + (uint64_t)delay * 1000;
+  at(t,[this,t]() { dropWifi(t); });
+}
+/**********************************************************
+Description: the module restarts (brown-out, watchdog, AT+RST)
+Parameters:  delay: us, see reply()
+Return:
+Others:      "ready" follows after EMU_RESET_LATENCY, the module
+             joins the last access point again by itself
+**********************************************************/
+void ATEmulator::restart(unsigned long delay)
+{
+  uint64_t t = (_inCommand ? _replyAt : now()) + (uint64_t)delay * 1000;
+  at(t,[this,t]()
+  {
+    bool rejoin = _wifi;
+    _link = false;
+    _mqtt = false;
+    _wifi = false;
+    _subscriptions.clear();
+    _payloadRemain = 0;
+    _line.clear();
+    _echo = true;
+    uint64_t ready = t + (uint64_t)EMU_RESET_LATENCY * 1000;
+    _busyUntil = ready;
+    emit(t + 1000000,std::string("\x81\xFE\x02\x00 ets Jan  8 2013,rst cause:2\r\n",34));
+    emit(ready,"\r\nready\r\n");
+    if(rejoin && _apUp)
+    {
+      uint64_t join = ready + (uint64_t)EMU_JOIN_LATENCY * 1000;
+      at(join,[this,join]()
+      {
+        if(!_apUp || _wifi) return;
+        _wifi = true;
+        _linkUsed = false;
+        emitNow(join,"WIFI CONNECTED\r\nWIFI GOT IP\r\n");
+      });
+    }
+  });
+}
+
+//----------------------fault injection----------------------------
+/**********************************************************
+Description: answer the next commands starting with prefix by a fault
+Parameters:  prefix: e.g. "AT+CIPSEND=", "" for any command
+             fault: EMU_FAULT_xxx
+             count: number of commands
+Return:
+Others:
+**********************************************************/
+void ATEmulator::failNext(const char *prefix,uint8_t fault,int count)
+{
+  Fault f;
+  f.prefix = prefix;
+  f.fault = fault;
+  f.count = count;
+  _faults.push_back(f);
+}
+/**********************************************************
+Description: answer a random share of all commands by a fault
+Parameters:  rate: 0..1
+             fault: EMU_FAULT_xxx
+Return:
+Others:      the sequence depends only on setSeed()
+**********************************************************/
+void ATEmulator::setFaultRate(double rate,uint8_t fault)
+{
+  _faultRate = rate;
+  _faultKind = fault;
+}
+/**********************************************************
+Description: noise on the line from the module to the board
+Parameters:  corruptRate: share of bytes with one bit flipped
+             lossRate: share of bytes lost
+Return:
+Others:
+**********************************************************/
+void ATEmulator::setLineNoise(double corruptRate,double lossRate)
+{
+  _corruptRate = corruptRate;
+  _lossRate = lossRate;
+}
+
+void ATEmulator::setSeed(uint32_t seed)
+{
+  _random = seed != 0 ? seed : 1;
+}
+/**********************************************************
+Description: forget the logged commands, messages and statistics
+Parameters:
+Return:
+Others:
+**********************************************************/
+void ATEmulator::clearLog(void)
+{
+  _commands.clear();
+  _published.clear();
+  memset(&_stats,0,sizeof(_stats));
+}
+
+//----------------------engine----------------------------
+/**********************************************************
+Description: virtual time in ns
+Parameters:
+Return:
+Others:      ns keep the byte times exact at every baud rate
+**********************************************************/
+uint64_t ATEmulator::now(void)
+{
+  return hostMicros() * 1000;
+}
+/**********************************************************
+Description: run the module up to a point in time
+Parameters:  until: ns
+Return:
+Others:      Bytes from the board and timed actions are handled in
+             the order of their time, then the bytes that reached
+             the board are moved into its UART buffer
+**********************************************************/
+void ATEmulator::update(uint64_t until)
+{
+  for(;;)
+  {
+    uint64_t tm = _toModule.empty() ? EMU_NEVER : _toModule.front().first;
+    uint64_t te = _events.empty() ? EMU_NEVER : _events.begin()->first;
+    if(tm <= te && tm <= until)
+    {
+      uint8_t c = _toModule.front().second;
+      _toModule.pop_front();
+      moduleByte(c,tm);
+    }
+    else if(te < tm && te <= until)
+    {
+      std::function<void()> action = _events.begin()->second;
+      _events.erase(_events.begin());
+      action();
+    }
+    else break;
+  }
+  while(!_toHost.empty() && _toHost.front().first <= until)
+  {
+    uint8_t c = _toHost.front().second;
+    _toHost.pop_front();
+    if(_lossRate > 0 && random01() < _lossRate)
+    {
+      _stats.lost++;
+      continue;
+    }
+    if(_corruptRate > 0 && random01() < _corruptRate)
+    {
+      c ^= 1 << (int)(random01() * 8);
+      _stats.corrupted++;
+    }
+    if(_rxBufferSize > 0 && (int)_uart.size() >= _rxBufferSize)
+    {
+      _stats.rxOverruns++;
+      continue;
+    }
+    _uart.push_back(c);
+  }
+}
+/**********************************************************
+Description: one byte reached the module
+Parameters:  c: byte
+             t: ns
+Return:
+Others:
+**********************************************************/
+void ATEmulator::moduleByte(uint8_t c,uint64_t t)
+{
+  if(_payloadRemain > 0)
+  {
+    _payload += (char)c;
+    if(--_payloadRemain == 0) payloadDone(t);
+    return;
+  }
+  if(c == '\n')
+  {
+    std::string line = _line;
+    _line.clear();
+    if(!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+    if(!line.empty()) command(line,t);
+    return;
+  }
+  if(_line.size() < EMU_LINE_MAX_LENGTH) _line += (char)c;
+}
+/**********************************************************
+Description: a command line is complete
+Parameters:  line: without CR LF
+             t: ns
+Return:
+Others:      A module still working on the previous command
+             answers "busy p..." and drops the line
+**********************************************************/
+void ATEmulator::command(const std::string &line,uint64_t t)
+{
+  _stats.commands++;
+  _commands.push_back(line);
+  trace(t,'>',line);
+  if(_echo) emit(t,line + "\r\n");
+  if(t < _busyUntil)
+  {
+    _stats.busy++;
+    emit(t,"busy p...\r\n");
+    return;
+  }
+  uint64_t tr = t + (uint64_t)latencyOf(line) * 1000;
+  _busyUntil = tr;
+  _payloadFault = EMU_FAULT_NONE;
+  bool payload = line.compare(0,11,"AT+CIPSEND=") == 0 || line.compare(0,14,"AT+MQTTPUBRAW=") == 0;
+  uint8_t fault = takeFault(line);
+  if(fault != EMU_FAULT_NONE)
+  {
+    _stats.faults++;
+    switch(fault)
+    {
+      case EMU_FAULT_ERROR:
+        emit(tr,EMU_ERROR);
+        return;
+      case EMU_FAULT_SILENT:
+        _busyUntil = t;
+        return;
+      case EMU_FAULT_BUSY:
+        _stats.busy++;
+        _busyUntil = t;
+        emit(t,"busy p...\r\n");
+        return;
+      case EMU_FAULT_FAIL:
+      case EMU_FAULT_CLOSE:
+        if(!payload)
+        {
+          emit(tr,fault == EMU_FAULT_FAIL ? "\r\nFAIL\r\n" : EMU_ERROR);
+          if(fault == EMU_FAULT_CLOSE) at(tr,[this,tr]() { dropLink(tr); });
+          return;
+        }
+        _payloadFault = fault;   // the payload is taken, the send fails
+        break;
+    }
+  }
+  _replyAt = tr;
+  _inCommand = true;
+  bool handled = false;
+  for(size_t i = 0; i < _handlers.size() && !handled; i++)
+  {
+    if(line.compare(0,_handlers[i].first.size(),_handlers[i].first) == 0)
+      handled = _handlers[i].second(*this,line);
+  }
+  if(!handled) firmware(line,t);
+  _inCommand = false;
+}
+/**********************************************************
+Description: built-in answers of the ESP-AT firmware
+Parameters:  line: command line
+             t: ns, end of the command line
+Return:
+Others:      single connection mode (AT+CIPMUX=0), like the driver
+**********************************************************/
+void ATEmulator::firmware(const std::string &line,uint64_t t)
+{
+  uint64_t tr = _replyAt;
+  size_t end = line.find_first_of("=?");
+  std::string name = line.substr(0,end);
+  bool query = end != std::string::npos && line[end] == '?';
+  std::vector<std::string> a;
+  if(end != std::string::npos && line[end] == '=') splitArgs(line.substr(end + 1),a);
+  while(a.size() < 5) a.push_back("");
+
+  if(name == "AT+MQTTUSERCFG" || name == "AT+MQTTCLIENTID" || name == "AT+MQTTUSERNAME"
+     || name == "AT+MQTTPASSWORD")
+  {
+    emit(tr,_mqtt ? EMU_ERROR : EMU_OK);   // refused while connected, AT+MQTTCLEAN first
+  }
+  else if(name == "AT" || name == "AT+CWMODE" || name == "AT+CIPMUX" || name == "AT+CIPMODE"
+     || name == "AT+CIPDINFO" || name == "AT+CWAUTOCONN" || name == "AT+SYSSTORE")
+  {
+    if(query && name == "AT+CWMODE") emit(tr,"+CWMODE:1\r\n");
+    if(query && name == "AT+CIPMUX") emit(tr,"+CIPMUX:0\r\n");
+    emit(tr,EMU_OK);
+  }
+  else if(name == "ATE0" || name == "ATE1")
+  {
+    _echo = name == "ATE1";
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+RST")
+  {
+    emit(tr,EMU_OK);
+    restart(1000);
+  }
+  else if((name == "AT+UART_CUR" || name == "AT+UART_DEF") && !query)
+  {
+    unsigned long baud = strtoul(a[0].c_str(),NULL,10);
+    if(baud < 80 || baud > 5000000)
+    {
+      emit(tr,EMU_ERROR);
+      return;
+    }
+    emit(tr,EMU_OK);
+    at(tr,[this,baud]() { if(!_fixedBaud) _baud = baud; });   // after OK went out at the old rate
+  }
+  else if(name == "AT+GMR")
+  {
+    emit(tr,"AT version:2.2.0.0(b097cdf - ESP8266 - Jun 17 2021 12:57:54)\r\n"
+            "SDK version:v3.4-22-g967752e2\r\n"
+            "compile time(6800286):Aug  4 2021 17:20:05\r\n"
+            "Bin version:2.2.0(WROOM-02)\r\n");
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+CWJAP" && query)
+  {
+    if(_wifi)
+      emit(tr,"+CWJAP:\"" + _joinedSsid + "\",\"9a:9f:8b:24:c1:31\",6,-45,0,1,3,0,0\r\n");
+    else
+      emit(tr,"No AP\r\n");
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+CWJAP")
+  {
+    if(_wifi) at(t,[this,t]() { dropWifi(t); });
+    bool known = _apSsid.empty() || a[0] == _apSsid;
+    if(!_apUp || !known || (!_apSsid.empty() && a[1] != _apPass))
+    {
+      emit(tr,std::string("+CWJAP:") + (_apUp && known ? "2" : "3") + "\r\n\r\nFAIL\r\n");
+      return;
+    }
+    std::string ssid = a[0];
+    uint64_t connected = t + (tr - t) * 6 / 10;
+    uint64_t gotIp = t + (tr - t) * 9 / 10;
+    emit(connected,"WIFI CONNECTED\r\n");
+    at(gotIp,[this,gotIp,ssid]()
+    {
+      _wifi = true;
+      _linkUsed = false;
+      _joinedSsid = ssid;
+      emitNow(gotIp,"WIFI GOT IP\r\n");
+    });
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+CWQAP")
+  {
+    at(tr,[this,tr]() { dropWifi(tr); });
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+CWLAP")
+  {
+    std::string ssid = _apSsid.empty() ? (_joinedSsid.empty() ? "NCNUIOT" : _joinedSsid) : _apSsid;
+    if(_apUp) emit(tr,"+CWLAP:(3,\"" + ssid + "\",-45,\"9a:9f:8b:24:c1:31\",6,-1,-1,4,4,7,0)\r\n");
+    emit(tr,"+CWLAP:(4,\"Office-5F\",-71,\"0c:9d:92:10:4e:08\",1,-1,-1,4,4,7,0)\r\n"
+            "+CWLAP:(0,\"Guest\",-83,\"0c:9d:92:10:4e:0c\",11,-1,-1,0,0,7,0)\r\n");
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+CIPSTATUS")
+  {
+    int status = !_wifi ? 5 : _link ? 3 : _linkUsed ? 4 : 2;
+    std::string text = "STATUS:" + std::to_string(status) + "\r\n";
+    if(_link) text += "+CIPSTATUS:0,\"TCP\",\"" + _linkHost + "\"," + std::to_string(_linkPort) + ",50000,0\r\n";
+    emit(tr,text);
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+CIPSTA" && query)
+  {
+    const char *ip = _wifi ? "192.168.1.123" : "0.0.0.0";
+    const char *gw = _wifi ? "192.168.1.1" : "0.0.0.0";
+    const char *mask = _wifi ? "255.255.255.0" : "0.0.0.0";
+    emit(tr,std::string("+CIPSTA:ip:\"") + ip + "\"\r\n+CIPSTA:gateway:\"" + gw
+            + "\"\r\n+CIPSTA:netmask:\"" + mask + "\"\r\n");
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+CIPSTAMAC" && query)
+  {
+    emit(tr,"+CIPSTAMAC:\"" + _mac + "\"\r\n");
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+CIPSTART")
+  {
+    if(_link)
+    {
+      emit(tr,"ALREADY CONNECTED\r\n\r\nERROR\r\n");
+    }
+    else if(!_wifi || !_reachable)
+    {
+      emit(tr,"\r\nERROR\r\nCLOSED\r\n");
+    }
+    else
+    {
+      _link = true;
+      _linkUsed = true;
+      _linkHost = a[1];
+      _linkPort = atoi(a[2].c_str());
+      emit(tr,"CONNECT\r\n");
+      emit(tr,EMU_OK);
+    }
+  }
+  else if(name == "AT+CIPSEND")
+  {
+    long length = atol(a[0].c_str());
+    if(!_link)
+    {
+      emit(tr,"link is not valid\r\n\r\nERROR\r\n");
+    }
+    else if(length <= 0 || length > EMU_PAYLOAD_MAX_LENGTH)
+    {
+      emit(tr,EMU_ERROR);
+    }
+    else
+    {
+      _payloadKind = EMU_PAYLOAD_TCP;
+      _payloadRemain = length;
+      _payload.clear();
+      emit(tr,"\r\nOK\r\n\r\n>");
+    }
+  }
+  else if(name == "AT+CIPCLOSE")
+  {
+    if(_link)
+    {
+      _link = false;
+      emit(tr,"CLOSED\r\n");
+      emit(tr,EMU_OK);
+    }
+    else emit(tr,EMU_ERROR);
+  }
+  else if(name == "AT+MQTTCONN" && query)
+  {
+    if(_mqtt) emit(tr,"+MQTTCONN:0,4,1,\"" + _mqttHost + "\",\"1883\",\"\",1\r\n");
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+MQTTCONN")
+  {
+    if(_mqtt || !_wifi || !_reachable)
+    {
+      emit(tr,EMU_ERROR);
+      return;
+    }
+    _mqtt = true;
+    _mqttHost = a[1];
+    emit(tr,"+MQTTCONNECTED:0,1,\"" + a[1] + "\",\"" + a[2] + "\",\"\",1\r\n");
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+MQTTSUB")
+  {
+    if(!_mqtt)
+    {
+      emit(tr,EMU_ERROR);
+      return;
+    }
+    if(subscribed(a[1]) && std::find(_subscriptions.begin(),_subscriptions.end(),a[1]) != _subscriptions.end())
+      emit(tr,"ALREADY SUBSCRIBE\r\n");
+    else
+      _subscriptions.push_back(a[1]);
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+MQTTUNSUB")
+  {
+    std::vector<std::string>::iterator i = std::find(_subscriptions.begin(),_subscriptions.end(),a[1]);
+    if(i == _subscriptions.end())
+    {
+      emit(tr,"NO UNSUBSCRIBE\r\n");
+    }
+    else _subscriptions.erase(i);
+    emit(tr,EMU_OK);
+  }
+  else if(name == "AT+MQTTPUB")
+  {
+    if(!_mqtt)
+    {
+      emit(tr,EMU_ERROR);
+      return;
+    }
+    EmuMessage m;
+    m.topic = a[1];
+    m.data = a[2];
+    m.time = tr / 1000;
+    _published.push_back(m);
+    emit(tr,EMU_OK);
+    deliver(tr,m.topic,m.data);
+  }
+  else if(name == "AT+MQTTPUBRAW")
+  {
+    long length = atol(a[2].c_str());
+    if(!_mqtt || length <= 0 || length > EMU_PAYLOAD_MAX_LENGTH)
+    {
+      emit(tr,EMU_ERROR);
+      return;
+    }
+    _payloadKind = EMU_PAYLOAD_MQTT;
+    _payloadRemain = length;
+    _payloadTopic = a[1];
+    _payload.clear();
+    emit(tr,"\r\nOK\r\n\r\n>");
+  }
+  else if(name == "AT+MQTTCLEAN")
+  {
+    _mqtt = false;
+    _subscriptions.clear();
+    emit(tr,EMU_OK);
+  }
+  else
+  {
+    emit(tr,EMU_ERROR);
+  }
+}
+/**********************************************************
+Description: the payload announced by AT+CIPSEND / AT+MQTTPUBRAW
+             has arrived
+Parameters:  t: ns, arrival of the last byte
+Return:
+Others:      the server answer of a TCP payload follows after one
+             round trip and the server time
+**********************************************************/
+void ATEmulator::payloadDone(uint64_t t)
+{
+  uint64_t tr = t + (uint64_t)_commandLatency * 1000;
+  if(_busyUntil < tr) _busyUntil = tr;
+  std::string data = _payload;
+  _payload.clear();
+  trace(t,'>',"<" + std::to_string(data.size()) + " bytes payload>");
+  if(_payloadKind == EMU_PAYLOAD_MQTT)
+  {
+    if(_payloadFault == EMU_FAULT_FAIL || !_mqtt)
+    {
+      emit(tr,"+MQTTPUB:FAIL\r\n");
+      return;
+    }
+    EmuMessage m;
+    m.topic = _payloadTopic;
+    m.data = data;
+    m.time = tr / 1000;
+    _published.push_back(m);
+    emit(tr,"+MQTTPUB:OK\r\n");
+    deliver(tr,m.topic,m.data);
+    return;
+  }
+  emit(tr,"\r\nRecv " + std::to_string(data.size()) + " bytes\r\n");
+  if(_payloadFault == EMU_FAULT_FAIL || !_link)
+  {
+    emit(tr,"\r\nSEND FAIL\r\n");
+    return;
+  }
+  emit(tr,"\r\nSEND OK\r\n");
+  if(_payloadFault == EMU_FAULT_CLOSE)
+  {
+    uint64_t tc = tr + (uint64_t)_rtt * 1000;
+    at(tc,[this,tc]() { dropLink(tc); });
+    return;
+  }
+  _replyAt = tr + ((uint64_t)_rtt + _serverLatency) * 1000;
+  _inCommand = true;
+  if(_tcpHandler)
+  {
+    _tcpHandler(*this,data);
+  }
+  else if(data.compare(0,4,"GET ") == 0 || data.compare(0,5,"POST ") == 0)
+  {
+    /* one reply per request, pipelined requests are answered in order */
+    const char *reason = _httpStatus == 200 ? "OK" : _httpStatus == 404 ? "Not Found" : "Error";
+    std::string replies;
+    size_t end = 0;
+    while((end = data.find("\r\n\r\n",end)) != std::string::npos)
+    {
+      end += 4;
+      replies += "HTTP/1.1 " + std::to_string(_httpStatus) + " " + reason + "\r\n"
+                 "Content-Type: text/html; charset=UTF-8\r\n"
+                 "Content-Length: " + std::to_string(_httpBody.size()) + "\r\n\r\n" + _httpBody;
+    }
+    sendIpd(replies);
+  }
+  else
+  {
+    sendIpd(data);   // echo server
+  }
+  _inCommand = false;
+}
+/**********************************************************
+Description: fault for a command
+Parameters:  line: command line
+Return:      EMU_FAULT_xxx
+Others:      failNext() entries first, then the random rate
+**********************************************************/
+uint8_t ATEmulator::takeFault(const std::string &line)
+{
+  for(size_t i = 0; i < _faults.size(); i++)
+  {
+    if(line.compare(0,_faults[i].prefix.size(),_faults[i].prefix) != 0) continue;
+    uint8_t fault = _faults[i].fault;
+    if(--_faults[i].count <= 0) _faults.erase(_faults.begin() + i);
+    return fault;
+  }
+  if(_faultRate > 0 && random01() < _faultRate) return _faultKind;
+  return EMU_FAULT_NONE;
+}
+/**********************************************************
+Description: processing time of a command
+Parameters:  line: command line
+Return:      us
+Others:
+**********************************************************/
+unsigned long ATEmulator::latencyOf(const std::string &line)
+{
+  size_t best = 0;
+  long latency = -1;
+  for(size_t i = 0; i < _latency.size(); i++)
+  {
+    const std::string &p = _latency[i].first;
+    if(p.size() >= best && line.compare(0,p.size(),p) == 0)
+    {
+      best = p.size();
+      latency = _latency[i].second;
+    }
+  }
+  if(latency >= 0) return latency;
+  if(line.compare(0,9,"AT+CWJAP=") == 0) return EMU_JOIN_LATENCY;
+  if(line.compare(0,8,"AT+CWLAP") == 0) return EMU_SCAN_LATENCY;
+  if(line.compare(0,12,"AT+CIPSTART=") == 0) return _commandLatency + _rtt;
+  if(line.compare(0,12,"AT+MQTTCONN=") == 0) return _commandLatency + 2 * _rtt;
+  return _commandLatency;
+}
+/**********************************************************
+Description: schedule an action of the module
+Parameters:  t: ns
+             action
+Return:
+Others:      actions of the same time run in the order they were
+             scheduled
+**********************************************************/
+void ATEmulator::at(uint64_t t,std::function<void()> action)
+{
+  _events.insert(std::make_pair(t,action));
+}
+/**********************************************************
+Description: send text to the board at a point in time
+Parameters:  t: ns
+             text
+Return:
+Others:
+**********************************************************/
+void ATEmulator::emit(uint64_t t,const std::string &text)
+{
+  at(t,[this,t,text]() { emitNow(t,text); });
+}
+/**********************************************************
+Description: put text on the line to the board
+Parameters:  t: ns, the line may still be busy with earlier text
+             text
+Return:
+Others:
+**********************************************************/
+void ATEmulator::emitNow(uint64_t t,const std::string &text)
+{
+  uint64_t byteTime = 10000000000ULL / _baud;
+  uint64_t at = _toHostFree > t ? _toHostFree : t;
+  for(size_t i = 0; i < text.size(); i++)
+  {
+    at += byteTime;
+    _toHost.push_back(std::make_pair(at,(uint8_t)text[i]));
+  }
+  _toHostFree = at;
+  _stats.bytesFromModule += text.size();
+  trace(t,'<',text);
+}
+/**********************************************************
+Description: the broker returns a published message to the board
+             if it subscribed the topic
+Parameters:  t: ns, publish time
+             topic, data
+Return:
+Others:
+**********************************************************/
+void ATEmulator::deliver(uint64_t t,const std::string &topic,const std::string &data)
+{
+  uint64_t td = t + (uint64_t)_rtt * 1000;
+  at(td,[this,td,topic,data]()
+  {
+    if(!_mqtt || !subscribed(topic)) return;
+    emitNow(td,"+MQTTSUBRECV:0,\"" + topic + "\"," + std::to_string(data.size()) + "," + data + "\r\n");
+  });
+}
+
+void ATEmulator::dropLink(uint64_t t)
+{
+  if(!_link) return;
+  _link = false;
+  emitNow(t,"CLOSED\r\n");
+}
+
+void ATEmulator::dropWifi(uint64_t t)
+{
+  dropLink(t);
+  if(_mqtt)
+  {
+    _mqtt = false;
+    emitNow(t,"+MQTTDISCONNECTED:0\r\n");
+  }
+  if(_wifi)
+  {
+    _wifi = false;
+    emitNow(t,"WIFI DISCONNECT\r\n");
+  }
+}
+
+bool ATEmulator::subscribed(const std::string &topic)
+{
+  for(size_t i = 0; i < _subscriptions.size(); i++)
+  {
+    if(topicMatch(_subscriptions[i],topic)) return true;
+  }
+  return false;
+}
+
+double ATEmulator::random01(void)
+{
+  _random = _random * 1103515245UL + 12345UL;
+  return ((_random >> 8) & 0xFFFFFF) / 16777216.0;
+}
+/**********************************************************
+Description: print one command or answer
+Parameters:  t: ns
+             direction: '>' to the module, '<' to the board
+             text
+Return:
+Others:      control characters are shown escaped
+**********************************************************/
+void ATEmulator::trace(uint64_t t,char direction,const std::string &text)
+{
+  if(_trace == NULL) return;
+  fprintf(_trace,"[%10.3f ms] %c ",t / 1000000.0,direction);
+  for(size_t i = 0; i < text.size(); i++)
+  {
+    uint8_t c = text[i];
+    if(c == '\r') fputs("\\r",_trace);
+    else if(c == '\n') fputs("\\n",_trace);
+    else if(c < 0x20 || c >= 0x7F) fprintf(_trace,"\\x%02X",c);
+    else fputc(c,_trace);
+  }
+  fputc('\n',_trace);
+}
+/**********************************************************
+Description: split the parameters of a command line
+Parameters:  text: part after '='
+             args: receives the parameters, quotes removed
+Return:
+Others:      '\' escapes ',', '"' and '\' inside quoted strings
+             like AT+MQTTPUB data
+**********************************************************/
+void ATEmulator::splitArgs(const std::string &text,std::vector<std::string> &args)
+{
+  std::string arg;
+  bool quoted = false;
+  for(size_t i = 0; i < text.size(); i++)
+  {
+    char c = text[i];
+    if(quoted && c == '\\' && i + 1 < text.size())
+    {
+      arg += text[++i];
+    }
+    else if(c == '"')
+    {
+      quoted = !quoted;
+    }
+    else if(c == ',' && !quoted)
+    {
+      args.push_back(arg);
+      arg.clear();
+    }
+    else arg += c;
+  }
+  args.push_back(arg);
+}
+/**********************************************************
+Description: MQTT topic filter with '+' and '#'
+Parameters:  filter, topic
+Return:      true if the topic matches
+Others:
+**********************************************************/
+bool ATEmulator::topicMatch(const std::string &filter,const std::string &topic)
+{
+  size_t f = 0, t = 0;
+  while(f < filter.size())
+  {
+    if(filter[f] == '#') return true;
+    if(filter[f] == '+')
+    {
+      while(t < topic.size() && topic[t] != '/') t++;
+      f++;
+      continue;
+    }
+    if(t >= topic.size() || filter[f] != topic[t]) return false;
+    f++;
+    t++;
+  }
+  return t == topic.size();
+}
@@ -0,0 +1,227 @@
+/*************************************************
+File:             ATEmulator.h
+Description:      Scriptable emulator of the ESP-AT firmware of the
+                  BMC81M001 for the host build
+version:          V1.0.0
+**************************************************/
+#ifndef _AT_EMULATOR_H_
+#define _AT_EMULATOR_H_
+
+#include <Arduino.h>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+//----------------------fault injection---------------------------
+#define EMU_FAULT_NONE    0
+#define EMU_FAULT_ERROR   1        // "ERROR" instead of the answer
+#define EMU_FAULT_FAIL    2        // "FAIL", "SEND FAIL" or "+MQTTPUB:FAIL" after the payload
+#define EMU_FAULT_SILENT  3        // no answer at all, the driver times out
+#define EMU_FAULT_BUSY    4        // "busy p..." and the command is dropped
+#define EMU_FAULT_CLOSE   5        // payload is sent, then the server closes the link
+
+//----------------------default timing (us)---------------------------
+#ifndef EMU_BAUD_RATE
+#define EMU_BAUD_RATE 115200       // used until the driver calls begin()
+#endif
+#ifndef EMU_COMMAND_LATENCY
+#define EMU_COMMAND_LATENCY 1000   // processing time of a simple command
+#endif
+#ifndef EMU_JOIN_LATENCY
+#define EMU_JOIN_LATENCY 2000000   // AT+CWJAP until "OK"
+#endif
+#ifndef EMU_SCAN_LATENCY
+#define EMU_SCAN_LATENCY 1500000   // AT+CWLAP
+#endif
+#ifndef EMU_NETWORK_RTT
+#define EMU_NETWORK_RTT 40000      // round trip to a server
+#endif
+#ifndef EMU_SERVER_LATENCY
+#define EMU_SERVER_LATENCY 10000   // time a server needs to answer a request
+#endif
+#ifndef EMU_RESET_LATENCY
+#define EMU_RESET_LATENCY 500000   // AT+RST until "ready"
+#endif
+#ifndef EMU_IDLE_STEP
+#define EMU_IDLE_STEP 100          // longest clock step of one empty poll
+#endif
+#ifndef EMU_TX_BUFFER_SIZE
+#define EMU_TX_BUFFER_SIZE 64      // write() blocks when this much is unsent
+#endif
+
+class ATEmulator;
+
+/* Called for a command line that starts with the registered prefix.
+   Return true if the handler has answered (see reply()), false to let
+   the built-in firmware answer. */
+typedef std::function<bool(ATEmulator &emu,const std::string &command)> EmuCommandHandler;
+
+/* Called with the data the device sent on its TCP/SSL link. The
+   handler answers with sendIpd() and may closeLink(). */
+typedef std::function<void(ATEmulator &emu,const std::string &data)> EmuTcpHandler;
+
+/* One message published by the device */
+struct EmuMessage
+{
+  std::string topic;
+  std::string data;
+  uint64_t time;                   // us, when the module accepted it
+};
+
+struct EmuStatistics
+{
+  uint32_t commands;               // command lines received
+  uint32_t faults;                 // commands answered by a fault
+  uint32_t busy;                   // "busy p..." answers
+  uint32_t bytesToModule;          // bytes written by the device
+  uint32_t bytesFromModule;        // bytes sent to the device
+  uint32_t rxOverruns;             // bytes lost because the UART buffer was full
+  uint32_t corrupted;              // bytes changed by line noise
+  uint32_t lost;                   // bytes dropped by line noise
+};
+
+/* Plugs into a HardwareSerial (Serial2.attach(&emu)) or a
+   SoftwareSerial (hostAttachSoftwareSerial()) in place of the module.
+   Every byte travels at the baud rate in both directions on the
+   virtual clock, the firmware answers after a configurable latency
+   and the UART buffer of the board can overflow like the real one. */
+class ATEmulator : public HostDevice
+{
+  public:
+      ATEmulator();
+      //----------------------serial side----------------------------
+      void begin(unsigned long baud);
+      int available(void);
+      int read(void);
+      int peek(void);
+      size_t write(uint8_t c);
+      //----------------------configuration----------------------------
+      void setBaudRate(unsigned long baud);
+      void setRxBufferSize(int size);
+      void setTxBufferSize(int size);
+      void setEcho(bool enable);
+      void setIdleStep(unsigned long us);
+      void setCommandLatency(unsigned long us);
+      void setLatency(const char *prefix,unsigned long us);
+      void setNetworkLatency(unsigned long rtt,unsigned long server);
+      void setAccessPoint(const char *ssid,const char *pass);
+      void setAccessPointUp(bool up);
+      void setServerReachable(bool reachable);
+      void setMacAddress(const char *mac);
+      void setIpdChunk(int size);
+      void setTrace(FILE *out);
+      //----------------------scripting----------------------------
+      void on(const char *prefix,EmuCommandHandler handler);
+      void onTcpData(EmuTcpHandler handler);
+      void setHttpReply(int status,const char *body);
+      void reply(const std::string &text,unsigned long delay = 0);
+      void sendIpd(const std::string &data,unsigned long delay = 0);
+      void closeLink(unsigned long delay = 0);
+      void publishToDevice(const char *topic,const std::string &data,unsigned long delay = 0);
+      void disconnectWifi(unsigned long delay = 0);
+      void restart(unsigned long delay = 0);
+      //----------------------fault injection----------------------------
+      void failNext(const char *prefix,uint8_t fault,int count = 1);
+      void setFaultRate(double rate,uint8_t fault = EMU_FAULT_ERROR);
+      void setLineNoise(double corruptRate,double lossRate);
+      void setSeed(uint32_t seed);
+      //----------------------inspection----------------------------
+      const std::vector<std::string> &commands(void) { return _commands; }
+      const std::vector<EmuMessage> &published(void) { return _published; }
+      const EmuStatistics &statistics(void) { return _stats; }
+      void clearLog(void);
+      bool wifiConnected(void) { return _wifi; }
+      bool linkOpen(void) { return _link; }
+      bool mqttConnected(void) { return _mqtt; }
+      unsigned long baudRate(void) { return _baud; }
+  private:
+      struct Fault
+      {
+        std::string prefix;
+        uint8_t fault;
+        int count;
+      };
+      uint64_t now(void);
+      void update(uint64_t until);
+      void moduleByte(uint8_t c,uint64_t t);
+      void command(const std::string &line,uint64_t t);
+      void firmware(const std::string &line,uint64_t t);
+      void payloadDone(uint64_t t);
+      uint8_t takeFault(const std::string &line);
+      unsigned long latencyOf(const std::string &line);
+      void at(uint64_t t,std::function<void()> action);
+      void emit(uint64_t t,const std::string &text);
+      void emitNow(uint64_t t,const std::string &text);
+      void deliver(uint64_t t,const std::string &topic,const std::string &data);
+      void dropLink(uint64_t t);
+      void dropWifi(uint64_t t);
+      bool subscribed(const std::string &topic);
+      double random01(void);
+      void trace(uint64_t t,char direction,const std::string &text);
+      static void splitArgs(const std::string &text,std::vector<std::string> &args);
+      static bool topicMatch(const std::string &filter,const std::string &topic);
+
+      //serial lines, times in ns
+      unsigned long _baud = EMU_BAUD_RATE;
+      bool _fixedBaud = false;
+      std::deque<std::pair<uint64_t,uint8_t> > _toModule;
+      std::deque<std::pair<uint64_t,uint8_t> > _toHost;
+      std::deque<uint8_t> _uart;
+      uint64_t _toModuleFree = 0;
+      uint64_t _toHostFree = 0;
+      int _rxBufferSize = 0;
+      int _txBufferSize = EMU_TX_BUFFER_SIZE;
+      unsigned long _idleStep = EMU_IDLE_STEP;
+      std::multimap<uint64_t,std::function<void()> > _events;
+      //firmware
+      std::string _line;
+      bool _echo = true;
+      uint64_t _busyUntil = 0;
+      uint64_t _replyAt = 0;
+      bool _inCommand = false;
+      long _payloadRemain = 0;
+      uint8_t _payloadKind = 0;
+      uint8_t _payloadFault = 0;
+      std::string _payload;
+      std::string _payloadTopic;
+      unsigned long _commandLatency = EMU_COMMAND_LATENCY;
+      std::vector<std::pair<std::string,unsigned long> > _latency;
+      unsigned long _rtt = EMU_NETWORK_RTT;
+      unsigned long _serverLatency = EMU_SERVER_LATENCY;
+      std::vector<std::pair<std::string,EmuCommandHandler> > _handlers;
+      EmuTcpHandler _tcpHandler;
+      int _httpStatus = 200;
+      std::string _httpBody = "{\"Result\":\"OK\"}";
+      int _ipdChunk = 1460;            // one TCP segment
+      //network state
+      std::string _apSsid;             // empty: any access point is accepted
+      std::string _apPass;
+      std::string _mac = "d8:bf:c0:12:34:56";
+      std::string _joinedSsid;
+      bool _apUp = true;
+      bool _reachable = true;
+      bool _wifi = false;
+      bool _link = false;
+      bool _linkUsed = false;
+      std::string _linkHost;
+      int _linkPort = 0;
+      bool _mqtt = false;
+      std::string _mqttHost;
+      std::vector<std::string> _subscriptions;
+      //faults
+      std::vector<Fault> _faults;
+      double _faultRate = 0;
+      uint8_t _faultKind = EMU_FAULT_ERROR;
+      double _corruptRate = 0;
+      double _lossRate = 0;
+      uint32_t _random = 1;
+      //inspection
+      std::vector<std::string> _commands;
+      std::vector<EmuMessage> _published;
+      EmuStatistics _stats;
+      FILE *_trace = NULL;
+};
+
+#endif
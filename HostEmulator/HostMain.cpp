@@ -0,0 +1,147 @@
+/*************************************************
+File:             HostMain.cpp
+Description:      Runs a sketch on Linux with the ESP-AT emulator in
+                  place of the BMC81M001
+version:          V1.0.0
+**************************************************/
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include <EEPROM.h>
+#include <Wire.h>
+#include <getopt.h>
+#include "ATEmulator.h"
+
+ATEmulator emulator;
+
+static void usage(const char *name)
+{
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  --port N          module on SerialN (default 2)\n"
+    "  --soft RX,TX      module on SoftwareSerial(RX,TX)\n"
+    "  --baud N          fix the line rate (default: rate of begin())\n"
+    "  --run MS          virtual run time (default 60000)\n"
+    "  --latency US      processing time of a command\n"
+    "  --rtt US          network round trip time\n"
+    "  --ap SSID,PASS    only this access point accepts AT+CWJAP\n"
+    "  --fault-rate R    share of commands answered by ERROR\n"
+    "  --noise C,L       share of bytes corrupted, lost on the line\n"
+    "  --rx-buffer N     UART receive buffer of the board\n"
+    "  --drop-wifi-at MS the access point drops the board\n"
+    "  --seed N          seed of the fault and noise generator\n"
+    "  --trace           print the AT traffic to stderr\n"
+    "  --quiet           do not print Serial\n",name);
+}
+/**********************************************************
+Description: split "a,b"
+Parameters:  text, a, b
+Return:      true if there was a comma
+Others:
+**********************************************************/
+static bool splitPair(const char *text,std::string &a,std::string &b)
+{
+  const char *comma = strchr(text,',');
+  if(comma == NULL) return false;
+  a.assign(text,comma - text);
+  b = comma + 1;
+  return true;
+}
+
+int main(int argc,char *argv[])
+{
+  static const struct option options[] =
+  {
+    {"port",required_argument,NULL,'p'},
+    {"soft",required_argument,NULL,'s'},
+    {"baud",required_argument,NULL,'b'},
+    {"run",required_argument,NULL,'r'},
+    {"latency",required_argument,NULL,'l'},
+    {"rtt",required_argument,NULL,'t'},
+    {"ap",required_argument,NULL,'a'},
+    {"fault-rate",required_argument,NULL,'f'},
+    {"noise",required_argument,NULL,'n'},
+    {"rx-buffer",required_argument,NULL,'x'},
+    {"drop-wifi-at",required_argument,NULL,'d'},
+    {"seed",required_argument,NULL,'e'},
+    {"trace",no_argument,NULL,'T'},
+    {"quiet",no_argument,NULL,'q'},
+    {"help",no_argument,NULL,'h'},
+    {NULL,0,NULL,0}
+  };
+  int port = 2;
+  int softRx = -1, softTx = -1;
+  unsigned long runMs = 60000;
+  long dropWifiAt = -1;
+  std::string a, b;
+  int c;
+  while((c = getopt_long(argc,argv,"",options,NULL)) != -1)
+  {
+    switch(c)
+    {
+      case 'p': port = atoi(optarg); break;
+      case 's':
+        if(!splitPair(optarg,a,b)) { usage(argv[0]); return 2; }
+        softRx = atoi(a.c_str());
+        softTx = atoi(b.c_str());
+        break;
+      case 'b': emulator.setBaudRate(strtoul(optarg,NULL,10)); break;
+      case 'r': runMs = strtoul(optarg,NULL,10); break;
+      case 'l': emulator.setCommandLatency(strtoul(optarg,NULL,10)); break;
+      case 't': emulator.setNetworkLatency(strtoul(optarg,NULL,10),EMU_SERVER_LATENCY); break;
+      case 'a':
+        if(!splitPair(optarg,a,b)) { usage(argv[0]); return 2; }
+        emulator.setAccessPoint(a.c_str(),b.c_str());
+        break;
+      case 'f': emulator.setFaultRate(atof(optarg)); break;
+      case 'n':
+        if(!splitPair(optarg,a,b)) { usage(argv[0]); return 2; }
+        emulator.setLineNoise(atof(a.c_str()),atof(b.c_str()));
+        break;
+      case 'x': emulator.setRxBufferSize(atoi(optarg)); break;
+      case 'd': dropWifiAt = atol(optarg); break;
+      case 'e': emulator.setSeed(strtoul(optarg,NULL,10)); break;
+      case 'T': emulator.setTrace(stderr); break;
+      case 'q': hostSetConsole(NULL); break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+
+  if(softRx >= 0)
+  {
+    hostAttachSoftwareSerial(softRx,softTx,&emulator);
+  }
+  else
+  {
+    HardwareSerial *ports[] = {&Serial1,&Serial1,&Serial2,&Serial3,&Serial4};
+    if(port < 1 || port > 4) { usage(argv[0]); return 2; }
+    ports[port]->attach(&emulator);
+  }
+  if(dropWifiAt >= 0) emulator.disconnectWifi((unsigned long)dropWifiAt * 1000);
+
+  setup();
+  while(hostMicros() < (uint64_t)runMs * 1000)
+  {
+    uint64_t before = hostMicros();
+    loop();
+    if(hostMicros() == before) hostAdvance(1);   // an empty loop() must not hang the host
+  }
+
+  const EmuStatistics &s = emulator.statistics();
+  fprintf(stderr,
+    "\n---- host run %.3f s (virtual), line %lu baud ----\n"
+    "commands      %u\n"
+    "faults        %u\n"
+    "busy          %u\n"
+    "bytes to      %u\n"
+    "bytes from    %u\n"
+    "rx overruns   %u\n"
+    "corrupted     %u\n"
+    "lost          %u\n"
+    "published     %u\n"
+    "eeprom writes %u\n"
+    "i2c bytes     %u\n",
+    hostMicros() / 1e6,emulator.baudRate(),s.commands,s.faults,s.busy,
+    s.bytesToModule,s.bytesFromModule,s.rxOverruns,s.corrupted,s.lost,
+    (unsigned)emulator.published().size(),EEPROM.writes,Wire.bytesWritten + Wire1.bytesWritten);
+  return 0;
+}
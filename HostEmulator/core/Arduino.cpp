@@ -0,0 +1,313 @@
+/*************************************************
+File:             Arduino.cpp
+Description:      Arduino core shim of the host build: virtual clock,
+                  pins, random numbers and serial ports
+version:          V1.0.0
+**************************************************/
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include <Wire.h>
+#include <EEPROM.h>
+#include <stdarg.h>
+#include <map>
+#include <new>
+
+#define HOST_PIN_COUNT 64
+
+static uint64_t hostClock = 0;              // virtual time in us
+static int hostPinValue[HOST_PIN_COUNT];
+static FILE *hostConsole = stdout;
+static std::map<uint32_t,HostDevice *> hostSoftDevices;
+
+HardwareSerial Serial(true);
+HardwareSerial Serial1;
+HardwareSerial Serial2;
+HardwareSerial Serial3;
+HardwareSerial Serial4;
+TwoWire Wire;
+TwoWire Wire1;
+TwoWire Wire2;
+EEPROMClass EEPROM;
+
+/**********************************************************
+Description: virtual time
+Parameters:
+Return:      us since start, calls of this function cost nothing
+Others:
+**********************************************************/
+uint64_t hostMicros(void)
+{
+  return hostClock;
+}
+/**********************************************************
+Description: move the virtual clock forward
+Parameters:  us: time passed
+Return:
+Others:      the emulated devices see the time when they are
+             accessed next
+**********************************************************/
+void hostAdvance(uint64_t us)
+{
+  hostClock += us;
+}
+
+unsigned long millis(void)
+{
+  hostClock += HOST_CALL_COST_US;
+  return (unsigned long)(uint32_t)(hostClock / 1000);
+}
+
+unsigned long micros(void)
+{
+  hostClock += HOST_CALL_COST_US;
+  return (unsigned long)(uint32_t)hostClock;
+}
+
+void delay(unsigned long ms)
+{
+  hostClock += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  hostClock += us;
+}
+
+void yield(void)
+{
+  hostClock += HOST_CALL_COST_US;
+}
+
+void pinMode(uint8_t pin,uint8_t mode)
+{
+  if(pin < HOST_PIN_COUNT && mode == INPUT_PULLUP) hostPinValue[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin,uint8_t value)
+{
+  if(pin < HOST_PIN_COUNT) hostPinValue[pin] = value;
+}
+
+int digitalRead(uint8_t pin)
+{
+  return pin < HOST_PIN_COUNT && hostPinValue[pin] ? HIGH : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+  return pin < HOST_PIN_COUNT ? hostPinValue[pin] : 0;
+}
+
+void analogWrite(uint8_t pin,int value)
+{
+  if(pin < HOST_PIN_COUNT) hostPinValue[pin] = value;
+}
+
+void hostSetPin(uint8_t pin,int value)
+{
+  if(pin < HOST_PIN_COUNT) hostPinValue[pin] = value;
+}
+
+int hostGetPin(uint8_t pin)
+{
+  return pin < HOST_PIN_COUNT ? hostPinValue[pin] : 0;
+}
+
+void attachInterrupt(int interrupt,void (*isr)(void),int mode) {}
+void detachInterrupt(int interrupt) {}
+void noInterrupts(void) {}
+void interrupts(void) {}
+
+/**********************************************************
+Description: random numbers
+Parameters:
+Return:
+Others:      own generator, so that a seed gives the same sequence
+             on every Linux machine
+**********************************************************/
+static uint32_t hostRandomState = 1;
+
+static uint32_t hostRandom(void)
+{
+  hostRandomState = hostRandomState * 1103515245UL + 12345UL;
+  return (hostRandomState >> 1) & 0x7FFFFFFFUL;
+}
+
+long random(long howbig)
+{
+  return howbig <= 0 ? 0 : (long)(hostRandom() % (uint32_t)howbig);
+}
+
+long random(long howsmall,long howbig)
+{
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+  if(seed != 0) hostRandomState = seed;
+}
+
+void hostSetConsole(FILE *out)
+{
+  hostConsole = out;
+}
+
+//----------------------heap----------------------------
+/* Every new/delete of the sketch and the driver (String included)
+   goes through these, so the heap use of an operation can be measured
+   like mallinfo() on the board. malloc() called directly is not seen.
+   Blocks allocated while muted (the emulated devices) are not counted;
+   each block carries the size it was counted with in a header. */
+#define HOST_HEAP_HEADER 16        // keeps the alignment of malloc()
+
+static size_t hostHeapUsed = 0;
+static size_t hostHeapMax = 0;
+static int hostHeapMuted = 0;
+
+static void *hostAllocate(size_t size)
+{
+  uint8_t *p = (uint8_t *)malloc(size + HOST_HEAP_HEADER);
+  if(p == NULL) throw std::bad_alloc();
+  size_t counted = hostHeapMuted > 0 ? 0 : size;
+  memcpy(p,&counted,sizeof(counted));
+  hostHeapUsed += counted;
+  if(hostHeapUsed > hostHeapMax) hostHeapMax = hostHeapUsed;
+  return p + HOST_HEAP_HEADER;
+}
+
+static void hostRelease(void *ptr)
+{
+  if(ptr == NULL) return;
+  uint8_t *p = (uint8_t *)ptr - HOST_HEAP_HEADER;
+  size_t counted;
+  memcpy(&counted,p,sizeof(counted));
+  hostHeapUsed -= counted;
+  free(p);
+}
+
+void *operator new(size_t size) { return hostAllocate(size); }
+void *operator new[](size_t size) { return hostAllocate(size); }
+void operator delete(void *p) noexcept { hostRelease(p); }
+void operator delete[](void *p) noexcept { hostRelease(p); }
+void operator delete(void *p,size_t size) noexcept { hostRelease(p); }
+void operator delete[](void *p,size_t size) noexcept { hostRelease(p); }
+
+void hostHeapMute(bool mute)
+{
+  hostHeapMuted += mute ? 1 : -1;
+}
+
+size_t hostHeapInUse(void)
+{
+  return hostHeapUsed;
+}
+
+size_t hostHeapPeak(void)
+{
+  return hostHeapMax;
+}
+
+void hostHeapResetPeak(void)
+{
+  hostHeapMax = hostHeapUsed;
+}
+
+//----------------------Print / Stream----------------------------
+size_t Print::write(const uint8_t *buffer,size_t size)
+{
+  size_t n = 0;
+  while(size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::printf(const char *format,...)
+{
+  char text[256];
+  va_list args;
+  va_start(args,format);
+  int n = vsnprintf(text,sizeof(text),format,args);
+  va_end(args);
+  if(n < 0) return 0;
+  return write(text,n < (int)sizeof(text) ? n : sizeof(text) - 1);
+}
+
+int Stream::timedRead(void)
+{
+  unsigned long start = millis();
+  do
+  {
+    int c = read();
+    if(c >= 0) return c;
+  } while(millis() - start < _timeout);
+  return -1;
+}
+
+size_t Stream::readBytes(char *buffer,size_t length)
+{
+  size_t n = 0;
+  while(n < length)
+  {
+    int c = timedRead();
+    if(c < 0) break;
+    buffer[n++] = (char)c;
+  }
+  return n;
+}
+
+String Stream::readString(void)
+{
+  String s;
+  int c;
+  while((c = timedRead()) >= 0) s += (char)c;
+  return s;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+  String s;
+  int c;
+  while((c = timedRead()) >= 0 && c != terminator) s += (char)c;
+  return s;
+}
+
+//----------------------HardwareSerial----------------------------
+void HardwareSerial::begin(unsigned long baud)
+{
+  _baud = baud;
+  if(_device != NULL) _device->begin(baud);
+}
+
+int HardwareSerial::available(void)
+{
+  return _device == NULL ? 0 : _device->available();
+}
+
+int HardwareSerial::read(void)
+{
+  return _device == NULL ? -1 : _device->read();
+}
+
+int HardwareSerial::peek(void)
+{
+  return _device == NULL ? -1 : _device->peek();
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  if(_device != NULL) return _device->write(c);
+  if(_console && hostConsole != NULL) fputc(c,hostConsole);
+  return 1;
+}
+
+//----------------------SoftwareSerial----------------------------
+void hostAttachSoftwareSerial(uint16_t rxPin,uint16_t txPin,HostDevice *device)
+{
+  hostSoftDevices[((uint32_t)rxPin << 16) | txPin] = device;
+}
+
+HostDevice *hostSoftwareSerialDevice(uint16_t rxPin,uint16_t txPin)
+{
+  std::map<uint32_t,HostDevice *>::iterator i = hostSoftDevices.find(((uint32_t)rxPin << 16) | txPin);
+  return i == hostSoftDevices.end() ? NULL : i->second;
+}
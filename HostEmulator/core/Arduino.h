@@ -0,0 +1,182 @@
+/*************************************************
+File:             Arduino.h
+Description:      Arduino core shim so that the sketches and the
+                  BMC81M001 driver build and run on Linux
+version:          V1.0.0
+**************************************************/
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <algorithm>
+#include "WString.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+#ifndef TRUE
+#define TRUE  1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define LED_BUILTIN 13
+
+#define constrain(x,low,high) ((x)<(low)?(low):((x)>(high)?(high):(x)))
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value,bit) (((value) >> (bit)) & 0x01)
+using std::min;
+using std::max;
+
+#define PROGMEM
+#define F(text) (text)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+
+//----------------------time----------------------------
+/* The host runs on a virtual clock. delay() moves it forward at once,
+   every call of millis()/micros() costs HOST_CALL_COST_US and an idle
+   poll of an emulated serial port jumps to the next byte, so a sketch
+   that waits two minutes in delay() finishes in milliseconds and the
+   measured times do not depend on the speed of the Linux machine. */
+#ifndef HOST_CALL_COST_US
+#define HOST_CALL_COST_US 1
+#endif
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+//----------------------pins----------------------------
+void pinMode(uint8_t pin,uint8_t mode);
+void digitalWrite(uint8_t pin,uint8_t value);
+int  digitalRead(uint8_t pin);
+int  analogRead(uint8_t pin);
+void analogWrite(uint8_t pin,int value);
+inline int digitalPinToInterrupt(int pin) { return pin; }
+void attachInterrupt(int interrupt,void (*isr)(void),int mode);
+void detachInterrupt(int interrupt);
+void noInterrupts(void);
+void interrupts(void);
+
+//----------------------random----------------------------
+long random(long howbig);
+long random(long howsmall,long howbig);
+void randomSeed(unsigned long seed);
+
+//----------------------host control----------------------------
+uint64_t hostMicros(void);                  // virtual time without call cost
+void hostAdvance(uint64_t us);              // move the virtual clock forward
+void hostSetPin(uint8_t pin,int value);     // level returned by digitalRead()/analogRead()
+int  hostGetPin(uint8_t pin);               // level written by digitalWrite()
+void hostSetConsole(FILE *out);             // where Serial prints, NULL to mute
+size_t hostHeapInUse(void);                 // bytes allocated by new (String, std::string, ...)
+size_t hostHeapPeak(void);                  // largest hostHeapInUse() since the last reset
+void hostHeapResetPeak(void);
+void hostHeapMute(bool mute);               // true: allocations of the host side are not counted
+
+//----------------------serial----------------------------
+class Print
+{
+  public:
+      virtual ~Print() {}
+      virtual size_t write(uint8_t c) = 0;
+      virtual size_t write(const uint8_t *buffer,size_t size);
+      size_t write(const char *str) { return str == NULL ? 0 : write((const uint8_t *)str,strlen(str)); }
+      size_t write(const char *buffer,size_t size) { return write((const uint8_t *)buffer,size); }
+      virtual void flush(void) {}
+
+      size_t print(const char *str) { return write(str); }
+      size_t print(const String &s) { return write(s.c_str(),s.length()); }
+      size_t print(char c) { return write((uint8_t)c); }
+      size_t print(unsigned char value,int base = DEC) { return print(String(value,base)); }
+      size_t print(int value,int base = DEC) { return print(String(value,base)); }
+      size_t print(unsigned int value,int base = DEC) { return print(String(value,base)); }
+      size_t print(long value,int base = DEC) { return print(String(value,base)); }
+      size_t print(unsigned long value,int base = DEC) { return print(String(value,base)); }
+      size_t print(double value,int digits = 2) { return print(String(value,digits)); }
+      size_t println(void) { return write("\r\n"); }
+      template<typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+      template<typename T> size_t println(T value,int format) { size_t n = print(value,format); return n + println(); }
+      size_t printf(const char *format,...);
+};
+
+class Stream : public Print
+{
+  public:
+      virtual int available(void) = 0;
+      virtual int read(void) = 0;
+      virtual int peek(void) = 0;
+      void setTimeout(unsigned long timeout) { _timeout = timeout; }
+      size_t readBytes(char *buffer,size_t length);
+      String readString(void);
+      String readStringUntil(char terminator);
+  protected:
+      int timedRead(void);
+      unsigned long _timeout = 1000;
+};
+
+/* Device at the other end of a serial port, e.g. the AT firmware
+   emulator. A port without device reads nothing and drops writes. */
+class HostDevice
+{
+  public:
+      virtual ~HostDevice() {}
+      virtual void begin(unsigned long baud) {}
+      virtual int available(void) = 0;
+      virtual int read(void) = 0;
+      virtual int peek(void) = 0;
+      virtual size_t write(uint8_t c) = 0;
+};
+
+class HardwareSerial : public Stream
+{
+  public:
+      HardwareSerial(bool console = false) : _console(console) {}
+      void begin(unsigned long baud);
+      void end(void) {}
+      void attach(HostDevice *device) { _device = device; }
+      HostDevice *device(void) { return _device; }
+      unsigned long baudRate(void) { return _baud; }
+      int available(void);
+      int read(void);
+      int peek(void);
+      size_t write(uint8_t c);
+      using Print::write;
+      operator bool(void) { return true; }
+  private:
+      HostDevice *_device = NULL;
+      bool _console;
+      unsigned long _baud = 0;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+extern HardwareSerial Serial3;
+extern HardwareSerial Serial4;
+
+//----------------------sketch----------------------------
+void setup(void);
+void loop(void);
+
+#endif
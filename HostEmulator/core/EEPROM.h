@@ -0,0 +1,45 @@
+/*************************************************
+File:             EEPROM.h
+Description:      EEPROM for the host build, kept in RAM
+version:          V1.0.0
+**************************************************/
+#ifndef _HOST_EEPROM_H_
+#define _HOST_EEPROM_H_
+
+#include <Arduino.h>
+
+#ifndef HOST_EEPROM_SIZE
+#define HOST_EEPROM_SIZE 4096
+#endif
+
+/* Starts erased (0xFF) like a new part. write() counts the cells
+   written so that wear can be compared between library versions. */
+class EEPROMClass
+{
+  public:
+      EEPROMClass() { memset(_data,0xFF,sizeof(_data)); }
+      uint8_t read(int address) { return valid(address) ? _data[address] : 0xFF; }
+      void write(int address,uint8_t value) { if(valid(address)) { _data[address] = value; writes++; } }
+      void update(int address,uint8_t value) { if(read(address) != value) write(address,value); }
+      uint16_t length(void) { return HOST_EEPROM_SIZE; }
+      template<typename T> T &get(int address,T &value)
+      {
+        uint8_t *p = (uint8_t *)&value;
+        for(size_t i = 0; i < sizeof(T); i++) p[i] = read(address + i);
+        return value;
+      }
+      template<typename T> const T &put(int address,const T &value)
+      {
+        const uint8_t *p = (const uint8_t *)&value;
+        for(size_t i = 0; i < sizeof(T); i++) update(address + i,p[i]);
+        return value;
+      }
+      uint32_t writes = 0;
+  private:
+      bool valid(int address) { return address >= 0 && address < HOST_EEPROM_SIZE; }
+      uint8_t _data[HOST_EEPROM_SIZE];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
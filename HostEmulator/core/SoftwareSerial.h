@@ -0,0 +1,55 @@
+/*************************************************
+File:             SoftwareSerial.h
+Description:      SoftwareSerial for the host build
+version:          V1.0.0
+**************************************************/
+#ifndef _HOST_SOFTWARESERIAL_H_
+#define _HOST_SOFTWARESERIAL_H_
+
+#include <Arduino.h>
+
+/* A software serial port on the rx/tx pins given to
+   hostAttachSoftwareSerial() talks to that device, any other one
+   reads nothing. The device is looked up on every access because the
+   sketches create their ports before main() has attached anything. */
+void hostAttachSoftwareSerial(uint16_t rxPin,uint16_t txPin,HostDevice *device);
+HostDevice *hostSoftwareSerialDevice(uint16_t rxPin,uint16_t txPin);
+
+class SoftwareSerial : public Stream
+{
+  public:
+      SoftwareSerial(uint16_t rxPin,uint16_t txPin) : _rxPin(rxPin),_txPin(txPin) {}
+      void begin(long baud)
+      {
+        HostDevice *d = hostSoftwareSerialDevice(_rxPin,_txPin);
+        if(d != NULL) d->begin(baud);
+      }
+      void end(void) {}
+      bool listen(void) { return true; }
+      int available(void)
+      {
+        HostDevice *d = hostSoftwareSerialDevice(_rxPin,_txPin);
+        return d == NULL ? 0 : d->available();
+      }
+      int read(void)
+      {
+        HostDevice *d = hostSoftwareSerialDevice(_rxPin,_txPin);
+        return d == NULL ? -1 : d->read();
+      }
+      int peek(void)
+      {
+        HostDevice *d = hostSoftwareSerialDevice(_rxPin,_txPin);
+        return d == NULL ? -1 : d->peek();
+      }
+      size_t write(uint8_t c)
+      {
+        HostDevice *d = hostSoftwareSerialDevice(_rxPin,_txPin);
+        return d == NULL ? 1 : d->write(c);
+      }
+      using Print::write;
+  private:
+      uint16_t _rxPin;
+      uint16_t _txPin;
+};
+
+#endif
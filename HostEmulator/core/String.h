@@ -0,0 +1,6 @@
+/*************************************************
+File:             String.h
+Description:      The sketches include <String.h>, the class itself
+                  is in WString.h
+**************************************************/
+#include "WString.h"
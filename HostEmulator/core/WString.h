@@ -0,0 +1,157 @@
+/*************************************************
+File:             WString.h
+Description:      Arduino String class for the host build
+version:          V1.0.0
+**************************************************/
+#ifndef _HOST_WSTRING_H_
+#define _HOST_WSTRING_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+/* Same interface as the Arduino core String, the text is kept in a
+   std::string so that allocations go through operator new and are
+   seen by the heap counters of the host core. */
+class String
+{
+  public:
+      String(const char *cstr = "") { if(cstr != NULL) _s = cstr; }
+      String(const char *cstr,unsigned int length) : _s(cstr,length) {}
+      String(const std::string &s) : _s(s) {}
+      explicit String(char c) : _s(1,c) {}
+      explicit String(unsigned char value,unsigned char base = DEC) { setNumber((unsigned long)value,base); }
+      explicit String(int value,unsigned char base = DEC) { setNumber((long)value,base); }
+      explicit String(unsigned int value,unsigned char base = DEC) { setNumber((unsigned long)value,base); }
+      explicit String(long value,unsigned char base = DEC) { setNumber(value,base); }
+      explicit String(unsigned long value,unsigned char base = DEC) { setNumber(value,base); }
+      explicit String(float value,unsigned char decimals = 2) { setFloat(value,decimals); }
+      explicit String(double value,unsigned char decimals = 2) { setFloat(value,decimals); }
+
+      unsigned int length(void) const { return _s.size(); }
+      const char *c_str(void) const { return _s.c_str(); }
+      bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+      bool concat(const String &s) { _s += s._s; return true; }
+      bool concat(const char *cstr) { if(cstr != NULL) _s += cstr; return true; }
+      bool concat(const char *cstr,unsigned int length) { _s.append(cstr,length); return true; }
+      bool concat(char c) { _s += c; return true; }
+      bool concat(int value) { return concat(String(value)); }
+      bool concat(unsigned int value) { return concat(String(value)); }
+      bool concat(long value) { return concat(String(value)); }
+      bool concat(unsigned long value) { return concat(String(value)); }
+      bool concat(float value) { return concat(String(value)); }
+      bool concat(double value) { return concat(String(value)); }
+      template<typename T> String &operator+=(T value) { concat(value); return *this; }
+
+      friend String operator+(const String &a,const String &b) { String r(a); r.concat(b); return r; }
+      friend String operator+(const String &a,const char *b) { String r(a); r.concat(b); return r; }
+      friend String operator+(const char *a,const String &b) { String r(a); r.concat(b); return r; }
+      friend String operator+(const String &a,char b) { String r(a); r.concat(b); return r; }
+      friend String operator+(const String &a,int b) { String r(a); r.concat(b); return r; }
+      friend String operator+(const String &a,unsigned int b) { String r(a); r.concat(b); return r; }
+      friend String operator+(const String &a,long b) { String r(a); r.concat(b); return r; }
+      friend String operator+(const String &a,unsigned long b) { String r(a); r.concat(b); return r; }
+      friend String operator+(const String &a,float b) { String r(a); r.concat(b); return r; }
+      friend String operator+(const String &a,double b) { String r(a); r.concat(b); return r; }
+
+      bool equals(const String &s) const { return _s == s._s; }
+      bool equals(const char *cstr) const { return _s == (cstr != NULL ? cstr : ""); }
+      bool equalsIgnoreCase(const String &s) const { return strcasecmp(_s.c_str(),s._s.c_str()) == 0; }
+      int compareTo(const String &s) const { return _s.compare(s._s); }
+      bool operator==(const String &s) const { return equals(s); }
+      bool operator==(const char *cstr) const { return equals(cstr); }
+      bool operator!=(const String &s) const { return !equals(s); }
+      bool operator!=(const char *cstr) const { return !equals(cstr); }
+      bool operator<(const String &s) const { return _s < s._s; }
+      bool startsWith(const String &s) const { return _s.compare(0,s._s.size(),s._s) == 0; }
+      bool endsWith(const String &s) const
+      {
+        return _s.size() >= s._s.size() && _s.compare(_s.size() - s._s.size(),s._s.size(),s._s) == 0;
+      }
+
+      char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+      void setCharAt(unsigned int index,char c) { if(index < _s.size()) _s[index] = c; }
+      char operator[](unsigned int index) const { return charAt(index); }
+      char &operator[](unsigned int index) { static char dummy; return index < _s.size() ? _s[index] : (dummy = 0); }
+      void getBytes(unsigned char *buf,unsigned int size,unsigned int index = 0) const { toCharArray((char *)buf,size,index); }
+      void toCharArray(char *buf,unsigned int size,unsigned int index = 0) const
+      {
+        if(size == 0) return;
+        unsigned int n = index < _s.size() ? _s.size() - index : 0;
+        if(n > size - 1) n = size - 1;
+        if(n > 0) memcpy(buf,_s.data() + index,n);
+        buf[n] = '\0';
+      }
+
+      int indexOf(char c,unsigned int from = 0) const { return position(_s.find(c,from)); }
+      int indexOf(const String &s,unsigned int from = 0) const { return position(_s.find(s._s,from)); }
+      int lastIndexOf(char c) const { return position(_s.rfind(c)); }
+      int lastIndexOf(char c,unsigned int from) const { return position(_s.rfind(c,from)); }
+      int lastIndexOf(const String &s) const { return position(_s.rfind(s._s)); }
+      String substring(unsigned int from) const { return substring(from,_s.size()); }
+      String substring(unsigned int from,unsigned int to) const
+      {
+        if(from > to) { unsigned int t = from; from = to; to = t; }
+        if(from >= _s.size()) return String();
+        if(to > _s.size()) to = _s.size();
+        return String(_s.substr(from,to - from));
+      }
+
+      void replace(const String &find,const String &with)
+      {
+        if(find._s.empty()) return;
+        for(size_t p = 0; (p = _s.find(find._s,p)) != std::string::npos; p += with._s.size())
+          _s.replace(p,find._s.size(),with._s);
+      }
+      void remove(unsigned int index) { if(index < _s.size()) _s.erase(index); }
+      void remove(unsigned int index,unsigned int count) { if(index < _s.size()) _s.erase(index,count); }
+      void toLowerCase(void) { for(size_t i = 0; i < _s.size(); i++) _s[i] = tolower((unsigned char)_s[i]); }
+      void toUpperCase(void) { for(size_t i = 0; i < _s.size(); i++) _s[i] = toupper((unsigned char)_s[i]); }
+      void trim(void)
+      {
+        size_t a = _s.find_first_not_of(" \t\r\n");
+        if(a == std::string::npos) { _s.clear(); return; }
+        _s = _s.substr(a,_s.find_last_not_of(" \t\r\n") - a + 1);
+      }
+      long toInt(void) const { return atol(_s.c_str()); }
+      float toFloat(void) const { return (float)atof(_s.c_str()); }
+      double toDouble(void) const { return atof(_s.c_str()); }
+
+  private:
+      static int position(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+      void setNumber(long value,unsigned char base)
+      {
+        if(base == DEC) { char t[24]; snprintf(t,sizeof(t),"%ld",value); _s = t; }
+        else setNumber((unsigned long)value,base);
+      }
+      void setNumber(unsigned long value,unsigned char base)
+      {
+        char t[66];
+        int i = sizeof(t) - 1;
+        t[i] = '\0';
+        if(base < 2) base = DEC;
+        do {
+          int d = value % base;
+          t[--i] = d < 10 ? '0' + d : 'a' + d - 10;
+          value /= base;
+        } while(value != 0);
+        _s = &t[i];
+      }
+      void setFloat(double value,unsigned char decimals)
+      {
+        char t[64];
+        snprintf(t,sizeof(t),"%.*f",decimals,value);
+        _s = t;
+      }
+      std::string _s;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*************************************************
+File:             Wire.h
+Description:      I2C bus of the host build. Transfers are counted
+                  and take the time of the bus clock (9 bits per
+                  byte). A module stub can attach() itself to an
+                  address to see what is written to it.
+version:          V1.0.0
+**************************************************/
+#ifndef _HOST_WIRE_H_
+#define _HOST_WIRE_H_
+
+#include <Arduino.h>
+
+#define HOST_WIRE_BUFFER 32       // bytes kept per transfer, like the Arduino Wire buffer
+#define HOST_WIRE_DEVICES 4
+
+/* a stub that wants to see the bytes written to its address */
+class HostI2CDevice
+{
+  public:
+      virtual void i2cWrite(const uint8_t *data,uint8_t length) = 0;
+};
+
+class TwoWire : public Stream
+{
+  public:
+      void begin(void) {}
+      void attach(uint8_t address,HostI2CDevice *device)
+      {
+        if(_devices < HOST_WIRE_DEVICES) { _address[_devices] = address; _device[_devices++] = device; }
+      }
+      void setClock(uint32_t frequency) { _frequency = frequency; }
+      uint32_t clock(void) { return _frequency; }
+      void beginTransmission(uint8_t address) { _target = address; _pending = 0; }
+      uint8_t endTransmission(bool stop = true)
+      {
+        transactions++;
+        hostAdvance((uint64_t)(_pending + 1) * 9 * 1000000 / _frequency);
+        for(uint8_t i = 0; i < _devices; i++)
+          if(_address[i] == _target) _device[i]->i2cWrite(_tx,_pending < HOST_WIRE_BUFFER ? _pending : HOST_WIRE_BUFFER);
+        _pending = 0;
+        return 0;
+      }
+      uint8_t requestFrom(uint8_t address,uint8_t quantity,bool stop = true)
+      {
+        transactions++;
+        hostAdvance((uint64_t)(quantity + 1) * 9 * 1000000 / _frequency);
+        return 0;
+      }
+      size_t write(uint8_t c)
+      {
+        if(_pending < HOST_WIRE_BUFFER) _tx[_pending] = c;
+        bytesWritten++;
+        _pending++;
+        return 1;
+      }
+      size_t write(int n) { return write((uint8_t)n); }
+      size_t write(unsigned int n) { return write((uint8_t)n); }
+      size_t write(long n) { return write((uint8_t)n); }
+      size_t write(unsigned long n) { return write((uint8_t)n); }
+      using Print::write;
+      int available(void) { return 0; }
+      int read(void) { return -1; }
+      int peek(void) { return -1; }
+      uint32_t transactions = 0;
+      uint32_t bytesWritten = 0;
+  private:
+      uint8_t _target = 0;
+      uint32_t _pending = 0;
+      uint8_t _tx[HOST_WIRE_BUFFER];
+      uint8_t _devices = 0;
+      uint8_t _address[HOST_WIRE_DEVICES];
+      HostI2CDevice *_device[HOST_WIRE_DEVICES];
+      uint32_t _frequency = 100000;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+extern TwoWire Wire2;
+
+#endif
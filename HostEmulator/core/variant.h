@@ -0,0 +1,5 @@
+/*************************************************
+File:             variant.h
+Description:      Board variant of the host build (no board specific
+                  definitions are needed)
+**************************************************/
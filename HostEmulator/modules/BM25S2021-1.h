@@ -0,0 +1,47 @@
+/*************************************************
+File:             BM25S2021-1.h
+Description:      BM25S2021-1 temperature/humidity sensor for the host
+                  build. The values are set by the host program.
+version:          V1.0.0
+**************************************************/
+#ifndef _BM25S2021_1_H_
+#define _BM25S2021_1_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+
+class BM25S2021_1
+{
+  public:
+      BM25S2021_1(TwoWire *theWire = &Wire) : _wire(theWire) {}
+      void begin(void) { _wire->begin(); }
+      /* one read is one I2C write plus a 4 byte read like the sensor */
+      float readTemperature(bool isFahrenheit = false)
+      {
+        transfer();
+        return isFahrenheit ? temperature * 1.8 + 32 : temperature;
+      }
+      float readHumidity(void)
+      {
+        transfer();
+        return humidity;
+      }
+      uint16_t getFWVer(void) { transfer(); return 0x0102; }
+      uint16_t getPID(void) { transfer(); return 0x2021; }
+      uint32_t getSN(void) { transfer(); return 0x00012345; }
+      float temperature = 25.0;
+      float humidity = 60.0;
+  private:
+      void transfer(void)
+      {
+        _wire->beginTransmission(0x5C);
+        _wire->write(0x03);
+        _wire->write(0x00);
+        _wire->write(0x04);
+        _wire->endTransmission();
+        _wire->requestFrom(0x5C,8);
+      }
+      TwoWire *_wire;
+};
+
+#endif
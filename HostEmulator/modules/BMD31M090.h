@@ -0,0 +1,206 @@
+/*************************************************
+File:             BMD31M090.h
+Description:      BMD31M090 OLED (SSD1306 128x64) for the host build.
+                  Pixels and lines go to a frame buffer that display()
+                  sends whole over the I2C stub, text is written to the
+                  display at once, like the library. The stub listens
+                  on its address and keeps the display memory in
+                  panel(), so it also sees what other code writes
+                  with page addressing.
+version:          V1.0.0
+**************************************************/
+#ifndef _BMD31M090_H_
+#define _BMD31M090_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define pixelColor_BLACK   0
+#define pixelColor_WHITE   1
+#define pixelColor_INVERSE 2
+
+#define SCROLL_2FRAMES   0x07
+#define SCROLL_3FRAMES   0x04
+#define SCROLL_4FRAMES   0x05
+#define SCROLL_5FRAMES   0x00
+#define SCROLL_25FRAMES  0x06
+#define SCROLL_64FRAMES  0x01
+#define SCROLL_128FRAMES 0x02
+#define SCROLL_256FRAMES 0x03
+#define SCROLLV_NONE   0
+#define SCROLLV_TOP    1
+#define SCROLLV_BOTTOM 2
+
+#ifndef displayROW0               // text rows (pages) as named by the library
+#define displayROW0 0
+#define displayROW1 1
+#define displayROW2 2
+#define displayROW3 3
+#define displayROW4 4
+#define displayROW5 5
+#define displayROW6 6
+#define displayROW7 7
+#endif
+
+#define BMD31M090_I2C_CHUNK 16    // data bytes per I2C transfer
+
+typedef uint8_t u8;
+
+/* width, height of one character; the glyphs are not needed on the host */
+static const unsigned char FontTable_6X8[] = {6,8};
+static const unsigned char FontTable_8X16[] = {8,16};
+static const unsigned char FontTable_16X32[] = {16,32};
+static const unsigned char FontTable_32X64[] = {32,64};
+
+class BMD31M090 : public HostI2CDevice
+{
+  public:
+      BMD31M090(uint8_t width,uint8_t height,TwoWire *theWire = &Wire)
+        : _width(width),_height(height),_wire(theWire)
+      {
+        memset(_buffer,0,sizeof(_buffer));
+        memset(_panel,0,sizeof(_panel));
+      }
+      void begin(uint8_t address = 0x3C)
+      {
+        _address = address;
+        _wire->begin();
+        _wire->attach(address,this);
+        _wire->setClock(400000);
+        command(0xAE);
+        command(0xAF);
+      }
+      void setFont(const unsigned char *font) { _fontWidth = font[0]; _fontHeight = font[1]; }
+      void clearDisplay(void) { memset(_buffer,0,sizeof(_buffer)); }
+      /* sends the frame buffer, page by page */
+      void display(void)
+      {
+        for(uint8_t page = 0; page < _height / 8; page++)
+        {
+          command(0xB0 + page);
+          command(0x00);
+          command(0x10);
+          for(uint8_t x = 0; x < _width; x += BMD31M090_I2C_CHUNK)
+          {
+            _wire->beginTransmission(_address);
+            _wire->write(0x40);
+            for(uint8_t i = 0; i < BMD31M090_I2C_CHUNK; i++) _wire->write(_buffer[page * 128 + x + i]);
+            _wire->endTransmission();
+          }
+        }
+        displays++;
+      }
+      void drawPixel(uint8_t x,uint8_t y,uint8_t color)
+      {
+        if(x >= _width || y >= _height) return;
+        uint8_t &b = _buffer[(y / 8) * 128 + x];
+        uint8_t bit = 1 << (y & 7);
+        if(color == pixelColor_WHITE) b |= bit;
+        else if(color == pixelColor_BLACK) b &= ~bit;
+        else b ^= bit;
+      }
+      uint8_t getPixel(uint8_t x,uint8_t y)
+      {
+        if(x >= _width || y >= _height) return 0;
+        return (_buffer[(y / 8) * 128 + x] >> (y & 7)) & 1;
+      }
+      void drawLine(uint8_t x0,uint8_t y0,uint8_t x1,uint8_t y1,uint8_t color)
+      {
+        int dx = abs(x1 - x0), dy = -abs(y1 - y0);
+        int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+        int err = dx + dy, x = x0, y = y0;
+        for(;;)
+        {
+          drawPixel(x,y,color);
+          if(x == x1 && y == y1) break;
+          int e2 = 2 * err;
+          if(e2 >= dy) { err += dy; x += sx; }
+          if(e2 <= dx) { err += dx; y += sy; }
+        }
+      }
+      void drawFastHLine(uint8_t x,uint8_t y,uint8_t w,uint8_t color) { for(uint8_t i = 0; i < w; i++) drawPixel(x + i,y,color); }
+      void drawFastVLine(uint8_t x,uint8_t y,uint8_t h,uint8_t color) { for(uint8_t i = 0; i < h; i++) drawPixel(x,y + i,color); }
+      void drawBitmap(uint8_t x,uint8_t y,const uint8_t *bitmap,uint8_t w,uint8_t h,uint8_t color)
+      {
+        uint8_t bytesPerRow = (w + 7) / 8;
+        for(uint8_t j = 0; j < h; j++)
+          for(uint8_t i = 0; i < w; i++)
+            if(pgm_read_byte(bitmap + j * bytesPerRow + i / 8) & (0x80 >> (i & 7))) drawPixel(x + i,y + j,color);
+      }
+      /* Text is written straight into the display memory like the
+         library does, the frame buffer is not changed. The glyph is
+         the character code repeated, the host has no font tables,
+         and a space is blank like in the real fonts. */
+      void drawChar(uint8_t x,uint8_t y,uint8_t c)
+      {
+        for(uint8_t page = 0; page < _fontHeight / 8; page++)
+        {
+          command(0xB0 + y + page);
+          command(0x00 | (x & 0x0F));
+          command(0x10 | (x >> 4));
+          _wire->beginTransmission(_address);
+          _wire->write(0x40);
+          for(uint8_t i = 0; i < _fontWidth; i++) _wire->write(c == ' ' ? 0 : c);
+          _wire->endTransmission();
+        }
+      }
+      void drawString(uint8_t x,uint8_t y,uint8_t *str)
+      {
+        for(; *str != 0 && x < _width; str++, x += _fontWidth) drawChar(x,y,*str);
+      }
+      void drawNum(uint8_t x,uint8_t y,uint32_t num,uint8_t len)
+      {
+        char text[24];
+        snprintf(text,sizeof(text),"%*lu",len > 10 ? 10 : len,(unsigned long)num);
+        drawString(x,y,(uint8_t *)text);
+      }
+      void dim(bool dim) { command(0x81); command(dim ? 0x00 : 0xCF); }
+      void invertDisplay(bool invert) { command(invert ? 0xA7 : 0xA6); }
+      void startScrollRight(uint8_t start,uint8_t stop,uint8_t speed,uint8_t vertical = SCROLLV_NONE) { command(0x26); command(0x2F); }
+      void startScrollLeft(uint8_t start,uint8_t stop,uint8_t speed,uint8_t vertical = SCROLLV_NONE) { command(0x27); command(0x2F); }
+      void stopScroll(void) { command(0x2E); }
+      const uint8_t *buffer(void) { return _buffer; }
+      /* display memory, 8 pages of 128 columns */
+      const uint8_t *panel(void) { return _panel; }
+      /* page addressing mode: 0x00 control byte then commands, 0x40 then data */
+      void i2cWrite(const uint8_t *data,uint8_t length)
+      {
+        if(length == 0) return;
+        for(uint8_t i = 1; i < length; i++)
+        {
+          uint8_t c = data[i];
+          if(data[0] == 0x40)
+          {
+            _panel[_page * 128 + _column] = c;
+            _column = (_column + 1) & 127;     // wraps within the page
+          }
+          else if(_skip > 0) _skip--;          // argument of the previous command
+          else if(c == 0x81) _skip = 1;        // contrast
+          else if(c >= 0xB0 && c <= 0xB7) _page = c & 7;
+          else if(c <= 0x0F) _column = (_column & 0xF0) | c;
+          else if(c <= 0x1F) _column = (_column & 0x0F) | ((c & 0x0F) << 4);
+        }
+      }
+      uint32_t displays = 0;
+  private:
+      void command(uint8_t c)
+      {
+        _wire->beginTransmission(_address);
+        _wire->write(0x00);
+        _wire->write(c);
+        _wire->endTransmission();
+      }
+      uint8_t _width;
+      uint8_t _height;
+      TwoWire *_wire;
+      uint8_t _address = 0x3C;
+      uint8_t _fontWidth = 8;
+      uint8_t _fontHeight = 16;
+      uint8_t _buffer[128 * 8];
+      uint8_t _panel[128 * 8];
+      uint8_t _page = 0;
+      uint8_t _column = 0;
+      uint8_t _skip = 0;
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*************************************************
+File:             BMP75M131.h
+Description:      BMP75M131 relay module for the host build. Every
+                  call is one I2C transfer over the stub bus, so a
+                  relay write waits for the bus like on the board.
+                  The relay states are kept for the host program.
+version:          V1.0.0
+**************************************************/
+#ifndef _BMP75M131_H_
+#define _BMP75M131_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define BMP75M131_MAX_RELAY 16
+
+class BMP75M131
+{
+  public:
+      BMP75M131(TwoWire *theWire = &Wire) : _wire(theWire) {}
+      void begin(void) { _wire->begin(); }
+      uint8_t getNumber(void) { read(1); return number; }
+      void setRelaySwitch(uint8_t relayNumber, uint8_t status)
+      {
+        if (relayNumber >= 1 && relayNumber <= number) relay[relayNumber - 1] = status;
+        write(relayNumber, status);
+        switches++;
+        lastSwitchUs = micros();
+      }
+      void setAllRelay(uint8_t status)
+      {
+        for (uint8_t i = 0; i < number; i++) relay[i] = status;
+        write(0xFF, status);
+        switches++;
+        lastSwitchUs = micros();
+      }
+      uint8_t getRelayStatus(uint8_t relayNumber)
+      {
+        read(1);
+        return relayNumber >= 1 && relayNumber <= number ? relay[relayNumber - 1] : 0;
+      }
+      void getAllRelayStatus(uint8_t status[])
+      {
+        read(number);
+        for (uint8_t i = 0; i < number; i++) status[i] = relay[i];
+      }
+      uint8_t number = 8;                       // relays on the module
+      uint8_t relay[BMP75M131_MAX_RELAY] = {0};
+      uint32_t switches = 0;                    // setRelaySwitch() / setAllRelay() calls
+      unsigned long lastSwitchUs = 0;           // micros() when the last switch was sent
+  private:
+      void write(uint8_t reg, uint8_t value)
+      {
+        _wire->beginTransmission(0x16);
+        _wire->write(reg);
+        _wire->write(value);
+        _wire->endTransmission();
+      }
+      void read(uint8_t quantity)
+      {
+        _wire->beginTransmission(0x16);
+        _wire->write(0x00);
+        _wire->endTransmission();
+        _wire->requestFrom(0x16, quantity);
+      }
+      TwoWire *_wire;
+};
+
+#endif
@@ -0,0 +1,272 @@
+/*************************************************
+File:             ATParserTest.cpp
+Description:      Transcript tests of ATParser. Recorded module output
+                  is fed byte by byte and the events are written as a
+                  trace that must match the expected one exactly:
+                    OK ERROR FAIL SEND_OK SEND_FAIL > BUSY READY
+                    LINE(text) CWLAP(text) WIFI_CONNECTED WIFI_GOT_IP
+                    WIFI_DISCONNECT CLOSED(text)
+                    IPD(len)[payload] MQTT(topic,len)[payload]
+                  Every transcript is also fed in two pieces split at
+                  each byte, with a reset-free parser, to show that no
+                  state is lost between reads of the serial port.
+                  The driver cases play a transcript to BMC81M001 and
+                  read the frames back the way a sketch does.
+                  Exit status is the number of failed cases.
+version:          V1.0.0
+**************************************************/
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include "BMC81M001.h"
+
+#define TRACE_MAX 1024
+
+/* serial port that plays a transcript once and ignores what is written */
+class TranscriptDevice : public HostDevice
+{
+  public:
+      void play(const char *bytes) { _bytes = bytes; _next = 0; }
+      int available(void) { return _bytes == NULL ? 0 : strlen(_bytes + _next); }
+      int read(void) { return available() > 0 ? (uint8_t)_bytes[_next++] : -1; }
+      int peek(void) { return available() > 0 ? (uint8_t)_bytes[_next] : -1; }
+      size_t write(uint8_t c) { return 1; }
+  private:
+      const char *_bytes = NULL;
+      int _next = 0;
+};
+
+static TranscriptDevice device;
+static BMC81M001 Wifi(&Serial2);
+
+static int failures = 0;
+static int cases = 0;
+
+/* append text to the trace, truncating silently */
+static void traceAdd(char *trace, const char *text)
+{
+  int used = strlen(trace);
+  int length = strlen(text);
+  if (used + length >= TRACE_MAX) length = TRACE_MAX - 1 - used;
+  memcpy(trace + used, text, length);
+  trace[used + length] = '\0';
+}
+
+/* feed bytes and append their events to the trace */
+static void feedTrace(ATParser &parser, const char *bytes, int length, char *trace)
+{
+  char item[AT_LINE_MAX_LENGTH + 32];
+  for (int i = 0; i < length; i++)
+  {
+    uint8_t evt = parser.feed((uint8_t)bytes[i]);
+    item[0] = '\0';
+    switch (evt)
+    {
+      case AT_EVT_NONE: continue;
+      case AT_EVT_OK: strcpy(item, "OK "); break;
+      case AT_EVT_ERROR: strcpy(item, "ERROR "); break;
+      case AT_EVT_FAIL: strcpy(item, "FAIL "); break;
+      case AT_EVT_SEND_OK: strcpy(item, "SEND_OK "); break;
+      case AT_EVT_SEND_FAIL: strcpy(item, "SEND_FAIL "); break;
+      case AT_EVT_PROMPT: strcpy(item, "> "); break;
+      case AT_EVT_BUSY: strcpy(item, "BUSY "); break;
+      case AT_EVT_READY: strcpy(item, "READY "); break;
+      case AT_EVT_WIFI_CONNECTED: strcpy(item, "WIFI_CONNECTED "); break;
+      case AT_EVT_WIFI_GOT_IP: strcpy(item, "WIFI_GOT_IP "); break;
+      case AT_EVT_WIFI_DISCONNECT: strcpy(item, "WIFI_DISCONNECT "); break;
+      case AT_EVT_LINE: snprintf(item, sizeof(item), "LINE(%s) ", parser.line()); break;
+      case AT_EVT_CWLAP: snprintf(item, sizeof(item), "CWLAP(%s) ", parser.line()); break;
+      case AT_EVT_CLOSED: snprintf(item, sizeof(item), "CLOSED(%s) ", parser.line()); break;
+      case AT_EVT_IPD: snprintf(item, sizeof(item), "IPD(%d)[", parser.frameLength()); break;
+      case AT_EVT_MQTT_RECV:
+        snprintf(item, sizeof(item), "MQTT(%s,%d)[", parser.topic(), parser.frameLength());
+        break;
+      case AT_EVT_DATA: item[0] = parser.data(); item[1] = '\0'; break;
+      case AT_EVT_DATA_END: item[0] = parser.data(); strcpy(item + 1, "] "); break;
+      default: snprintf(item, sizeof(item), "?%d ", evt); break;
+    }
+    /* an empty frame has no payload events */
+    if ((evt == AT_EVT_IPD || evt == AT_EVT_MQTT_RECV) && parser.frameLength() == 0)
+    {
+      strcat(item, "] ");
+    }
+    traceAdd(trace, item);
+  }
+}
+
+/* run one transcript whole and split at every byte */
+static void check(const char *name, const char *transcript, const char *expected)
+{
+  static char trace[TRACE_MAX];
+  int length = strlen(transcript);
+
+  cases++;
+  for (int split = 0; split <= length; split++)
+  {
+    ATParser parser;
+    trace[0] = '\0';
+    feedTrace(parser, transcript, split, trace);
+    feedTrace(parser, transcript + split, length - split, trace);
+    if (strcmp(trace, expected) != 0)
+    {
+      printf("FAIL %s (split at %d)\n  expected: %s\n  got:      %s\n", name, split, expected, trace);
+      failures++;
+      return;
+    }
+  }
+  printf("ok   %s\n", name);
+}
+
+/* a line longer than the buffer is truncated and the next one is intact */
+static void checkLongLine(void)
+{
+  static char transcript[AT_LINE_MAX_LENGTH * 2 + 32];
+  static char expected[AT_LINE_MAX_LENGTH * 2 + 32];
+  int n = 0;
+
+  for (int i = 0; i < AT_LINE_MAX_LENGTH + 40; i++) transcript[n++] = 'a' + i % 26;
+  strcpy(transcript + n, "\r\nOK\r\n");
+  strcpy(expected, "LINE(");
+  for (int i = 0; i < AT_LINE_MAX_LENGTH; i++) expected[5 + i] = 'a' + i % 26;
+  strcpy(expected + 5 + AT_LINE_MAX_LENGTH, ") OK ");
+  check("long line is truncated, next result intact", transcript, expected);
+}
+
+/* a payload longer than the line buffer is passed through whole */
+static void checkLongFrame(void)
+{
+  static char transcript[AT_LINE_MAX_LENGTH * 3 + 64];
+  static char expected[AT_LINE_MAX_LENGTH * 3 + 64];
+  int length = AT_LINE_MAX_LENGTH * 2 + 10;
+  char payload[AT_LINE_MAX_LENGTH * 2 + 11];
+
+  for (int i = 0; i < length; i++) payload[i] = i % 50 == 49 ? '\n' : '0' + i % 10;
+  payload[length] = '\0';
+  snprintf(transcript, sizeof(transcript), "+IPD,%d:%s\r\nCLOSED\r\n", length, payload);
+  snprintf(expected, sizeof(expected), "IPD(%d)[%s] CLOSED(CLOSED) ", length, payload);
+  check("payload longer than the line buffer", transcript, expected);
+}
+
+/* frames that arrive before the sketch reads them are kept in order */
+static void checkFrameQueue(void)
+{
+  const char *name = "two +MQTTSUBRECV before one readIotData()";
+  String payload, topic;
+  int length;
+  bool ok = true;
+
+  cases++;
+  Wifi.resetRxStatistics();
+  device.play("+MQTTSUBRECV:0,\"a\",2,on\r\n+MQTTSUBRECV:0,\"b\",3,off\r\n");
+  Wifi.readIotData(&payload, &length, &topic);
+  ok = ok && topic == "a" && length == 2 && payload == "on";
+  Wifi.readIotData(&payload, &length, &topic);
+  ok = ok && topic == "b" && length == 3 && payload == "off";
+  Wifi.readIotData(&payload, &length, &topic);
+  ok = ok && length == 0 && Wifi.framesDropped() == 0;
+  if (ok) printf("ok   %s\n", name);
+  else { printf("FAIL %s\n", name); failures++; }
+}
+
+/* a full queue keeps the unread frames and counts the new one */
+static void checkFrameDrop(void)
+{
+  const char *name = "frame beyond AT_FRAME_QUEUE_SIZE is dropped and counted";
+  static char transcript[64 * (AT_FRAME_QUEUE_SIZE + 1)];
+  String payload, topic;
+  int length;
+  bool ok = true;
+
+  cases++;
+  Wifi.resetRxStatistics();
+  transcript[0] = '\0';
+  for (int i = 0; i <= AT_FRAME_QUEUE_SIZE; i++)
+  {
+    char frame[64];
+    snprintf(frame, sizeof(frame), "+MQTTSUBRECV:0,\"t\",1,%d\r\n", i % 10);
+    strcat(transcript, frame);
+  }
+  device.play(transcript);
+  for (int i = 0; i < AT_FRAME_QUEUE_SIZE; i++)
+  {
+    char expected[2] = { (char)('0' + i % 10), '\0' };
+    Wifi.readIotData(&payload, &length, &topic);
+    ok = ok && length == 1 && payload == expected;
+  }
+  Wifi.readIotData(&payload, &length, &topic);
+  ok = ok && length == 0 && Wifi.framesDropped() == 1;
+  if (ok) printf("ok   %s\n", name);
+  else { printf("FAIL %s\n", name); failures++; }
+}
+
+int main(void)
+{
+  hostHeapMute(true);
+  hostSetConsole(NULL);
+  Serial2.attach(&device);
+
+  /* plain replies and result codes */
+  check("result codes",
+        "AT\r\n\r\nOK\r\nERROR\r\nFAIL\r\nSEND OK\r\nSEND FAIL\r\n",
+        "LINE(AT) OK ERROR FAIL SEND_OK SEND_FAIL ");
+  check("result code must match the whole line",
+        "+CWLAP:(3,\"OK\",-60,\"aa:bb\",1)\r\nOKAY\r\nNOT OK\r\nOK\r\n",
+        "CWLAP(+CWLAP:(3,\"OK\",-60,\"aa:bb\",1)) LINE(OKAY) LINE(NOT OK) OK ");
+  check("unsolicited module messages",
+        "ready\r\nWIFI CONNECTED\r\nWIFI GOT IP\r\nbusy p...\r\nWIFI DISCONNECT\r\n0,CLOSED\r\n",
+        "READY WIFI_CONNECTED WIFI_GOT_IP BUSY WIFI_DISCONNECT CLOSED(0,CLOSED) ");
+  check("bare LF and CR CR LF line ends",
+        "+CIFSR:STAIP,\"192.168.1.5\"\nOK\r\r\n",
+        "LINE(+CIFSR:STAIP,\"192.168.1.5\") OK ");
+  check("MQTT publish results",
+        "+MQTTPUB:OK\r\n+MQTTPUB:FAIL\r\n",
+        "OK FAIL ");
+
+  /* data prompt, the space after '>' ends up as an information line */
+  check("send with prompt",
+        "AT+CIPSEND=5\r\n\r\nOK\r\n\r\n> \r\nRecv 5 bytes\r\n\r\nSEND OK\r\n",
+        "LINE(AT+CIPSEND=5) OK > LINE( ) LINE(Recv 5 bytes) SEND_OK ");
+  check("'>' inside a line is no prompt",
+        "a>b\r\nOK\r\n",
+        "LINE(a>b) OK ");
+
+  /* frames interleaved with replies */
+  check("+IPD with CR LF and OK inside the payload",
+        "+IPD,8:OK\r\nab\r\n\r\nOK\r\n",
+        "IPD(8)[OK\r\nab\r\n] OK ");
+  check("+IPD with link id",
+        "+IPD,0,3:xyz+IPD,1,2:hiOK\r\n",
+        "IPD(3)[xyz] IPD(2)[hi] OK ");
+  check("+IPD between a command and its reply",
+        "AT+CIPSEND=2\r\n+IPD,4:SEND\r\nOK\r\n>\r\nSEND OK\r\n",
+        "LINE(AT+CIPSEND=2) IPD(4)[SEND] OK > SEND_OK ");
+  check("+MQTTSUBRECV with commas and quotes in the payload",
+        "+MQTTSUBRECV:0,\"dev/cmd\",13,{\"a\":1,\"b\":2}\r\nOK\r\n",
+        "MQTT(dev/cmd,13)[{\"a\":1,\"b\":2}] OK ");
+  check("+MQTTSUBRECV topic with a comma",
+        "+MQTTSUBRECV:0,\"a,b\",2,on\r\n",
+        "MQTT(a,b,2)[on] ");
+  check("+IPD and +MQTTSUBRECV back to back",
+        "+MQTTSUBRECV:0,\"t\",3,+IP+IPD,5:OK\r\n>\r\n+MQTTSUBRECV:0,\"u\",1,1WIFI GOT IP\r\n",
+        "MQTT(t,3)[+IP] IPD(5)[OK\r\n>] MQTT(u,1)[1] WIFI_GOT_IP ");
+  check("empty frames",
+        "+IPD,0:\r\n+MQTTSUBRECV:0,\"t\",0,\r\nOK\r\n",
+        "IPD(0)[] MQTT(t,0)[] OK ");
+
+  /* broken or cut off input */
+  check("frame header cut by a line end",
+        "+IPD,12\r\nOK\r\n",
+        "LINE(+IPD,12) OK ");
+  check("MQTT header cut by a line end",
+        "+MQTTSUBRECV:0,\"t\"\r\nERROR\r\n",
+        "LINE(+MQTTSUBRECV:0,\"t\") ERROR ");
+  checkLongLine();
+  checkLongFrame();
+
+  /* driver frame queue */
+  checkFrameQueue();
+  checkFrameDrop();
+
+  printf("%d cases, %d failed\n", cases, failures);
+  return failures;
+}
@@ -0,0 +1,253 @@
+/*************************************************
+File:             HTTPPipelineTest.cpp
+Description:      http_getPipelined() against the ESP-AT emulator:
+                  all requests go out in one AT+CIPSEND, the replies
+                  are split by their framing and reported in order,
+                  requests left unanswered by a closed connection are
+                  sent again. Exit status is the number of failed
+                  cases.
+version:          V1.0.0
+**************************************************/
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "ATEmulator.h"
+#include "BMC81M001.h"
+
+#define REPLY_MAX 8
+
+static ATEmulator emu;
+static BMC81M001 Wifi(&Serial2);
+
+static int failures = 0;
+static int cases = 0;
+
+/* what the reply callback saw */
+static int replies = 0;
+static uint8_t replyIndex[REPLY_MAX];
+static int replyStatus[REPLY_MAX];
+static std::string replyBody[REPLY_MAX];
+
+static void onReply(uint8_t index, int status, const char *body, int length)
+{
+  if (replies >= REPLY_MAX) return;
+  replyIndex[replies] = index;
+  replyStatus[replies] = status;
+  replyBody[replies].assign(body, length);
+  replies++;
+}
+
+/* number of logged commands starting with prefix */
+static int countCommands(const char *prefix)
+{
+  int count = 0;
+  for (size_t i = 0; i < emu.commands().size(); i++)
+  {
+    if (emu.commands()[i].compare(0, strlen(prefix), prefix) == 0) count++;
+  }
+  return count;
+}
+
+/* paths of the requests in one payload, in order */
+static int requestPaths(const std::string &data, std::string paths[], int max)
+{
+  int count = 0;
+  size_t start = 0, end;
+  while (count < max && (end = data.find("\r\n\r\n", start)) != std::string::npos)
+  {
+    size_t space = data.find(' ', start + 4);
+    paths[count++] = data.substr(start + 4, space - start - 4);
+    start = end + 4;
+  }
+  return count;
+}
+
+static std::string httpReply(int status, const std::string &body)
+{
+  return "HTTP/1.1 " + std::to_string(status) + " X\r\nContent-Length: "
+         + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+static std::string chunkedReply(const std::string &body)
+{
+  char size[16];
+  snprintf(size, sizeof(size), "%x", (unsigned)body.size());
+  return "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+         + std::string(size) + "\r\n" + body + "\r\n0\r\n\r\n";
+}
+
+static void expect(bool ok, const char *name, const char *what)
+{
+  if (ok) return;
+  printf("FAIL %s: %s\n", name, what);
+  failures++;
+}
+
+/* start a case: clean log, default server, new batch of count requests */
+static void beginCase(int count)
+{
+  cases++;
+  replies = 0;
+  emu.clearLog();
+  emu.onTcpData(EmuTcpHandler());
+  emu.setIpdChunk(1460);
+  Wifi.http_begin("http://iot.arduino.org.tw", 8888);
+  for (int i = 0; i < count; i++)
+  {
+    char path[32];
+    snprintf(path, sizeof(path), "/check.php?KEY=%d", i);
+    Wifi.http_addRequest(path);
+  }
+}
+
+static void checkOneSend(void)
+{
+  const char *name = "three requests, one connection, one send";
+  int before = failures;
+  beginCase(3);
+  int result = Wifi.http_getPipelined(onReply);
+  expect(result == HTTP_GET_OP_SUCCESS, name, "result");
+  expect(countCommands("AT+CIPSTART") == 1, name, "one AT+CIPSTART");
+  expect(countCommands("AT+CIPSEND") == 1, name, "one AT+CIPSEND");
+  expect(replies == 3, name, "three replies");
+  for (int i = 0; i < replies; i++)
+  {
+    expect(replyIndex[i] == i && replyStatus[i] == 200 && replyBody[i] == "{\"Result\":\"Find\"}",
+           name, "reply in order with its body");
+  }
+  if (failures == before) printf("ok   %s\n", name);
+}
+
+static void checkKeepAlive(void)
+{
+  const char *name = "next batch reuses the connection";
+  int before = failures;
+  beginCase(2);
+  int result = Wifi.http_getPipelined(onReply);
+  expect(result == HTTP_GET_OP_SUCCESS && replies == 2, name, "two replies");
+  expect(countCommands("AT+CIPSTART") == 0, name, "no AT+CIPSTART");
+  if (failures == before) printf("ok   %s\n", name);
+}
+
+static void checkFraming(void)
+{
+  const char *name = "chunked, 204 and 404 replies split across +IPD frames";
+  int before = failures;
+  beginCase(3);
+  emu.setIpdChunk(7);
+  emu.onTcpData([](ATEmulator &e, const std::string &data)
+  {
+    std::string paths[REPLY_MAX];
+    int count = requestPaths(data, paths, REPLY_MAX);
+    std::string all;
+    for (int i = 0; i < count; i++)
+    {
+      if (i == 0) all += chunkedReply("first");
+      else if (i == 1) all += "HTTP/1.1 204 No Content\r\n\r\n";
+      else all += httpReply(404, "gone");
+    }
+    e.sendIpd(all);
+  });
+  int result = Wifi.http_getPipelined(onReply);
+  expect(result == HTTP_GET_OP_SUCCESS && replies == 3, name, "three replies");
+  expect(replyStatus[0] == 200 && replyBody[0] == "first", name, "chunked body");
+  expect(replyStatus[1] == 204 && replyBody[1] == "", name, "empty 204");
+  expect(replyStatus[2] == 404 && replyBody[2] == "gone", name, "404 body");
+  if (failures == before) printf("ok   %s\n", name);
+}
+
+static void checkReconnect(void)
+{
+  const char *name = "server closes after one reply, the rest is sent again";
+  int before = failures;
+  static int connections;
+  connections = 0;
+  beginCase(3);
+  emu.onTcpData([](ATEmulator &e, const std::string &data)
+  {
+    std::string paths[REPLY_MAX];
+    int count = requestPaths(data, paths, REPLY_MAX);
+    if (++connections == 1)
+    {
+      e.sendIpd(httpReply(200, paths[0]));
+      e.closeLink(1000);
+      return;
+    }
+    std::string all;
+    for (int i = 0; i < count; i++) all += httpReply(200, paths[i]);
+    e.sendIpd(all);
+  });
+  int result = Wifi.http_getPipelined(onReply);
+  expect(result == HTTP_GET_OP_SUCCESS && replies == 3, name, "three replies");
+  expect(countCommands("AT+CIPSTART") == 1, name, "one new connection");
+  expect(countCommands("AT+CIPSEND") == 2, name, "two sends");
+  for (int i = 0; i < replies; i++)
+  {
+    char path[32];
+    snprintf(path, sizeof(path), "/check.php?KEY=%d", i);
+    expect(replyIndex[i] == i && replyBody[i] == path, name, "replies in request order");
+  }
+  if (failures == before) printf("ok   %s\n", name);
+}
+
+static void checkBadReply(void)
+{
+  const char *name = "reply that is not HTTP stops the batch";
+  int before = failures;
+  beginCase(2);
+  emu.onTcpData([](ATEmulator &e, const std::string &data)
+  {
+    e.sendIpd("<html>Notice</html>\r\n");
+  });
+  int result = Wifi.http_getPipelined(onReply);
+  expect(result == HTTP_GET_BAD_REPLY, name, "HTTP_GET_BAD_REPLY");
+  expect(replies == 0, name, "no reply reported");
+  expect(!emu.linkOpen(), name, "connection closed");
+  if (failures == before) printf("ok   %s\n", name);
+}
+
+static void checkLimits(void)
+{
+  const char *name = "batch limits";
+  int before = failures;
+  cases++;
+  Wifi.http_begin("http://iot.arduino.org.tw", 8888);
+  for (int i = 0; i < HTTP_PIPELINE_DEPTH; i++)
+  {
+    expect(Wifi.http_addRequest("/"), name, "request within the depth");
+  }
+  expect(!Wifi.http_addRequest("/"), name, "request beyond HTTP_PIPELINE_DEPTH");
+  Wifi.http_begin("http://iot.arduino.org.tw", 8888);
+  static char longPath[HTTP_PIPELINE_BUFFER];
+  memset(longPath, 'a', sizeof(longPath) - 1);
+  longPath[0] = '/';
+  longPath[sizeof(longPath) - 1] = '\0';
+  expect(!Wifi.http_addRequest(longPath), name, "request beyond HTTP_PIPELINE_BUFFER");
+  expect(Wifi.http_getPipelined(onReply) == HTTP_GET_OP_SUCCESS, name, "empty batch");
+  if (failures == before) printf("ok   %s\n", name);
+}
+
+int main(void)
+{
+  hostSetConsole(NULL);
+  Serial2.attach(&emu);
+  emu.setHttpReply(200, "{\"Result\":\"Find\"}");
+  Wifi.begin(115200);
+  if (!Wifi.connectToAP("NCNUIOT", "0123456789"))
+  {
+    printf("FAIL connectToAP\n");
+    return 1;
+  }
+  Wifi.http_setKeepAlive(true);
+
+  checkOneSend();
+  checkKeepAlive();
+  checkFraming();
+  checkReconnect();
+  checkBadReply();
+  checkLimits();
+
+  printf("%d cases, %d failed\n", cases, failures);
+  return failures;
+}
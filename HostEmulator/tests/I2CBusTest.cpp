@@ -0,0 +1,128 @@
+/*************************************************
+File:             I2CBusTest.cpp
+Description:      I2CBusLib.h with the OLED and relay stubs on Wire1:
+                  a relay command submitted while the OLED logo is
+                  being sent waits for one page when the logo goes out
+                  page by page (oledPictureStep()), and for the whole
+                  1 KB frame when it goes out at once (drawPicture()).
+                  Uses the OledLib.h of BMduino_DHT2_HC05_CTRL_Relay_Led.
+                  Exit status is the number of failed cases.
+version:          V1.0.0
+**************************************************/
+#include <Arduino.h>
+#include <stdio.h>
+#include "I2CBusLib.h"
+#include "../../BMduino_DHT2_HC05_CTRL_Relay_Led/OledLib.h"
+#include <BMP75M131.h>
+
+#define ROUNDS OLED_PAGES     /* paged: the relay command arrives at each page once */
+#define RELAY 1
+
+static BMP75M131 relay(&Wire1);
+static int oledBus = BUS_NONE;
+static int relayBus = BUS_NONE;
+
+static int failures = 0;
+static int cases = 0;
+
+static uint8_t injectPage = 0;
+static unsigned long submitUs = 0;
+static uint32_t waitUs[ROUNDS];
+
+static void expect(bool ok, const char *name, const char *what)
+{
+  if (ok) return;
+  printf("FAIL %s: %s\n", name, what);
+  failures++;
+}
+
+static bool relayStep(int arg, uint8_t step)
+{
+  relay.setRelaySwitch(RELAY, arg);
+  return false;
+}
+
+/* relay command as if the Bluetooth task received it mid-transfer */
+static void submitRelay(int on)
+{
+  submitUs = micros();
+  busSubmit(relayBus, BUS_PRIO_URGENT, relayStep, on);
+}
+
+static bool pagedStep(int arg, uint8_t page)
+{
+  if (page == injectPage) submitRelay(arg);
+  return oledPictureStep(arg, page);
+}
+
+static bool frameStep(int arg, uint8_t step)
+{
+  submitRelay(arg);
+  drawPicture(0, 0, BestModule_LOGO, 128, 64);
+  return false;
+}
+
+/* send the logo ROUNDS times with step, return the longest relay wait */
+static uint32_t measure(BusStep step, uint32_t *oledStepUs)
+{
+  uint32_t longest = 0;
+  oledPicture = BestModule_LOGO;
+  busDevices[oledBus].maxStepUs = 0;
+  for (uint8_t i = 0; i < ROUNDS; i++)
+  {
+    clearScreen();
+    injectPage = i;
+    busSubmit(oledBus, BUS_PRIO_DISPLAY, step, i & 1);
+    busFlush();
+    waitUs[i] = relay.lastSwitchUs - submitUs;
+    if (waitUs[i] > longest) longest = waitUs[i];
+  }
+  *oledStepUs = busDevices[oledBus].maxStepUs;
+  return longest;
+}
+
+static uint32_t pagedWait, pagedStepUs;
+
+static void checkPaged(void)
+{
+  const char *name = "paged logo: relay waits for at most one page";
+  int before = failures;
+  cases++;
+  pagedWait = measure(pagedStep, &pagedStepUs);
+  expect(pagedStepUs > 0, name, "pages were sent");
+  /* the page in flight plus the relay write itself */
+  expect(pagedWait <= pagedStepUs + busDevices[relayBus].maxStepUs, name, "wait within one page");
+  for (uint8_t i = 0; i < ROUNDS; i++)
+  {
+    expect(waitUs[i] > 0, name, "relay switched");
+  }
+  if (failures == before) printf("ok   %s (%lu us, page %lu us)\n", name,
+                                 (unsigned long)pagedWait, (unsigned long)pagedStepUs);
+}
+
+static void checkFrame(void)
+{
+  const char *name = "whole-frame logo: relay waits for the full transfer";
+  int before = failures;
+  uint32_t frameStepUs;
+  cases++;
+  uint32_t frameWait = measure(frameStep, &frameStepUs);
+  expect(frameWait >= frameStepUs, name, "wait covers the frame");
+  expect(frameWait > 4 * pagedWait, name, "several times the paged wait");
+  if (failures == before) printf("ok   %s (%lu us)\n", name, (unsigned long)frameWait);
+}
+
+int main(void)
+{
+  hostSetConsole(NULL);
+  initOled();
+  relay.begin();
+  oledBus = busAddDevice("oled");
+  relayBus = busAddDevice("relay");
+
+  checkPaged();
+  checkFrame();
+
+  printf("%d cases, %d failed\n", cases, failures);
+  return failures;
+}
@@ -0,0 +1,2679 @@
+#include "variant.h"
+/*************************************************
+File:             BMC81M001.cpp
+Author:           BEST MODULES CORP.
+Description:      UART communication with the BMC81M001 
+version:          V1.1.0-2026-10-17
+**************************************************/
+#include "BMC81M001.h"
+
+#define AT_PARSE_LINE      0
+#define AT_PARSE_IPD_HEAD  1
+#define AT_PARSE_MQTT_HEAD 2
+#define AT_PARSE_DATA      3
+
+#define HTTP_PARSE_STATUS      0
+#define HTTP_PARSE_HEADER      1
+#define HTTP_PARSE_BODY        2
+#define HTTP_PARSE_UNTIL_CLOSE 3
+#define HTTP_PARSE_CHUNK_SIZE  4
+#define HTTP_PARSE_CHUNK_DATA  5
+#define HTTP_PARSE_CHUNK_END   6
+#define HTTP_PARSE_TRAILER     7
+#define HTTP_PARSE_DONE        8
+#define HTTP_PARSE_ERROR       9
+
+#define JSON_SCAN_IDLE     0
+#define JSON_SCAN_TOKEN    1
+#define JSON_SCAN_STRING   2
+#define JSON_SCAN_ESCAPE   3
+#define JSON_SCAN_LITERAL  4
+#define JSON_SCAN_DONE     5
+#define JSON_SCAN_ERROR    6
+
+/**********************************************************
+Description: Constructor of the AT response parser
+Parameters:         
+Return:      none     
+Others:     
+**********************************************************/
+ATParser::ATParser()
+{
+  reset();
+}
+/**********************************************************
+Description: forget the partial line or frame
+Parameters:         
+Return:        
+Others:      Used after the serial port was read around the parser
+**********************************************************/
+void ATParser::reset(void)
+{
+  _state = AT_PARSE_LINE;
+  _lineLength = 0;
+  _lineDone = false;
+  _line[0] = '\0';
+  _topic = _line;
+  _frameLength = 0;
+  _remain = 0;
+  _frameType = 0;
+}
+/**********************************************************
+Description: parse one received byte
+Parameters:  c: byte read from the module
+Return:      AT_EVT_NONE while a line is still incomplete, otherwise
+             the AT_EVT_xxx code of the completed item. line(),
+             topic(), frameLength() and data() describe it until the
+             next call
+Others:      Constant work per byte. Frame payloads are passed through
+             byte by byte (AT_EVT_DATA) and never buffered here, so
+             they may contain CR LF
+**********************************************************/
+uint8_t ATParser::feed(uint8_t c)
+{
+  if(_lineDone)
+  {
+    /* line() stays valid until the next byte arrives */
+    _lineDone = false;
+    _lineLength = 0;
+  }
+  switch(_state)
+  {
+    case AT_PARSE_DATA:
+      _data = c;
+      if(--_remain > 0) return AT_EVT_DATA;
+      _state = AT_PARSE_LINE;
+      _lineLength = 0;
+      return AT_EVT_DATA_END;
+
+    case AT_PARSE_IPD_HEAD:
+      /* +IPD,<len>: or +IPD,<link>,<len>: */
+      if(c == ':') return beginFrame(AT_FRAME_IPD);
+      break;
+
+    case AT_PARSE_MQTT_HEAD:
+      /* +MQTTSUBRECV:<link>,"<topic>",<len>,<data> */
+      if(c == '"') _quoted = !_quoted;
+      if(c == ',' && !_quoted && ++_commas == 3) return beginFrame(AT_FRAME_MQTT);
+      break;
+
+    default:
+      if(c == '\r') return AT_EVT_NONE;
+      if(c == '\n')
+      {
+        if(_lineLength == 0) return AT_EVT_NONE;
+        _line[_lineLength] = '\0';
+        _lineDone = true;
+        return classifyLine();
+      }
+      if(c == '>' && _lineLength == 0)
+      {
+        _line[0] = '\0';
+        return AT_EVT_PROMPT;
+      }
+      break;
+  }
+  if(c == '\n' || c == '\r')
+  {
+    /* a frame header never spans lines, treat it as a plain line */
+    _state = AT_PARSE_LINE;
+    if(c == '\r') return AT_EVT_NONE;
+    _line[_lineLength] = '\0';
+    _lineDone = true;
+    return AT_EVT_LINE;
+  }
+  if(_lineLength < AT_LINE_MAX_LENGTH) _line[_lineLength++] = c;
+  if(_state == AT_PARSE_LINE)
+  {
+    if(_lineLength == 5 && memcmp(_line,"+IPD,",5) == 0)
+    {
+      _state = AT_PARSE_IPD_HEAD;
+    }
+    else if(_lineLength == 13 && memcmp(_line,"+MQTTSUBRECV:",13) == 0)
+    {
+      _state = AT_PARSE_MQTT_HEAD;
+      _commas = 0;
+      _quoted = false;
+    }
+  }
+  return AT_EVT_NONE;
+}
+/**********************************************************
+Description: finish a frame header and switch to payload mode
+Parameters:  type: AT_FRAME_IPD or AT_FRAME_MQTT
+Return:      AT_EVT_IPD or AT_EVT_MQTT_RECV
+Others:      The length is the last number of the header, the MQTT
+             topic is cut out of the header line in place
+**********************************************************/
+uint8_t ATParser::beginFrame(uint8_t type)
+{
+  _line[_lineLength] = '\0';
+  int start = _lineLength;
+  while(start > 0 && _line[start - 1] != ',') start--;
+  _frameLength = atoi(&_line[start]);
+  _topic = _line + _lineLength;             // empty string
+  if(type == AT_FRAME_MQTT)
+  {
+    char *open = strchr(_line,'"');
+    char *close = open != NULL ? strchr(open + 1,'"') : NULL;
+    if(close != NULL)
+    {
+      *close = '\0';
+      _topic = open + 1;
+    }
+  }
+  _frameType = type;
+  _lineLength = 0;
+  if(_frameLength > 0)
+  {
+    _remain = _frameLength;
+    _state = AT_PARSE_DATA;
+  }
+  else
+  {
+    _frameLength = 0;
+    _state = AT_PARSE_LINE;
+  }
+  return type == AT_FRAME_IPD ? AT_EVT_IPD : AT_EVT_MQTT_RECV;
+}
+/**********************************************************
+Description: compare the completed line
+Parameters:  text: expected line
+Return:      true if the line equals text
+Others:        
+**********************************************************/
+bool ATParser::lineIs(const char *text)
+{
+  return strcmp(_line,text) == 0;
+}
+/**********************************************************
+Description: map a completed line to its event
+Parameters:         
+Return:      AT_EVT_xxx
+Others:      Result codes must match the whole line, so data such as
+             an SSID containing "OK" is never taken for a result
+**********************************************************/
+uint8_t ATParser::classifyLine(void)
+{
+  if(lineIs("OK") || lineIs("+MQTTPUB:OK")) return AT_EVT_OK;
+  if(lineIs("ERROR")) return AT_EVT_ERROR;
+  if(lineIs("FAIL") || lineIs("+MQTTPUB:FAIL")) return AT_EVT_FAIL;
+  if(lineIs("SEND OK")) return AT_EVT_SEND_OK;
+  if(lineIs("SEND FAIL")) return AT_EVT_SEND_FAIL;
+  if(lineIs("WIFI CONNECTED")) return AT_EVT_WIFI_CONNECTED;
+  if(lineIs("WIFI GOT IP")) return AT_EVT_WIFI_GOT_IP;
+  if(lineIs("WIFI DISCONNECT")) return AT_EVT_WIFI_DISCONNECT;
+  if(lineIs("ready")) return AT_EVT_READY;
+  if(strncmp(_line,"+CWLAP:",7) == 0) return AT_EVT_CWLAP;
+  if(strncmp(_line,"busy ",5) == 0) return AT_EVT_BUSY;
+  if(_lineLength >= 6 && strcmp(&_line[_lineLength - 6],"CLOSED") == 0) return AT_EVT_CLOSED;
+  return AT_EVT_LINE;
+}
+
+#if BMC81M001_USE_HTTP
+/**********************************************************
+Description: Constructor of the http response parser
+Parameters:         
+Return:      none     
+Others:     
+**********************************************************/
+HTTPParser::HTTPParser()
+{
+  reset();
+}
+/**********************************************************
+Description: prepare for the next reply
+Parameters:         
+Return:        
+Others:        
+**********************************************************/
+void HTTPParser::reset(void)
+{
+  _state = HTTP_PARSE_STATUS;
+  _lineLength = 0;
+  _status = 0;
+  _contentLength = -1;
+  _remain = 0;
+  _chunked = false;
+}
+/**********************************************************
+Description: reply finished?
+Parameters:         
+Return:      true after the last byte or a bad status line
+Others:        
+**********************************************************/
+bool HTTPParser::isDone(void)
+{
+  return _state == HTTP_PARSE_DONE || _state == HTTP_PARSE_ERROR;
+}
+/**********************************************************
+Description: body without length?
+Parameters:         
+Return:      true if the body ends with the connection
+Others:        
+**********************************************************/
+bool HTTPParser::bodyUntilClose(void)
+{
+  return _state == HTTP_PARSE_UNTIL_CLOSE;
+}
+/**********************************************************
+Description: parse one byte of the reply
+Parameters:  c: byte of the +IPD data
+Return:      HTTP_EVT_BODY with data() valid, HTTP_EVT_DONE once,
+             HTTP_EVT_ERROR once, otherwise HTTP_EVT_NONE
+Others:      Constant work per byte, only the current header line
+             is kept
+**********************************************************/
+uint8_t HTTPParser::feed(uint8_t c)
+{
+  switch(_state)
+  {
+    case HTTP_PARSE_BODY:
+      _data = c;
+      if(--_remain == 0) _state = HTTP_PARSE_DONE;
+      return HTTP_EVT_BODY;
+
+    case HTTP_PARSE_UNTIL_CLOSE:
+      _data = c;
+      return HTTP_EVT_BODY;
+
+    case HTTP_PARSE_CHUNK_DATA:
+      _data = c;
+      if(--_remain == 0) _state = HTTP_PARSE_CHUNK_END;
+      return HTTP_EVT_BODY;
+
+    case HTTP_PARSE_CHUNK_END:
+      /* CR LF after the chunk data */
+      if(c == '\n') _state = HTTP_PARSE_CHUNK_SIZE;
+      return HTTP_EVT_NONE;
+
+    case HTTP_PARSE_CHUNK_SIZE:
+      /* <hex size>[;extension] CR LF */
+      if(c == '\n')
+      {
+        _state = _remain > 0 ? HTTP_PARSE_CHUNK_DATA : HTTP_PARSE_TRAILER;
+        _lineLength = 0;
+      }
+      else if(_lineLength == 0)
+      {
+        if(c >= '0' && c <= '9') _remain = _remain * 16 + c - '0';
+        else if(c >= 'a' && c <= 'f') _remain = _remain * 16 + c - 'a' + 10;
+        else if(c >= 'A' && c <= 'F') _remain = _remain * 16 + c - 'A' + 10;
+        else if(c != '\r') _lineLength = 1;     // skip the extension
+      }
+      return HTTP_EVT_NONE;
+
+    case HTTP_PARSE_DONE:
+    case HTTP_PARSE_ERROR:
+      return HTTP_EVT_NONE;
+  }
+
+  /* status line, header lines and trailer lines */
+  if(c == '\r') return HTTP_EVT_NONE;
+  if(c != '\n')
+  {
+    if(_lineLength < HTTP_LINE_MAX_LENGTH) _line[_lineLength++] = c;
+    return HTTP_EVT_NONE;
+  }
+  _line[_lineLength] = '\0';
+  uint8_t length = _lineLength;
+  _lineLength = 0;
+  switch(_state)
+  {
+    case HTTP_PARSE_STATUS:
+      /* HTTP/1.1 200 OK */
+      if(length == 0) return HTTP_EVT_NONE;
+      if(strncmp(_line,"HTTP/",5) != 0 || strchr(_line,' ') == NULL)
+      {
+        _state = HTTP_PARSE_ERROR;
+        return HTTP_EVT_ERROR;
+      }
+      _status = atoi(strchr(_line,' ') + 1);
+      _state = HTTP_PARSE_HEADER;
+      return HTTP_EVT_NONE;
+
+    case HTTP_PARSE_HEADER:
+      if(length > 0)
+      {
+        headerLine();
+        return HTTP_EVT_NONE;
+      }
+      return endOfHeaders();
+
+    default:   // HTTP_PARSE_TRAILER
+      if(length > 0) return HTTP_EVT_NONE;
+      _state = HTTP_PARSE_DONE;
+      return HTTP_EVT_DONE;
+  }
+}
+/**********************************************************
+Description: take the framing headers out of a header line
+Parameters:         
+Return:        
+Others:      header names are not case sensitive
+**********************************************************/
+void HTTPParser::headerLine(void)
+{
+  if(strncasecmp(_line,"Content-Length:",15) == 0)
+  {
+    _contentLength = atol(&_line[15]);
+  }
+  else if(strncasecmp(_line,"Transfer-Encoding:",18) == 0)
+  {
+    for(char *p = &_line[18]; *p != '\0'; p++)
+    {
+      if(strncasecmp(p,"chunked",7) == 0) _chunked = true;
+    }
+  }
+}
+/**********************************************************
+Description: choose how the body is framed
+Parameters:         
+Return:      HTTP_EVT_DONE if the reply has no body
+Others:        
+**********************************************************/
+uint8_t HTTPParser::endOfHeaders(void)
+{
+  if(_status >= 100 && _status < 200)
+  {
+    /* interim reply, the real one follows */
+    reset();
+    return HTTP_EVT_NONE;
+  }
+  _remain = 0;
+  if(_status == 204 || _status == 304 || (!_chunked && _contentLength == 0))
+  {
+    _state = HTTP_PARSE_DONE;
+    return HTTP_EVT_DONE;
+  }
+  if(_chunked) _state = HTTP_PARSE_CHUNK_SIZE;
+  else if(_contentLength > 0)
+  {
+    _remain = _contentLength;
+    _state = HTTP_PARSE_BODY;
+  }
+  else _state = HTTP_PARSE_UNTIL_CLOSE;
+  return HTTP_EVT_NONE;
+}
+
+#endif // BMC81M001_USE_HTTP
+
+/**********************************************************
+Description: Constructor of the json field scanner
+Parameters:         
+Return:      none     
+Others:     
+**********************************************************/
+JSONScanner::JSONScanner()
+{
+  _fieldCount = 0;
+  reset();
+}
+/**********************************************************
+Description: look for one more key
+Parameters:  key: key name, must stay valid
+             value: buffer receiving the value as text
+             size: buffer size including the terminating '\0'
+Return:      false if JSON_MAX_FIELDS keys are registered already
+Others:        
+**********************************************************/
+bool JSONScanner::addField(const char *key,char *value,uint8_t size)
+{
+  if(_fieldCount >= JSON_MAX_FIELDS || size == 0) return false;
+  _key[_fieldCount] = key;
+  _value[_fieldCount] = value;
+  _size[_fieldCount] = size;
+  _fieldCount++;
+  reset();
+  return true;
+}
+/**********************************************************
+Description: prepare for the next document
+Parameters:         
+Return:        
+Others:      the value buffers are cleared, the keys are kept
+**********************************************************/
+void JSONScanner::reset(void)
+{
+  for(uint8_t i = 0; i < _fieldCount; i++)
+  {
+    _value[i][0] = '\0';
+    _length[i] = 0;
+  }
+  _foundMask = 0;
+  _nameLength = 0;
+  _state = JSON_SCAN_IDLE;
+  _depth = 0;
+  _objects = 0;
+  _readingKey = false;
+  _expectKey = false;
+  _afterValue = false;
+  _target = -1;
+  _skip = 0;
+}
+/**********************************************************
+Description: was the key in the document?
+Parameters:  key: key name given to addField()
+Return:      true once its value has been read completely
+Others:        
+**********************************************************/
+bool JSONScanner::found(const char *key)
+{
+  for(uint8_t i = 0; i < _fieldCount; i++)
+  {
+    if(strcmp(_key[i],key) == 0) return (_foundMask & (1 << i)) != 0;
+  }
+  return false;
+}
+/**********************************************************
+Description: document finished?
+Parameters:         
+Return:      true after the closing bracket of the document
+Others:        
+**********************************************************/
+bool JSONScanner::isComplete(void)
+{
+  return _state == JSON_SCAN_DONE;
+}
+/**********************************************************
+Description: document broken?
+Parameters:         
+Return:      true if an unexpected character was found
+Others:      the values read before the error are kept
+**********************************************************/
+bool JSONScanner::isError(void)
+{
+  return _state == JSON_SCAN_ERROR;
+}
+/**********************************************************
+Description: scan a block of text
+Parameters:  text, length
+Return:        
+Others:        
+**********************************************************/
+void JSONScanner::feed(const char *text,int length)
+{
+  for(int i = 0; i < length; i++) feed(text[i]);
+}
+/**********************************************************
+Description: scan one byte
+Parameters:  c: next byte of the document
+Return:        
+Others:      Constant work per byte
+**********************************************************/
+void JSONScanner::feed(uint8_t c)
+{
+  switch(_state)
+  {
+    case JSON_SCAN_IDLE:
+      /* skip everything before the document */
+      if(c == '{' || c == '[')
+      {
+        _state = JSON_SCAN_TOKEN;
+        structural(c);
+      }
+      return;
+
+    case JSON_SCAN_STRING:
+      if(_skip > 0)
+      {
+        _skip--;
+        return;
+      }
+      if(c == '\\')
+      {
+        _state = JSON_SCAN_ESCAPE;
+        return;
+      }
+      if(c == '"')
+      {
+        _state = JSON_SCAN_TOKEN;
+        if(_readingKey) endKey();
+        else endValue();
+        return;
+      }
+      store(c);
+      return;
+
+    case JSON_SCAN_ESCAPE:
+      _state = JSON_SCAN_STRING;
+      switch(c)
+      {
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'u': c = '?'; _skip = 4; break;   // no unicode decoding
+      }
+      store(c);
+      return;
+
+    case JSON_SCAN_LITERAL:
+      if(c == ',' || c == '}' || c == ']' || c == ' ' || c == '\r' || c == '\n' || c == '\t')
+      {
+        _state = JSON_SCAN_TOKEN;
+        endValue();
+        structural(c);
+        return;
+      }
+      store(c);
+      return;
+
+    case JSON_SCAN_TOKEN:
+      structural(c);
+      return;
+  }
+}
+/**********************************************************
+Description: handle a byte between tokens
+Parameters:  c
+Return:        
+Others:        
+**********************************************************/
+void JSONScanner::structural(uint8_t c)
+{
+  switch(c)
+  {
+    case ' ': case '\r': case '\n': case '\t': case ':':
+      return;
+    case '{':
+    case '[':
+      /* a requested key with an object or array value is not taken */
+      _target = -1;
+      if(_depth >= 32 || _afterValue || _expectKey)
+      {
+        fail();
+        return;
+      }
+      if(c == '{') _objects |= (uint32_t)1 << _depth;
+      else _objects &= ~((uint32_t)1 << _depth);
+      _depth++;
+      _expectKey = c == '{';
+      return;
+    case '}':
+    case ']':
+      _depth--;
+      _expectKey = false;
+      _afterValue = true;
+      if(_depth == 0) _state = JSON_SCAN_DONE;
+      return;
+    case ',':
+      if(!_afterValue)
+      {
+        fail();
+        return;
+      }
+      _afterValue = false;
+      _expectKey = (_objects & ((uint32_t)1 << (_depth - 1))) != 0;
+      return;
+    case '"':
+      if(_afterValue)
+      {
+        fail();
+        return;
+      }
+      _state = JSON_SCAN_STRING;
+      _readingKey = _expectKey;
+      _nameLength = 0;
+      return;
+  }
+  if(!_afterValue && !_expectKey && ((c >= '0' && c <= '9') || c == '-' || (c >= 'a' && c <= 'z')))
+  {
+    /* number, true, false, null */
+    _state = JSON_SCAN_LITERAL;
+    _readingKey = false;
+    store(c);
+    return;
+  }
+  fail();
+}
+/**********************************************************
+Description: unexpected character
+Parameters:         
+Return:        
+Others:      Before any key was found the text is taken for noise
+             and the scanner waits for the next '{' or '['
+**********************************************************/
+void JSONScanner::fail(void)
+{
+  if(_foundMask == 0) reset();
+  else _state = JSON_SCAN_ERROR;
+}
+/**********************************************************
+Description: a key is complete, find the field it names
+Parameters:         
+Return:        
+Others:      only the first occurrence of a key is taken
+**********************************************************/
+void JSONScanner::endKey(void)
+{
+  _expectKey = false;
+  _target = -1;
+  if(_nameLength > JSON_KEY_MAX_LENGTH) return;
+  _name[_nameLength] = '\0';
+  for(uint8_t i = 0; i < _fieldCount; i++)
+  {
+    if((_foundMask & (1 << i)) == 0 && strcmp(_key[i],_name) == 0)
+    {
+      _target = i;
+      _length[i] = 0;
+      return;
+    }
+  }
+}
+/**********************************************************
+Description: keep one character of a key or of a wanted value
+Parameters:  c
+Return:        
+Others:        
+**********************************************************/
+void JSONScanner::store(uint8_t c)
+{
+  if(_readingKey)
+  {
+    if(_nameLength <= JSON_KEY_MAX_LENGTH) _name[_nameLength++] = c;
+    return;
+  }
+  if(_target < 0) return;
+  if(_length[_target] < _size[_target] - 1)
+  {
+    _value[_target][_length[_target]++] = c;
+    _value[_target][_length[_target]] = '\0';
+  }
+}
+/**********************************************************
+Description: a value is complete
+Parameters:         
+Return:        
+Others:        
+**********************************************************/
+void JSONScanner::endValue(void)
+{
+  if(_target >= 0) _foundMask |= 1 << _target;
+  _target = -1;
+  _afterValue = true;
+}
+
+/**********************************************************
+Description: Constructor
+Parameters:  *theSerial�hardware serial 
+             BMduino optional:serial(default) serial1/seria2/seria3/seria4
+             UNO optional:serial(default)
+Return:      none     
+Others:     
+**********************************************************/
+  BMC81M001::BMC81M001(HardwareSerial *theSerial)
+  {
+    _softSerial = NULL;
+    _serial = theSerial;
+  }
+
+/**********************************************************
+Description: Constructor
+Parameters:  rxPin : Receiver pin of the UART
+             txPin : Send signal pin of UART  
+Return:      none    
+Others:   
+**********************************************************/
+  BMC81M001::BMC81M001(uint16_t rxPin,uint16_t txPin)
+{
+  _serial = NULL;
+  _rxPin = rxPin;
+  _txPin = txPin;
+  _softSerial = new SoftwareSerial(_rxPin, _txPin);
+}
+/**********************************************************
+ Description: Module serial Initial
+ Parameters:  baudRate : Set the Module  baudRate       
+ Return:          
+ Others:   If the hardware UART is initialized, the _softSerial 
+           pointer is null, otherwise it is non-null       
+ **********************************************************/
+ void BMC81M001::begin(uint32_t baud)
+ {
+    if(_serial!=NULL)
+    {    _serial->begin(baud);}
+    
+    else
+    {
+          _softSerial->begin(baud);
+    }
+
+ }
+/**********************************************************
+Description: change the baud rate of the module and of the port
+Parameters:  baud: new rate, e.g. 9600 .. 921600
+Return:      Communication status  1:SEND_Success 0:SEND_FAIL
+Others:      <AT+UART_CUR> is not stored in the flash of the
+             module, it is back at 115200 after a power cycle.
+             The module answers OK at the old rate, then switches.
+**********************************************************/
+bool BMC81M001::setBaudRate(uint32_t baud)
+{
+  char cmd[40];
+  sprintf(cmd,"AT+UART_CUR=%lu,8,1,0,0",(unsigned long)baud);
+  if(sendATCommand(cmd,1000,1) != SEND_SUCCESS) return SEND_FAIL;
+  begin(baud);
+  return SEND_SUCCESS;
+}
+
+/**********************************************************
+Description: connect Ap
+Parameters:  ssid : wifi name
+             password: wifi password     
+Return:     Communication status  1:SEND_Success 0:SEND_FAIL  
+                                     
+Others:     
+**********************************************************/
+bool BMC81M001::connectToAP( String  ssid,  String pass)
+{  
+  return connectToAP(ssid.c_str(),pass.c_str());
+}
+bool BMC81M001::connectToAP(const char *ssid,const char *pass)
+{  
+  if(waitCommand(queueConnectToAP(ssid,pass,NULL,true)) == AT_CMD_OK ) 
+  {  
+      return SEND_SUCCESS;
+  }
+  else 
+  {
+    return SEND_FAIL;
+  } 
+}
+/**********************************************************
+Description: Queue the commands that connect to an AP
+Parameters:  ssid : wifi name
+             password: wifi password     
+             callback: called when the connection attempt finished
+Return:      ticket of the last command, AT_CMD_QUEUE_FULL on failure
+Others:      The commands are sent from poll()
+**********************************************************/
+int BMC81M001::connectToAPAsync(String ssid,String pass,ATCallback callback)
+{
+  return queueConnectToAP(ssid.c_str(),pass.c_str(),callback,false);
+}
+int BMC81M001::connectToAPAsync(const char *ssid,const char *pass,ATCallback callback)
+{
+  return queueConnectToAP(ssid,pass,callback,false);
+}
+/**********************************************************
+Description: build the commands that connect to an AP
+Parameters:  ssid, pass, callback: see connectToAPAsync()
+             keep: true  - reference the strings, they stay valid
+                           until the command has finished
+                   false - copy them into the queue
+Return:      ticket of the last command, AT_CMD_QUEUE_FULL on failure
+Others:        
+**********************************************************/
+int BMC81M001::queueConnectToAP(const char *ssid,const char *pass,ATCallback callback,bool keep)
+{
+  if(!beginChain(2)) return AT_CMD_QUEUE_FULL;
+  /* <AT+CWMODE=1> command to Set station mode   */
+  ATCommand *c = beginCommand(1000,3,NULL);
+  int ticket = commitCommand(c,addPiece(c,AT_TEXT("AT+CWMODE=1"),true));
+  /* <AT+CWJAP="ssid","password"> add to AP  */
+  if(ticket > 0)
+  {
+    c = beginCommand(1000,3,callback);
+    bool ok = addPiece(c,AT_TEXT("AT+CWJAP=\""),true)
+           && addPiece(c,ssid,strlen(ssid),keep)
+           && addPiece(c,AT_TEXT("\",\""),true)
+           && addPiece(c,pass,strlen(pass),keep)
+           && addPiece(c,AT_TEXT("\""),true);
+    ticket = commitCommand(c,ok);
+  }
+  return endChain(ticket);
+}
+#if BMC81M001_USE_TCP
+/**********************************************************
+Description: Connect to TCP server
+Parameters:  ip: TCP sever IP address
+             port: TCP sever port number      
+Return:      Communication status  1:SEND_Success 0:SEND_FAIL  
+Others:        
+**********************************************************/
+bool BMC81M001::connectTCP( String ip,  int port)
+{  
+  return connectTCP(ip.c_str(),port);
+}
+bool BMC81M001::connectTCP(const char *ip,int port)
+{  
+  ATCommand *c = beginCommand(1000,3,NULL);
+  if(c == NULL) return SEND_FAIL;
+  bool ok = addPiece(c,AT_TEXT("AT+CIPSTART=\"TCP\",\""),true)
+         && addPiece(c,ip,strlen(ip),true)
+         && addPiece(c,AT_TEXT("\","),true)
+         && addNumber(c,port);
+  if(waitCommand(commitCommand(c,ok)) == AT_CMD_OK )
+  {
+     return SEND_SUCCESS; 
+  }
+  else 
+  {
+    return SEND_FAIL;
+  } 
+}
+
+/**********************************************************
+Description: Send data to TCP server
+Parameters:  Dlength: data length
+             Dbuffer[] : Storing Data        
+Return:      Communication status  1:SEND_Success 0:SEND_FAIL  
+Others:      Dbuffer is written to the port as it is, not copied
+**********************************************************/
+bool BMC81M001::writeDataTcp(int Dlength,char Dbuffer[])
+{
+  return writeDataTcp(Dbuffer,Dlength);
+}
+bool BMC81M001::writeDataTcp(const char *Dbuffer,int Dlength)
+{
+  ATCommand *c = beginCommand(1000,3,NULL);
+  if(c == NULL) return SEND_FAIL;
+  bool ok = addPiece(c,AT_TEXT("AT+CIPSEND="),true)
+         && addNumber(c,Dlength)
+         && beginPayload(c)
+         && addPiece(c,Dbuffer,Dlength,true);
+  /* the data is written as soon as the module answers '>' */
+  if(waitCommand(commitCommand(c,ok)) == AT_CMD_OK )  
+  {  
+    return SEND_SUCCESS;
+  }
+  else 
+  {
+    return SEND_FAIL;
+  } 
+}
+/**********************************************************
+Description: read data from module connect TCP server
+Parameters:           
+Return:   String   
+Others:        
+**********************************************************/
+String  BMC81M001::readDataTcp()
+{
+  String tcpBuf;
+  poll();
+  int i = findFrame(AT_FRAME_IPD);
+  if(i >= 0)
+  {
+    tcpBuf = String(_frames[i].data);
+    dropFrame(i);
+  }
+  return tcpBuf;
+}
+#endif // BMC81M001_USE_TCP
+#if BMC81M001_USE_MQTT
+/**********************************************************
+Description: Configure MQTT parameters
+Parameters:  clientlid,username,password,mqtt_host,server_port      
+Return:      Communication status  1:SEND_Success 0:SEND_FAIL  
+Others:        
+**********************************************************/
+bool BMC81M001::configMqtt(String clientlid,String username,String password,String mqtt_host,int server_port)
+{
+  return configMqtt(clientlid.c_str(),username.c_str(),password.c_str(),mqtt_host.c_str(),server_port);
+}
+bool BMC81M001::configMqtt(const char *clientlid,const char *username,const char *password,const char *mqtt_host,int server_port)
+{
+  if(waitCommand(queueConfigMqtt(clientlid,username,password,mqtt_host,server_port,NULL,true)) == AT_CMD_OK )
+  {  
+    return SEND_SUCCESS;
+  }
+  else 
+  {
+    return SEND_FAIL;
+  } 
+}
+/**********************************************************
+Description: Queue the commands that configure MQTT and connect the broker
+Parameters:  clientlid,username,password,mqtt_host,server_port
+             callback: called when the broker connection finished
+Return:      ticket of the last command, AT_CMD_QUEUE_FULL on failure
+Others:      The commands are sent from poll(), a failed step
+             cancels the remaining ones
+**********************************************************/
+int BMC81M001::configMqttAsync(String clientlid,String username,String password,String mqtt_host,int server_port,ATCallback callback)
+{
+  return queueConfigMqtt(clientlid.c_str(),username.c_str(),password.c_str(),mqtt_host.c_str(),server_port,callback,false);
+}
+int BMC81M001::configMqttAsync(const char *clientlid,const char *username,const char *password,const char *mqtt_host,int server_port,ATCallback callback)
+{
+  return queueConfigMqtt(clientlid,username,password,mqtt_host,server_port,callback,false);
+}
+/**********************************************************
+Description: build the MQTT configuration commands
+Parameters:  see configMqttAsync(), keep: see queueConnectToAP()
+Return:      ticket of the last command, AT_CMD_QUEUE_FULL on failure
+Others:        
+**********************************************************/
+int BMC81M001::queueConfigMqtt(const char *clientlid,const char *username,const char *password,const char *mqtt_host,int server_port,ATCallback callback,bool keep)
+{
+  if(!beginChain(4)) return AT_CMD_QUEUE_FULL;
+/**********************************************************  
+Description: Set mqtt user properties and client ID
+command:     At+mqttusercfg=<linkid>, <scheme>, < "client\u ID" >, <username ">, <password" >, <cert_ Key_ Id>, <ca_ Id>, < "path" >
+             The client ID goes into this command instead of a
+             separate AT+MQTTCLIENTID, so the whole configuration
+             fits into an AT_QUEUE_SIZE of 4
+**********************************************************/
+  ATCommand *c = beginCommand(1000,3,NULL);
+  bool ok = addPiece(c,AT_TEXT("AT+MQTTUSERCFG=0,1,\""),true)
+         && addPiece(c,clientlid,strlen(clientlid),keep)
+         && addPiece(c,AT_TEXT("\",\"NULL\",\"NULL\",0,0,\"\""),true);
+  int ticket = commitCommand(c,ok);
+/**********************************************************
+Description: Set mqtt username
+command:     AT+MQTTUSERNAME=<LinkID>,<"username">
+**********************************************************/
+  if(ticket > 0)
+  {
+    c = beginCommand(1000,3,NULL);
+    bool ok = addPiece(c,AT_TEXT("AT+MQTTUSERNAME=0,\""),true)
+           && addPiece(c,username,strlen(username),keep)
+           && addPiece(c,AT_TEXT("\""),true);
+    ticket = commitCommand(c,ok);
+  }
+/**********************************************************
+Description: Set mqtt userpassword
+command:     AT+MQTTPASSWORD=<LinkID>,<"password">
+**********************************************************/
+  if(ticket > 0)
+  {
+    c = beginCommand(1000,3,NULL);
+    bool ok = addPiece(c,AT_TEXT("AT+MQTTPASSWORD=0,\""),true)
+           && addPiece(c,password,strlen(password),keep)
+           && addPiece(c,AT_TEXT("\""),true);
+    ticket = commitCommand(c,ok);
+  }
+/**********************************************************
+Description: Connect  MQTT Broker
+command:     AT+MQTTCONN=<LinkID>,<"host">,<port>,<reconnect>
+**********************************************************/
+  if(ticket > 0)
+  {
+    c = beginCommand(5000,3,callback);
+    bool ok = addPiece(c,AT_TEXT("AT+MQTTCONN=0,\""),true)
+           && addPiece(c,mqtt_host,strlen(mqtt_host),keep)
+           && addPiece(c,AT_TEXT("\","),true)
+           && addNumber(c,server_port)
+           && addPiece(c,AT_TEXT(",0"),true);
+    ticket = commitCommand(c,ok);
+  }
+  return endChain(ticket);
+}
+/**********************************************************
+Description: set PublishTopic
+Parameters:       
+Return:      Communication status  1:SEND_Success 0:SEND_FAIL  
+Others:        
+**********************************************************/
+bool BMC81M001::setPublishTopic(String publishtopic)
+{
+  return setTopic(publishtopic.c_str());
+}
+bool BMC81M001::setPublishTopic(const char *publishtopic)
+{
+  return setTopic(publishtopic);
+}
+/**********************************************************
+Description: set Subscribetopic
+Parameters:       
+Return:      Communication status  1:SEND_Success 0:SEND_FAIL  
+Others:        
+**********************************************************/
+bool BMC81M001::setSubscribetopic(String subscribetopic)
+{
+  return setTopic(subscribetopic.c_str());
+}
+bool BMC81M001::setSubscribetopic(const char *subscribetopic)
+{
+  return setTopic(subscribetopic);
+}
+/**********************************************************
+Description: set custom topic
+Parameters:  topic : MQTT topic Data    
+Return:      Communication status  1:SEND_Success 0:SEND_FAIL  
+Others:        
+**********************************************************/
+bool BMC81M001::setTopic(String topic)
+{
+  return setTopic(topic.c_str());
+}
+bool BMC81M001::setTopic(const char *topic)
+{
+  ATCommand *c = beginCommand(1000,3,NULL);
+  if(c == NULL) return SEND_FAIL;
+  bool ok = addPiece(c,AT_TEXT("AT+MQTTSUB=0,\""),true)
+         && addPiece(c,topic,strlen(topic),true)
+         && addPiece(c,AT_TEXT("\",0"),true);
+  if(waitCommand(commitCommand(c,ok)) == AT_CMD_OK )
+  {  
+    return SEND_SUCCESS;
+  }
+  else 
+  {
+    return SEND_FAIL;
+  } 
+}
+
+/**********************************************************
+Description: Send data to IOT (data type:string)
+Parameters:  Dbuffer: data
+             topic : MQTT topic Data      
+Return:      Communication status  1:SEND_Success 0:SEND_FAIL  
+Others:      The char overloads stream data and topic to the port
+             without copying or allocating
+**********************************************************/
+bool BMC81M001::writeString(String Dbuffer,String topic)
+{
+  return writeString(Dbuffer.c_str(),Dbuffer.length(),topic.c_str(),topic.length());
+}
+bool BMC81M001::writeString(const char *Dbuffer,const char *topic)
+{
+  return writeString(Dbuffer,strlen(Dbuffer),topic,strlen(topic));
+}
+bool BMC81M001::writeString(const char *Dbuffer,int Dlength,const char *topic,int topicLength)
+{
+  if(waitCommand(queueWriteString(Dbuffer,Dlength,topic,topicLength,NULL,true)) == AT_CMD_OK ) ;
+  else 
+  {
+    return SEND_FAIL;
+  } 
+  return SEND_SUCCESS;
+}
+/**********************************************************
+Description: Queue data for IOT (data type:string)
+Parameters:  Dbuffer: data
+             topic : MQTT topic Data      
+             callback: called when the module acknowledged the publish
+Return:      ticket (>0), AT_CMD_QUEUE_FULL or AT_CMD_TOO_LONG
+Others:      data and topic are copied into the queue
+**********************************************************/
+int BMC81M001::writeStringAsync(String Dbuffer,String topic,ATCallback callback)
+{
+  return queueWriteString(Dbuffer.c_str(),Dbuffer.length(),topic.c_str(),topic.length(),callback,false);
+}
+int BMC81M001::writeStringAsync(const char *Dbuffer,const char *topic,ATCallback callback)
+{
+  return queueWriteString(Dbuffer,strlen(Dbuffer),topic,strlen(topic),callback,false);
+}
+/**********************************************************
+Description: build the AT+MQTTPUB command
+Parameters:  see writeStringAsync(), keep: see queueConnectToAP()
+Return:      ticket (>0), AT_CMD_QUEUE_FULL or AT_CMD_TOO_LONG
+Others:        
+**********************************************************/
+int BMC81M001::queueWriteString(const char *Dbuffer,int Dlength,const char *topic,int topicLength,ATCallback callback,bool keep)
+{
+  ATCommand *c = beginCommand(1000,3,callback);
+  if(c == NULL) return AT_CMD_QUEUE_FULL;
+  bool ok = addPiece(c,AT_TEXT("AT+MQTTPUB=0,\""),true)
+         && addPiece(c,topic,topicLength,keep)
+         && addPiece(c,AT_TEXT("\",\""),true)
+         && addPiece(c,Dbuffer,Dlength,keep)
+         && addPiece(c,AT_TEXT("\",0,0"),true);
+  return commitCommand(c,ok);
+}
+
+/**********************************************************
+Description: Send data to IOT (data type:byte)
+Parameters:  Dlength:   data length
+             *Dbuffer : Storing Data
+             topic:   PUBLISHTOPIC         
+Return:      Communication status  1:SEND_Success 0:SEND_FAIL  
+Others:      Dbuffer is written to the port as it is, not copied
+**********************************************************/
+bool BMC81M001::writeBytes(char Dbuffer[],int Dlength,String topic)
+{
+  return writeBytes((const char *)Dbuffer,Dlength,topic.c_str());
+}
+bool BMC81M001::writeBytes(const char *Dbuffer,int Dlength,const char *topic)
+{
+  ATCommand *c = beginCommand(1000,3,NULL);
+  if(c == NULL) return SEND_FAIL;
+  bool ok = addPiece(c,AT_TEXT("AT+MQTTPUBRAW=0,\""),true)
+         && addPiece(c,topic,strlen(topic),true)
+         && addPiece(c,AT_TEXT("\","),true)
+         && addNumber(c,Dlength)
+         && addPiece(c,AT_TEXT(",0,0"),true)
+         && beginPayload(c)
+         && addPiece(c,Dbuffer,Dlength,true);
+  /* the data is written as soon as the module answers '>' */
+  if(waitCommand(commitCommand(c,ok)) == AT_CMD_OK ) ;
+  else 
+  {
+    return SEND_FAIL;
+  } 
+  return SEND_SUCCESS;
+}
+/**********************************************************
+Description: read data from module connect TCP server
+Parameters:  IotReciveBuff�Storing String data  
+             IotReciveBufflen   String length 
+             topic�data form topic
+Return:      
+Others:        
+**********************************************************/
+void BMC81M001::readIotData(String *IotReciveBuff,int *IotReciveBufflen,String *topic)
+{
+  *IotReciveBufflen=0;
+  poll();
+  int i = findFrame(AT_FRAME_MQTT);
+  if(i >= 0)
+  {
+    *topic=String(_frames[i].topic);
+    *IotReciveBufflen=_frames[i].length;
+    *IotReciveBuff=String(_frames[i].data);
+    dropFrame(i);
+  }
+}
+/*
+void BMC81M001::readIotData(String *IotReciveBuff,int *IotReciveBufflen,String *topic)
+{
+  String ReciveTopic; 
+  int commaPosition;
+  char  data_div=0;
+  String S_Dbuffer, S_Dbuffer1;
+  clearResponse(BMC81M001Response);
+  int ReciveBufflen=0;
+  if(_serial!=NULL)
+  {
+      if(_serial->available())
+      {
+        delay(10);
+        while(_serial->available())
+        {
+          uint8_t temp;
+          temp=_serial->read();
+          //Serial.write(temp);
+          BMC81M001Response[resLength++] = temp;
+          if(resLength == AT_RESPONSE_MAX_LENGTH) clearResponse(BMC81M001Response);
+        }}
+   }
+    else
+    {
+      if(_softSerial->available())
+    {
+      delay(10);
+    while(_softSerial->available())
+    {
+      BMC81M001Response[resLength++] = _softSerial->read();
+      if(resLength == AT_RESPONSE_MAX_LENGTH) clearResponse(BMC81M001Response);
+    }}        
+    }
+    if(resLength>0)    
+    {
+      
+      if(strstr(BMC81M001Response, "+MQTTSUBRECV") != NULL)
+      {
+        //Serial.println("+MQTTSUBRECV OK");
+        S_Dbuffer = BMC81M001Response;  
+        OneNetReciveBuff=S_Dbuffer;  
+        do
+        { 
+          commaPosition = S_Dbuffer.indexOf('"');
+          if(commaPosition != -1)
+          {
+            data_div++;
+            if(data_div== 2)
+            {
+              Serial.print("topic:");
+             
+              ReciveTopic = S_Dbuffer1.substring(0, commaPosition);
+               Serial.println(ReciveTopic);
+              S_Dbuffer = S_Dbuffer.substring(commaPosition+1, S_Dbuffer.length());
+              data_div=0;
+            }
+            else
+            {
+              S_Dbuffer = S_Dbuffer.substring(commaPosition+1, S_Dbuffer.length());
+              S_Dbuffer1 =S_Dbuffer;
+             // Serial.println(S_Dbuffer1);
+            }
+          }    
+         }
+         while(commaPosition >=0); 
+          S_Dbuffer = S_Dbuffer.substring(commaPosition+2, S_Dbuffer.length());
+         for (uint8_t i=0;i<(S_Dbuffer.length()-2);i++)
+         {
+            if(S_Dbuffer[i]==0x2c)
+            {
+              break;
+            }
+            else
+            {
+              *IotReciveBufflen = ReciveBufflen *10  + (S_Dbuffer[i]-48);
+            }
+         }         
+        commaPosition= 0;
+        do
+        { 
+          commaPosition = S_Dbuffer.indexOf(',');
+          if(commaPosition != -1)
+          {
+              *IotReciveBuff = S_Dbuffer.substring(commaPosition+1,commaPosition+1+ *IotReciveBufflen);
+              break;
+          }       
+         }while(commaPosition >=0);  
+      }
+    }
+    *topic=ReciveTopic;
+}
+*/
+#endif // BMC81M001_USE_MQTT
+/**********************************************************
+Description: send <AT+RST> command to softreset the module
+Parameters:           
+Return:     Communication status  1:SEND_Success 0:SEND_FAIL  
+                                     
+Others:     
+**********************************************************/
+bool BMC81M001::reset(void)
+{
+  boolean found = SEND_SUCCESS;   
+  if(sendATCommand("AT+RST",1000,3) == SEND_SUCCESS )
+  {
+    clearResponse(BMC81M001Response);
+    delay(2000) ;        // Issue soft-reset command
+  }
+  else 
+  {
+    found = SEND_FAIL;
+  }
+  return found;
+}
+/**********************************************************
+Description: Send AT command  to moudle
+Parameters:  StringstrCmd:AT command
+             *response :receiving the response indicates success
+             timeout�Resend message after timeout
+             reTry :retransmission number      
+Return:      Communication status  1:SEND_Success 0:SEND_FAIL  
+Others:        
+**********************************************************/
+int BMC81M001::sendATCommand(String StringstrCmd, int timeout, uint8_t reTry)
+{
+  return sendATCommand(StringstrCmd.c_str(),timeout,reTry);
+}
+int BMC81M001::sendATCommand(const char *strCmd, int timeout, uint8_t reTry)
+{
+  ATCommand *c = beginCommand(timeout,reTry,NULL);
+  if(waitCommand(commitCommand(c,addPiece(c,strCmd,strlen(strCmd),true))) == AT_CMD_OK)
+  {
+    return SEND_SUCCESS;
+  }
+  return SEND_FAIL;
+}
+/**********************************************************
+Description: Send AT command  to moudle
+Parameters:  StringstrCmd:AT command
+             timeout: Resend message after timeout
+             reTry :retransmission number      
+Return:      AT command Ack  
+Others:        
+**********************************************************/
+String BMC81M001::sendATCmd(String StringstrCmd,int timeout,uint8_t reTry)
+{
+  String  AckString;
+  ATCommand *c = beginCommand(timeout,reTry,NULL);
+  int result = waitCommand(commitCommand(c,addPiece(c,StringstrCmd.c_str(),StringstrCmd.length(),true)));
+  if(result == AT_CMD_OK)
+  {
+    AckString=String(BMC81M001Response);
+  }
+  else if(result == AT_CMD_TIMEOUT)
+  {
+    AckString="TimeOut";
+  }
+  return AckString;
+}
+/**********************************************************
+Description: Queue an AT command without waiting for the reply
+Parameters:  StringstrCmd:AT command
+             timeout: Resend message after timeout
+             reTry :retransmission number      
+             callback: called with the final result, may be NULL
+Return:      ticket (>0) for commandStatus()/waitCommand()
+             AT_CMD_QUEUE_FULL  no free queue entry
+             AT_CMD_TOO_LONG    command longer than AT_CMD_MAX_LENGTH
+Others:      The command is copied and sent from poll() after the
+             commands queued before it have finished
+**********************************************************/
+int BMC81M001::sendATCommandAsync(String StringstrCmd,int timeout,uint8_t reTry,ATCallback callback)
+{
+  return sendATCommandAsync(StringstrCmd.c_str(),timeout,reTry,callback);
+}
+int BMC81M001::sendATCommandAsync(const char *strCmd,int timeout,uint8_t reTry,ATCallback callback)
+{
+  ATCommand *c = beginCommand(timeout,reTry,callback);
+  return commitCommand(c,addPiece(c,strCmd,strlen(strCmd),false));
+}
+/**********************************************************
+Description: Drive the AT command queue, call it from loop()
+Parameters:  void
+Return:      number of commands not finished yet
+Others:      Only reads the bytes that are available, never waits.
+             "OK" finishes the running command, "ERROR"/"FAIL" or the
+             timeout resends it until reTry is used up. For commands
+             carrying a payload the payload is written after the '>'
+             prompt and the command finishes on the "OK" that follows.
+             +IPD and +MQTTSUBRECV frames are kept for readDataTcp()
+             and readIotData() also while no command is running.
+**********************************************************/
+int BMC81M001::poll(void)
+{
+  if(_queueCount > 0 && _queue[_queueHead].tries == 0)
+  {
+    startCommand();
+  }
+  readResponse();
+  if(_queueCount > 0 && _queue[_queueHead].tries > 0
+     && millis() - _cmdStart >= (unsigned long)_queue[_queueHead].timeout)
+  {
+    retryCommand(AT_CMD_TIMEOUT);
+  }
+  return _queueCount;
+}
+/**********************************************************
+Description: Result of a queued command
+Parameters:  ticket: value returned by an *Async() call
+Return:      AT_CMD_PENDING while queued or running, otherwise the
+             final AT_CMD_xxx result. AT_CMD_UNKNOWN if the ticket
+             is too old to be remembered
+Others:        
+**********************************************************/
+int BMC81M001::commandStatus(int ticket)
+{
+  if(ticket <= 0) return ticket == 0 ? AT_CMD_UNKNOWN : ticket;
+  for(uint8_t i = 0; i < _queueCount; i++)
+  {
+    if(_queue[(_queueHead + i) % AT_QUEUE_SIZE].ticket == ticket) return AT_CMD_PENDING;
+  }
+  for(uint8_t i = 0; i < AT_QUEUE_SIZE; i++)
+  {
+    if(_resultTicket[i] == ticket) return _resultCode[i];
+  }
+  return AT_CMD_UNKNOWN;
+}
+/**********************************************************
+Description: Poll the queue until a command has finished
+Parameters:  ticket: value returned by an *Async() call
+Return:      final AT_CMD_xxx result
+Others:      Blocking helper used by the synchronous API
+**********************************************************/
+int BMC81M001::waitCommand(int ticket)
+{
+  int result;
+  while((result = commandStatus(ticket)) == AT_CMD_PENDING)
+  {
+    poll();
+  }
+  return result;
+}
+/**********************************************************
+Description: Check whether the AT command queue is empty
+Parameters:  void
+Return:      true: no command queued or running
+Others:        
+**********************************************************/
+bool BMC81M001::isIdle(void)
+{
+  return _queueCount == 0;
+}
+/**********************************************************
+Description: Register a handler for unsolicited module messages
+Parameters:  callback: receives AT_EVT_WIFI_DISCONNECT, AT_EVT_CLOSED,
+             AT_EVT_IPD, AT_EVT_MQTT_RECV ... with the line or the
+             frame payload, NULL to disable
+Return:      void
+Others:      Called from poll(), must not block
+**********************************************************/
+void BMC81M001::setEventCallback(ATEventCallback callback)
+{
+  _eventCallback = callback;
+}
+/**********************************************************
+Description: Register a handler for operation statistics
+Parameters:  callback: receives AT_STAT_COMMAND for every queued
+             command and AT_STAT_HTTP for every http_get(),
+             NULL to disable
+Return:      void
+Others:      Called from poll(), must not block or send commands
+**********************************************************/
+void BMC81M001::setStatsCallback(ATStatsCallback callback)
+{
+  _statsCallback = callback;
+}
+#if BMC81M001_USE_AP
+ /**********************************************************
+  Description: Get surrounding WiFi information
+  Parameters:  void
+  Return:return WiFi information
+  Others:   
+  **********************************************************/
+String BMC81M001::SSID()
+{
+  String result="AT error";
+  if(sendATCommand("AT+CWLAP",5000,3)==SEND_SUCCESS)
+  {
+      result=String(BMC81M001Response);
+  }
+  return result;
+}
+/*
+AT+CIPSTATUS
+STATUS:5
+
+OK
+*/
+/**********************************************************
+Description: Get current connected SSID.
+Parameters:  void   
+Return:      The name of the currently connected WIFI
+Others:      void
+**********************************************************/
+ String BMC81M001::getSSID()
+ {
+  char *token;
+   String result="AT error";
+    if(sendATCommand("AT+CWJAP?",1000,3)==SEND_SUCCESS)
+    {
+      token = strtok(BMC81M001Response, "\"");// strchr(BMC81M001Response,'\"');
+      if(token!=NULL)
+      {
+          token = strtok(NULL, "\"");// strchr(BMC81M001Response,'\"');
+          if(token!=NULL)
+          {
+            result=String(token);
+          }
+           else {
+              result="No wifi connected";
+          }
+      }
+
+    }
+    return result;
+ }
+ /*
+OK
+AT+CWJAP?
++CWJAP:"zengdebin","9a:9f:8b:24:c1:31",1,-19,0,1,3,0,0
+
+OK
+
+*/
+#endif // BMC81M001_USE_AP
+/**********************************************************
+Description: get wifi status
+Parameters:  void   
+Return:    recived wifi status
+          WIFI_STATUS_GOT_IP  2
+           WIFI_STATUS_CONNETED  3
+          WIFI_STATUS_DISCONNETED  4
+          WIFI_STATUS_NO_CONNET  5
+          COMMUNICAT_ERROR -1
+          AT_ACK_ERROR -2
+Others:      
+**********************************************************/
+
+int BMC81M001::getStatus()
+{
+  int result=COMMUNICAT_ERROR;
+  if(sendATCommand("AT+CIPSTATUS",1000,3)==SEND_SUCCESS)
+  {
+      char *pos=strchr(BMC81M001Response,':');
+     // Serial.println(pos);
+      if(pos!=NULL)
+       result = atoi(&pos[1]);
+      else
+        result=AT_ACK_ERROR;
+
+  }
+  else
+    result=COMMUNICAT_ERROR;
+  return result;
+}
+/*
+AT+CIPSTATUS
+STATUS:5
+
+OK
+*/
+/**********************************************************
+Description: Get the IP address of the currently connected AP
+Parameters:  void   
+Return:      IP string
+Others:       Connect to AP for data, otherwise 0
+**********************************************************/
+/*
+AT+CIPSTA?
++CIPSTA:ip:"192.168.110.179"
++CIPSTA:gateway:"192.168.110.17"
++CIPSTA:netmask:"255.255.255.0"
+OK
+
+*/
+
+String BMC81M001::getIP()
+{
+  String AckString="AT error";
+  char *token;
+  char sourceStr[20]="\0";
+  char s[2]=":";
+  uint8_t i;
+  if(sendATCommand("AT+CIPSTA?",1000,3)==SEND_SUCCESS)
+  {
+     token = strtok(BMC81M001Response, "\"");// strchr(BMC81M001Response,'\"');
+      if(token!=NULL)
+      {
+          //for(i=0;i<6;i++)
+          {
+            token = strtok(NULL, "\""); 
+            if(token!=NULL)
+            {
+              //strcat(sourceStr,token);
+              AckString=String(token);
+            }
+          }
+      }  
+   }
+  return AckString;
+}
+#if BMC81M001_USE_AP
+/**********************************************************
+Description: Get the Gateway address of the currently connected AP
+Parameters:  void   
+Return:      Gateway string
+Others:       Connect to AP for data, otherwise 0
+**********************************************************/
+String BMC81M001::getGateway()
+{
+  String AckString="AT error";
+  char *token;
+  char sourceStr[20]="\0";
+  char s[2]=":";
+  uint8_t i;
+  if(sendATCommand("AT+CIPSTA?",1000,3)==SEND_SUCCESS)
+  {
+     token = strtok(BMC81M001Response, "\"");// strchr(BMC81M001Response,'\"');
+      if(token!=NULL)
+      {
+          for(i=0;i<3;i++)
+          {
+            token = strtok(NULL, "\""); 
+
+          }
+           if(token!=NULL)
+            {
+              //strcat(sourceStr,token);
+              AckString=String(token);
+            }
+      }  
+   }
+  return AckString;
+}
+/**********************************************************
+Description: Get the Mask address of the currently connected AP
+Parameters:  void   
+Return:      Mask string
+Others:       Connect to AP for data, otherwise 0
+**********************************************************/
+String BMC81M001::getMask()
+{
+  String AckString="AT error";
+  char *token;
+  char sourceStr[20]="\0";
+  char s[2]=":";
+  uint8_t i;
+  if(sendATCommand("AT+CIPSTA?",1000,3)==SEND_SUCCESS)
+  {
+     token = strtok(BMC81M001Response, "\"");// strchr(BMC81M001Response,'\"');
+      if(token!=NULL)
+      {
+          for(i=0;i<5;i++)
+          {
+            token = strtok(NULL, "\""); 
+          }            
+          if(token!=NULL)
+          {
+            //strcat(sourceStr,token);
+            AckString=String(token);
+          }
+      }  
+   }
+  return AckString;
+}
+#endif // BMC81M001_USE_AP
+/**********************************************************
+Description: get MAC address
+Parameters:  void   
+Return:      MAC string
+Others:        
+**********************************************************/
+String BMC81M001::getMacAddress()
+{
+  String AckString="AT error";
+  char *token;
+  char sourceStr[20]="\0";
+  char s[2]=":";
+  uint8_t i;
+  if(sendATCommand("AT+CIPSTAMAC?",1000,3)==SEND_SUCCESS)
+  {
+     token = strtok(BMC81M001Response, "\"");// strchr(BMC81M001Response,'\"');
+      if(token!=NULL)
+      {
+          for(i=0;i<6;i++)
+          {
+            token = strtok(NULL, ":"); 
+            if(token!=NULL)
+            {
+              strcat(sourceStr,token);
+                for(uint8_t i=0;i<12;i++)
+              {
+                sourceStr[i]=toupper(sourceStr[i]); 
+              }
+            }
+          }
+          sourceStr[12]='\0';
+          AckString=String(sourceStr);
+      }  
+   }
+  return AckString;
+}
+/**********************************************************
+Description: get AT command  version
+Parameters:  void   
+Return:     AT command  version
+Others:        
+**********************************************************/
+String BMC81M001::getATVersion()
+{
+  String AckString="AT error";
+  char sourceStr[20];
+  char *pos1,*pos2;
+  if(sendATCommand("AT+GMR",1000,3)==SEND_SUCCESS)
+  {
+      pos1=strchr(BMC81M001Response,':');
+      pos2=strchr(BMC81M001Response,'-');
+      memcpy(sourceStr,pos1+1,pos2-pos1-1); 
+      AckString=String(sourceStr);
+   }
+  return AckString;
+}
+#if BMC81M001_USE_HTTP
+/**********************************************************
+Description: Start entering HTTP get
+Parameters:    
+            serverURL:Website Domain Name
+            port:Website port
+            subURL:Path, default value '/'
+Return:    HTTP data processing result
+              HTTP_GET_BEGIN_SUCCESS 0
+              HTTP_GET_OP_SUCCESS 0
+              HTTP_GET_URL_ERROR -1
+              HTTP_GET_OP_TIMEOUT -2            
+Others:        
+**********************************************************/
+
+int  BMC81M001::http_begin(String serverURL,int port,String subURL)
+{
+ 
+  serverURL.toCharArray(BMC81M001Response, AT_RESPONSE_MAX_LENGTH);
+  //Serial.println(BMC81M001Response);
+  char *token =strtok(BMC81M001Response,"//");
+  if(token==NULL) return HTTP_GET_URL_ERROR;
+
+  if(strstr(token,"http:")!=NULL)
+  {
+    _port=80;
+ 
+    _type="TCP";
+  }
+  else if(strstr(token,"https:")!=NULL)
+  {
+    _port=443;
+ 
+    _type="SSL";
+  }    
+  else return HTTP_GET_URL_ERROR;
+  token =strtok(NULL,"//");
+  _url=String(token);
+
+  if(subURL=="")
+    _suburl="/";
+  else  _suburl=subURL;
+  _len= subURL.length()+4+9+2;//GET / HTTP/1.1
+
+  //   Serial.print("subURL:");
+  //  Serial.println(subURL);
+  //  Serial.print("_len1:");
+  //  Serial.println(_len);
+
+
+  // Serial.print("subURL.length:");
+  // Serial.println(subURL.length());
+  // Serial.print("_url.length:");
+  // Serial.println(_url.length());
+  _host= "Host: ";
+  _host+=_url;
+  if(port!=80&&port!=443)
+  {
+      _port= port;
+      _host+=":";
+      _host+= _port;
+      _host+="\r\n\r\n";
+  }
+  else
+      _host+="\r\n\r\n";
+   _len+=_host.length();  
+
+  //  Serial.print("_host:");
+  //  Serial.println(_host);
+  //  Serial.print("_len2:");
+  //  Serial.println(_len);
+
+  //  Serial.println(_host);
+  //  Serial.print("_host.length:");
+  //  Serial.println(_host.length());
+
+  //-http_end();
+  _pipeCount = 0;     // requests added for another server are dropped
+
+  return HTTP_GET_BEGIN_SUCCESS;
+
+}
+
+
+/**********************************************************
+Description: Http_get operation
+Parameters: void
+Return:    HTTP status code of the reply, e.g. 200 or 404
+              HTTP_GET_URL_ERROR -1
+              COMMUNICAT_ERROR -1
+              HTTP_GET_OP_TIMEOUT -2
+              HTTP_GET_INCOMPLETE -3
+              HTTP_GET_BAD_REPLY -4
+Others:      In keep-alive mode the connection of the previous
+             request is used again when it goes to the same server
+             and the module has not reported it CLOSED
+**********************************************************/
+int BMC81M001::http_get(void)
+ {
+  int result=HTTP_GET_OP_SUCCESS;
+  unsigned long startUs = micros();
+
+  poll();   // take in a CLOSED reported since the last request
+  bool reused = _keepAlive && _linkOpen && _linkUrl == _url && _linkPort == _port;
+  if(!reused && httpConnect() != AT_CMD_OK)
+  {
+    if(_statsCallback != NULL) _statsCallback(AT_STAT_HTTP,COMMUNICAT_ERROR,micros() - startUs,1);
+    return COMMUNICAT_ERROR;
+  }
+  uint8_t tries = 1;
+  if(httpSendRequest() != AT_CMD_OK)
+  {
+    /* the server may have dropped an idle connection without the
+       module noticing yet, connect again once */
+    tries = 2;
+    if(!reused || httpConnect() != AT_CMD_OK || httpSendRequest() != AT_CMD_OK)
+    {
+      _linkOpen = false;
+      if(_statsCallback != NULL) _statsCallback(AT_STAT_HTTP,COMMUNICAT_ERROR,micros() - startUs,tries);
+      return COMMUNICAT_ERROR;
+    }
+  }
+
+  result = httpReceive();
+  if(result == HTTP_GET_OP_SUCCESS)
+  {
+    if(_http.statusCode() == 0) result=HTTP_GET_BAD_REPLY;
+    else result=_http.statusCode();
+  }
+  finishHttp();
+  if(_statsCallback != NULL) _statsCallback(AT_STAT_HTTP,result,micros() - startUs,tries);
+  return result;
+ }
+/**********************************************************
+Description: receive the replies of the requests just sent
+Parameters:         
+Return:      HTTP_GET_OP_SUCCESS
+             HTTP_GET_OP_TIMEOUT  no data for AT_HTTP_TIMEOUT ms
+             HTTP_GET_INCOMPLETE  connection closed before the end
+Others:      +IPD data goes through the http parser in handleEvent(),
+             the body is collected into BMC81M001Response. A reply
+             is complete as soon as its last byte has arrived
+**********************************************************/
+int BMC81M001::httpReceive(void)
+{
+  int result = HTTP_GET_OP_SUCCESS;
+  clearResponse(BMC81M001Response);
+  _http.reset();
+  if(_jsonScanner != NULL) _jsonScanner->reset();
+  _httpReceiving = true;
+  unsigned long start = millis();
+  uint8_t done = _pipeDone;
+  while(!httpReplied())
+  {
+    poll();
+    if(httpReplied()) break;
+    if(_pipeDone != done)
+    {
+      /* each pipelined reply restarts the timeout */
+      done = _pipeDone;
+      start = millis();
+    }
+    if(!_linkOpen)
+    {
+      /* a body without length ends with the connection */
+      if(!_http.bodyUntilClose()) result=HTTP_GET_INCOMPLETE;
+      else if(_pipelining)
+      {
+        httpReplyDone();
+        if(!httpReplied()) result=HTTP_GET_INCOMPLETE;
+      }
+      break;
+    }
+    if(millis() - start > AT_HTTP_TIMEOUT)
+    {
+      result=HTTP_GET_OP_TIMEOUT;
+      break;
+    }
+  }
+  _httpReceiving = false;
+  return result;
+}
+/**********************************************************
+Description: all replies in?
+Parameters:         
+Return:      true after the last reply or a reply that is not HTTP
+Others:      a reply that is not HTTP cannot be framed, so the
+             replies behind it are lost
+**********************************************************/
+bool BMC81M001::httpReplied(void)
+{
+  if(!_pipelining) return _http.isDone();
+  return _pipeDone >= _pipeCount || (_http.isDone() && _http.statusCode() == 0);
+}
+/**********************************************************
+Description: hand a complete pipelined reply to the sketch
+Parameters:         
+Return:        
+Others:      Called from handleEvent() on the byte that ends the
+             reply, so the following bytes of the same +IPD frame
+             already belong to the next reply
+**********************************************************/
+void BMC81M001::httpReplyDone(void)
+{
+  if(_pipeDone >= _pipeCount || _http.statusCode() == 0) return;
+  BMC81M001Response[resLength]='\0';
+#if BMC81M001_USE_HTTP_PIPELINE
+  if(_pipeCallback != NULL) _pipeCallback(_pipeDone,_http.statusCode(),BMC81M001Response,resLength);
+#endif
+  _pipeDone++;
+  if(_pipeDone < _pipeCount)
+  {
+    clearResponse(BMC81M001Response);
+    _http.reset();
+    if(_jsonScanner != NULL) _jsonScanner->reset();
+  }
+}
+/**********************************************************
+Description: end of a reply
+Parameters:         
+Return:        
+Others:      Without keep-alive the server closes the connection.
+             A reply that was not read to its end or was not HTTP
+             leaves data on the connection, so it cannot be used
+             again.
+**********************************************************/
+void BMC81M001::finishHttp(void)
+{
+  if((!_http.isDone() || _http.statusCode() == 0) && _linkOpen)
+  {
+    http_close();
+  }
+}
+/**********************************************************
+Description: open the http connection
+Parameters:         
+Return:      AT_CMD_OK or the AT_CMD_xxx error
+Others:      an open connection is closed first
+**********************************************************/
+int BMC81M001::httpConnect(void)
+{
+  if(_linkOpen)
+  {
+    sendATCommand("AT+CIPCLOSE", 1000, 1);
+    _linkOpen = false;
+  }
+  // AT+CIPSTART="TCP","iot.arduino.org.tw",8888
+  ATCommand *c = beginCommand(10000,3,NULL);
+  if(c == NULL) return AT_CMD_QUEUE_FULL;
+  bool ok = addPiece(c,AT_TEXT("AT+CIPSTART=\""),true)
+         && addPiece(c,_type.c_str(),_type.length(),true)
+         && addPiece(c,AT_TEXT("\",\""),true)
+         && addPiece(c,_url.c_str(),_url.length(),true)
+         && addPiece(c,AT_TEXT("\","),true)
+         && addNumber(c,_port);
+  int result = waitCommand(commitCommand(c,ok));
+  if(result == AT_CMD_OK)
+  {
+    _linkOpen = true;
+    _linkUrl = _url;
+    _linkPort = _port;
+  }
+  return result;
+}
+/**********************************************************
+Description: send the GET request on the open connection
+Parameters:         
+Return:      AT_CMD_OK or the AT_CMD_xxx error
+Others:        
+**********************************************************/
+int BMC81M001::httpSendRequest(void)
+{
+  /* GET <suburl> HTTP/1.1 + Host header, written on the '>' prompt */
+  int length = 4 + _suburl.length() + 11 + _host.length();
+  ATCommand *c = beginCommand(1000,3,NULL);
+  if(c == NULL) return AT_CMD_QUEUE_FULL;
+  bool ok = addPiece(c,AT_TEXT("AT+CIPSEND="),true)
+         && addNumber(c,length)
+         && beginPayload(c)
+         && addPiece(c,AT_TEXT("GET "),true)
+         && addPiece(c,_suburl.c_str(),_suburl.length(),true)
+         && addPiece(c,AT_TEXT(" HTTP/1.1\r\n"),true)
+         && addPiece(c,_host.c_str(),_host.length(),true);
+  return waitCommand(commitCommand(c,ok));
+}
+#if BMC81M001_USE_HTTP_PIPELINE
+/**********************************************************
+Description: add a GET request to the next http_getPipelined()
+Parameters:  subURL: path, "" for '/'
+Return:      false if HTTP_PIPELINE_DEPTH requests are waiting or
+             the request does not fit into HTTP_PIPELINE_BUFFER
+Others:      Goes to the server of the last http_begin(). The
+             request line and Host header are copied, subURL may
+             be reused right away
+**********************************************************/
+bool BMC81M001::http_addRequest(String subURL)
+{
+  return http_addRequest(subURL.c_str());
+}
+bool BMC81M001::http_addRequest(const char *subURL)
+{
+  if(_pipeCount >= HTTP_PIPELINE_DEPTH) return false;
+  if(subURL[0] == '\0') subURL = "/";
+  int pathLength = strlen(subURL);
+  int start = _pipeOffset[_pipeCount];
+  if(start + 4 + pathLength + 11 + (int)_host.length() > HTTP_PIPELINE_BUFFER) return false;
+  char *p = &_pipeRequest[start];
+  memcpy(p,"GET ",4);
+  p += 4;
+  memcpy(p,subURL,pathLength);
+  p += pathLength;
+  memcpy(p," HTTP/1.1\r\n",11);
+  p += 11;
+  memcpy(p,_host.c_str(),_host.length());
+  p += _host.length();
+  _pipeCount++;
+  _pipeOffset[_pipeCount] = p - _pipeRequest;
+  return true;
+}
+/**********************************************************
+Description: send the requests added by http_addRequest() back to
+             back and read their replies
+Parameters:  callback: called once per reply in request order with
+             the status code and the body, may be NULL
+Return:      HTTP_GET_OP_SUCCESS once every request got its reply
+              COMMUNICAT_ERROR -1
+              HTTP_GET_OP_TIMEOUT -2
+              HTTP_GET_INCOMPLETE -3
+              HTTP_GET_BAD_REPLY -4
+Others:      All requests go out in one AT+CIPSEND without waiting
+             for the replies in between. The replies are split by
+             their Content-Length or chunked framing. When the server
+             closes the connection after some replies, the requests
+             still unanswered are sent again on a new connection.
+             The batch is emptied on return. The connection is kept
+             for the next call in keep-alive mode, see http_end()
+**********************************************************/
+int BMC81M001::http_getPipelined(HTTPReplyCallback callback)
+{
+  int result=HTTP_GET_OP_SUCCESS;
+  unsigned long startUs = micros();
+  uint8_t tries = 0;
+
+  if(_pipeCount == 0) return HTTP_GET_OP_SUCCESS;
+  _pipeDone = 0;
+  _pipeCallback = callback;
+  _pipelining = true;
+  poll();   // take in a CLOSED reported since the last request
+  bool reused = _keepAlive && _linkOpen && _linkUrl == _url && _linkPort == _port;
+  while(_pipeDone < _pipeCount)
+  {
+    uint8_t before = _pipeDone;
+    tries++;
+    if(!reused && httpConnect() != AT_CMD_OK)
+    {
+      result=COMMUNICAT_ERROR;
+      break;
+    }
+    if(httpSendPipeline() != AT_CMD_OK)
+    {
+      _linkOpen = false;
+      /* an idle connection may be gone without the module knowing */
+      if(reused)
+      {
+        reused = false;
+        continue;
+      }
+      result=COMMUNICAT_ERROR;
+      break;
+    }
+    reused = false;
+    result = httpReceive();
+    if(result == HTTP_GET_OP_SUCCESS && _http.statusCode() == 0) result=HTTP_GET_BAD_REPLY;
+    /* connect again only while the server makes progress */
+    if(result != HTTP_GET_INCOMPLETE || _pipeDone == before) break;
+    result=HTTP_GET_OP_SUCCESS;
+  }
+  if(result != HTTP_GET_OP_SUCCESS && result != COMMUNICAT_ERROR && _linkOpen) http_close();
+  _pipelining = false;
+  _pipeCallback = NULL;
+  _pipeCount = 0;
+  if(_statsCallback != NULL) _statsCallback(AT_STAT_HTTP,result,micros() - startUs,tries);
+  return result;
+}
+/**********************************************************
+Description: send the unanswered requests of the batch
+Parameters:         
+Return:      AT_CMD_OK or the AT_CMD_xxx error
+Others:      one AT+CIPSEND, the payload is written from the
+             request buffer without a copy
+**********************************************************/
+int BMC81M001::httpSendPipeline(void)
+{
+  int from = _pipeOffset[_pipeDone];
+  int length = _pipeOffset[_pipeCount] - from;
+  ATCommand *c = beginCommand(1000,3,NULL);
+  if(c == NULL) return AT_CMD_QUEUE_FULL;
+  bool ok = addPiece(c,AT_TEXT("AT+CIPSEND="),true)
+         && addNumber(c,length)
+         && beginPayload(c)
+         && addPiece(c,&_pipeRequest[from],length,true);
+  return waitCommand(commitCommand(c,ok));
+}
+#endif // BMC81M001_USE_HTTP_PIPELINE
+/**********************************************************
+Description: keep the http connection open between requests
+Parameters:  enable: true  - http_end() leaves the connection open
+                             and the next http_get() to the same
+                             server sends its request on it
+                     false - one connection per request (default)
+Return:        
+Others:      The connection is opened again automatically after
+             the server or the module closed it
+**********************************************************/
+void BMC81M001::http_setKeepAlive(bool enable)
+{
+  _keepAlive = enable;
+  if(!enable && _linkOpen) http_close();
+}
+/**********************************************************
+Description: scan the body of the following replies for json keys
+Parameters:  scanner: keys and value buffers, NULL to stop
+Return:        
+Others:      The values are ready when http_get() returns, the body
+             does not have to be parsed again from http_getString()
+**********************************************************/
+void BMC81M001::http_setJsonScanner(JSONScanner *scanner)
+{
+  _jsonScanner = scanner;
+}
+/**********************************************************
+Description: close the http connection
+Parameters:         
+Return:        
+Others:      also in keep-alive mode
+**********************************************************/
+void BMC81M001::http_close(void)
+{
+  sendATCommand("AT+CIPCLOSE", 1000, 3);
+  _linkOpen = false;
+}
+/**********************************************************
+Description: read data after http get
+Parameters:         
+Return:        
+Others:      got sting
+**********************************************************/
+String BMC81M001::http_getString(void)
+{
+  BMC81M001Response[resLength]='\0';
+  return String(BMC81M001Response);
+
+}
+/**********************************************************
+Description: end http opration  
+Parameters:         
+Return:        
+Others:      If you don't execute 'end', 
+            you won't be able to perform the next HTTP operation.
+            In keep-alive mode the connection stays open, use
+            http_close() to close it.
+**********************************************************/
+void BMC81M001::http_end(void)
+{
+  if(_keepAlive) return;
+  http_close();
+}
+
+
+#endif // BMC81M001_USE_HTTP
+
+/**********************************************************
+Description: prepare the next free queue entry
+Parameters:  timeout, reTry, callback: see sendATCommandAsync()
+Return:      the entry, NULL if the queue is full
+Others:      The entry is queued by commitCommand() after the
+             command pieces were added
+**********************************************************/
+ATCommand *BMC81M001::beginCommand(int timeout,uint8_t reTry,ATCallback callback)
+{
+  if(_queueCount >= AT_QUEUE_SIZE) return NULL;
+  ATCommand *c = &_queue[(_queueHead + _queueCount) % AT_QUEUE_SIZE];
+  c->textLength = 0;
+  c->pieceCount = 0;
+  c->payloadStart = AT_CMD_MAX_PIECES;
+  c->timeout = timeout;
+  c->reTry = reTry > 0 ? reTry : 1;
+  c->tries = 0;
+  c->chain = _chain;
+  c->callback = callback;
+  return c;
+}
+/**********************************************************
+Description: add a piece of the command line or payload
+Parameters:  c: entry from beginCommand()
+             text, length: the piece
+             keep: true  - only the pointer is stored, text must stay
+                           valid until the command has finished
+                   false - text is copied into the entry
+Return:      false if the entry has no room left
+Others:      Pieces are written to the port one after the other,
+             the command line is never assembled in memory
+**********************************************************/
+bool BMC81M001::addPiece(ATCommand *c,const char *text,int length,bool keep)
+{
+  if(c == NULL || c->pieceCount >= AT_CMD_MAX_PIECES) return false;
+  if(!keep)
+  {
+    if(c->textLength + length > AT_CMD_MAX_LENGTH) return false;
+    memcpy(&c->text[c->textLength],text,length);
+    text = &c->text[c->textLength];
+    c->textLength += length;
+  }
+  c->piece[c->pieceCount].text = text;
+  c->piece[c->pieceCount].length = length;
+  c->pieceCount++;
+  return true;
+}
+/**********************************************************
+Description: add a decimal number to the command line
+Parameters:  c: entry from beginCommand()
+             value: number
+Return:      false if the entry has no room left
+Others:        
+**********************************************************/
+bool BMC81M001::addNumber(ATCommand *c,long value)
+{
+  char digits[12];
+  int length = 0;
+  unsigned long v = value < 0 ? -value : value;
+  do
+  {
+    digits[sizeof(digits) - 1 - length++] = '0' + v % 10;
+    v /= 10;
+  }
+  while(v > 0);
+  if(value < 0) digits[sizeof(digits) - 1 - length++] = '-';
+  return addPiece(c,&digits[sizeof(digits) - length],length,false);
+}
+/**********************************************************
+Description: mark where the payload starts
+Parameters:  c: entry from beginCommand()
+Return:      true
+Others:      The pieces added afterwards are written on the '>'
+             prompt instead of being part of the command line
+**********************************************************/
+bool BMC81M001::beginPayload(ATCommand *c)
+{
+  if(c == NULL) return false;
+  c->payloadStart = c->pieceCount;
+  return true;
+}
+/**********************************************************
+Description: queue the entry prepared by beginCommand()
+Parameters:  c: entry from beginCommand()
+             ok: false if adding a piece failed
+Return:      ticket (>0), AT_CMD_QUEUE_FULL or AT_CMD_TOO_LONG
+Others:        
+**********************************************************/
+int BMC81M001::commitCommand(ATCommand *c,bool ok)
+{
+  if(c == NULL) return AT_CMD_QUEUE_FULL;
+  if(!ok) return AT_CMD_TOO_LONG;
+  c->ticket = _nextTicket++;
+  if(_nextTicket > 30000) _nextTicket = 1;
+  _queueCount++;
+  return c->ticket;
+}
+/**********************************************************
+Description: start a group of commands that succeed or fail together
+Parameters:  count: number of commands in the group
+Return:      false if the queue cannot hold the whole group
+Others:        
+**********************************************************/
+bool BMC81M001::beginChain(uint8_t count)
+{
+  if(AT_QUEUE_SIZE - _queueCount < count) return false;
+  _chain = _nextChain++;
+  if(_nextChain == 0) _nextChain = 1;
+  return true;
+}
+/**********************************************************
+Description: close the group opened by beginChain()
+Parameters:  ticket: result of the last commitCommand()
+Return:      ticket
+Others:      If a command could not be queued, the commands of the
+             group already queued are removed again
+**********************************************************/
+int BMC81M001::endChain(int ticket)
+{
+  if(ticket < 0)
+  {
+    while(_queueCount > 0 && _queue[(_queueHead + _queueCount - 1) % AT_QUEUE_SIZE].chain == _chain)
+    {
+      _queueCount--;
+    }
+  }
+  _chain = 0;
+  return ticket;
+}
+/**********************************************************
+Description: send the command at the head of the queue
+Parameters:         
+Return:        
+Others:      Late replies of earlier commands are parsed first so
+             they cannot be taken for the reply of this one.
+             BMC81M001Response collects the reply lines
+**********************************************************/
+void BMC81M001::startCommand(void)
+{
+  ATCommand *c = &_queue[_queueHead];
+  _draining = true;
+  readResponse();
+  _draining = false;
+  clearResponse(BMC81M001Response);
+  writePieces(c,0,c->payloadStart < c->pieceCount ? c->payloadStart : c->pieceCount);
+  writeRaw("\r\n",2);
+  if(c->tries == 0) _cmdFirstUs = micros();
+  c->tries++;
+  _cmdStart = millis();
+  _waitPayloadAck = false;
+}
+/**********************************************************
+Description: resend the command at the head of the queue
+Parameters:  result: reported if no retry is left
+Return:        
+Others:        
+**********************************************************/
+void BMC81M001::retryCommand(int result)
+{
+  if(_queue[_queueHead].tries < _queue[_queueHead].reTry)
+  {
+    startCommand();
+  }
+  else
+  {
+    finishCommand(result);
+  }
+}
+/**********************************************************
+Description: remove the command at the head of the queue
+Parameters:  result: final AT_CMD_xxx result
+Return:        
+Others:      A failed command cancels the rest of its chain.
+             BMC81M001Response keeps the reply until the next
+             command is started
+**********************************************************/
+void BMC81M001::finishCommand(int result)
+{
+  ATCommand *c = &_queue[_queueHead];
+  int ticket = c->ticket;
+  uint8_t chain = c->chain;
+  ATCallback callback = c->callback;
+  uint8_t tries = c->tries;
+  _queueHead = (_queueHead + 1) % AT_QUEUE_SIZE;
+  _queueCount--;
+  recordResult(ticket,result);
+  if(_statsCallback != NULL && tries > 0) _statsCallback(AT_STAT_COMMAND,result,micros() - _cmdFirstUs,tries);
+  if(callback != NULL) callback(ticket,result);
+  if(result == AT_CMD_OK || chain == 0) return;
+  while(_queueCount > 0 && _queue[_queueHead].chain == chain)
+  {
+    c = &_queue[_queueHead];
+    ticket = c->ticket;
+    callback = c->callback;
+    _queueHead = (_queueHead + 1) % AT_QUEUE_SIZE;
+    _queueCount--;
+    recordResult(ticket,AT_CMD_CANCELED);
+    if(callback != NULL) callback(ticket,AT_CMD_CANCELED);
+  }
+}
+/**********************************************************
+Description: remember the result of a finished command
+Parameters:  ticket, result
+Return:        
+Others:      The last AT_QUEUE_SIZE results are kept
+**********************************************************/
+void BMC81M001::recordResult(int ticket,int result)
+{
+  _resultTicket[_resultIndex] = ticket;
+  _resultCode[_resultIndex] = result;
+  _resultIndex = (_resultIndex + 1) % AT_QUEUE_SIZE;
+}
+/**********************************************************
+Description: move received bytes from the serial port into the
+             receive ring buffer
+Parameters:         
+Return:      number of bytes moved
+Others:      Called by the driver itself while polling. Call it from
+             a timer interrupt or serialEvent() instead after
+             setRxPolling(false), so that bursts are taken out of
+             the small serial buffer while loop() is busy.
+             Bytes that do not fit are counted in rxOverruns().
+**********************************************************/
+int BMC81M001::serviceRx(void)
+{
+  /* only the bytes waiting now, a burst still arriving is left to
+     the next call instead of being pushed past the ring */
+  int count;
+  if(_serial != NULL)
+  {
+    count = _serial->available();
+    for(int i = 0; i < count; i++) _rx.push(_serial->read());
+  }
+  else
+  {
+    count = _softSerial->available();
+    for(int i = 0; i < count; i++) _rx.push(_softSerial->read());
+  }
+  _bytesReceived += count;
+  return count;
+}
+/**********************************************************
+Description: select who fills the receive ring buffer
+Parameters:  enable: true  - the driver calls serviceRx() itself (default)
+                     false - the sketch calls serviceRx() from an
+                             interrupt, the driver only reads the ring
+Return:        
+Others:      The ring has a single producer, never call serviceRx()
+             from two places at the same time
+**********************************************************/
+void BMC81M001::setRxPolling(bool enable)
+{
+  _rxPolling = enable;
+}
+/**********************************************************
+Description: restart overrun counting and the high watermark
+Parameters:         
+Return:        
+Others:        
+**********************************************************/
+void BMC81M001::resetRxStatistics(void)
+{
+  _rx.resetStatistics();
+  _responseOverruns = 0;
+  _framesDropped = 0;
+}
+/**********************************************************
+Description: read one byte from the module
+Parameters:         
+Return:      the byte, -1 if nothing is available
+Others:      bytes are taken from the receive ring buffer
+**********************************************************/
+int BMC81M001::readByte(void)
+{
+  if(_rxPolling) serviceRx();
+  return _rx.pop();
+}
+/**********************************************************
+Description: write raw bytes to the module
+Parameters:  data, length
+Return:        
+Others:        
+**********************************************************/
+void BMC81M001::writeRaw(const char *data,int length)
+{
+  _bytesSent += length;
+  if(_softSerial != NULL)
+  {
+    _softSerial->write((const uint8_t *)data,length);
+  }
+  else
+  {
+    _serial->write((const uint8_t *)data,length);
+  }
+}
+/**********************************************************
+Description: write pieces of a queued command
+Parameters:  c: queue entry
+             from, to: piece range
+Return:        
+Others:        
+**********************************************************/
+void BMC81M001::writePieces(ATCommand *c,uint8_t from,uint8_t to)
+{
+  for(uint8_t i = from; i < to; i++)
+  {
+    writeRaw(c->piece[i].text,c->piece[i].length);
+  }
+}
+/**********************************************************
+Description: read data from module ,Send data to parser
+Parameters:         
+Return:        
+Others:      1. every available byte is fed to the parser once
+             2. stops after the running command has finished so
+                that the following bytes stay in the serial buffer
+**********************************************************/
+void BMC81M001::readResponse(){
+  int temp;
+  int ticket = _queueCount > 0 ? _queue[_queueHead].ticket : 0;
+  while((temp = readByte()) >= 0)
+  {
+    uint8_t event = _parser.feed(temp);
+    if(event == AT_EVT_NONE) continue;
+    handleEvent(event);
+    if(ticket != 0 && (_queueCount == 0 || _queue[_queueHead].ticket != ticket)) break;
+  }
+}
+/**********************************************************
+Description: oldest received frame of a type
+Parameters:  type: AT_FRAME_IPD or AT_FRAME_MQTT
+Return:      index into _frames, -1 if there is none
+Others:        
+**********************************************************/
+int BMC81M001::findFrame(uint8_t type)
+{
+  for(uint8_t i = 0; i < _frameCount; i++)
+  {
+    if(_frames[i].type == type) return i;
+  }
+  return -1;
+}
+/**********************************************************
+Description: remove a frame the sketch has read
+Parameters:  i: index from findFrame()
+Return:        
+Others:      The later frames, and a frame still being received,
+             move down one entry so the order stays the same
+**********************************************************/
+void BMC81M001::dropFrame(int i)
+{
+  int last = _frameFilling ? _frameCount : _frameCount - 1;
+  for(; i < last; i++) _frames[i] = _frames[i + 1];
+  _frameCount--;
+}
+/**********************************************************
+Description: act on one parser event
+Parameters:  event: AT_EVT_xxx returned by ATParser::feed()
+Return:        
+Others:        
+**********************************************************/
+void BMC81M001::handleEvent(uint8_t event)
+{
+  bool running = _queueCount > 0 && _queue[_queueHead].tries > 0 && !_draining;
+  ATCommand *c = &_queue[_queueHead];
+  switch(event)
+  {
+    case AT_EVT_IPD:
+    case AT_EVT_MQTT_RECV:
+      _frameType = _parser.frameType();
+      _frameFilling = false;
+#if BMC81M001_USE_HTTP
+      if(_httpReceiving && _frameType == AT_FRAME_IPD) return;
+#endif
+      if(_frameCount >= AT_FRAME_QUEUE_SIZE)
+      {
+        /* the frames not read yet are kept, the new one is lost */
+        _framesDropped++;
+        return;
+      }
+      _frameFilling = true;
+      _frames[_frameCount].type = _frameType;
+      _frames[_frameCount].length = 0;
+      _frames[_frameCount].data[0] = '\0';
+#if BMC81M001_USE_MQTT
+      strncpy(_frames[_frameCount].topic,_parser.topic(),AT_LINE_MAX_LENGTH);
+      _frames[_frameCount].topic[AT_LINE_MAX_LENGTH] = '\0';
+#endif
+      if(_parser.frameLength() == 0)
+      {
+        _frameFilling = false;
+        _frameCount++;
+      }
+      return;
+    case AT_EVT_DATA:
+    case AT_EVT_DATA_END:
+#if BMC81M001_USE_HTTP
+      if(_httpReceiving && _frameType == AT_FRAME_IPD)
+      {
+        if(_http.feed(_parser.data()) == HTTP_EVT_BODY)
+        {
+          if(_jsonScanner != NULL) _jsonScanner->feed(_http.data());
+          if(resLength < AT_RESPONSE_MAX_LENGTH - 1)
+          {
+            BMC81M001Response[resLength++] = _parser.data();
+            BMC81M001Response[resLength] = '\0';
+          }
+          else
+          {
+            _responseOverruns++;
+          }
+        }
+        if(_pipelining && _http.isDone()) httpReplyDone();
+        return;
+      }
+#endif
+      if(!_frameFilling) return;
+      {
+        ATFrame *f = &_frames[_frameCount];
+        if(f->length < AT_FRAME_MAX_LENGTH)
+        {
+          f->data[f->length++] = _parser.data();
+          f->data[f->length] = '\0';
+        }
+        else
+        {
+          _responseOverruns++;
+        }
+        if(event == AT_EVT_DATA_END)
+        {
+          _frameFilling = false;
+          _frameCount++;
+          if(_eventCallback != NULL)
+            _eventCallback(_frameType == AT_FRAME_IPD ? AT_EVT_IPD : AT_EVT_MQTT_RECV,f->data,f->length);
+        }
+      }
+      return;
+    case AT_EVT_PROMPT:
+      if(running && c->payloadStart < c->pieceCount && !_waitPayloadAck)
+      {
+        writePieces(c,c->payloadStart,c->pieceCount);
+        clearResponse(BMC81M001Response);
+        _waitPayloadAck = true;
+      }
+      return;
+    case AT_EVT_WIFI_DISCONNECT:
+    case AT_EVT_CLOSED:
+    case AT_EVT_READY:
+#if BMC81M001_USE_HTTP
+      _linkOpen = false;   // the http connection is gone
+#endif
+      /* fall through */
+    case AT_EVT_WIFI_CONNECTED:
+    case AT_EVT_WIFI_GOT_IP:
+      if(_eventCallback != NULL) _eventCallback(event,_parser.line(),_parser.lineLength());
+      break;
+  }
+  if(!running) return;
+  appendResponse(_parser.line(),_parser.lineLength());
+  switch(event)
+  {
+    case AT_EVT_OK:
+    case AT_EVT_SEND_OK:
+      /* a payload command is acknowledged only after the payload went out */
+      if(c->payloadStart >= c->pieceCount || _waitPayloadAck) finishCommand(AT_CMD_OK);
+      break;
+    case AT_EVT_ERROR:
+    case AT_EVT_FAIL:
+    case AT_EVT_SEND_FAIL:
+      retryCommand(AT_CMD_ERROR);
+      break;
+  }
+}
+/**********************************************************
+Description: add one reply line to BMC81M001Response
+Parameters:  text, length: line without CR LF
+Return:        
+Others:      Lines that do not fit any more are dropped and
+             counted in responseOverruns()
+**********************************************************/
+void BMC81M001::appendResponse(const char *text,int length)
+{
+  if(resLength + length + 2 >= AT_RESPONSE_MAX_LENGTH)
+  {
+    _responseOverruns += length + 2;
+    return;
+  }
+  memcpy(&BMC81M001Response[resLength],text,length);
+  resLength += length;
+  BMC81M001Response[resLength++] = '\r';
+  BMC81M001Response[resLength++] = '\n';
+  BMC81M001Response[resLength] = '\0';
+}
+
+/**********************************************************
+Description: clear  data buffer
+Parameters:        
+Return:      
+Others:        
+**********************************************************/
+void BMC81M001::clearResponse(char Dbuffer[])
+{
+  memset(Dbuffer,'\0',AT_RESPONSE_MAX_LENGTH);
+  resLength = 0;
+}
@@ -0,0 +1,554 @@
+/*************************************************
+File:             BMC81M001.h
+Author:           BEST MODULES CORP.
+Description:      Define classes and required variables 
+version:          V1.1.0-2026-10-17
+**************************************************/
+#ifndef _BMC81M001_H_
+#define _BMC81M001_H_
+
+ 
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include "BMC81M001_config.h"
+
+#define BMC81M001_VERSION "1.1.0"
+
+#define BMC81M001_baudRate 115200
+#define SEND_SUCCESS 1
+#define SEND_FAIL 0
+#define  COMMUNICAT_ERROR -1
+#define  AT_ACK_ERROR -2
+//----------------------wifi status---------------------------
+#define  WIFI_STATUS_GOT_IP  2
+#define  WIFI_STATUS_CONNETED  3
+#define  WIFI_STATUS_DISCONNETED  4
+#define  WIFI_STATUS_NO_CONNET  5
+//----------------------wifi status---------------------------
+#define HTTP_GET_BEGIN_SUCCESS 0
+#define HTTP_GET_OP_SUCCESS 0
+#define HTTP_GET_URL_ERROR -1
+#define HTTP_GET_OP_TIMEOUT -2
+#define HTTP_GET_INCOMPLETE -3     // connection closed before the reply was complete
+#define HTTP_GET_BAD_REPLY -4      // reply is not HTTP
+//----------------------AT command engine---------------------------
+#define AT_CMD_PENDING     0
+#define AT_CMD_OK          1
+#define AT_CMD_ERROR      -3
+#define AT_CMD_TIMEOUT    -4
+#define AT_CMD_CANCELED   -5
+#define AT_CMD_QUEUE_FULL -6
+#define AT_CMD_UNKNOWN    -7
+#define AT_CMD_TOO_LONG   -8
+
+#ifndef AT_QUEUE_SIZE
+#define AT_QUEUE_SIZE 4            // commands that can wait in the queue, configMqtt() queues 4 at once
+#endif
+#ifndef AT_CMD_MAX_LENGTH
+#define AT_CMD_MAX_LENGTH 112      // bytes a queued command may copy (async calls):
+                                   // SSID (32) + password (64) + digits of connectToAPAsync()
+#endif
+#ifndef AT_CMD_MAX_PIECES
+#define AT_CMD_MAX_PIECES 8        // pieces of command line + payload
+#endif
+//----------------------AT response parser---------------------------
+#define AT_EVT_NONE             0
+#define AT_EVT_OK               1  // "OK", "+MQTTPUB:OK"
+#define AT_EVT_ERROR            2  // "ERROR"
+#define AT_EVT_FAIL             3  // "FAIL", "+MQTTPUB:FAIL"
+#define AT_EVT_SEND_OK          4  // "SEND OK"
+#define AT_EVT_SEND_FAIL        5  // "SEND FAIL"
+#define AT_EVT_PROMPT           6  // '>' data prompt
+#define AT_EVT_LINE             7  // any other information line
+#define AT_EVT_CWLAP            8  // "+CWLAP:(...)" scan row
+#define AT_EVT_WIFI_CONNECTED   9  // "WIFI CONNECTED"
+#define AT_EVT_WIFI_GOT_IP     10  // "WIFI GOT IP"
+#define AT_EVT_WIFI_DISCONNECT 11  // "WIFI DISCONNECT"
+#define AT_EVT_CLOSED          12  // "CLOSED", "<link>,CLOSED"
+#define AT_EVT_BUSY            13  // "busy p...", "busy s..."
+#define AT_EVT_READY           14  // "ready" after a reset
+#define AT_EVT_IPD             15  // "+IPD,<len>:" frame header
+#define AT_EVT_MQTT_RECV       16  // "+MQTTSUBRECV:<id>,\"<topic>\",<len>," header
+#define AT_EVT_DATA            17  // one payload byte of the current frame
+#define AT_EVT_DATA_END        18  // last payload byte of the current frame
+
+#define AT_FRAME_IPD   1
+#define AT_FRAME_MQTT  2
+
+#ifndef AT_LINE_MAX_LENGTH
+#define AT_LINE_MAX_LENGTH 128     // longer lines are truncated
+#endif
+#ifndef AT_FRAME_MAX_LENGTH
+#define AT_FRAME_MAX_LENGTH 256    // +IPD / +MQTTSUBRECV payload kept for the sketch
+#endif
+#ifndef AT_FRAME_QUEUE_SIZE
+#define AT_FRAME_QUEUE_SIZE 2      // frames kept until readIotData() / readDataTcp()
+#endif
+#ifndef AT_RX_BUFFER_SIZE
+#define AT_RX_BUFFER_SIZE 256      // bytes received but not parsed yet
+#endif
+
+#ifndef AT_HTTP_TIMEOUT
+#define AT_HTTP_TIMEOUT 5000       // ms to wait for an http reply
+#endif
+#ifndef HTTP_LINE_MAX_LENGTH
+#define HTTP_LINE_MAX_LENGTH 64    // status line / header kept for parsing
+#endif
+#ifndef HTTP_PIPELINE_DEPTH
+#define HTTP_PIPELINE_DEPTH 4      // requests http_getPipelined() sends at once
+#endif
+#ifndef HTTP_PIPELINE_BUFFER
+#define HTTP_PIPELINE_BUFFER 512   // request lines + Host headers of one batch
+#endif
+//----------------------http response parser---------------------------
+#define HTTP_EVT_NONE   0
+#define HTTP_EVT_BODY   1          // one body byte, see data()
+#define HTTP_EVT_DONE   2          // reply complete
+#define HTTP_EVT_ERROR  3          // status line is not HTTP
+//----------------------json field scanner---------------------------
+#ifndef JSON_MAX_FIELDS
+#define JSON_MAX_FIELDS 4          // keys one scanner can look for
+#endif
+#ifndef JSON_KEY_MAX_LENGTH
+#define JSON_KEY_MAX_LENGTH 16     // longer keys never match
+#endif
+
+#ifndef AT_RESPONSE_MAX_LENGTH
+#define AT_RESPONSE_MAX_LENGTH 512 // reply lines of one command or one http body,
+                                   // the rest is counted in responseOverruns()
+#endif
+
+/* Completion callback of a queued AT command: ticket returned by the
+   *Async() call and the final AT_CMD_xxx result */
+typedef void (*ATCallback)(int ticket, int result);
+
+/* Called for unsolicited module messages (WIFI DISCONNECT, CLOSED, ...)
+   and for every +IPD / +MQTTSUBRECV frame received completely */
+typedef void (*ATEventCallback)(uint8_t event, const char *data, int length);
+
+/* Called by http_getPipelined() once per reply, in request order,
+   with the index of the request, the status code and the body */
+typedef void (*HTTPReplyCallback)(uint8_t index,int status,const char *body,int length);
+
+/* What a statistics callback reports */
+#define AT_STAT_COMMAND 1          // a queued command finished, result is AT_CMD_xxx
+#define AT_STAT_HTTP    2          // http_get() returned, result is its return value
+
+/* Called once per finished operation with its result, the time from the
+   first try to the end in microseconds and the number of tries */
+typedef void (*ATStatsCallback)(uint8_t kind, int result, unsigned long us, uint8_t tries);
+
+/* Streaming parser of the module output. feed() handles one byte at a
+   time and returns an AT_EVT_xxx code once a line, a prompt or a payload
+   byte is complete, so no received data is ever scanned twice. */
+class ATParser
+{
+  public:
+      ATParser();
+      void reset(void);
+      uint8_t feed(uint8_t c);
+      const char *line(void) { return _line; }
+      int lineLength(void) { return _lineLength; }
+      const char *topic(void) { return _topic; }
+      int frameLength(void) { return _frameLength; }
+      uint8_t frameType(void) { return _frameType; }
+      uint8_t data(void) { return _data; }
+  private:
+      uint8_t classifyLine(void);
+      uint8_t beginFrame(uint8_t type);
+      bool lineIs(const char *text);
+      char _line[AT_LINE_MAX_LENGTH + 1];
+      int _lineLength;
+      bool _lineDone;
+      uint8_t _state;
+      uint8_t _commas;
+      bool _quoted;
+      const char *_topic;
+      int _frameLength;
+      int _remain;
+      uint8_t _frameType;
+      uint8_t _data;
+};
+
+#if BMC81M001_USE_HTTP
+/* Streaming parser of one HTTP/1.1 reply. Reads the status line and
+   the Content-Length / Transfer-Encoding headers, passes the body
+   through byte by byte (chunk framing removed) and reports the end of
+   the reply as soon as the last byte has arrived. A reply without
+   length ends when the connection is closed (bodyUntilClose()). */
+class HTTPParser
+{
+  public:
+      HTTPParser();
+      void reset(void);
+      uint8_t feed(uint8_t c);
+      uint8_t data(void) { return _data; }
+      int statusCode(void) { return _status; }
+      long contentLength(void) { return _contentLength; }
+      bool isDone(void);
+      bool bodyUntilClose(void);
+  private:
+      void headerLine(void);
+      uint8_t endOfHeaders(void);
+      char _line[HTTP_LINE_MAX_LENGTH + 1];
+      uint8_t _lineLength;
+      uint8_t _state;
+      int _status;
+      long _contentLength;
+      long _remain;
+      bool _chunked;
+      uint8_t _data;
+};
+#endif // BMC81M001_USE_HTTP
+
+/* Incremental JSON tokenizer that copies the values of a few keys
+   into buffers given by the sketch while the bytes arrive. Only the
+   key being read is kept, so the document is never stored. Text
+   before the first '{' or '[' and after the closing bracket is
+   skipped, as is a broken document before any key was found (e.g. a
+   PHP notice printed ahead of the reply). The first occurrence of a key at any depth is taken;
+   string, number, true/false/null values are copied as text and
+   truncated to the buffer. */
+class JSONScanner
+{
+  public:
+      JSONScanner();
+      bool addField(const char *key,char *value,uint8_t size);
+      void reset(void);
+      void feed(uint8_t c);
+      void feed(const char *text,int length);
+      bool found(const char *key);
+      bool isComplete(void);
+      bool isError(void);
+  private:
+      void structural(uint8_t c);
+      void endKey(void);
+      void store(uint8_t c);
+      void endValue(void);
+      void fail(void);
+      const char *_key[JSON_MAX_FIELDS];
+      char *_value[JSON_MAX_FIELDS];
+      uint8_t _size[JSON_MAX_FIELDS];
+      uint8_t _length[JSON_MAX_FIELDS];
+      uint8_t _fieldCount;
+      uint8_t _foundMask;
+      char _name[JSON_KEY_MAX_LENGTH + 1];
+      uint8_t _nameLength;
+      uint8_t _state;
+      uint8_t _depth;
+      uint32_t _objects;          // bit n set: container at depth n+1 is an object
+      bool _readingKey;
+      bool _expectKey;
+      bool _afterValue;           // only , } ] may follow
+      int8_t _target;             // field receiving the current value, -1 none
+      uint8_t _skip;              // \uXXXX digits still to skip
+};
+
+/* Fixed size single producer / single consumer byte ring. push() and
+   pop() may run in different contexts (e.g. a UART RX interrupt and
+   loop()) without locking, as long as each side has only one caller.
+   A full ring drops the new byte and counts it as an overrun; the
+   high watermark is the largest fill level seen, so SIZE can be chosen
+   from measurements instead of guessing. */
+template <uint16_t SIZE>
+class ATRingBuffer
+{
+  public:
+      ATRingBuffer() : _head(0), _tail(0), _overruns(0), _highWatermark(0) {}
+      bool push(uint8_t c)
+      {
+        uint16_t head = _head;
+        uint16_t next = head + 1 == SIZE + 1 ? 0 : head + 1;
+        if(next == _tail)
+        {
+          _overruns++;
+          return false;
+        }
+        _buffer[head] = c;
+        _head = next;
+        uint16_t used = available();
+        if(used > _highWatermark) _highWatermark = used;
+        return true;
+      }
+      int pop(void)
+      {
+        uint16_t tail = _tail;
+        if(tail == _head) return -1;
+        uint8_t c = _buffer[tail];
+        _tail = tail + 1 == SIZE + 1 ? 0 : tail + 1;
+        return c;
+      }
+      uint16_t available(void)
+      {
+        uint16_t head = _head;
+        uint16_t tail = _tail;
+        return head >= tail ? head - tail : SIZE + 1 - tail + head;
+      }
+      uint16_t capacity(void) { return SIZE; }
+      uint32_t overruns(void) { return _overruns; }
+      uint16_t highWatermark(void) { return _highWatermark; }
+      void resetStatistics(void) { _overruns = 0; _highWatermark = available(); }
+  private:
+      uint8_t _buffer[SIZE + 1];    // one slot stays empty to tell full from empty
+      volatile uint16_t _head;      // written by the producer only
+      volatile uint16_t _tail;      // written by the consumer only
+      volatile uint32_t _overruns;
+      volatile uint16_t _highWatermark;
+};
+
+/* One piece of a command line or payload, written without copying */
+typedef struct
+{
+  const char *text;
+  uint16_t length;
+} ATPiece;
+
+/* One received +IPD / +MQTTSUBRECV frame waiting for the sketch */
+typedef struct
+{
+  uint8_t type;                   // AT_FRAME_IPD or AT_FRAME_MQTT
+  int length;
+  char data[AT_FRAME_MAX_LENGTH + 1];
+#if BMC81M001_USE_MQTT
+  char topic[AT_LINE_MAX_LENGTH + 1];
+#endif
+} ATFrame;
+
+/* String literal piece, its length is known at compile time */
+#define AT_TEXT(s) s, (sizeof(s) - 1)
+
+/* One entry of the AT command queue */
+typedef struct
+{
+  char text[AT_CMD_MAX_LENGTH];   // copies of pieces that are not kept
+  uint16_t textLength;
+  ATPiece piece[AT_CMD_MAX_PIECES];
+  uint8_t pieceCount;
+  uint8_t payloadStart;       // pieces from here on follow the '>' prompt
+  int timeout;
+  uint8_t reTry;
+  uint8_t tries;
+  uint8_t chain;              // commands of one chain are canceled together
+  int ticket;
+  ATCallback callback;
+} ATCommand;
+
+/*! Subclassing Print makes debugging easier -- output en route to ESP8266 module
+ * can be duplicated on a second stream (e.g. Serial). !*/
+class BMC81M001 
+{
+  public:
+      BMC81M001( HardwareSerial *theSerial = &Serial);
+      BMC81M001(uint16_t rxPin,uint16_t txPin);
+      void begin(uint32_t baud = BMC81M001_baudRate);  
+      bool setBaudRate(uint32_t baud);
+      bool connectToAP(String ssid,String pass);
+      bool connectToAP(const char *ssid,const char *pass);
+#if BMC81M001_USE_TCP
+      bool connectTCP(String ip,  int port);
+      bool connectTCP(const char *ip,int port);
+      bool writeDataTcp(int Dlength,char Dbuffer[]);
+      bool writeDataTcp(const char *Dbuffer,int Dlength);
+      String readDataTcp();
+#endif
+#if BMC81M001_USE_MQTT
+      bool configMqtt(String clientid,String username,String password,String mqtt_host,int server_port);
+      bool configMqtt(const char *clientid,const char *username,const char *password,const char *mqtt_host,int server_port);
+      bool setPublishTopic(String publishtopic);
+      bool setPublishTopic(const char *publishtopic);
+      bool setSubscribetopic(String subscribetopic);
+      bool setSubscribetopic(const char *subscribetopic);
+      bool setTopic(String topic);
+      bool setTopic(const char *topic);
+      bool writeString(String Dbuffer,String topic);
+      bool writeString(const char *Dbuffer,const char *topic);
+      bool writeString(const char *Dbuffer,int Dlength,const char *topic,int topicLength);
+      bool writeBytes(char Dbuffer[],int Dlength,String topic);
+      bool writeBytes(const char *Dbuffer,int Dlength,const char *topic);
+      void readIotData(String *ReciveBuff,int *ReciveBufflen,String *topic);
+#endif
+      bool reset(void);
+      int  sendATCommand(String StringstrCmd,int timeout,uint8_t reTry);
+      int  sendATCommand(const char *strCmd,int timeout,uint8_t reTry);
+      //----------------------AT command engine----------------------------
+      int  sendATCommandAsync(String StringstrCmd,int timeout,uint8_t reTry,ATCallback callback=NULL);
+      int  sendATCommandAsync(const char *strCmd,int timeout,uint8_t reTry,ATCallback callback=NULL);
+      int  connectToAPAsync(String ssid,String pass,ATCallback callback=NULL);
+      int  connectToAPAsync(const char *ssid,const char *pass,ATCallback callback=NULL);
+#if BMC81M001_USE_MQTT
+      int  configMqttAsync(String clientid,String username,String password,String mqtt_host,int server_port,ATCallback callback=NULL);
+      int  configMqttAsync(const char *clientid,const char *username,const char *password,const char *mqtt_host,int server_port,ATCallback callback=NULL);
+      int  writeStringAsync(String Dbuffer,String topic,ATCallback callback=NULL);
+      int  writeStringAsync(const char *Dbuffer,const char *topic,ATCallback callback=NULL);
+#endif
+      int  poll(void);
+      int  commandStatus(int ticket);
+      int  waitCommand(int ticket);
+      bool isIdle(void);
+      void setEventCallback(ATEventCallback callback);
+      void setStatsCallback(ATStatsCallback callback);
+      //----------------------receive buffer-------------------------------
+      int  serviceRx(void);
+      void setRxPolling(bool enable);
+      uint16_t rxBufferSize(void) { return _rx.capacity(); }
+      uint16_t rxHighWatermark(void) { return _rx.highWatermark(); }
+      uint32_t rxOverruns(void) { return _rx.overruns(); }
+      uint32_t responseOverruns(void) { return _responseOverruns; }
+      uint32_t framesDropped(void) { return _framesDropped; }
+      void resetRxStatistics(void);
+      //----------------------traffic counters-----------------------------
+      uint32_t bytesSent(void) { return _bytesSent; }
+      uint32_t bytesReceived(void) { return _bytesReceived; }
+      void resetTrafficCounters(void) { _bytesSent = 0; _bytesReceived = 0; }
+      //-------------------------------------------------------------------
+      String sendATCmd(String StringstrCmd,int timeout,uint8_t reTry);
+      int getStatus();
+      String getIP();
+      String getMacAddress();
+      String getATVersion();
+#if BMC81M001_USE_AP
+      String SSID();
+      String getSSID();
+      String getGateway();
+      String getMask();
+#endif
+      //-------------------------------------------------------------------
+#if BMC81M001_USE_HTTP
+      int http_begin(String serverURL,int port,String subURL="");
+      int http_get(void);
+      String http_getString(void);
+      void http_end(void);
+      int  http_statusCode(void) { return _http.statusCode(); }
+      void http_setJsonScanner(JSONScanner *scanner);
+      void http_setKeepAlive(bool enable);
+      void http_close(void);
+#if BMC81M001_USE_HTTP_PIPELINE
+      bool http_addRequest(String subURL);
+      bool http_addRequest(const char *subURL);
+      int  http_getPipelined(HTTPReplyCallback callback);
+#endif
+#endif
+
+
+      char BMC81M001Response[AT_RESPONSE_MAX_LENGTH];
+      int resLength = 0;
+
+      String  OneNetReciveBuff;
+  private:
+      uint16_t _rxPin;
+      uint16_t _txPin;
+      void readResponse(void);
+#if BMC81M001_USE_HTTP
+      int  httpConnect(void);
+      void finishHttp(void);
+      int  httpSendRequest(void);
+#if BMC81M001_USE_HTTP_PIPELINE
+      int  httpSendPipeline(void);
+#endif
+      int  httpReceive(void);
+      bool httpReplied(void);
+      void httpReplyDone(void);
+#endif
+      void handleEvent(uint8_t event);
+      int  findFrame(uint8_t type);
+      void dropFrame(int i);
+      void appendResponse(const char *text,int length);
+      void clearResponse(char Debugbuffer[]);
+      //AT command engine----------------
+      ATCommand *beginCommand(int timeout,uint8_t reTry,ATCallback callback);
+      bool addPiece(ATCommand *c,const char *text,int length,bool keep);
+      bool addNumber(ATCommand *c,long value);
+      bool beginPayload(ATCommand *c);
+      int  commitCommand(ATCommand *c,bool ok);
+      void writePieces(ATCommand *c,uint8_t from,uint8_t to);
+      int  queueConnectToAP(const char *ssid,const char *pass,ATCallback callback,bool keep);
+#if BMC81M001_USE_MQTT
+      int  queueConfigMqtt(const char *clientid,const char *username,const char *password,const char *mqtt_host,int server_port,ATCallback callback,bool keep);
+      int  queueWriteString(const char *Dbuffer,int Dlength,const char *topic,int topicLength,ATCallback callback,bool keep);
+#endif
+      bool beginChain(uint8_t count);
+      int  endChain(int ticket);
+      void startCommand(void);
+      void retryCommand(int result);
+      void finishCommand(int result);
+      void recordResult(int ticket,int result);
+      int  readByte(void);
+      void writeRaw(const char *data,int length);
+      ATCommand _queue[AT_QUEUE_SIZE];
+      uint8_t _queueHead = 0;
+      uint8_t _queueCount = 0;
+      bool _waitPayloadAck = false;
+      bool _draining = false;
+      unsigned long _cmdStart;
+      int _nextTicket = 1;
+      uint8_t _chain = 0;
+      uint8_t _nextChain = 1;
+      int _resultTicket[AT_QUEUE_SIZE] = {0};
+      int8_t _resultCode[AT_QUEUE_SIZE] = {0};
+      uint8_t _resultIndex = 0;
+      //AT response parser--------------
+      ATParser _parser;
+      ATEventCallback _eventCallback = NULL;
+      ATStatsCallback _statsCallback = NULL;
+      unsigned long _cmdFirstUs;
+      ATFrame _frames[AT_FRAME_QUEUE_SIZE];  // complete frames first, oldest at 0
+      uint8_t _frameCount = 0;        // complete frames
+      bool _frameFilling = false;     // _frames[_frameCount] is being received
+      uint8_t _frameType = 0;         // type of the frame being received
+      uint32_t _framesDropped = 0;    // frames refused because the queue was full
+      //receive buffer------------------
+      ATRingBuffer<AT_RX_BUFFER_SIZE> _rx;
+      bool _rxPolling = true;
+      uint32_t _responseOverruns = 0;
+      uint32_t _bytesSent = 0;        // bytes written to the module
+      uint32_t _bytesReceived = 0;    // bytes taken from the serial port
+      HardwareSerial *_serial = NULL;
+      SoftwareSerial *_softSerial = NULL ;
+#if BMC81M001_USE_HTTP
+      //http get------------------------
+      String _host="Host: ";
+      int _port;
+      String _type;
+      String _url;
+      String _suburl;
+      int _len;
+      bool _keepAlive = false;
+      bool _linkOpen = false;
+      String _linkUrl;
+      int _linkPort = 0;
+      bool _httpReceiving = false;
+      HTTPParser _http;
+      JSONScanner *_jsonScanner = NULL;
+      //http pipelining-----------------
+      uint8_t _pipeCount = 0;         // requests added
+      uint8_t _pipeDone = 0;          // replies received
+      bool _pipelining = false;
+#if BMC81M001_USE_HTTP_PIPELINE
+      char _pipeRequest[HTTP_PIPELINE_BUFFER];
+      uint16_t _pipeOffset[HTTP_PIPELINE_DEPTH + 1] = {0};   // start of each request
+      HTTPReplyCallback _pipeCallback = NULL;
+#endif
+#endif
+      //--------------------------------
+};
+
+enum
+{
+  
+  RST_Fail=1,
+  Init_Fail,
+  Station_Fail,
+  WIFI_CONNECTED_Fail,
+  TCP_CONNECTED_Fail,
+  TCP_Senddata_Fail,
+
+  MQTTSNTP_FAIL= 10,
+  MQTTUSERCFG_Fail,
+  MQTTCLIENTID_Fail,
+  MQTTUSERNAME_Fail,
+  MQTTPASSWORD_Fail,
+  MQTTConnect_Fail,
+  MQTTTopic_Fail
+};
+
+#endif // _BMC81M001_H_
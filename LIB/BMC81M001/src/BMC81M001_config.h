@@ -0,0 +1,37 @@
+/*************************************************
+File:             BMC81M001_config.h
+Author:           BEST MODULES CORP.
+Description:      Compile-time selection of the driver subsystems
+version:          V1.1.1-2026-10-17
+**************************************************/
+#ifndef _BMC81M001_CONFIG_H_
+#define _BMC81M001_CONFIG_H_
+
+/* Set a subsystem to 0 to remove its methods, its member variables
+   and its part of the receive path from the firmware. The value must
+   be the same for the sketch and for BMC81M001.cpp, so change it here
+   or with a compiler flag (e.g. -DBMC81M001_USE_HTTP=0), not with a
+   #define in the sketch. The core (begin, reset, connectToAP, AT
+   command engine, getStatus, getIP, getMacAddress) is always built. */
+
+#ifndef BMC81M001_USE_HTTP
+#define BMC81M001_USE_HTTP 1       // http_begin() .. http_close(), HTTPParser
+#endif
+
+#ifndef BMC81M001_USE_MQTT
+#define BMC81M001_USE_MQTT 1       // configMqtt(), setTopic(), writeString(), writeBytes(), readIotData()
+#endif
+
+#ifndef BMC81M001_USE_TCP
+#define BMC81M001_USE_TCP 1        // connectTCP(), writeDataTcp(), readDataTcp()
+#endif
+
+#ifndef BMC81M001_USE_HTTP_PIPELINE
+#define BMC81M001_USE_HTTP_PIPELINE 0  // http_addRequest(), http_getPipelined(), needs BMC81M001_USE_HTTP
+#endif
+
+#ifndef BMC81M001_USE_AP
+#define BMC81M001_USE_AP 1         // access point scan and details: SSID(), getSSID(), getGateway(), getMask()
+#endif
+
+#endif // _BMC81M001_CONFIG_H_
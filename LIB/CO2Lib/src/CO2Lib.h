@@ -0,0 +1,559 @@
+/*
+ * 檔案名稱：CO2Lib.h
+ * 程式語言：Arduino C/C++
+ * 檔案類型：標頭檔（Header File）- 二氧化碳感測器驅動程式庫
+ * 
+ * ========================================
+ * 程式功能完整解說
+ * ========================================
+ * 
+ * 【檔案概述】
+ *   本檔案為 BM25S3321-1 二氧化碳（CO2）感測模組的驅動程式庫，
+ *   提供完整的感測器初始化、預熱程序、量程設定、濃度讀取等功能。
+ *   透過 UART 序列通訊介面，可精確讀取環境中的二氧化碳濃度，
+ *   適用於室內空氣品質監測、通風控制、智慧農業、溫室種植等應用場景。
+ * 
+ * 【硬體規格】
+ *   - 感測器模組：BM25S3321-1 CO2 感測模組
+ *   - 感測原理：NDIR（非分散式紅外線）技術
+ *   - 通訊介面：UART（通用非同步收發傳輸器）
+ *   - 通訊速率：9600 bps（固定）
+ *   - 量測範圍：0～2000 ppm 或 0～5000 ppm（可設定）
+ *   - 工作電壓：3.3V 或 5V（依模組規格）
+ *   - 狀態腳位：提供模組狀態指示（熱機中、量測中、就緒）
+ * 
+ * 【NDIR 感測原理說明】
+ *   NDIR（Non-Dispersive Infrared，非分散式紅外線）是常見的 CO2 感測技術：
+ *   
+ *   1. 紅外線光源發射特定波長的紅外光（CO2 分子會吸收 4.26 μm 波長）
+ *   2. 紅外光穿過氣體樣本到達接收器
+ *   3. CO2 濃度越高，吸收的紅外光越多，接收到的光強度越低
+ *   4. 透過檢測光強度的衰減量，計算出 CO2 濃度
+ *   
+ *   優點：精度高、穩定性好、使用壽命長
+ *   缺點：需要預熱時間（約 60 秒）以穩定光源
+ * 
+ * 【主要功能】
+ * 
+ *   一、感測器初始化（initCO2）
+ *       - 啟動 UART 通訊（9600 bps）
+ *       - 記錄開機時間，預熱（約 60 秒）在背景進行，立即返回
+ *       - WiFi、OLED、MQTT 等初始化不必再等待預熱
+ *
+ *   二、背景狀態機（pollCO2，於 loop() 或週期任務中呼叫）
+ *       - 預熱時間到達後設定量測範圍（2000 ppm 或 5000 ppm）
+ *       - 每 CO2_READ_INTERVAL 毫秒送出一次查詢指令，不等待回應
+ *       - 之後每次呼叫只取出已到達的位元組，收滿一個封包才解析
+ *       - 回應逾時或校驗錯誤時放棄本次讀取，保留上一次的數值
+ *
+ *   三、濃度讀取（readCO2、co2Status）
+ *       - readCO2() 直接回傳最近一次有效的 ppm 值，不會阻塞
+ *       - co2Status() 區分「熱機中」、「有效」、「過舊」三種狀態
+ *       - 可選的零點校正功能（預熱完成後才可執行）
+ * 
+ * 【UART 通訊說明】
+ *   UART（Universal Asynchronous Receiver/Transmitter）是非同步序列通訊：
+ *   
+ *   - 使用兩條線：TX（發送）、RX（接收）
+ *   - 通訊速率固定為 9600 bps（位元/秒）
+ *   - 數據格式：通常為 8 個數據位元、1 個停止位元、無奇偶校驗
+ *   - 感測器回傳固定格式的封包，需進行解析
+ * 
+ * 【運作流程】
+ * 
+ *   初始化階段（initCO2）：
+ *       1. 呼叫 CO2.begin() 初始化 UART 通訊
+ *       2. 記錄開機時間，狀態設為 CO2_WARMING 後立即返回
+ *          - 不再呼叫 CO2.preheatCountdown()（會阻塞約 60 秒）
+ *
+ *   背景狀態機（pollCO2）：
+ *
+ *       CO2_WARMING ──預熱時間到，設定量程──> CO2_IDLE
+ *       CO2_IDLE ──讀取間隔到，送出查詢──> CO2_WAIT_REPLY
+ *       CO2_WAIT_REPLY ──收到完整封包或逾時──> CO2_IDLE
+ *
+ *       1. 熱機中：只檢查時間，不使用 UART
+ *       2. 熱機完成：呼叫 CO2.setRangeMax() 設定量程（只執行一次）
+ *       3. 送出查詢：清除接收緩衝區殘留資料，寫出 4 bytes 查詢指令
+ *       4. 等待回應：每次呼叫取出已到達的位元組（9600 bps 約 1 byte/ms）
+ *       5. 收滿 8 bytes：驗證表頭與校驗碼，更新 CO2Value 與讀取時間
+ *
+ *   濃度讀取階段（readCO2）：
+ *       1. 回傳最近一次有效的 CO2Value（單位：ppm）
+ *       2. 熱機中或尚未讀到時回傳 0，請以 co2Status() 判斷
+ * 
+ * 【量程設定說明】
+ *   setRangeMax() 函式用於設定 CO2 最大量測範圍：
+ *   
+ *   - 2000 ppm：適合室內空調環境、辦公室、住宅
+ *               量程較小，精度相對較高
+ *   
+ *   - 5000 ppm：適合一般室內環境、教室、會議室
+ *               量程較大，可應對較高濃度情況
+ *   
+ *   CO2 濃度標準參考：
+ *   - 350～450 ppm：戶外新鮮空氣
+ *   - 400～1000 ppm：室內空氣品質良好
+ *   - 1000～1500 ppm：空氣品質下降，需通風
+ *   - 1500～2000 ppm：空氣品質不良，建議立即通風
+ *   - > 2000 ppm：空氣品質極差，可能引起頭痛、嗜睡
+ * 
+ * 【全域變數說明】
+ *   - STA_PIN：狀態腳位編號（22），用於連接感測器狀態輸出腳
+ *   - CO2_SERIAL：連接感測器的序列埠（預設 Serial1，可在引入前重新定義）
+ *   - CO2Value：最近一次有效的 CO2 濃度值（單位：ppm，型態 uint16_t）
+ *   - CO2：BM25S3321_1 類別物件，用於初始化與量程設定
+ *   - co2State：背景狀態機目前的狀態（CO2_WARMING ...）
+ *   - co2ReadAt：最近一次有效讀取的 millis()
+ *   - co2Errors：回應逾時或校驗錯誤的次數
+ * 
+ * 【相依函式庫】
+ *   - BM25S3321-1.h：BM25S3321-1 CO2 感測器底層驅動函式庫
+ * 
+ * 【硬體接線說明】
+ *   以 BMduino-UNO 為例（使用 Serial1）：
+ *   
+ *   CO2 模組    →    BMduino-UNO
+ *   ---------------------------------
+ *   VCC         →    5V 或 3.3V
+ *   GND         →    GND
+ *   TX（發送）  →    RX1（D1）← 注意：模組 TX 接開發板 RX
+ *   RX（接收）  →    TX1（D0）← 注意：模組 RX 接開發板 TX
+ *   STA（狀態） →    D22（GPIO 22）
+ * 
+ *   若使用其他序列埠（Serial2、Serial3、Serial4）：
+ *   - Serial2：RX2（D17）、TX2（D16）
+ *   - Serial3：RX3（D15）、TX3（D14）
+ *   - Serial4：RX4（D19）、TX4（D18）
+ * 
+ * 【注意事項】
+ *   1. 預熱程序非常重要：
+ *      - 若不進行預熱，初期數據會「偏低」或「跳動」
+ *      - 預熱時間約 60 秒，期間 co2Status() 為 CO2_STATUS_WARMING，
+ *        pollCO2() 不會送出查詢，readCO2() 回傳 0
+ *      - 預熱在背景計時，不會阻塞程式；其他模組可同時初始化
+ *      - 計時從 initCO2() 開始，請在 setup() 一開始就呼叫
+ * 
+ *   2. 零點校正：
+ *      - 必須在純淨戶外空氣（約 400 ppm CO2）條件下進行
+ *      - 若誤按校正，感測器量測可能嚴重偏差
+ *      - 預設為註解狀態，非必要請勿啟用
+ * 
+ *   3. 讀取頻率：
+ *      - 查詢間隔由 CO2_READ_INTERVAL 決定（預設 2 秒），不需要再 delay()
+ *      - 過於頻繁讀取可能影響感測器精度與壽命
+ *      - pollCO2() 本身很快，建議每 10～100 毫秒呼叫一次，
+ *        呼叫間隔越長，回應在緩衝區停留越久（緩衝區須容納 8 bytes）
+ * 
+ *   4. 電源供應：
+ *      - 確保電源穩定，波動可能影響讀數準確性
+ *      - CO2 感測器功耗較高，建議使用外部電源
+ * 
+ *   5. 環境影響：
+ *      - 溫度和氣壓變化會影響 CO2 讀數
+ *      - 避免安裝在通風口或陽光直射處
+ * 
+ * 【使用範例】
+ * 
+ *   #include "CO2Lib.h"
+ *   
+ *   void setup() {
+ *       Serial.begin(9600);      // 電腦監控用
+ *       initCO2();               // 初始化 CO2 感測器（立即返回，背景預熱）
+ *       // 接著初始化 WiFi、OLED、MQTT ...，不必等待預熱
+ *   }
+ *
+ *   void loop() {
+ *       pollCO2();               // 推進背景狀態機，不會阻塞
+ *
+ *       // 根據濃度進行通風控制（只使用有效的讀值）
+ *       if (co2Status() == CO2_STATUS_VALID) {
+ *           if (readCO2() > 1500) {
+ *               digitalWrite(FAN_PIN, HIGH);  // 開啟風扇
+ *           } else if (readCO2() < 1000) {
+ *               digitalWrite(FAN_PIN, LOW);   // 關閉風扇
+ *           }
+ *       }
+ *
+ *       // 其他工作（網路、顯示）照常執行，不需要 delay()
+ *   }
+ *
+ *   使用 TaskLib.h 時，也可登錄為週期任務：
+ *       taskAddPeriodic("co2", pollCO2, 50, 20);
+ *
+ * 【版本資訊】
+ *   最後修改日期：2026年10月17日（預熱與查詢改為背景狀態機）
+ *   適用專案：二氧化碳濃度監測相關應用
+ */
+
+/*
+ * 二氧化碳偵測模組（BMCOM）BME58M332 獨立模組
+ * 
+ * ************************************************
+ * 原始檔案名稱：readCO2Concentration.ino
+ * 功能描述：讀取二氧化碳濃度（CO2 concentration），單位為 ppm
+ * 適用硬體：BM25S3321-1 CO2 感測模組搭配 BMduino-UNO
+ * 
+ * 【程式功能摘要】
+ * 模組 / 函式                功能說明
+ * -----------------------------------------------------------
+ * BM25S3321-1.h      CO2 感測器函式庫，負責 UART 封包解析
+ * CO2.begin()        初始化 UART / 感測模組
+ * preheatCountdown() 必要的預熱程序（約 60 秒）
+ * setRangeMax()      設定 CO2 最大量測範圍（2000 / 5000 ppm）
+ * readCO2Value()     回傳解析後的 CO2 濃度（ppm）
+ * ************************************************
+ */
+
+#ifndef _CO2LIB_H_
+#define _CO2LIB_H_
+
+#include <Arduino.h>
+
+// ================================================================
+// =============== 外部函式庫引入區 ===============================
+// ================================================================
+
+// 匯入 BestModules 官方的 BM25S3321-1 CO2 感測器函式庫
+// 此模組以 UART（序列埠）方式回傳 CO2 濃度值
+// UART 速度固定為 9600 bps，回傳資料為已封裝好的協議格式
+#include <BM25S3321-1.h>
+
+// ================================================================
+// =============== 全域變數與巨集定義區 ===========================
+// ================================================================
+
+/*
+ * 巨集名稱：STA_PIN
+ * 功能說明：定義感測器狀態腳位的 GPIO 編號
+ * 用途：連接 CO2 模組的 STA 腳位，用於讀取模組狀態
+ *       （例如：預熱中、量測中、就緒狀態）
+ * 數值：22（BMduino-UNO 的 D22 腳位）
+ * 注意：可根據實際接線修改此腳位編號
+ */
+#define STA_PIN 22  
+
+/*
+ * 背景狀態機設定
+ *   CO2_SERIAL        ：連接感測器的硬體序列埠，須與建立 CO2 物件時相同
+ *   CO2_PREHEAT_TIME  ：預熱時間（毫秒），與 preheatCountdown() 相同約 60 秒
+ *   CO2_READ_INTERVAL ：兩次查詢的間隔（毫秒）
+ *   CO2_REPLY_TIMEOUT ：送出查詢後等待回應的最長時間（毫秒）
+ *   CO2_STALE_TIME    ：超過此時間沒有有效讀值，co2Status() 回報過舊
+ *   CO2_RANGE_MAX     ：預熱完成後設定的量程（2000 或 5000 ppm）
+ */
+#ifndef CO2_SERIAL
+#define CO2_SERIAL Serial1
+#endif
+#define CO2_PREHEAT_TIME 60000UL
+#define CO2_READ_INTERVAL 2000
+#define CO2_REPLY_TIMEOUT 500
+#define CO2_STALE_TIME 10000
+#define CO2_RANGE_MAX 5000
+
+/*
+ * 查詢與回應封包（與 readCO2Value() 使用的格式相同）
+ *   查詢：11 01 01 ED
+ *   回應：16 05 01 DF1 DF2 DF3 DF4 CS，CO2 = DF1 * 256 + DF2
+ *   校驗碼：封包所有位元組相加的低 8 位元為 0
+ */
+#define CO2_FRAME_HEAD 0x16
+#define CO2_FRAME_LEN 8
+
+// 背景狀態機的狀態
+#define CO2_WARMING    0           // 預熱中，不使用 UART
+#define CO2_IDLE       1           // 等待下一次查詢
+#define CO2_WAIT_REPLY 2           // 已送出查詢，等待回應
+
+// co2Status() 回報的讀值狀態
+#define CO2_STATUS_WARMING 0       // 預熱中或尚未讀到第一筆，CO2Value 無效
+#define CO2_STATUS_VALID   1       // CO2Value 為 CO2_STALE_TIME 內的有效讀值
+#define CO2_STATUS_STALE   2       // 曾經讀到，但最近 CO2_STALE_TIME 都沒有成功
+
+/*
+ * 軟體序列埠（SoftwareSerial）接線定義
+ * 若使用 SoftwareSerial，可取消註解下列腳位定義
+ * 注意：SoftwareSerial 會佔用較多 CPU 資源，建議優先使用硬體序列埠
+ */
+// #define RX_PIN 2   // CO2 Sensor → Arduino（資料輸入腳）
+// #define TX_PIN 3   // Arduino → CO2 Sensor（資料輸出腳）
+
+/*
+ * 變數名稱：CO2Value
+ * 資料型態：uint16_t（無號 16 位元整數，範圍 0～65535）
+ * 功能說明：儲存最近一次有效的 CO2 濃度值（由 pollCO2() 更新）
+ * 單位：ppm（百萬分之一）
+ * 量程範圍：0～2000 ppm 或 0～5000 ppm（依設定而定）
+ */
+uint16_t CO2Value = 0;
+
+/*
+ * 背景狀態機的變數（只由 initCO2()、pollCO2() 修改）
+ */
+uint8_t co2State = CO2_WARMING;         // 目前狀態
+unsigned long co2StartAt = 0;           // initCO2() 的 millis()，預熱由此起算
+unsigned long co2QueryAt = 0;           // 最近一次送出查詢的 millis()
+unsigned long co2ReadAt = 0;            // 最近一次有效讀取的 millis()
+bool co2HasValue = false;               // 是否曾經讀到有效值
+uint8_t co2Rx[CO2_FRAME_LEN];           // 接收中的回應封包
+uint8_t co2RxLen = 0;                   // 已收到的位元組數
+uint32_t co2Errors = 0;                 // 回應逾時或校驗錯誤的次數
+
+// ================================================================
+// =============== 感測元件物件實例化區 ===========================
+// ================================================================
+
+/*-------------------------------------------------------------
+   建立 CO2 感測模組物件
+   感測器支援硬體序列埠（HardwareSerial）與軟體序列埠（SoftwareSerial）
+--------------------------------------------------------------*/
+
+// ▼ 軟體序列埠（SoftwareSerial）建立方式（已註解）：
+// BM25S3321_1 CO2(STA_PIN, RX_PIN, TX_PIN);
+// 適用於硬體序列埠不足的情況，但會佔用較多 CPU 資源
+// 注意：背景查詢直接使用 CO2_SERIAL 收發，軟體序列埠須自行改寫 pollCO2()
+
+// ▼ 硬體序列埠（HardwareSerial）建立方式（已註解）：
+// BM25S3321_1 CO2(STA_PIN, &Serial);    // 使用主序列埠（不建議，會與電腦監控衝突）
+// BM25S3321_1 CO2(STA_PIN, &Serial2);   // 使用 Serial2（需確認開發板支援）
+// BM25S3321_1 CO2(STA_PIN, &Serial3);   // 使用 Serial3（需確認開發板支援）
+// BM25S3321_1 CO2(STA_PIN, &Serial4);   // 使用 Serial4（需確認開發板支援）
+
+/*
+ * 物件名稱：CO2
+ * 類別：BM25S3321_1
+ * 功能：建立 BM25S3321-1 CO2 感測器的控制物件
+ * 
+ * 建構函式參數說明：
+ *   參數 1：STA_PIN - 狀態腳位編號，用於讀取模組狀態
+ *   參數 2：&CO2_SERIAL - 使用的 UART 序列埠（預設 Serial1）
+ * 
+ * 本程式採用 Serial1（BMduino-UNO 具備多組 UART）：
+ *   - BMduino-UNO 的 Serial1 對應腳位：TX1 (D0)、RX1 (D1)
+ *   - 建議使用硬體序列埠，效能較佳且穩定
+ */
+BM25S3321_1 CO2(STA_PIN, &CO2_SERIAL);
+
+// ================================================================
+// =============== 自訂函式宣告區 =================================
+// ================================================================
+
+/*
+ * 函式名稱：initCO2()
+ * 功能：初始化二氧化碳感測模組，開始背景預熱
+ * 執行內容：
+ *   - 啟動 UART 通訊
+ *   - 記錄預熱開始時間後立即返回（不阻塞）
+ * 參數：無
+ * 傳回值：無
+ */
+void initCO2();
+
+/*
+ * 函式名稱：pollCO2()
+ * 功能：推進背景狀態機（預熱計時、設定量程、送出查詢、接收回應）
+ * 參數：無
+ * 傳回值：無
+ * 注意：在 loop() 或週期任務中頻繁呼叫，每次只做不需等待的工作
+ */
+void pollCO2();
+
+/*
+ * 函式名稱：readCO2()
+ * 功能：取得最近一次有效的 CO2 濃度（ppm）
+ * 參數：無
+ * 傳回值：uint16_t - CO2 濃度（單位：ppm），尚未讀到時為 0
+ */
+uint16_t readCO2();
+
+/*
+ * 函式名稱：co2Status()
+ * 功能：回報 CO2Value 是否可用
+ * 參數：無
+ * 傳回值：CO2_STATUS_WARMING、CO2_STATUS_VALID 或 CO2_STATUS_STALE
+ */
+uint8_t co2Status();
+
+/*
+ * 函式名稱：co2WarmupLeft()
+ * 功能：預熱剩餘時間
+ * 參數：無
+ * 傳回值：剩餘毫秒數，預熱完成後為 0
+ */
+unsigned long co2WarmupLeft();
+
+// ================================================================
+// =============== 自訂函式實作區 =================================
+// ================================================================
+
+/*-------------------------------------------------------------
+   自訂函式：初始化二氧化碳感測模組
+   功能：啟動 UART，開始背景預熱
+
+   執行流程：
+     1. 初始化 UART 通訊（9600 bps）
+     2. 記錄預熱開始時間，狀態設為 CO2_WARMING
+     3. 立即返回，預熱完成與量程設定由 pollCO2() 處理
+
+   注意事項：
+     - 預熱程序非常重要，不可省略；只是改為在背景計時
+     - 零點校正需在預熱完成後、純淨空氣中進行，預設註解
+--------------------------------------------------------------*/
+void initCO2()
+{
+    // --------------------------------------------------------
+    // 步驟 1：初始化感測模組
+    // begin() 會自動設定感測器與序列埠溝通的波特率：9600 bps
+    // --------------------------------------------------------
+    CO2.begin();
+
+    /*
+     * ➤ 為何需要預熱？
+     *
+     * CO2 感測器採用 NDIR（Non-Dispersive Infrared，非分散式紅外線）原理，
+     * 內部有紅外線光源與感測元件。為確保光源穩定、量測準確，
+     * 必須進行約 60 秒的預熱程序。
+     *
+     * 若不預熱 → 初期數據會「偏低」或「跳動」。
+     *
+     * 原本的 CO2.preheatCountdown() 在預熱期間阻塞整個程式，
+     * WiFi、OLED、MQTT 都要等 60 秒後才能初始化。
+     * 預熱只需要時間經過，不需要程式參與，因此改為記錄開始時間，
+     * 由 pollCO2() 判斷是否已經完成。
+     */
+
+    // --------------------------------------------------------
+    // 步驟 2：記錄預熱開始時間
+    // --------------------------------------------------------
+    co2StartAt = millis();
+    co2State = CO2_WARMING;
+    co2HasValue = false;
+    co2RxLen = 0;
+    CO2Value = 0;
+
+    Serial.println("Module preheating in background...(about 60 seconds)");
+}
+
+/*-------------------------------------------------------------
+   自訂函式：推進背景狀態機
+   功能：依狀態完成一小段工作後立即返回
+
+   狀態說明：
+     CO2_WARMING    ：預熱時間到達後設定量程，進入 CO2_IDLE
+     CO2_IDLE       ：讀取間隔到達後送出查詢，進入 CO2_WAIT_REPLY
+     CO2_WAIT_REPLY ：取出已到達的位元組，收滿封包或逾時後回到 CO2_IDLE
+
+   注意事項：
+     - 查詢與回應直接在 CO2_SERIAL 上收發，不呼叫 readCO2Value()，
+       因為 readCO2Value() 會等待回應（約 1-2 秒）
+     - 預熱完成時呼叫一次 CO2.setRangeMax()，只有這一次會等待模組回應
+--------------------------------------------------------------*/
+void pollCO2()
+{
+    unsigned long now = millis();
+
+    if (co2State == CO2_WARMING) {
+        if (now - co2StartAt < CO2_PREHEAT_TIME) return;
+
+        Serial.println("End of module preheating.\n");
+        Serial.println("Perform initial setup.");
+
+        /*
+         * （選用）零點校正
+         * 必須在純淨戶外空氣（約 400 ppm CO2）條件下進行
+         * 若誤按校正 → 感測器量測可能嚴重偏差，因此預設關閉
+         */
+        // CO2.calibrateZeroPoint();
+
+        // 設定最大可量測範圍（2000 或 5000 ppm）
+        CO2.setRangeMax(CO2_RANGE_MAX);
+
+        co2State = CO2_IDLE;
+        co2QueryAt = now - CO2_READ_INTERVAL;  // 預熱完成後立即查詢第一次
+        return;
+    }
+
+    if (co2State == CO2_IDLE) {
+        if (now - co2QueryAt < CO2_READ_INTERVAL) return;
+
+        // 清除上一次逾時後才到達的殘留資料，避免與新的回應混在一起
+        while (CO2_SERIAL.available() > 0) CO2_SERIAL.read();
+
+        const uint8_t query[4] = {0x11, 0x01, 0x01, 0xED};
+        CO2_SERIAL.write(query, sizeof(query));
+        co2QueryAt = now;
+        co2RxLen = 0;
+        co2State = CO2_WAIT_REPLY;
+        return;
+    }
+
+    // CO2_WAIT_REPLY：只取出已到達的位元組，不等待
+    while (CO2_SERIAL.available() > 0 && co2RxLen < CO2_FRAME_LEN) {
+        uint8_t c = CO2_SERIAL.read();
+        if (co2RxLen == 0 && c != CO2_FRAME_HEAD) continue;   // 尋找表頭
+        co2Rx[co2RxLen++] = c;
+    }
+
+    if (co2RxLen < CO2_FRAME_LEN) {
+        if (now - co2QueryAt >= CO2_REPLY_TIMEOUT) {    // 逾時：放棄本次，保留舊值
+            co2Errors++;
+            co2State = CO2_IDLE;
+        }
+        return;
+    }
+
+    // 收滿一個封包：驗證長度欄位、命令碼與校驗碼
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < CO2_FRAME_LEN; i++) sum += co2Rx[i];
+    if (sum == 0 && co2Rx[1] == 0x05 && co2Rx[2] == 0x01) {
+        CO2Value = ((uint16_t)co2Rx[3] << 8) | co2Rx[4];
+        co2ReadAt = now;
+        co2HasValue = true;
+    } else {
+        co2Errors++;
+    }
+    co2State = CO2_IDLE;
+}
+
+/*-------------------------------------------------------------
+   自訂函式：取得 CO2 濃度（ppm）
+   功能：回傳 pollCO2() 最近一次讀到的有效值
+
+   傳回值：uint16_t - CO2 濃度值（單位：ppm）
+
+   注意事項：
+     - 不再向感測器查詢，呼叫不會阻塞
+     - 預熱中或尚未讀到時回傳 0，請先以 co2Status() 判斷
+--------------------------------------------------------------*/
+uint16_t readCO2()
+{
+    return CO2Value;
+}
+
+/*-------------------------------------------------------------
+   自訂函式：回報 CO2Value 是否可用
+   傳回值：
+     CO2_STATUS_WARMING：預熱中或尚未讀到第一筆，顯示「熱機中」
+     CO2_STATUS_VALID  ：CO2_STALE_TIME 內讀到的有效值
+     CO2_STATUS_STALE  ：感測器最近沒有回應，CO2Value 為舊值
+--------------------------------------------------------------*/
+uint8_t co2Status()
+{
+    if (!co2HasValue) return CO2_STATUS_WARMING;
+    if (millis() - co2ReadAt >= CO2_STALE_TIME) return CO2_STATUS_STALE;
+    return CO2_STATUS_VALID;
+}
+
+/*-------------------------------------------------------------
+   自訂函式：預熱剩餘時間（毫秒）
+   用途：顯示「熱機中，剩餘 N 秒」
+--------------------------------------------------------------*/
+unsigned long co2WarmupLeft()
+{
+    if (co2State != CO2_WARMING) return 0;
+    unsigned long elapsed = millis() - co2StartAt;
+    if (elapsed >= CO2_PREHEAT_TIME) return 0;
+    return CO2_PREHEAT_TIME - elapsed;
+}
+
+#endif
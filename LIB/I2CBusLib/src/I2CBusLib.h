@@ -0,0 +1,259 @@
+// ================================================================
+// 檔案名稱：I2CBusLib.h
+// 描述：共用 I2C 匯流排（Wire1）的交易排程與匯流排時間統計（不配置動態記憶體、固定容量）
+// 功能：DHT、繼電器、紅外線溫度、LED 按鈕、OLED 等模組共用同一條 Wire1 時，
+//       避免一次 1 KB 的 OLED 畫面更新讓繼電器指令等上數十毫秒
+//       - 每個模組以 busAddDevice() 登錄一個裝置編號，各自累計佔用匯流排的時間
+//       - busSubmit() 把交易放進佇列，依優先權執行：
+//           BUS_PRIO_URGENT  繼電器寫入、中斷通知後的讀取
+//           BUS_PRIO_SENSOR  定期的感測器讀取
+//           BUS_PRIO_DISPLAY OLED 畫面更新
+//         同優先權依送出順序執行，畫面的繪製順序不會被打亂
+//       - 交易函式可以分成多步（例如 OLED 一次送一頁 128 bytes），
+//         每一步之後回到 loop()，較高優先權的交易可在兩頁之間插隊
+//       - 必須立即取得結果的讀取（例如讀溫濕度）以 busBegin()/busEnd() 包住，
+//         同樣計入該裝置的匯流排時間
+// 使用方式：
+//   int relayBus = busAddDevice("relay");
+//   busSubmit(relayBus, BUS_PRIO_URGENT, relayStep, 1);   // relayStep(1, 0) 稍後執行
+//   void loop() { taskRun(); busRun(); }
+// 注意：交易函式在 busRun() 中執行，一步不可佔用太久（建議不超過 1 頁 OLED，約 3 毫秒）；
+//       所有交易都在 loop() 中依序執行，不會同時使用匯流排，因此不需要鎖
+// ================================================================
+
+#ifndef _I2CBUSLIB_H_
+#define _I2CBUSLIB_H_
+
+#include <Arduino.h>
+
+// ================================================================
+// =============== 設定常數區 ===============
+// ================================================================
+#ifndef BUS_MAX_DEVICES
+#define BUS_MAX_DEVICES 6          // 最多可登錄的裝置數
+#endif
+#ifndef BUS_QUEUE_SIZE
+#define BUS_QUEUE_SIZE 8           // 最多同時等待的交易數
+#endif
+#define BUS_NONE -1                // 登錄失敗或沒有裝置時的編號
+
+// 交易優先權（數字越小越優先）
+#define BUS_PRIO_URGENT  0         // 繼電器寫入、中斷通知後的讀取
+#define BUS_PRIO_SENSOR  1         // 定期的感測器讀取
+#define BUS_PRIO_DISPLAY 2         // OLED 畫面更新
+
+// ================================================================
+// =============== 資料結構宣告區 ===============
+// ================================================================
+// 交易函式：arg 為送出時的參數，step 為第幾步（從 0 開始）
+// 回傳 true 表示還有下一步，false 表示交易完成
+typedef bool (*BusStep)(int arg, uint8_t step);
+
+// 一個裝置的匯流排使用統計
+typedef struct
+{
+    const char *name;              // 裝置名稱（字串常數，不複製）
+    uint32_t jobs;                 // 完成的交易數（含 busBegin()/busEnd()）
+    uint32_t steps;                // 執行的步數
+    uint32_t busUs;                // 累計佔用匯流排的時間（微秒）
+    uint32_t maxStepUs;            // 單步最長時間（微秒）
+    uint32_t maxWaitUs;            // 送出到開始執行的最長等待時間（微秒）
+    uint32_t dropped;              // 佇列已滿而未送出的交易數
+} BusDevice;
+
+// 佇列中的一筆交易
+typedef struct
+{
+    BusStep func;                  // 交易函式，NULL 表示空位
+    int arg;                       // 交易參數
+    uint8_t device;                // 裝置編號
+    uint8_t prio;                  // 優先權
+    uint8_t step;                  // 下一步的編號
+    uint16_t seq;                  // 送出順序（同優先權先送先做）
+    unsigned long queuedUs;        // 送出時的 micros()
+} BusJob;
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+BusDevice busDevices[BUS_MAX_DEVICES];     // 裝置表
+uint8_t busDeviceCount = 0;                // 已登錄的裝置數
+BusJob busQueue[BUS_QUEUE_SIZE];           // 交易佇列（固定位置，以 seq 排序）
+uint8_t busPending = 0;                    // 佇列中的交易數
+uint16_t busSeq = 0;                       // 下一筆交易的送出順序
+int busOpen = BUS_NONE;                    // busBegin() 開啟中的裝置
+unsigned long busOpenUs = 0;               // busBegin() 的 micros()
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+int busAddDevice(const char *name);                            // 登錄裝置，回傳裝置編號
+bool busSubmit(int device, uint8_t prio, BusStep func, int arg); // 送出交易，佇列已滿時回傳 false
+bool busRun();                                                 // 執行一步，沒有交易時回傳 false
+void busFlush();                                               // 執行到佇列清空（只在 setup() 等可等待的地方使用）
+bool busIdle();                                                // 佇列是否為空
+void busBegin(int device);                                     // 開始一段立即執行的匯流排存取
+void busEnd(int device);                                       // 結束並計入匯流排時間
+void busReport();                                              // 由序列埠印出各裝置的統計
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：busAddDevice()
+// 功能：登錄一個共用匯流排的裝置
+// 參數：name - 裝置名稱（須為字串常數）
+// 回傳：裝置編號，裝置表已滿時回傳 BUS_NONE
+// ---------------------------------------------------------------
+int busAddDevice(const char *name)
+{
+    if (busDeviceCount >= BUS_MAX_DEVICES) return BUS_NONE;
+    BusDevice *d = &busDevices[busDeviceCount];
+    memset(d, 0, sizeof(BusDevice));
+    d->name = name;
+    return busDeviceCount++;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：busSubmit()
+// 功能：把一筆交易放進佇列，由 busRun() 依優先權執行
+// 參數：device - 裝置編號；prio - 優先權（BUS_PRIO_URGENT ...）
+//       func - 交易函式；arg - 交給交易函式的參數
+// 回傳：成功放入佇列回傳 true；佇列已滿或參數錯誤回傳 false（計入 dropped）
+// ---------------------------------------------------------------
+bool busSubmit(int device, uint8_t prio, BusStep func, int arg)
+{
+    if (device < 0 || device >= busDeviceCount || func == NULL) return false;
+    for (int i = 0; i < BUS_QUEUE_SIZE; i++) {
+        BusJob *j = &busQueue[i];
+        if (j->func != NULL) continue;
+        j->func = func;
+        j->arg = arg;
+        j->device = device;
+        j->prio = prio;
+        j->step = 0;
+        j->seq = busSeq++;
+        j->queuedUs = micros();
+        busPending++;
+        return true;
+    }
+    busDevices[device].dropped++;
+    return false;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：busRun()
+// 功能：執行佇列中優先權最高（同優先權最早送出）的交易的下一步
+// 回傳：有執行時回傳 true，佇列為空時回傳 false
+// 說明：每次只執行一步就返回，loop() 中其他任務送出的緊急交易
+//       在下一次 busRun() 就會先於剩下的 OLED 分頁執行
+// ---------------------------------------------------------------
+bool busRun()
+{
+    if (busPending == 0) return false;
+
+    BusJob *best = NULL;
+    for (int i = 0; i < BUS_QUEUE_SIZE; i++) {
+        BusJob *j = &busQueue[i];
+        if (j->func == NULL) continue;
+        if (best == NULL || j->prio < best->prio
+            || (j->prio == best->prio && (int16_t)(j->seq - best->seq) < 0)) {
+            best = j;
+        }
+    }
+
+    BusDevice *d = &busDevices[best->device];
+    unsigned long startUs = micros();
+    if (best->step == 0) {
+        unsigned long waitUs = startUs - best->queuedUs;
+        if (waitUs > d->maxWaitUs) d->maxWaitUs = waitUs;
+    }
+    bool more = best->func(best->arg, best->step);
+    unsigned long runUs = micros() - startUs;
+
+    d->steps++;
+    d->busUs += runUs;
+    if (runUs > d->maxStepUs) d->maxStepUs = runUs;
+    if (more) {
+        best->step++;
+    } else {
+        best->func = NULL;
+        busPending--;
+        d->jobs++;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：busFlush()
+// 功能：執行到佇列清空
+// 說明：會一直佔用 loop()，只用於 setup() 或需要確定畫面已更新的地方
+// ---------------------------------------------------------------
+void busFlush()
+{
+    while (busRun()) {
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：busIdle()
+// 功能：佇列是否為空
+// ---------------------------------------------------------------
+bool busIdle()
+{
+    return busPending == 0;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：busBegin() / busEnd()
+// 功能：包住一段必須立即完成的匯流排存取，計入該裝置的匯流排時間
+// 說明：在任務或 loop() 中呼叫時，busRun() 不會同時執行，匯流排一定空閒；
+//       不可在中斷服務程式或交易函式中呼叫
+// ---------------------------------------------------------------
+void busBegin(int device)
+{
+    if (device < 0 || device >= busDeviceCount) return;
+    busOpen = device;
+    busOpenUs = micros();
+}
+
+void busEnd(int device)
+{
+    if (device != busOpen) return;
+    BusDevice *d = &busDevices[device];
+    unsigned long runUs = micros() - busOpenUs;
+    d->jobs++;
+    d->steps++;
+    d->busUs += runUs;
+    if (runUs > d->maxStepUs) d->maxStepUs = runUs;
+    busOpen = BUS_NONE;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：busReport()
+// 功能：每個裝置印出一列統計，可看出哪個裝置佔用匯流排最久
+// 欄位：BUS,名稱,交易數,步數,匯流排時間(us),單步最長(us),最長等待(us),丟棄數
+// ---------------------------------------------------------------
+void busReport()
+{
+    for (int i = 0; i < busDeviceCount; i++) {
+        BusDevice *d = &busDevices[i];
+        Serial.print("BUS,");
+        Serial.print(d->name);
+        Serial.print(",");
+        Serial.print(d->jobs);
+        Serial.print(",");
+        Serial.print(d->steps);
+        Serial.print(",");
+        Serial.print(d->busUs);
+        Serial.print(",");
+        Serial.print(d->maxStepUs);
+        Serial.print(",");
+        Serial.print(d->maxWaitUs);
+        Serial.print(",");
+        Serial.println(d->dropped);
+    }
+}
+
+#endif
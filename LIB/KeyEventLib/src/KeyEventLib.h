@@ -0,0 +1,235 @@
+// ================================================================
+// 檔案名稱：KeyEventLib.h
+// 描述：BMK52T016 16 鍵模組的中斷驅動按鍵事件佇列（不配置動態記憶體、固定容量）
+// 功能：取代每 200 毫秒輪詢一次 getINT() 的讀鍵方式，快速連按也不會漏鍵
+//       - INT 腳下降緣觸發中斷，中斷服務程式只設定旗標並以 taskSignal() 喚醒讀鍵任務
+//       - 讀鍵任務讀出 16 位元按鍵狀態，與上一次比較後產生
+//         按下（KEY_PRESS）、放開（KEY_RELEASE）、長按（KEY_LONG）事件
+//       - 變化的位元以 __builtin_ctz() 直接取得按鍵編號，不必逐一掃描 16 個位元
+//       - 每個事件附帶當時所有按住的按鍵（chord），可判斷多鍵組合
+//       - 事件放在環狀佇列，讀鍵任務寫入、keyGet() 讀出，兩邊各自只改一個索引，不需關閉中斷
+// 使用方式：
+//   BMK52T016 BMK52(2, &Wire);  // 須先建立 BMK52 物件，INT 腳與 KEY_INT_PIN 相同
+//   #include "KeyEventLib.h"
+//   keyEventBegin(keychar);     // BMK52.begin() 之後呼叫
+//   KeyEvent ev;
+//   while (keyGet(&ev)) { if (ev.type == KEY_PRESS) Serial.println(keyChar(ev.key)); }
+// 注意：I2C 不能在中斷服務程式中使用，讀取按鍵狀態一律在讀鍵任務中進行；
+//       去彈跳由模組內部處理（setThreshold() 設定的門檻）
+// ================================================================
+
+#ifndef _KEYEVENTLIB_H_
+#define _KEYEVENTLIB_H_
+
+#include <Arduino.h>
+#include "BMK52T016.h"
+#include "TaskLib.h"
+
+extern BMK52T016 BMK52;              // 由草稿碼建立，讀鍵任務讀取按鍵狀態使用
+
+// ================================================================
+// =============== 設定常數區 ===============
+// ================================================================
+#ifndef KEY_INT_PIN
+#define KEY_INT_PIN 2              // BMK52T016 的 INT 腳（須與建立 BMK52 物件時相同）
+#endif
+#ifndef KEY_QUEUE_SIZE
+#define KEY_QUEUE_SIZE 16          // 事件佇列容量（須為 2 的次方）
+#endif
+#define KEY_COUNT 16               // 按鍵數
+#define KEY_LONG_TIME 800          // 按住超過此時間（毫秒）產生一次長按事件
+#define KEY_HOLD_POLL 20           // 有按鍵按住時的讀取週期（毫秒），用來偵測放開與長按
+#define KEY_SCAN_DEADLINE 5        // 讀鍵任務被喚醒後可容許延遲的時間（毫秒）
+#define KEY_NONE -1                // 沒有按鍵
+
+// 事件種類
+#define KEY_PRESS   0              // 按下
+#define KEY_RELEASE 1              // 放開
+#define KEY_LONG    2              // 按住超過 KEY_LONG_TIME
+
+// ================================================================
+// =============== 資料結構宣告區 ===============
+// ================================================================
+// 一個按鍵事件
+typedef struct
+{
+    uint8_t type;                  // 事件種類（KEY_PRESS ...）
+    uint8_t key;                   // 按鍵編號 0~15（對應 readKeyValue() 的位元）
+    uint16_t chord;                // 事件發生時所有按住的按鍵（位元遮罩，放開事件不含該鍵）
+    unsigned long time;            // 事件發生的 millis()
+} KeyEvent;
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+KeyEvent keyQueue[KEY_QUEUE_SIZE];         // 事件佇列
+volatile uint8_t keyHead = 0;              // 下一個寫入位置（只由讀鍵任務修改）
+volatile uint8_t keyTail = 0;              // 下一個讀出位置（只由 keyGet() 修改）
+volatile bool keyIntPending = false;       // INT 腳有下降緣尚未讀取（由中斷設定）
+uint16_t keyState = 0;                     // 上一次讀到的按鍵狀態
+uint16_t keyLongSent = 0;                  // 已送出長按事件的按鍵
+unsigned long keyDownAt[KEY_COUNT];        // 各按鍵按下的時間
+const char *keyChars = NULL;               // 按鍵字元對照表（16 個字元）
+int keyTask = TASK_NONE;                   // 讀鍵任務編號
+uint32_t keyDropped = 0;                   // 佇列已滿而丟棄的事件數
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+void keyEventBegin(const char *chars);     // 登錄讀鍵任務並啟用 INT 中斷
+void keyISR();                             // INT 腳中斷服務程式
+void keyScan();                            // 讀鍵任務：讀取狀態並產生事件
+bool keyGet(KeyEvent *ev);                 // 取出一個事件，佇列為空時回傳 false
+uint8_t keyPending();                      // 佇列中尚未取出的事件數
+char keyChar(uint8_t key);                 // 按鍵編號轉換為字元
+uint8_t keyChordCount(uint16_t chord);     // chord 中按住的按鍵數
+int keyFirst(uint16_t chord);              // chord 中編號最小的按鍵，沒有按鍵時回傳 KEY_NONE
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：keyEventBegin()
+// 功能：登錄讀鍵任務、掛上 INT 腳的下降緣中斷，並讀取一次目前狀態
+// 參數：chars - 按鍵字元對照表（16 個字元，索引即按鍵編號）
+// 說明：重複呼叫只更新對照表，不會重複登錄任務
+// ---------------------------------------------------------------
+void keyEventBegin(const char *chars)
+{
+    keyChars = chars;
+    if (keyTask != TASK_NONE) return;
+    keyTask = taskAddPeriodic("keypad", keyScan, KEY_HOLD_POLL, KEY_SCAN_DEADLINE);
+    attachInterrupt(digitalPinToInterrupt(KEY_INT_PIN), keyISR, FALLING);
+    keyIntPending = true;          // 開機時可能已有按鍵按住
+    taskSignal(keyTask);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：keyISR()
+// 功能：INT 腳下降緣中斷服務程式
+// 說明：只設定旗標並喚醒讀鍵任務，I2C 讀取留給 keyScan()
+// ---------------------------------------------------------------
+void keyISR()
+{
+    keyIntPending = true;
+    taskSignal(keyTask);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：keyPush()
+// 功能：寫入一個事件（內部使用），佇列已滿時丟棄並計數
+// ---------------------------------------------------------------
+void keyPush(uint8_t type, uint8_t key, uint16_t chord, unsigned long now)
+{
+    uint8_t next = (keyHead + 1) & (KEY_QUEUE_SIZE - 1);
+    if (next == keyTail) {
+        keyDropped++;
+        return;
+    }
+    KeyEvent *ev = &keyQueue[keyHead];
+    ev->type = type;
+    ev->key = key;
+    ev->chord = chord;
+    ev->time = now;
+    keyHead = next;                // 事件內容寫完才移動索引
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：keyScan()
+// 功能：讀鍵任務，中斷喚醒時或有按鍵按住時每 KEY_HOLD_POLL 毫秒執行
+// 說明：沒有中斷也沒有按鍵按住時立即返回，不佔用 I2C；
+//       同時變化的多個按鍵依編號由小到大產生事件，先放開後按下
+// ---------------------------------------------------------------
+void keyScan()
+{
+    if (!keyIntPending && keyState == 0) return;
+    keyIntPending = false;         // 先清除，讀取期間的新中斷會再喚醒一次
+
+    unsigned long now = millis();
+    uint16_t mask = BMK52.readKeyValue();
+    uint16_t changed = mask ^ keyState;
+    uint16_t released = changed & keyState;
+    uint16_t pressed = changed & mask;
+
+    while (released) {
+        uint8_t k = __builtin_ctz(released);
+        released &= released - 1;  // 清除最低的 1 位元
+        keyPush(KEY_RELEASE, k, mask, now);
+    }
+    while (pressed) {
+        uint8_t k = __builtin_ctz(pressed);
+        pressed &= pressed - 1;
+        keyDownAt[k] = now;
+        keyPush(KEY_PRESS, k, mask, now);
+    }
+    keyState = mask;
+    keyLongSent &= mask;
+
+    uint16_t held = mask & ~keyLongSent;
+    while (held) {
+        uint8_t k = __builtin_ctz(held);
+        held &= held - 1;
+        if (now - keyDownAt[k] >= KEY_LONG_TIME) {
+            keyLongSent |= (uint16_t)(1u << k);
+            keyPush(KEY_LONG, k, mask, now);
+        }
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：keyGet()
+// 功能：取出最早的一個事件
+// 參數：ev - 存放事件的位置
+// 回傳：有事件時回傳 true，佇列為空時回傳 false
+// ---------------------------------------------------------------
+bool keyGet(KeyEvent *ev)
+{
+    uint8_t tail = keyTail;
+    if (tail == keyHead) return false;
+    *ev = keyQueue[tail];
+    keyTail = (tail + 1) & (KEY_QUEUE_SIZE - 1);   // 複製完才釋放位置
+    return true;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：keyPending()
+// 功能：佇列中尚未取出的事件數
+// ---------------------------------------------------------------
+uint8_t keyPending()
+{
+    return (keyHead - keyTail) & (KEY_QUEUE_SIZE - 1);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：keyChar()
+// 功能：按鍵編號轉換為對照表中的字元
+// 回傳：編號超出範圍或尚未呼叫 keyEventBegin() 時回傳 '?'
+// ---------------------------------------------------------------
+char keyChar(uint8_t key)
+{
+    if (keyChars == NULL || key >= KEY_COUNT) return '?';
+    return keyChars[key];
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：keyChordCount()
+// 功能：chord 中按住的按鍵數（大於 1 表示多鍵組合）
+// ---------------------------------------------------------------
+uint8_t keyChordCount(uint16_t chord)
+{
+    return __builtin_popcount(chord);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：keyFirst()
+// 功能：chord 中編號最小的按鍵
+// 回傳：按鍵編號，chord 為 0 時回傳 KEY_NONE
+// ---------------------------------------------------------------
+int keyFirst(uint16_t chord)
+{
+    if (chord == 0) return KEY_NONE;
+    return __builtin_ctz(chord);
+}
+
+#endif
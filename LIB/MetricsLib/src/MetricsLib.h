@@ -0,0 +1,434 @@
+// ================================================================
+// 檔案名稱：MetricsLib.h
+// 描述：執行期量測函式庫（固定記憶體，不配置動態記憶體）
+// 功能：各子系統的計數器、量表與延遲分佈
+//       - 計數器 (counter)：只會增加的次數，例如發佈失敗次數
+//       - 量表 (gauge)：目前的數值，例如尚未補送的樣本數
+//       - 延遲分佈 (histogram)：以 2 倍為間隔的對數區間記錄每次花費的時間，
+//         可估計 p50 / p99，記憶體固定，不需保留每一筆樣本
+//       - AT 指令與 http_get() 由驅動程式的 setStatsCallback() 自動記錄
+//       - metricsSerialPoll()：序列埠送入 'm' 印出全部數值，'r' 清除
+//       - metricsPublish()：把摘要以 JSON 發佈到 MQTT，作為定期健康訊息
+// 使用方式：
+//   metricsBegin();                              // setup() 中呼叫一次
+//   unsigned long t = metricStart();
+//   readHumidity();
+//   metricStop(metricHistogram("dht_read"), t);  // 名稱第一次使用時登錄
+//   metricInc(metricCounter("mqtt_recv"));
+// 注意：需在建立 Wifi 物件（TCP.h）之後引入；名稱須為字串常數（不複製）
+// ================================================================
+
+#ifndef _METRICSLIB_H_
+#define _METRICSLIB_H_
+
+#include <Arduino.h>
+#include "BMC81M001.h"
+
+extern BMC81M001 Wifi;                 // 由草稿碼（TCP.h）建立，發佈健康訊息與讀取接收緩衝區統計使用
+
+// ================================================================
+// =============== 量測設定常數區 ===============
+// ================================================================
+#ifndef METRICS_MAX_COUNTERS
+#define METRICS_MAX_COUNTERS 16        // 最多可登錄的計數器數
+#endif
+#ifndef METRICS_MAX_GAUGES
+#define METRICS_MAX_GAUGES 8           // 最多可登錄的量表數
+#endif
+#ifndef METRICS_MAX_HISTOGRAMS
+#define METRICS_MAX_HISTOGRAMS 8       // 最多可登錄的延遲分佈數
+#endif
+#define METRICS_BUCKETS 16             // 每個延遲分佈的區間數
+#define METRICS_FIRST_BUCKET_US 128    // 第 0 區間：< 128 微秒；第 i 區間：< 128 × 2^i 微秒（最後一區間不設上限，約 2 秒以上）
+#ifndef METRICS_PAYLOAD_SIZE
+#define METRICS_PAYLOAD_SIZE 512       // 健康訊息緩衝區大小（放不下的項目略過）
+#endif
+#define METRICS_NONE -1                // 登錄失敗時的編號，傳給其他函式時不做任何事
+
+// ================================================================
+// =============== 資料結構宣告區 ===============
+// ================================================================
+
+// 計數器
+typedef struct
+{
+    const char *name;                  // 名稱（字串常數，不複製）
+    uint32_t value;                    // 累計次數
+} MetricCounter;
+
+// 量表
+typedef struct
+{
+    const char *name;                  // 名稱
+    long value;                        // 目前數值
+} MetricGauge;
+
+// 延遲分佈
+typedef struct
+{
+    const char *name;                  // 名稱
+    uint32_t count;                    // 記錄次數
+    uint32_t sumMs;                    // 總時間（毫秒，計算平均用）
+    uint32_t maxUs;                    // 最長時間（微秒）
+    uint32_t buckets[METRICS_BUCKETS]; // 各區間的次數（與 count 相同為 32 位元）
+} MetricHistogram;
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+MetricCounter metricCounters[METRICS_MAX_COUNTERS];        // 計數器
+MetricGauge metricGauges[METRICS_MAX_GAUGES];              // 量表
+MetricHistogram metricHistograms[METRICS_MAX_HISTOGRAMS];  // 延遲分佈
+uint8_t metricCounterCount = 0;        // 已登錄的計數器數
+uint8_t metricGaugeCount = 0;          // 已登錄的量表數
+uint8_t metricHistogramCount = 0;      // 已登錄的延遲分佈數
+char metricsBuffer[METRICS_PAYLOAD_SIZE];   // 健康訊息緩衝區
+
+// 驅動程式回報使用的編號（metricsBegin() 登錄）
+int metricAtCmd = METRICS_NONE;        // AT 指令時間
+int metricAtFail = METRICS_NONE;       // AT 指令失敗次數（ERROR / FAIL）
+int metricAtTimeout = METRICS_NONE;    // AT 指令逾時次數
+int metricAtRetry = METRICS_NONE;      // AT 指令重送次數
+int metricHttp = METRICS_NONE;         // http_get() 時間
+int metricHttpFail = METRICS_NONE;     // http_get() 失敗次數（沒有收到 2xx 回應）
+int metricUptime = METRICS_NONE;       // 開機秒數
+int metricRxHighWater = METRICS_NONE;  // 接收緩衝區最高使用量
+int metricRxOverruns = METRICS_NONE;   // 接收緩衝區溢位位元組數
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+void metricsBegin();                                 // 登錄驅動程式的量測項目並設定回報函式
+int  metricCounter(const char *name);                // 取得（或登錄）計數器編號
+int  metricGauge(const char *name);                  // 取得（或登錄）量表編號
+int  metricHistogram(const char *name);              // 取得（或登錄）延遲分佈編號
+void metricInc(int id);                              // 計數器加 1
+void metricAdd(int id, uint32_t n);                  // 計數器加 n
+void metricSet(int id, long value);                  // 設定量表數值
+void metricObserve(int id, unsigned long us);        // 記錄一次時間（微秒）
+unsigned long metricStart();                         // 開始計時，傳回 micros()
+void metricStop(int id, unsigned long startUs);      // 結束計時並記錄
+uint32_t metricPercentile(int id, uint8_t pct);      // 延遲分佈的百分位數（微秒，區間上限）
+void metricsATStats(uint8_t kind, int result, unsigned long us, uint8_t tries);  // 驅動程式回報函式
+void metricsUpdateGauges();                          // 更新驅動程式相關的量表
+void metricsPrint();                                 // 由序列埠印出所有數值
+void metricsSerialPoll();                            // 處理序列埠的查詢指令
+int  metricsEncode(char *buf, int size, const char *dev);  // 產生 JSON 健康訊息，傳回長度
+bool metricsPublish(const char *topic, const char *dev);   // 發佈健康訊息
+void metricsReset();                                 // 清除所有數值（名稱保留，編號不變）
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：metricsBegin()
+// 功能：登錄驅動程式的量測項目，並由驅動程式回報每個 AT 指令與 http_get()
+// ---------------------------------------------------------------
+void metricsBegin()
+{
+    metricAtCmd = metricHistogram("at_cmd");
+    metricAtFail = metricCounter("at_fail");
+    metricAtTimeout = metricCounter("at_timeout");
+    metricAtRetry = metricCounter("at_retry");
+    metricHttp = metricHistogram("http_get");
+    metricHttpFail = metricCounter("http_fail");
+    metricUptime = metricGauge("up_s");
+    metricRxHighWater = metricGauge("rx_hwm");
+    metricRxOverruns = metricGauge("rx_overrun");
+    Wifi.setStatsCallback(metricsATStats);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricCounter() / metricGauge() / metricHistogram()
+// 功能：依名稱找到編號，第一次使用時登錄
+// 參數：name - 名稱（須為字串常數）
+// 回傳：編號，已滿時回傳 METRICS_NONE
+// ---------------------------------------------------------------
+int metricCounter(const char *name)
+{
+    for (int i = 0; i < metricCounterCount; i++) {
+        if (strcmp(metricCounters[i].name, name) == 0) return i;
+    }
+    if (metricCounterCount >= METRICS_MAX_COUNTERS) return METRICS_NONE;
+    metricCounters[metricCounterCount].name = name;
+    metricCounters[metricCounterCount].value = 0;
+    return metricCounterCount++;
+}
+
+int metricGauge(const char *name)
+{
+    for (int i = 0; i < metricGaugeCount; i++) {
+        if (strcmp(metricGauges[i].name, name) == 0) return i;
+    }
+    if (metricGaugeCount >= METRICS_MAX_GAUGES) return METRICS_NONE;
+    metricGauges[metricGaugeCount].name = name;
+    metricGauges[metricGaugeCount].value = 0;
+    return metricGaugeCount++;
+}
+
+int metricHistogram(const char *name)
+{
+    for (int i = 0; i < metricHistogramCount; i++) {
+        if (strcmp(metricHistograms[i].name, name) == 0) return i;
+    }
+    if (metricHistogramCount >= METRICS_MAX_HISTOGRAMS) return METRICS_NONE;
+    MetricHistogram *h = &metricHistograms[metricHistogramCount];
+    memset(h, 0, sizeof(MetricHistogram));
+    h->name = name;
+    return metricHistogramCount++;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricInc() / metricAdd() / metricSet()
+// 功能：更新計數器與量表，編號無效時不做任何事
+// ---------------------------------------------------------------
+void metricInc(int id)
+{
+    metricAdd(id, 1);
+}
+
+void metricAdd(int id, uint32_t n)
+{
+    if (id < 0 || id >= metricCounterCount) return;
+    metricCounters[id].value += n;
+}
+
+void metricSet(int id, long value)
+{
+    if (id < 0 || id >= metricGaugeCount) return;
+    metricGauges[id].value = value;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricObserve()
+// 功能：把一次花費的時間放進對應的區間
+// 參數：id - 延遲分佈編號；us - 時間（微秒）
+// ---------------------------------------------------------------
+void metricObserve(int id, unsigned long us)
+{
+    if (id < 0 || id >= metricHistogramCount) return;
+    MetricHistogram *h = &metricHistograms[id];
+    uint8_t b = 0;
+    unsigned long bound = METRICS_FIRST_BUCKET_US;
+    while (b < METRICS_BUCKETS - 1 && us >= bound) {
+        bound <<= 1;
+        b++;
+    }
+    h->buckets[b]++;
+    h->count++;
+    h->sumMs += (us + 500) / 1000;
+    if (us > h->maxUs) h->maxUs = us;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricStart() / metricStop()
+// 功能：量測一段程式的執行時間
+// 說明：t = metricStart(); ...; metricStop(id, t);
+// ---------------------------------------------------------------
+unsigned long metricStart()
+{
+    return micros();
+}
+
+void metricStop(int id, unsigned long startUs)
+{
+    metricObserve(id, micros() - startUs);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricPercentile()
+// 功能：由區間次數估計百分位數
+// 參數：id - 延遲分佈編號；pct - 百分位（50、99 ...）
+// 回傳：該百分位所在區間的上限（微秒），不超過最長時間；沒有記錄時回傳 0
+// 說明：區間以 2 倍為間隔，估計值與實際值相差不到 2 倍，足以找出特別慢的節點
+// ---------------------------------------------------------------
+uint32_t metricPercentile(int id, uint8_t pct)
+{
+    if (id < 0 || id >= metricHistogramCount) return 0;
+    MetricHistogram *h = &metricHistograms[id];
+    uint32_t total = 0;
+    for (uint8_t b = 0; b < METRICS_BUCKETS; b++) total += h->buckets[b];
+    if (total == 0) return 0;
+    uint32_t rank = ((uint32_t)pct * total + 99) / 100;    // 無條件進位
+    if (rank < 1) rank = 1;
+    uint32_t seen = 0;
+    uint32_t bound = METRICS_FIRST_BUCKET_US;
+    for (uint8_t b = 0; b < METRICS_BUCKETS - 1; b++, bound <<= 1) {
+        seen += h->buckets[b];
+        if (seen >= rank) return bound < h->maxUs ? bound : h->maxUs;
+    }
+    return h->maxUs;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricsATStats()
+// 功能：驅動程式的回報函式（Wifi.setStatsCallback()）
+// 參數：kind - AT_STAT_COMMAND / AT_STAT_HTTP
+//       result - AT_CMD_xxx 或 http_get() 的回傳值
+//       us - 花費時間（微秒）；tries - 嘗試次數
+// 說明：在驅動程式中呼叫，只更新數值，不可送出指令或印出訊息
+// ---------------------------------------------------------------
+void metricsATStats(uint8_t kind, int result, unsigned long us, uint8_t tries)
+{
+    if (kind == AT_STAT_HTTP) {
+        metricObserve(metricHttp, us);
+        if (result < 200 || result > 299) metricInc(metricHttpFail);
+        return;
+    }
+    metricObserve(metricAtCmd, us);
+    if (tries > 1) metricAdd(metricAtRetry, tries - 1);
+    if (result == AT_CMD_TIMEOUT) metricInc(metricAtTimeout);
+    else if (result != AT_CMD_OK) metricInc(metricAtFail);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricsUpdateGauges()
+// 功能：讀取驅動程式的統計值，更新開機時間與接收緩衝區量表
+// ---------------------------------------------------------------
+void metricsUpdateGauges()
+{
+    metricSet(metricUptime, millis() / 1000);
+    metricSet(metricRxHighWater, Wifi.rxHighWatermark());
+    metricSet(metricRxOverruns, Wifi.rxOverruns());
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricsPrint()
+// 功能：每個項目印出一列 CSV
+// 欄位：METRIC,counter,名稱,次數
+//       METRIC,gauge,名稱,數值
+//       METRIC,hist,名稱,次數,p50(us),p99(us),最長(us),平均(ms)
+// ---------------------------------------------------------------
+void metricsPrint()
+{
+    metricsUpdateGauges();
+    for (int i = 0; i < metricCounterCount; i++) {
+        Serial.print("METRIC,counter,");
+        Serial.print(metricCounters[i].name);
+        Serial.print(",");
+        Serial.println(metricCounters[i].value);
+    }
+    for (int i = 0; i < metricGaugeCount; i++) {
+        Serial.print("METRIC,gauge,");
+        Serial.print(metricGauges[i].name);
+        Serial.print(",");
+        Serial.println(metricGauges[i].value);
+    }
+    for (int i = 0; i < metricHistogramCount; i++) {
+        MetricHistogram *h = &metricHistograms[i];
+        Serial.print("METRIC,hist,");
+        Serial.print(h->name);
+        Serial.print(",");
+        Serial.print(h->count);
+        Serial.print(",");
+        Serial.print(metricPercentile(i, 50));
+        Serial.print(",");
+        Serial.print(metricPercentile(i, 99));
+        Serial.print(",");
+        Serial.print(h->maxUs);
+        Serial.print(",");
+        Serial.println(h->count ? h->sumMs / h->count : 0);
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricsSerialPoll()
+// 功能：處理序列埠送入的查詢指令，在 loop() 或任務中定期呼叫
+// 指令：'m' - 印出所有數值；'r' - 清除所有數值；其他字元忽略
+// ---------------------------------------------------------------
+void metricsSerialPoll()
+{
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c == 'm') {
+            metricsPrint();
+        } else if (c == 'r') {
+            metricsReset();
+            Serial.println("METRIC,reset");
+        }
+    }
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricsEncode()
+// 功能：產生健康訊息
+// 格式：{"Device":"<MAC>","C":{"名稱":次數,...},"G":{"名稱":數值,...},
+//        "H":{"名稱":[次數,p50,p99,最長],...}}    時間單位為微秒
+//       次數為 0 的計數器與延遲分佈不列出，讓訊息維持精簡
+// 參數：buf - 輸出緩衝區；size - 緩衝區大小；dev - 裝置識別碼
+// 回傳：長度，緩衝區放不下標頭時回傳 0（放不下的項目略過）
+// ---------------------------------------------------------------
+int metricsEncode(char *buf, int size, const char *dev)
+{
+    metricsUpdateGauges();
+    int len = snprintf(buf, size, "{\"Device\":\"%s\",\"C\":{", dev);
+    if (len < 0 || len + 24 >= size) return 0;     // 各區段的標頭與結尾共需 24 位元組以內
+    char item[64];
+    bool first = true;
+    for (int i = 0; i < metricCounterCount; i++) {
+        if (metricCounters[i].value == 0) continue;
+        int n = snprintf(item, sizeof(item), "%s\"%s\":%lu", first ? "" : ",",
+                         metricCounters[i].name, (unsigned long)metricCounters[i].value);
+        if (len + n + 24 >= size) break;           // 保留結尾與其他區段標頭的空間
+        memcpy(buf + len, item, n + 1);
+        len += n;
+        first = false;
+    }
+    len += snprintf(buf + len, size - len, "},\"G\":{");
+    first = true;
+    for (int i = 0; i < metricGaugeCount; i++) {
+        int n = snprintf(item, sizeof(item), "%s\"%s\":%ld", first ? "" : ",",
+                         metricGauges[i].name, metricGauges[i].value);
+        if (len + n + 12 >= size) break;
+        memcpy(buf + len, item, n + 1);
+        len += n;
+        first = false;
+    }
+    len += snprintf(buf + len, size - len, "},\"H\":{");
+    first = true;
+    for (int i = 0; i < metricHistogramCount; i++) {
+        MetricHistogram *h = &metricHistograms[i];
+        if (h->count == 0) continue;
+        int n = snprintf(item, sizeof(item), "%s\"%s\":[%lu,%lu,%lu,%lu]", first ? "" : ",", h->name,
+                         (unsigned long)h->count, (unsigned long)metricPercentile(i, 50),
+                         (unsigned long)metricPercentile(i, 99), (unsigned long)h->maxUs);
+        if (len + n + 3 >= size) break;
+        memcpy(buf + len, item, n + 1);
+        len += n;
+        first = false;
+    }
+    len += snprintf(buf + len, size - len, "}}");
+    return len;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricsPublish()
+// 功能：以 AT+MQTTPUBRAW 發佈健康訊息（不需轉譯）
+// 參數：topic - 發佈主題；dev - 裝置識別碼
+// 回傳：送出成功傳回 true
+// 說明：發佈本身也會經過 AT 指令統計，下一則訊息才會看到
+// ---------------------------------------------------------------
+bool metricsPublish(const char *topic, const char *dev)
+{
+    int len = metricsEncode(metricsBuffer, sizeof(metricsBuffer), dev);
+    if (len == 0) return false;
+    return Wifi.writeBytes((const char *)metricsBuffer, len, topic);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricsReset()
+// 功能：清除所有數值（名稱保留，編號不變）
+// ---------------------------------------------------------------
+void metricsReset()
+{
+    for (int i = 0; i < metricCounterCount; i++) metricCounters[i].value = 0;
+    for (int i = 0; i < metricGaugeCount; i++) metricGauges[i].value = 0;
+    for (int i = 0; i < metricHistogramCount; i++) {
+        const char *name = metricHistograms[i].name;
+        memset(&metricHistograms[i], 0, sizeof(MetricHistogram));
+        metricHistograms[i].name = name;
+    }
+}
+
+#endif
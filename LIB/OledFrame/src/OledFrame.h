@@ -0,0 +1,226 @@
+// ================================================================
+// 檔案名稱：OledFrame.h
+// 描述：BMD31M090 OLED（128x64）畫面緩衝區與只送出變動部分的更新
+// 說明：點、線、框、圖畫在畫面緩衝區（每位元組為一欄 8 個像素，與 OLED 記憶體相同），
+//       並記錄每一頁（8 列像素）變動的欄範圍，updateScreen() 只送出變動的部分
+//       文字由 BMD31 直接寫到螢幕，oledTextMask 記錄文字占用的欄，送出時跳過這些欄，不會蓋掉文字
+// 使用：各草稿碼的 OledLib.h 先引入 BMD31M090.h、定義 BMD31M090_WIDTH / HEIGHT / ADDRESS，
+//       並定義 TwoWire *oledWire（與 BMD31 物件使用相同的 I2C 介面），再引入本檔
+// version:          V1.0.0
+// ================================================================
+#ifndef _OLEDFRAME_H_
+#define _OLEDFRAME_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define OLED_PAGES (BMD31M090_HEIGHT / 8)   // 頁數，每頁高 8 像素
+#ifndef OLED_I2C_CHUNK
+#define OLED_I2C_CHUNK 16                   // 每次 I2C 傳輸的資料位元組數（Wire 緩衝區為 32 bytes）
+#endif
+
+// 送出方式
+#define OLED_FLUSH_IMMEDIATE 0    // 每次繪圖後立即送出變動部分（預設）
+#define OLED_FLUSH_MANUAL    1    // 只在呼叫 updateScreen() 時送出
+#define OLED_FLUSH_FRAMERATE 2    // oledPoll() 依設定的間隔送出
+
+extern TwoWire *oledWire;   // 由草稿碼的 OledLib.h 定義
+
+uint8_t oledFrame[OLED_PAGES][BMD31M090_WIDTH];         // 畫面緩衝區
+uint8_t oledTextMask[OLED_PAGES][BMD31M090_WIDTH / 8];  // 文字占用的欄，每位元為一欄
+uint8_t oledDirtyLo[OLED_PAGES];                        // 每頁變動的第一欄
+uint8_t oledDirtyHi[OLED_PAGES];                        // 每頁變動的最後一欄（小於第一欄表示沒有變動）
+uint8_t oledFontWidth = 8;                              // 目前字型的寬度（像素），由 setFont() 設定
+uint8_t oledFontPages = 2;                              // 目前字型的高度（頁），由 setFont() 設定
+uint8_t oledFlushMode = OLED_FLUSH_IMMEDIATE;           // 送出方式
+unsigned long oledFrameInterval = 100;                  // OLED_FLUSH_FRAMERATE 的最短間隔（毫秒）
+unsigned long oledLastFlush = 0;                        // 上次送出的時間
+uint32_t oledBytesSent = 0;                             // updateScreen() 送出的 I2C 位元組數（統計用）
+
+//---------畫面緩衝區與送出----------------
+void updateScreen();                                // 送出所有變動的部分
+void oledSetFlushMode(uint8_t mode, unsigned long interval);  // 設定送出方式與更新間隔
+void oledPoll();                                    // OLED_FLUSH_FRAMERATE 時在 loop() 中定期呼叫
+bool oledIsDirty();                                 // 是否有尚未送出的變動
+void oledSetPixel(int x, int y, int pixelColor);    // 在畫面緩衝區設定一點並記錄變動
+void oledMarkDirty(uint8_t page, uint8_t lo, uint8_t hi);  // 記錄第 page 頁 lo~hi 欄有變動
+void oledMarkClean();                               // 清除所有變動記錄
+void oledClearFrame();                              // 清除畫面緩衝區與文字記錄（不送出）
+void oledFlushIfImmediate();                        // 立即模式時送出變動部分
+void oledFlushPage(uint8_t page, uint8_t lo, uint8_t hi);  // 送出第 page 頁 lo~hi 欄，跳過文字占用的欄
+bool oledIsText(uint8_t page, uint8_t col);         // 第 page 頁第 col 欄是否為文字
+void oledMarkText(int x, int y, const char *str);   // 記錄文字占用的欄
+void oledDrawBitmap(int x, int y, const uint8_t *pp, int width, int height, int pixelColor);  // 將點陣圖畫進畫面緩衝區
+
+//----------送出所有變動的部分------------------
+void updateScreen()
+{
+  // 每一頁只送出變動的欄範圍，沒有變動時不會有任何 I2C 傳輸
+  for (uint8_t page = 0; page < OLED_PAGES; page++)
+  {
+    if (oledDirtyHi[page] >= oledDirtyLo[page]) oledFlushPage(page, oledDirtyLo[page], oledDirtyHi[page]);
+  }
+  oledMarkClean();
+  oledLastFlush = millis();
+}
+
+//---------設定送出方式------------------
+// mode：OLED_FLUSH_IMMEDIATE / OLED_FLUSH_MANUAL / OLED_FLUSH_FRAMERATE
+// interval：OLED_FLUSH_FRAMERATE 的最短間隔（毫秒），例如 100 為每秒最多 10 次
+// 由批次模式切回立即模式時，先送出尚未送出的變動
+void oledSetFlushMode(uint8_t mode, unsigned long interval)
+{
+  oledFlushMode = mode;
+  oledFrameInterval = interval;
+  oledFlushIfImmediate();
+}
+
+//---------依間隔送出（OLED_FLUSH_FRAMERATE）------------------
+void oledPoll()   // 在 loop() 中定期呼叫
+{
+  if (oledFlushMode != OLED_FLUSH_FRAMERATE || !oledIsDirty()) return;
+  if (millis() - oledLastFlush >= oledFrameInterval) updateScreen();
+}
+
+//---------是否有尚未送出的變動------------------
+bool oledIsDirty()
+{
+  for (uint8_t page = 0; page < OLED_PAGES; page++)
+  {
+    if (oledDirtyHi[page] >= oledDirtyLo[page]) return true;
+  }
+  return false;
+}
+
+//---------在畫面緩衝區設定一點------------------
+// pixelColor：0 黑色、1 白色、2 反轉，顏色沒有改變的點不記錄變動
+void oledSetPixel(int x, int y, int pixelColor)
+{
+  if (x < 0 || x >= BMD31M090_WIDTH || y < 0 || y >= BMD31M090_HEIGHT) return;
+  uint8_t page = y >> 3;
+  uint8_t bit = 1 << (y & 7);
+  uint8_t old = oledFrame[page][x];
+  uint8_t now;
+  if (pixelColor == pixelColor_WHITE) now = old | bit;
+  else if (pixelColor == pixelColor_BLACK) now = old & ~bit;
+  else now = old ^ bit;
+  if (now == old) return;
+  oledFrame[page][x] = now;
+  oledMarkDirty(page, x, x);
+}
+
+//---------記錄第 page 頁 lo~hi 欄有變動------------------
+void oledMarkDirty(uint8_t page, uint8_t lo, uint8_t hi)
+{
+  if (oledDirtyHi[page] < oledDirtyLo[page])
+  {
+    oledDirtyLo[page] = lo;
+    oledDirtyHi[page] = hi;
+    return;
+  }
+  if (lo < oledDirtyLo[page]) oledDirtyLo[page] = lo;
+  if (hi > oledDirtyHi[page]) oledDirtyHi[page] = hi;
+}
+
+//---------清除所有變動記錄------------------
+void oledMarkClean()
+{
+  for (uint8_t page = 0; page < OLED_PAGES; page++)
+  {
+    oledDirtyLo[page] = 1;
+    oledDirtyHi[page] = 0;
+  }
+}
+
+//---------清除畫面緩衝區與文字記錄（不送出）------------------
+void oledClearFrame()
+{
+  memset(oledFrame, 0, sizeof(oledFrame));
+  memset(oledTextMask, 0, sizeof(oledTextMask));
+  oledMarkClean();
+}
+
+//---------立即模式時送出變動部分------------------
+void oledFlushIfImmediate()
+{
+  if (oledFlushMode == OLED_FLUSH_IMMEDIATE && oledIsDirty()) updateScreen();
+}
+
+//---------送出第 page 頁 lo~hi 欄------------------
+// 設定頁位址與起始欄（頁定址模式）後分段寫入，欄位址會自動遞增
+// 文字占用的欄不送出，連續的非文字欄為一段
+void oledFlushPage(uint8_t page, uint8_t lo, uint8_t hi)
+{
+  for (uint8_t col = lo; col <= hi; col++)
+  {
+    if (oledIsText(page, col)) continue;
+    uint8_t end = col;
+    while (end < hi && !oledIsText(page, end + 1)) end++;
+
+    oledWire->beginTransmission(BMD31M090_ADDRESS);
+    oledWire->write(0x00);                 // 以下為指令
+    oledWire->write(0xB0 | page);          // 頁位址
+    oledWire->write(0x00 | (col & 0x0F));  // 起始欄低 4 位元
+    oledWire->write(0x10 | (col >> 4));    // 起始欄高 4 位元
+    oledWire->endTransmission();
+    oledBytesSent += 4;
+
+    while (col <= end)
+    {
+      uint8_t n = end - col + 1;
+      if (n > OLED_I2C_CHUNK) n = OLED_I2C_CHUNK;
+      oledWire->beginTransmission(BMD31M090_ADDRESS);
+      oledWire->write(0x40);               // 以下為顯示資料
+      oledWire->write(&oledFrame[page][col], n);
+      oledWire->endTransmission();
+      oledBytesSent += n + 1;
+      col += n;
+    }
+    col = end;
+  }
+}
+
+//---------第 page 頁第 col 欄是否為文字------------------
+bool oledIsText(uint8_t page, uint8_t col)
+{
+  return oledTextMask[page][col >> 3] & (1 << (col & 7));
+}
+
+//---------記錄文字占用的欄------------------
+// x：欄（像素），y：列（頁），依目前字型的寬度與高度記錄
+// 空白字元在螢幕上是全黑，之後的繪圖可以再使用，所以取消記錄並清除緩衝區的這些欄
+void oledMarkText(int x, int y, const char *str)
+{
+  for (; *str != 0 && x < BMD31M090_WIDTH; str++, x += oledFontWidth)
+  {
+    for (uint8_t page = y; page < y + oledFontPages && page < OLED_PAGES; page++)
+    {
+      for (int col = x; col < x + oledFontWidth && col < BMD31M090_WIDTH; col++)
+      {
+        if (*str == ' ')
+        {
+          oledTextMask[page][col >> 3] &= ~(1 << (col & 7));
+          oledFrame[page][col] = 0;
+        }
+        else oledTextMask[page][col >> 3] |= 1 << (col & 7);
+      }
+    }
+  }
+}
+
+//---------將點陣圖畫進畫面緩衝區------------------
+// 點陣圖為橫向格式，每列 (width + 7) / 8 bytes，最高位元在左邊
+// 只畫出位元為 1 的點，顏色同 oledSetPixel()
+void oledDrawBitmap(int x, int y, const uint8_t *pp, int width, int height, int pixelColor)
+{
+  int bytesPerRow = (width + 7) / 8;
+  for (int j = 0; j < height; j++)
+  {
+    for (int i = 0; i < width; i++)
+    {
+      if (pgm_read_byte(pp + j * bytesPerRow + i / 8) & (0x80 >> (i & 7))) oledSetPixel(x + i, y + j, pixelColor);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,322 @@
+// ================================================================
+// 檔案名稱：TaskLib.h
+// 描述：協同式任務排程函式庫（不配置動態記憶體、固定容量）
+// 功能：取代 loop() 中以 delay() 等待的寫法，讓各項工作各自排程
+//       - 週期任務：每隔 period 毫秒執行一次（taskAddPeriodic）
+//       - 單次計時：taskStart() 設定的時間到了執行一次後停止（taskAddTimer）
+//       - 事件任務：平時不執行，taskSignal() 喚醒後執行一次（taskAddEvent），
+//         taskSignal() 只設定旗標，可在中斷服務程式中呼叫
+//       - 每個任務有自己的期限 deadline：同時到期時先執行期限最早的任務，
+//         開始時間晚於到期時間 + deadline 時記為一次逾時（taskReport() 可查看）
+// 使用方式：
+//   int dhtTask = taskAddPeriodic("dht", sampleDHT, 120000, 1000);
+//   void loop() { taskRun(); }
+// 注意：任務函式不可再呼叫 delay() 長時間等待，否則其他任務都會跟著延後
+// ================================================================
+
+#ifndef _TASKLIB_H_
+#define _TASKLIB_H_
+
+#include <Arduino.h>
+
+// ================================================================
+// =============== 排程設定常數區 ===============
+// ================================================================
+#ifndef TASK_MAX_TASKS
+#define TASK_MAX_TASKS 8           // 最多可登錄的任務數
+#endif
+#define TASK_NONE -1               // 登錄失敗或沒有任務時的編號
+
+// 任務種類
+#define TASK_PERIODIC 0            // 依週期重複執行
+#define TASK_TIMER    1            // 時間到了執行一次後停止
+#define TASK_EVENT    2            // 等待 taskSignal() 喚醒
+
+// ================================================================
+// =============== 資料結構宣告區 ===============
+// ================================================================
+typedef void (*TaskFunction)(void);    // 任務函式：沒有參數也沒有回傳值
+
+// 一個任務的設定與統計
+typedef struct
+{
+    const char *name;                  // 任務名稱（字串常數，不複製）
+    TaskFunction func;                 // 任務函式
+    uint8_t kind;                      // 任務種類（TASK_PERIODIC ...）
+    bool active;                       // 是否在排程中
+    volatile bool signaled;            // 是否有尚未處理的喚醒（可由中斷設定）
+    uint8_t pass;                      // 最後一次執行時的 taskRun() 輪次
+    unsigned long period;              // 週期（毫秒，只用於週期任務）
+    unsigned long deadline;            // 到期後可容許延遲的時間（毫秒）
+    unsigned long due;                 // 下次到期的 millis()
+    uint32_t runs;                     // 執行次數
+    uint32_t late;                     // 逾時次數
+    uint32_t skipped;                  // 落後整個週期以上而略過的次數
+    unsigned long maxLate;             // 最大延遲（毫秒）
+    unsigned long maxRunUs;            // 單次執行最長時間（微秒）
+} Task;
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+Task taskTable[TASK_MAX_TASKS];        // 任務表
+uint8_t taskCount = 0;                 // 已登錄的任務數
+uint8_t taskPass = 0;                  // taskRun() 輪次，用來讓每個任務每輪最多執行一次
+int taskCurrent = TASK_NONE;           // 正在執行的任務編號
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+int  taskAddPeriodic(const char *name, TaskFunction func, unsigned long period, unsigned long deadline);  // 登錄週期任務（立即開始）
+int  taskAddTimer(const char *name, TaskFunction func, unsigned long deadline);   // 登錄單次計時任務（taskStart() 後才開始）
+int  taskAddEvent(const char *name, TaskFunction func, unsigned long deadline);   // 登錄事件任務
+void taskStart(int id, unsigned long delayMs);     // 在 delayMs 毫秒後執行（週期任務由此重新起算）
+void taskStop(int id);                             // 停止排程
+void taskSignal(int id);                           // 喚醒任務（可在中斷中呼叫）
+void taskSetPeriod(int id, unsigned long period);  // 變更週期，由下一次到期後生效
+bool taskIsActive(int id);                         // 任務是否在排程中
+uint8_t taskRun();                                 // 執行所有已到期的任務，在 loop() 中呼叫
+unsigned long taskIdleTime();                      // 距離下一個任務到期的毫秒數
+void taskReport();                                 // 由序列埠印出各任務的統計
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：taskAdd()
+// 功能：在任務表中登錄一個任務（內部使用）
+// 回傳：任務編號，任務表已滿時回傳 TASK_NONE
+// ---------------------------------------------------------------
+int taskAdd(const char *name, TaskFunction func, uint8_t kind,
+            unsigned long period, unsigned long deadline, bool active)
+{
+    if (taskCount >= TASK_MAX_TASKS || func == NULL) return TASK_NONE;
+    Task *t = &taskTable[taskCount];
+    memset(t, 0, sizeof(Task));
+    t->name = name;
+    t->func = func;
+    t->kind = kind;
+    t->period = period;
+    t->deadline = deadline;
+    t->due = millis();
+    t->active = active;
+    t->pass = taskPass;
+    return taskCount++;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskAddPeriodic()
+// 功能：登錄週期任務，第一次在下一輪 taskRun() 就執行
+// 參數：name - 任務名稱（須為字串常數）
+//       func - 任務函式
+//       period - 週期（毫秒）
+//       deadline - 到期後可容許延遲的時間（毫秒）
+// 回傳：任務編號，任務表已滿時回傳 TASK_NONE
+// ---------------------------------------------------------------
+int taskAddPeriodic(const char *name, TaskFunction func, unsigned long period, unsigned long deadline)
+{
+    return taskAdd(name, func, TASK_PERIODIC, period, deadline, true);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskAddTimer()
+// 功能：登錄單次計時任務，呼叫 taskStart() 後才開始計時
+// 參數：name - 任務名稱；func - 任務函式；deadline - 可容許延遲（毫秒）
+// 回傳：任務編號，任務表已滿時回傳 TASK_NONE
+// ---------------------------------------------------------------
+int taskAddTimer(const char *name, TaskFunction func, unsigned long deadline)
+{
+    return taskAdd(name, func, TASK_TIMER, 0, deadline, false);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskAddEvent()
+// 功能：登錄事件任務，只有 taskSignal() 喚醒時才執行
+// 參數：name - 任務名稱；func - 任務函式
+//       deadline - 喚醒後可容許延遲的時間（毫秒），用來決定執行順序
+// 回傳：任務編號，任務表已滿時回傳 TASK_NONE
+// ---------------------------------------------------------------
+int taskAddEvent(const char *name, TaskFunction func, unsigned long deadline)
+{
+    return taskAdd(name, func, TASK_EVENT, 0, deadline, true);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskStart()
+// 功能：(重新) 開始排程，在 delayMs 毫秒後執行
+// 參數：id - 任務編號；delayMs - 延遲時間（毫秒），0 表示下一輪就執行
+// 說明：週期任務之後的到期時間由這次起算
+// ---------------------------------------------------------------
+void taskStart(int id, unsigned long delayMs)
+{
+    if (id < 0 || id >= taskCount) return;
+    taskTable[id].due = millis() + delayMs;
+    taskTable[id].active = true;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskStop()
+// 功能：停止排程，尚未處理的喚醒也一併清除
+// ---------------------------------------------------------------
+void taskStop(int id)
+{
+    if (id < 0 || id >= taskCount) return;
+    taskTable[id].active = false;
+    taskTable[id].signaled = false;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskSignal()
+// 功能：喚醒任務，下一輪 taskRun() 就執行（週期任務提前執行並重新起算週期）
+// 說明：只寫入一個位元組的旗標，可在中斷服務程式中呼叫；
+//       執行前重複喚醒只會執行一次
+// ---------------------------------------------------------------
+void taskSignal(int id)
+{
+    if (id < 0 || id >= taskCount) return;
+    taskTable[id].signaled = true;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskSetPeriod()
+// 功能：變更週期任務的週期，由下一次到期後生效
+// ---------------------------------------------------------------
+void taskSetPeriod(int id, unsigned long period)
+{
+    if (id < 0 || id >= taskCount) return;
+    taskTable[id].period = period;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskIsActive()
+// 功能：任務是否在排程中（單次計時任務執行後即停止）
+// ---------------------------------------------------------------
+bool taskIsActive(int id)
+{
+    if (id < 0 || id >= taskCount) return false;
+    return taskTable[id].active;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskReady()
+// 功能：任務是否可以執行（內部使用）
+// 回傳：可以執行時傳回 true，並由 slack 傳回距離期限的毫秒數（越小越急）
+// ---------------------------------------------------------------
+bool taskReady(Task *t, unsigned long now, long *slack)
+{
+    if (!t->active || t->pass == taskPass) return false;
+    if (t->signaled) {
+        *slack = (long)t->deadline;
+        return true;
+    }
+    if (t->kind == TASK_EVENT || (long)(now - t->due) < 0) return false;
+    *slack = (long)(t->due + t->deadline - now);
+    return true;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskRun()
+// 功能：執行所有已到期或已喚醒的任務
+// 回傳：這一輪執行的任務數
+// 說明：每次挑選期限最早的任務執行，每個任務每輪最多執行一次，
+//       週期很短的任務不會讓其他任務等不到；沒有任務到期時立即返回
+//       週期任務以固定速率排程（到期時間加上週期），
+//       落後整個週期以上時不補執行，由現在重新起算
+// ---------------------------------------------------------------
+uint8_t taskRun()
+{
+    uint8_t ran = 0;
+    taskPass++;
+    for (;;) {
+        unsigned long now = millis();
+        int best = TASK_NONE;
+        long bestSlack = 0;
+        for (int i = 0; i < taskCount; i++) {
+            long slack;
+            if (taskReady(&taskTable[i], now, &slack) && (best == TASK_NONE || slack < bestSlack)) {
+                best = i;
+                bestSlack = slack;
+            }
+        }
+        if (best == TASK_NONE) break;
+
+        Task *t = &taskTable[best];
+        unsigned long lateMs = t->signaled ? 0 : now - t->due;
+        t->signaled = false;            // 先清除，執行中再次喚醒會在下一輪執行
+        t->pass = taskPass;
+        if (lateMs > t->deadline) t->late++;
+        if (lateMs > t->maxLate) t->maxLate = lateMs;
+
+        if (t->kind == TASK_PERIODIC) {
+            if (t->period == 0 || (long)(now - t->due) < 0) {
+                t->due = now + t->period;               // 每輪執行，或被喚醒提前執行：由現在起算
+            } else {
+                t->due += t->period;
+                if ((long)(now - t->due) >= 0) {        // 落後整個週期以上
+                    t->skipped += (now - t->due) / t->period + 1;
+                    t->due = now + t->period;
+                }
+            }
+        } else if (t->kind == TASK_TIMER) {
+            t->active = false;
+        }
+
+        taskCurrent = best;
+        unsigned long startUs = micros();
+        t->func();
+        unsigned long runUs = micros() - startUs;
+        taskCurrent = TASK_NONE;
+        t->runs++;
+        if (runUs > t->maxRunUs) t->maxRunUs = runUs;
+        ran++;
+    }
+    return ran;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskIdleTime()
+// 功能：距離下一個任務到期的毫秒數（可用來決定能否進入省電模式）
+// 回傳：已有任務到期或已喚醒時回傳 0；沒有任何計時中的任務時回傳 0xFFFFFFFF
+// ---------------------------------------------------------------
+unsigned long taskIdleTime()
+{
+    unsigned long now = millis();
+    unsigned long idle = 0xFFFFFFFFUL;
+    for (int i = 0; i < taskCount; i++) {
+        Task *t = &taskTable[i];
+        if (!t->active) continue;
+        if (t->signaled) return 0;
+        if (t->kind == TASK_EVENT) continue;
+        long left = (long)(t->due - now);
+        if (left <= 0) return 0;
+        if ((unsigned long)left < idle) idle = left;
+    }
+    return idle;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：taskReport()
+// 功能：每個任務印出一列統計
+// 欄位：TASK,名稱,執行次數,逾時次數,略過次數,最大延遲(ms),最長執行時間(us)
+// ---------------------------------------------------------------
+void taskReport()
+{
+    for (int i = 0; i < taskCount; i++) {
+        Task *t = &taskTable[i];
+        Serial.print("TASK,");
+        Serial.print(t->name);
+        Serial.print(",");
+        Serial.print(t->runs);
+        Serial.print(",");
+        Serial.print(t->late);
+        Serial.print(",");
+        Serial.print(t->skipped);
+        Serial.print(",");
+        Serial.print(t->maxLate);
+        Serial.print(",");
+        Serial.println(t->maxRunUs);
+    }
+}
+
+#endif
@@ -1,6 +1,7 @@
 import paho.mqtt.client as mqtt  # 導入 paho.mqtt.client 套件，並將其命名為 mqtt
 # 使用 paho 套件，將 paho.mqtt.client 套件下連線的物件 import 進來並更名為 mqtt
 import json #將json套件仔入
+from commlib import decode_payload  # 解析 JSON、批次或二進位（PackLib.h）承載資料
 
 # 設定 MQTT Broker 伺服器詳細資訊
 broker_address = "broker.emqx.io"  # 設定 MQTT Broker 伺服器網址
@@ -60,13 +61,12 @@ def on_message(client, userdata, msg):
     print("Data coming from "+msg.topic)  # 打印接收到的主題和消息內容
     # jsonStr = json.dumps(msg.payload, ensure_ascii=False, indent=4)
     print("Payload is :\n"+str(msg.payload))  # 打印接收到的主題和消息內容
-    Payload = msg.payload.decode("utf-8")
-    jsondata = json.loads(Payload)
-    jsonStr = json.dumps(jsondata, ensure_ascii=False, indent=4)
-    print(jsonStr)  # 印出jsonStr
-    print("Devce:",jsondata["Device"])
-    print("Temperature:",jsondata["Temperature"])
-    print("Humidity:",jsondata["Humidity"])
+    # decode_payload() 自動分辨單筆 JSON、批次 JSON 與 PackLib.h 的二進位格式
+    for device, temperature, humidity, systime in decode_payload(msg.payload):
+        print("Devce:",device)
+        print("Temperature:",temperature)
+        print("Humidity:",humidity)
+        print("Time:",systime)
 
 
 
@@ -24,16 +24,21 @@ from commlib import *
 # 匯入 pymysql 套件，並命名為 DB，作為資料庫連線與操作的工具
 import pymysql as DB
 
+# 匯入佇列、執行緒與時間模組（Python 內建），用來把資料庫寫入移出 MQTT 網路執行緒
+import queue
+import threading
+import time
+
 # ==================== 資料庫連線設定 ====================
 
-# 建立資料庫連線物件，參數說明如下：
+# 資料庫連線參數，說明如下：
 # host：資料庫主機名稱（localhost 表示本機）
 # port：連接埠號（MySQL 預設為 3306）
 # user：登入資料庫使用者名稱
 # passwd：登入密碼
 # db：要連接的資料庫名稱
 # charset：資料編碼格式，使用 utf8，確保中文等字元正確儲存
-db = DB.connect(
+DB_CONFIG = dict(
     host='localhost',  # 資料庫主機位址
     port=3306,  # MySQL 預設通訊埠
     user='big',  # 資料庫使用者名稱
@@ -42,15 +47,57 @@ db = DB.connect(
     charset='utf8'  # 使用 UTF-8 編碼
 )
 
-# 建立資料庫游標，用來執行 SQL 指令
-# 游標（cursor）是資料庫操作的核心物件，用於執行查詢和獲取結果
-cursor = db.cursor()
+# ==================== 批次寫入設定 ====================
+# on_message() 在 paho 的網路執行緒中執行，若在這裡直接寫資料庫，
+# 每一筆 INSERT 的往返時間都會卡住所有節點的訊息接收；
+# 因此 on_message() 只負責解析並放進佇列，由獨立的寫入執行緒批次寫入
+QUEUE_MAX = 10000  # 佇列最多暫存的樣本數（滿了就丟棄並計數，避免記憶體無限成長）
+BATCH_SIZE = 200  # 累積到這麼多筆就立即寫入
+FLUSH_INTERVAL = 1.0  # 佇列中最舊的樣本最多等待的秒數，不足一批也會寫入
+RECONNECT_MIN = 1.0  # 資料庫斷線後第一次重新連線前等待的秒數
+RECONNECT_MAX = 30.0  # 重新連線等待時間每次加倍，最長不超過這個秒數
+STATS_INTERVAL = 60.0  # 每隔多少秒顯示一次寫入統計
+VERBOSE = False  # 是否逐筆顯示收到的資料（每分鐘數千筆時請關閉）
+
+# 本機 IP 在程式執行期間不會改變，啟動時取得一次即可
+# （原本每筆資料都呼叫 get_local_ip()，每次都要建立一個 socket）
+local_ip = get_local_ip()
+
+# 樣本佇列：元素為 (MAC, IP, temperature, humidity, systime)，直接對應 sqlstr 的參數
+sample_queue = queue.Queue(maxsize=QUEUE_MAX)
+
+# 統計數字（只有計數，由寫入執行緒與 on_message() 各自累加）
+stats = {
+    'received': 0,  # 放進佇列的樣本數
+    'dropped': 0,  # 佇列已滿而丟棄的樣本數
+    'written': 0,  # 已提交到資料庫的樣本數
+    'batches': 0,  # 已提交的批次數
+    'errors': 0,  # 寫入失敗（會重新連線後重試）的次數
+    'malformed': 0,  # 無法解析而略過的訊息數
+}
+
+
+def connect_db():
+    """
+    建立資料庫連線，失敗時以指數退避方式重試，直到連線成功為止
 
-# 測試用的 SQL 指令，插入一筆固定的資料到 dhtdata 資料表
-# 這行程式碼主要用於測試資料庫連線是否正常
-sql1 = "INSERT INTO dhtdata (id, MAC, crtdatetime, temperature, humidity, systime) VALUES (NULL, 'a01110001', current_timestamp(), '25.3', '88.9', '20220624220101');"
+    等待時間由 RECONNECT_MIN 開始每次加倍，最長 RECONNECT_MAX 秒，
+    避免資料庫重新啟動期間不斷連線造成負擔
+
+    返回值：
+    pymysql.connections.Connection: 已連線的資料庫物件（autocommit 關閉，每批次手動提交）
+    """
+    delay = RECONNECT_MIN
+    while True:
+        try:
+            conn = DB.connect(autocommit=False, **DB_CONFIG)
+            print("已連線到資料庫")
+            return conn
+        except DB.Error as e:
+            print("資料庫連線失敗：%s，%.0f 秒後重試" % (e, delay))
+            time.sleep(delay)
+            delay = min(delay * 2, RECONNECT_MAX)
 
-# ------------------------------ # 
 
 # ==================== MQTT 連線設定 ====================
 
@@ -70,14 +117,95 @@ topic = "/arduino/dht/#"  # 要訂閱的主題（topic），# 是萬用字元
 
 # ==================== SQL 語法模板 ====================
 
-# SQL 字串模板，將接收到的 JSON 解析後組合為 SQL 插入語法
+# 參數化的 SQL 插入語法，由 pymysql 負責跳脫與型別轉換
+# （原本以 % 字串格式化組合，每筆都要重新組字串，且裝置名稱未經跳脫）
 # 欄位說明：
 # - MAC: 裝置的 MAC 地址（從 JSON 的 Device 欄位取得）
-# - IP: 本地電腦的 IP 地址（從 get_local_ip() 函數取得）
+# - IP: 本地電腦的 IP 地址（啟動時由 get_local_ip() 取得）
 # - temperature: 溫度值（從 JSON 的 Temperature 欄位取得）
 # - humidity: 濕度值（從 JSON 的 Humidity 欄位取得）
-# - systime: 系統時間（從 getsystime() 函數取得）
-sqlstr0 = "INSERT INTO dhtdata (MAC, IP, temperature, humidity, systime) VALUES ('%s', '%s', %f, %f, '%s');"
+# - systime: 取樣時間（由 decode_payload() 回推）
+# executemany() 會把整批參數合併成一個多列的 INSERT 指令送出
+sqlstr = "INSERT INTO dhtdata (MAC, IP, temperature, humidity, systime) VALUES (%s, %s, %s, %s, %s)"
+
+
+# ==================== 資料庫寫入執行緒 ====================
+
+def write_batch(conn, batch):
+    """
+    以一個交易寫入一批樣本
+
+    參數：
+    conn: 資料庫連線物件
+    batch (list): (MAC, IP, temperature, humidity, systime) 的清單
+
+    說明：
+    成功時整批一起提交；失敗時復原交易並丟出例外，由呼叫端重新連線後重試同一批
+    """
+    try:
+        with conn.cursor() as cursor:
+            cursor.executemany(sqlstr, batch)
+        conn.commit()
+    except DB.Error:
+        try:
+            conn.rollback()
+        except DB.Error:
+            pass  # 連線已中斷時無法復原，交易本來就不會生效
+        raise
+
+
+def db_writer():
+    """
+    資料庫寫入執行緒的主迴圈
+
+    從佇列取出樣本，累積到 BATCH_SIZE 筆，或最舊的樣本已等待 FLUSH_INTERVAL 秒時，
+    以 write_batch() 一次寫入並提交；寫入失敗時重新連線（指數退避）後重試同一批，
+    資料不會因資料庫暫時中斷而遺失（佇列滿時才會在 on_message() 端丟棄）
+    """
+    conn = connect_db()
+    batch = []
+    deadline = None  # 目前這一批必須寫入的時間
+    next_stats = time.monotonic() + STATS_INTERVAL
+
+    while True:
+        # ---------- 收集樣本：等到批次滿或時間到 ----------
+        timeout = FLUSH_INTERVAL if deadline is None else max(0.0, deadline - time.monotonic())
+        try:
+            row = sample_queue.get(timeout=timeout)
+            if deadline is None:
+                deadline = time.monotonic() + FLUSH_INTERVAL
+            batch.append(row)
+            # 佇列中已有的樣本直接取出，不必每筆都等待
+            while len(batch) < BATCH_SIZE:
+                batch.append(sample_queue.get_nowait())
+        except queue.Empty:
+            pass
+
+        # ---------- 寫入：批次滿或最舊的樣本已等待太久 ----------
+        if batch and (len(batch) >= BATCH_SIZE or time.monotonic() >= deadline):
+            while True:
+                try:
+                    write_batch(conn, batch)
+                    break
+                except DB.Error as e:
+                    stats['errors'] += 1
+                    print("寫入資料庫失敗：%s，重新連線後重試 %d 筆" % (e, len(batch)))
+                    try:
+                        conn.close()
+                    except DB.Error:
+                        pass
+                    conn = connect_db()
+            stats['written'] += len(batch)
+            stats['batches'] += 1
+            batch = []
+            deadline = None
+
+        # ---------- 定期顯示統計 ----------
+        if time.monotonic() >= next_stats:
+            next_stats += STATS_INTERVAL
+            print("寫入統計：收到 %d 筆、寫入 %d 筆（%d 批）、丟棄 %d 筆、錯誤 %d 次、格式錯誤 %d 則、佇列 %d 筆" % (
+                stats['received'], stats['written'], stats['batches'],
+                stats['dropped'], stats['errors'], stats['malformed'], sample_queue.qsize()))
 
 
 # ==================== MQTT 回調函數定義 ====================
@@ -127,68 +255,55 @@ def on_message(client, userdata, msg):
           msg.retain：訊息是否為保留訊息（Broker 會保存並發送給新訂閱者）
     """
     # 顯示訊息來源的主題和原始數據
-    print("接收到來自主題的數據: " + str(msg.payload))
-    print("Data coming from " + msg.topic)  # 顯示主題名稱
-
-    # ==================== 步驟 1：解碼位元組數據 ====================
-    # 將接收到的位元組資料解碼為 UTF-8 格式的字串
-    # decode("utf-8") 將 bytes 類型轉換為 string 類型
-    Payload = msg.payload.decode("utf-8")
-
-    # ==================== 步驟 2：解析 JSON 數據 ====================
-    # 將 JSON 格式的字串解析為 Python 字典物件
-    # json.loads() 函數將 JSON 字串轉換為 Python 字典
-    jsondata = json.loads(Payload)
-
-    # ==================== 步驟 3：格式化並顯示 JSON 數據 ====================
-    # 將字典轉換為格式化的 JSON 字串（方便閱讀）
-    # json.dumps() 函數將 Python 字典轉換為格式化的 JSON 字串
-    # - ensure_ascii=False: 允許非 ASCII 字元（如中文）正確顯示
-    # - indent=4: 使用 4 個空格縮排，讓 JSON 更易讀
-    jsonStr = json.dumps(jsondata, ensure_ascii=False, indent=4)
-    print("格式化後的 JSON 數據:")
-    print(jsonStr)
-
-    # ==================== 步驟 4：提取所需的數據欄位 ====================
-    # 從 JSON 數據中提取裝置識別碼、溫度和濕度值
-    # 使用 .get() 方法可以安全地獲取值，避免鍵不存在的錯誤
-    device = jsondata.get("Device")  # 裝置 MAC 地址
-    temperature = jsondata.get("Temperature")  # 溫度值
-    humidity = jsondata.get("Humidity")  # 濕度值
-
-    # 顯示提取的數據值
-    print("裝置識別碼 (Device):", device)
-    print("溫度值 (Temperature):", temperature)
-    print("濕度值 (Humidity):", humidity)
-
-    # ==================== 步驟 5：組合 SQL 插入語句 ====================
-    # 根據接收到的 JSON 數據組合 SQL 語法
-    # 使用 sqlstr0 模板，插入以下資料：
-    # 1. device: 裝置 MAC 地址
-    # 2. get_local_ip(): 從 commlib 模組取得本地 IP 地址
-    # 3. temperature: 溫度值（浮點數）
-    # 4. humidity: 濕度值（浮點數）
-    # 5. getsystime(): 從 commlib 模組取得系統時間
-    sqlstr = sqlstr0 % (
-        device,  # %s: 字串類型的裝置 MAC
-        get_local_ip(),  # %s: 字串類型的本地 IP
-        temperature,  # %f: 浮點數類型的溫度值
-        humidity,  # %f: 浮點數類型的濕度值
-        getsystime()  # %s: 字串類型的系統時間
-    )
-
-    # 顯示組合完成的 SQL 指令（用於除錯）
-    print("即將執行的 SQL 指令:")
-    print(sqlstr)
-
-    # ==================== 步驟 6：執行 SQL 指令 ====================
-    # 使用資料庫游標執行 SQL 指令，將資料插入資料庫中
-    # cursor.execute() 執行 SQL 語句
-    cursor.execute(sqlstr)
-
-    # 注意：這裡沒有使用 db.commit()，可能需要根據需求手動提交事務
-    # 如果沒有自動提交，需要加上 db.commit() 才能將數據真正寫入資料庫
-    # db.commit()  # 如果需要手動提交，請取消註解這行
+    if VERBOSE:
+        print("接收到來自主題的數據: " + str(msg.payload))
+        print("Data coming from " + msg.topic)  # 顯示主題名稱
+
+    # ==================== 步驟 1~3：解析承載資料 ====================
+    # 裝置可能送來以下幾種承載資料，decode_payload() 會自動分辨：
+    #   1. 單筆 JSON：{"Device":..,"Temperature":..,"Humidity":..}（補送資料另有 "Age" 秒數）
+    #   2. 批次 JSON：BatchLib.h 以 AT+MQTTPUBRAW 送出的 {"Device":..,"Batch":[[經過毫秒,溫度,濕度],...]}
+    #   3. 二進位：PackLib.h 的精簡格式（第一個位元組為 0xD1，單筆只有 17 位元組）
+    # 全部拆成 (裝置, 溫度, 濕度, 取樣時間) 的清單，
+    # 取樣時間依經過毫秒（或補送資料的 Age 秒數）由收到的時間回推
+    # 格式錯誤的訊息只計數並略過，例外不可離開回調函數（會中斷 paho 的網路執行緒）
+    try:
+        samples = decode_payload(msg.payload)
+    except json.JSONDecodeError as e:
+        # 處理 JSON 解析過程中可能發生的錯誤
+        stats['malformed'] += 1
+        print(f"JSON 解析錯誤: {e}")
+        return
+    except UnicodeDecodeError as e:
+        # 處理字串解碼過程中可能發生的錯誤
+        stats['malformed'] += 1
+        print(f"解碼錯誤: {e}")
+        return
+    except ValueError as e:
+        # 處理二進位格式的識別碼、版本或長度錯誤
+        stats['malformed'] += 1
+        print(f"二進位資料錯誤: {e}")
+        return
+    except Exception as e:
+        # 處理其他未預期的錯誤（例如 JSON 欄位型態不符）
+        stats['malformed'] += 1
+        print(f"其他未預期錯誤: {e}")
+        return
+    if VERBOSE:
+        print("樣本數:", len(samples))
+
+    # ==================== 步驟 4：放進寫入佇列 ====================
+    # 這裡不碰資料庫，只把樣本交給 db_writer() 執行緒批次寫入，
+    # 網路執行緒可以立刻回去接收下一則訊息
+    # 佇列已滿（資料庫長時間無法寫入）時丟棄新樣本並計數，不阻塞 MQTT 連線
+    for device, temperature, humidity, systime in samples:
+        try:
+            sample_queue.put_nowait((device, local_ip, temperature, humidity, systime))
+            stats['received'] += 1
+        except queue.Full:
+            stats['dropped'] += 1
+            if stats['dropped'] % 100 == 1:
+                print("寫入佇列已滿，已丟棄 %d 筆樣本" % stats['dropped'])
 
 
 # ------------------------------ #
@@ -223,6 +338,10 @@ client.connect(broker_address, port, 60)
 # 1. 監聽 MQTT 訊息
 # 2. 處理接收到的訊息
 # 3. 維持與 Broker 的連線
+# 先啟動資料庫寫入執行緒（daemon：按 Ctrl+C 結束主程式時一併結束）
+writer = threading.Thread(target=db_writer, name="db_writer", daemon=True)
+writer.start()
+
 print("MQTT 客戶端已啟動，開始監聽主題: " + topic)
 print("正在等待接收感測器數據...")
 print("-" * 50)
@@ -232,6 +351,6 @@ client.loop_forever()
 # 注意事項：
 # 1. 程式執行到 client.loop_forever() 會進入無窮循環
 # 2. 若要停止程式，請按 Ctrl+C 中斷執行
-# 3. 建議在程式中加入錯誤處理和資料庫事務管理
+# 3. 資料庫寫入在 db_writer 執行緒中批次進行，每批一個交易，斷線會自動重新連線
 # 4. 確保 MySQL 服務正在運行且連線參數正確
 # 5. commlib 模組必須存在於 Python 路徑中
\ No newline at end of file
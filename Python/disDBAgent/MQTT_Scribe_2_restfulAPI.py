@@ -9,6 +9,13 @@ MQTT 到 RESTful API 轉接器
 import paho.mqtt.client as mqtt  # 導入 MQTT 客戶端套件，用於 MQTT 通訊協定
 import json  # 導入 JSON 套件，用於解析和處理 JSON 格式數據
 import requests  # 導入 HTTP 請求套件，用於發送 HTTP GET 請求到伺服器
+from requests.adapters import HTTPAdapter  # 設定每個工作執行緒的連線池大小
+from commlib import decode_payload  # 解析 JSON、批次或二進位（PackLib.h）承載資料
+import queue  # 有上限的轉發佇列
+import random  # 重試等待時間的隨機抖動（jitter）
+import sys  # 讀取命令列參數（可改用本機的假 API 端點做負載測試）
+import threading  # 轉發工作執行緒與統計執行緒
+import time  # 計算延遲與統計間隔
 
 # ==================== MQTT 連線設定 ====================
 # 設定 MQTT Broker（伺服器）的詳細資訊
@@ -22,6 +29,46 @@ topic = "/arduino/dht/#"  # 要訂閱的主題（Topic），# 是萬用字元，
 # 設定要轉發數據的 HTTP RESTful API 端點
 BASE_URL = "http://iot.arduino.org.tw:8888/bmduino/dhtdata/dataadd.php"  # HTTP API 的基礎 URL
 
+# 負載測試時可在命令列指定其他端點，例如搭配 fakeRestServer.py：
+#   python MQTT_Scribe_2_restfulAPI.py http://localhost:8890/bmduino/dhtdata/dataadd.php
+if len(sys.argv) > 1:
+    BASE_URL = sys.argv[1]
+
+# ==================== 轉發設定 ====================
+# on_message() 在 paho 的網路執行緒中執行，若在這裡直接送 HTTP 請求，
+# 每則訊息都要等一次完整的往返（數十到數百毫秒），訊息就會在 Broker 端堆積；
+# 因此 on_message() 只負責解析並放進佇列，由多個工作執行緒同時轉發
+WORKER_COUNT = 8  # 同時轉發的工作執行緒數量（每個各自保持一條 keep-alive 連線）
+QUEUE_MAX = 5000  # 佇列最多暫存的樣本數（滿了就丟棄並計數，不阻塞 MQTT 連線）
+HTTP_TIMEOUT = 5.0  # 單次 HTTP 請求的逾時秒數
+MAX_RETRIES = 3  # 網路錯誤或伺服器 5xx 錯誤時最多重試的次數
+RETRY_BASE = 0.5  # 第一次重試的最長等待秒數，之後每次加倍
+RETRY_MAX = 8.0  # 重試等待秒數的上限
+STATS_INTERVAL = 10.0  # 每隔多少秒顯示一次轉發統計
+VERBOSE = False  # 是否逐筆顯示收到的資料與伺服器回應（每分鐘數千筆時請關閉）
+
+# 待轉發樣本佇列：元素為 (查詢參數, 放進佇列的時間)
+send_queue = queue.Queue(maxsize=QUEUE_MAX)
+
+# 統計數字（多個執行緒同時累加，以 stats_lock 保護）
+stats_lock = threading.Lock()
+stats = {
+    'received': 0,  # 放進佇列的樣本數
+    'dropped': 0,  # 佇列已滿而丟棄的樣本數
+    'sent': 0,  # 伺服器回應 200 的樣本數
+    'failed': 0,  # 重試用盡或伺服器拒絕（4xx）的樣本數
+    'retries': 0,  # 重試次數
+    'latency_sum': 0.0,  # 從放進佇列到轉發完成的秒數總和（含排隊與重試）
+    'latency_max': 0.0,  # 上述秒數的最大值
+    'queue_hwm': 0,  # 佇列長度的最高水位
+}
+
+
+def count(name, n=1):
+    """以 stats_lock 保護累加一個統計數字"""
+    with stats_lock:
+        stats[name] += n
+
 
 # ==================== 預期接收的數據格式說明 ====================
 # MQTT 發布的數據預期格式如下：
@@ -77,67 +124,59 @@ def on_message(client, userdata, msg):
           msg.qos：訊息的服務品質等級（Quality of Service）
           msg.retain：訊息是否為保留訊息（Broker 會保存並發送給新訂閱者）
     """
-    # 顯示訊息來源的主題
-    print("接收到來自主題的數據: " + msg.topic)
-
-    # 顯示原始 payload 數據（位元組格式）
-    print("原始數據 (Payload):\n" + str(msg.payload))
+    # 顯示訊息來源的主題與原始 payload 數據（位元組格式）
+    if VERBOSE:
+        print("接收到來自主題的數據: " + msg.topic)
+        print("原始數據 (Payload):\n" + str(msg.payload))
 
     # 使用 try-except 區塊處理可能發生的各種錯誤
     try:
-        # ==================== 步驟 1：解碼位元組數據 ====================
-        # 將接收到的位元組資料解碼為 UTF-8 格式的字串
-        Payload = msg.payload.decode("utf-8")
-
-        # ==================== 步驟 2：解析 JSON 數據 ====================
-        # 將 JSON 格式的字串解析為 Python 字典物件
-        jsondata = json.loads(Payload)
-
-        # ==================== 步驟 3：格式化並顯示 JSON 數據 ====================
-        # 將字典轉換為格式化的 JSON 字串（方便閱讀）
-        jsonStr = json.dumps(jsondata, ensure_ascii=False, indent=4)
-        print("格式化後的 JSON 數據:")
-        print(jsonStr)
-
-        # ==================== 步驟 4：提取所需的數據欄位 ====================
-        # 從 JSON 數據中提取裝置識別碼、溫度和濕度值
-        # 使用 .get() 方法可以安全地獲取值，避免鍵不存在的錯誤
-        device = jsondata.get("Device")  # 裝置 MAC 地址
-        temperature = jsondata.get("Temperature")  # 溫度值
-        humidity = jsondata.get("Humidity")  # 濕度值
-
-        # 顯示提取的數據值
-        print("裝置識別碼 (Device):", device)
-        print("溫度值 (Temperature):", temperature)
-        print("濕度值 (Humidity):", humidity)
-
-        # ==================== 步驟 5：檢查數據完整性 ====================
-        # 確認所有必要的數據欄位都存在且不為 None
-        if device and temperature is not None and humidity is not None:
+        # ==================== 步驟 1~4：解析承載資料 ====================
+        # decode_payload() 自動分辨單筆 JSON、批次 JSON 與 PackLib.h 的二進位格式，
+        # 全部拆成 (裝置, 溫度, 濕度, 取樣時間) 的清單，一筆樣本轉發一次
+        samples = decode_payload(msg.payload)
+        if VERBOSE:
+            print("樣本數:", len(samples))
+
+        for device, temperature, humidity, systime in samples:
+            # 顯示提取的數據值
+            if VERBOSE:
+                print("裝置識別碼 (Device):", device)
+                print("溫度值 (Temperature):", temperature)
+                print("濕度值 (Humidity):", humidity)
+
+            # ==================== 步驟 5：檢查數據完整性 ====================
+            # 確認所有必要的數據欄位都存在且不為 None
+            if not (device and temperature is not None and humidity is not None):
+                # 數據不完整，缺少必要的欄位
+                print("錯誤：JSON 數據中缺少必要的字段")
+                continue
+
             # ==================== 步驟 6：構建 HTTP GET 請求參數 ====================
             # 建立查詢參數字串，將數據轉換為 URL 參數格式
+            # systime 為 decode_payload() 回推的取樣時間（YYYYMMDDHHMMSS），
+            # 批次與補送的樣本才不會被記成伺服器收到的時間
             params = {
                 "MAC": device,  # 裝置 MAC 地址
                 "T": str(temperature),  # 溫度值（轉為字串）
-                "H": str(humidity)  # 濕度值（轉為字串）
+                "H": str(humidity),  # 濕度值（轉為字串）
+                "systime": systime  # 取樣時間
             }
 
-            # ==================== 步驟 7：發送 HTTP GET 請求 ====================
-            # 使用 requests 套件發送 HTTP GET 請求到指定的 API 端點，就是http://iot.arduino.org.tw:8888/bmduino/dhtdata/dataadd.php
-            response = requests.get(BASE_URL, params=params)
-
-            # ==================== 步驟 8：檢查 HTTP 響應狀態 ====================
-            # 檢查伺服器回傳的狀態碼，200 表示請求成功
-            if response.status_code == 200:
-                print(f"HTTP 請求成功！狀態碼: {response.status_code}")
-                print(f"伺服器響應內容: {response.text}")
-            else:
-                # 狀態碼不是 200，表示請求失敗
-                print(f"HTTP 請求失敗！狀態碼: {response.status_code}")
-                print(f"錯誤信息: {response.text}")
-        else:
-            # 數據不完整，缺少必要的欄位
-            print("錯誤：JSON 數據中缺少必要的字段")
+            # ==================== 步驟 7：放進轉發佇列 ====================
+            # 這裡不送 HTTP 請求，交給 forward_worker() 執行緒轉發，
+            # 網路執行緒可以立刻回去接收下一則訊息
+            # 佇列已滿（API 伺服器長時間跟不上）時丟棄新樣本並計數，不阻塞 MQTT 連線
+            try:
+                send_queue.put_nowait((params, time.monotonic()))
+            except queue.Full:
+                count('dropped')
+                continue
+            count('received')
+            depth = send_queue.qsize()
+            with stats_lock:
+                if depth > stats['queue_hwm']:
+                    stats['queue_hwm'] = depth
 
     # ==================== 例外處理區塊 ====================
     # 處理 JSON 解析過程中可能發生的錯誤
@@ -150,10 +189,10 @@ def on_message(client, userdata, msg):
         print(f"解碼錯誤: {e}")
         print("可能的原因：數據不是有效的 UTF-8 編碼")
 
-    # 處理 HTTP 請求過程中可能發生的網路錯誤
-    except requests.exceptions.RequestException as e:
-        print(f"HTTP 請求錯誤: {e}")
-        print("可能的原因：網路連線問題、伺服器無回應等")
+    # 處理二進位格式的識別碼、版本或長度錯誤
+    except ValueError as e:
+        print(f"二進位資料錯誤: {e}")
+        print("可能的原因：PackLib.h 格式版本不符或資料不完整")
 
     # 處理其他未預期的錯誤
     except Exception as e:
@@ -161,6 +200,92 @@ def on_message(client, userdata, msg):
         print("請檢查程式邏輯或系統環境")
 
 
+# ==================== 轉發工作執行緒 ====================
+
+def send_with_retry(session, params):
+    """
+    以 HTTP GET 轉發一筆樣本，網路錯誤或伺服器 5xx 錯誤時重試
+
+    重試前的等待時間為 0 到 min(RETRY_MAX, RETRY_BASE * 2^次數) 之間的隨機秒數（full jitter），
+    API 伺服器短暫當機恢復時，所有工作執行緒不會在同一瞬間一起重送
+
+    參數：
+    session (requests.Session): 這個工作執行緒專用的連線（keep-alive，不必每筆重新建立 TCP 連線）
+    params (dict): 查詢參數 MAC、T、H
+
+    返回值：
+    bool: 伺服器回應 200 時為 True；重試用盡或伺服器拒絕（4xx）時為 False
+    """
+    for attempt in range(MAX_RETRIES + 1):
+        if attempt > 0:
+            count('retries')
+            time.sleep(random.uniform(0, min(RETRY_MAX, RETRY_BASE * (2 ** (attempt - 1)))))
+        try:
+            # 就是 http://iot.arduino.org.tw:8888/bmduino/dhtdata/dataadd.php
+            response = session.get(BASE_URL, params=params, timeout=HTTP_TIMEOUT)
+        except requests.exceptions.RequestException as e:
+            # 網路連線問題、伺服器無回應等，重試
+            if VERBOSE:
+                print(f"HTTP 請求錯誤: {e}")
+            continue
+
+        if response.status_code == 200:
+            if VERBOSE:
+                print(f"HTTP 請求成功！伺服器響應內容: {response.text}")
+            return True
+        if response.status_code < 500:
+            # 4xx：請求本身有問題，重送也不會成功
+            print(f"HTTP 請求失敗！狀態碼: {response.status_code}，錯誤信息: {response.text}")
+            return False
+        # 5xx：伺服器暫時無法處理，重試
+    print(f"HTTP 轉發失敗，已重試 {MAX_RETRIES} 次: MAC={params['MAC']}")
+    return False
+
+
+def forward_worker():
+    """
+    轉發工作執行緒的主迴圈
+
+    每個工作執行緒使用自己的 requests.Session（Session 不保證可在多個執行緒間共用），
+    連線池只保留一條連線，轉發時重複使用同一條 keep-alive 連線
+    """
+    session = requests.Session()
+    session.mount("http://", HTTPAdapter(pool_connections=1, pool_maxsize=1))
+    session.mount("https://", HTTPAdapter(pool_connections=1, pool_maxsize=1))
+    while True:
+        params, queued = send_queue.get()
+        ok = send_with_retry(session, params)
+        latency = time.monotonic() - queued
+        with stats_lock:
+            stats['sent' if ok else 'failed'] += 1
+            stats['latency_sum'] += latency
+            if latency > stats['latency_max']:
+                stats['latency_max'] = latency
+
+
+def stats_reporter():
+    """
+    每 STATS_INTERVAL 秒顯示一次轉發統計（背壓指標）
+
+    佇列長度持續上升或出現丟棄，表示 API 伺服器跟不上訊息速率，
+    可以增加 WORKER_COUNT 或檢查伺服器端的處理時間
+    """
+    last_done = 0
+    while True:
+        time.sleep(STATS_INTERVAL)
+        with stats_lock:
+            done = stats['sent'] + stats['failed']
+            rate = (done - last_done) * 60.0 / STATS_INTERVAL
+            avg = stats['latency_sum'] / done if done else 0.0
+            print("轉發統計：收到 %d、成功 %d、失敗 %d、重試 %d、丟棄 %d、佇列 %d（最高 %d）、"
+                  "速率 %.0f 筆/分、延遲 平均 %.3f 秒 最大 %.3f 秒" % (
+                      stats['received'], stats['sent'], stats['failed'], stats['retries'],
+                      stats['dropped'], send_queue.qsize(), stats['queue_hwm'],
+                      rate, avg, stats['latency_max']))
+            stats['latency_max'] = 0.0  # 最大延遲每個統計區間重新計算
+            last_done = done
+
+
 # ==================== MQTT 客戶端初始化區塊 ====================
 
 # 建立 MQTT 客戶端物件
@@ -189,8 +314,14 @@ print("正在嘗試連線到 MQTT Broker...")
 print(f"Broker 位址: {broker_address}:{port}")
 print(f"訂閱主題: {topic}")
 print(f"轉發 API: {BASE_URL}")
+print(f"工作執行緒: {WORKER_COUNT}，佇列上限: {QUEUE_MAX}")
 print("-" * 50)
 
+# 啟動轉發工作執行緒與統計執行緒（daemon：按 Ctrl+C 結束主程式時一併結束）
+for i in range(WORKER_COUNT):
+    threading.Thread(target=forward_worker, name="forward_%d" % i, daemon=True).start()
+threading.Thread(target=stats_reporter, name="stats", daemon=True).start()
+
 # 進入無窮迴圈模式，持續監聽來自 Broker 的訊息
 # 這行程式會讓程式持續執行，直到手動停止（Ctrl+C）或發生嚴重錯誤
 # 在迴圈中，客戶端會執行以下操作：
@@ -0,0 +1,170 @@
+"""
+RFID 卡片清單增量同步參考伺服器 (cardSyncServer.py)
+功能：提供 CheckRFID_pass_oled_BMduino/CardSyncLib.h 使用的 cardsync.php 介面，
+      讓門禁裝置以「版本號 + 分頁」方式取得卡片狀態的變更，供本機測試使用
+作者：自動生成繁體中文註解版本
+日期：2026-10-17
+"""
+
+# ==================== 導入必要的套件 ====================
+
+# 匯入 HTTP 伺服器模組（Python 內建，不需另外安裝）
+from http.server import BaseHTTPRequestHandler, HTTPServer
+from urllib.parse import urlparse, parse_qs
+
+# 匯入 pymysql 套件，並命名為 DB（連線設定與 connectMYSQL.py 相同）
+import pymysql as DB
+
+# ==================== 伺服器設定 ====================
+
+SERVER_PORT = 8888  # 與裝置端 clouding.h 的 ServerPort 相同
+PAGE_LIMIT_MAX = 64  # 每頁最多回傳的變更筆數（裝置端預設索取 16 筆）
+
+# ==================== 資料庫連線設定 ====================
+
+db = DB.connect(
+    host='localhost',  # 資料庫主機位址
+    port=3306,  # MySQL 預設通訊埠
+    user='big',  # 資料庫使用者名稱
+    passwd='12345678',  # 資料庫使用者密碼
+    db='big',  # 要連接的資料庫名稱
+    charset='utf8',  # 使用 UTF-8 編碼
+    autocommit=True  # 每個指令立即生效，變更馬上可以被同步
+)
+
+# ==================== 變更記錄資料表 ====================
+# 每一次卡片狀態變更（註冊、啟用、停用、失效）都新增一筆，
+# version 為自動遞增的版本號，裝置只要記住最後套用的版本，
+# 下次就用 SINCE=<版本> 取得之後的變更
+#   state：'A' 已註冊或已啟用（可開門）、'D' 已停用或已失效（不可開門）
+sqlcreate = """
+CREATE TABLE IF NOT EXISTS rfidchange (
+    version BIGINT UNSIGNED NOT NULL AUTO_INCREMENT PRIMARY KEY,
+    MAC VARCHAR(20) NOT NULL,
+    cardkey VARCHAR(16) NOT NULL,
+    state CHAR(1) NOT NULL,
+    crtdatetime TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    INDEX (MAC, version)
+)
+"""
+
+# 查詢某版本之後的變更（多取一筆用來判斷是否還有下一頁）
+sqlchanges = "SELECT version, cardkey, state FROM rfidchange WHERE MAC = %s AND version > %s ORDER BY version LIMIT %s"
+
+# 新增一筆變更
+sqlrecord = "INSERT INTO rfidchange (MAC, cardkey, state) VALUES (%s, %s, %s)"
+
+# 註冊、啟用、停用、失效四種操作對應的狀態（與 regRFID_2rfidlist、activateRFID_inrfidlist、
+# inactivateRFID_inrfidlist、invalidRFID_inrfidlist 四個範例程式的操作相同）
+ACTION_STATE = {
+    'reg': 'A',
+    'activate': 'A',
+    'inactivate': 'D',
+    'invalid': 'D',
+}
+
+
+def record_change(mac, cardkey, state):
+    """
+    記錄一筆卡片狀態變更
+
+    參數：
+    mac (str): 門禁裝置的 MAC 位址
+    cardkey (str): 10 位數卡號（readRFIDUIDString() 的格式）
+    state (str): 'A' 或 'D'
+
+    返回值：
+    int: 這筆變更的版本號
+    """
+    cursor = db.cursor()
+    cursor.execute(sqlrecord, (mac, cardkey, state))
+    return cursor.lastrowid
+
+
+def changes_since(mac, since, limit):
+    """
+    取得某版本之後的一頁變更
+
+    參數：
+    mac (str): 門禁裝置的 MAC 位址
+    since (int): 裝置目前已套用的版本
+    limit (int): 每頁最多筆數
+
+    返回值：
+    str: 裝置端 cardSyncApply() 解析的純文字回應
+         第一行：V <新版本> <是否還有下一頁>
+         之後每行：A <卡號> 或 D <卡號>
+    """
+    cursor = db.cursor()
+    cursor.execute(sqlchanges, (mac, since, limit + 1))
+    rows = cursor.fetchall()
+    more = 1 if len(rows) > limit else 0
+    rows = rows[:limit]
+
+    # 同一頁內同一張卡多次變更時，只需要最後的狀態
+    latest = {}
+    for version, cardkey, state in rows:
+        latest[cardkey] = state
+    version = rows[-1][0] if rows else since
+
+    lines = ["V %d %d" % (version, more)]
+    for cardkey, state in latest.items():
+        lines.append("%s %s" % (state, cardkey))
+    return "\n".join(lines) + "\n"
+
+
+class CardSyncHandler(BaseHTTPRequestHandler):
+    """
+    HTTP 請求處理類別
+
+    支援的路徑：
+    1. /bmduino/rfid/cardsync.php?MAC=..&SINCE=..&LIMIT=..
+       回傳 SINCE 之後的一頁變更（裝置端同步使用）
+    2. /bmduino/rfid/cardchange.php?MAC=..&KEY=..&ACTION=reg|activate|inactivate|invalid
+       記錄一筆變更（本機測試時代替雲端的註冊、啟用、停用、失效程式）
+    """
+
+    # 使用 HTTP/1.1，讓裝置端的 keep-alive 連線可以連續送出多個請求
+    protocol_version = "HTTP/1.1"
+
+    def do_GET(self):
+        url = urlparse(self.path)
+        query = parse_qs(url.query)
+        mac = query.get("MAC", [""])[0]
+        try:
+            if url.path.endswith("/cardsync.php"):
+                since = int(query.get("SINCE", ["0"])[0])
+                limit = min(int(query.get("LIMIT", ["16"])[0]), PAGE_LIMIT_MAX)
+                self.reply(200, changes_since(mac, since, max(limit, 1)))
+            elif url.path.endswith("/cardchange.php"):
+                cardkey = query.get("KEY", [""])[0]
+                state = ACTION_STATE.get(query.get("ACTION", [""])[0])
+                if not mac or not cardkey or state is None:
+                    self.reply(400, "bad request\n")
+                    return
+                version = record_change(mac, cardkey, state)
+                self.reply(200, "V %d 0\n%s %s\n" % (version, state, cardkey))
+            else:
+                self.reply(404, "not found\n")
+        except ValueError:
+            self.reply(400, "bad request\n")
+
+    def reply(self, code, text):
+        """送出純文字回應，並附上 Content-Length（裝置端依此判斷回應結束）"""
+        body = text.encode("utf-8")
+        self.send_response(code)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+
+# ==================== 主程式 ====================
+
+if __name__ == "__main__":
+    db.cursor().execute(sqlcreate)  # 第一次執行時建立變更記錄資料表
+    server = HTTPServer(("", SERVER_PORT), CardSyncHandler)
+    print("卡片同步伺服器已啟動，通訊埠：%d" % SERVER_PORT)
+    print("同步：/bmduino/rfid/cardsync.php?MAC=<MAC>&SINCE=<版本>&LIMIT=<筆數>")
+    print("變更：/bmduino/rfid/cardchange.php?MAC=<MAC>&KEY=<卡號>&ACTION=reg|activate|inactivate|invalid")
+    server.serve_forever()
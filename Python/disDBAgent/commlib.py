@@ -7,10 +7,12 @@
 
 # ==================== 導入必要的套件 ====================
 
-from datetime import datetime  # 日期時間處理模組，用於取得系統時間
+from datetime import datetime, timedelta  # 日期時間處理模組，用於取得系統時間與回推取樣時間
 import string  # 字串處理模組，提供字串相關常數和函式
 import socket  # 網路通訊模組，用於取得本機 IP 地址
 import uuid  # 通用唯一識別碼模組，用於取得 MAC 地址
+import json  # JSON 處理模組，用於解析裝置送來的文字承載資料
+import struct  # 位元組打包模組，用於解析裝置送來的二進位承載資料
 
 
 # ==================== 通用工具函式 ====================
@@ -267,4 +269,111 @@ def generate_random_string(length=8):
     import random
     import string
     chars = string.ascii_letters + string.digits
-    return ''.join(random.choice(chars) for _ in range(length))
\ No newline at end of file
+    return ''.join(random.choice(chars) for _ in range(length))
+
+def getsystime_ago(seconds):
+    """
+    取得「數秒之前」的系統時間字串，格式與 getsystime() 相同（YYYYMMDDHHMMSS）
+
+    參數：
+    seconds (int/float): 距今的秒數，用於補送或批次資料回推實際取樣時間
+    """
+    return (datetime.now() - timedelta(seconds=seconds)).strftime("%Y%m%d%H%M%S")
+
+
+def unpack_samples(jsondata):
+    """
+    把裝置送來的 JSON 承載資料拆成單筆樣本
+
+    支援的格式：
+    1. 單筆：{"Device":..,"Temperature":..,"Humidity":..}，補送資料另有 "Age"（秒），
+       "Age":-1 表示裝置無法得知經過時間（上次開機留下的樣本）
+    2. 批次：{"Device":..,"Batch":[[經過毫秒,溫度,濕度],...]}（BatchLib.h 以 AT+MQTTPUBRAW 送出）
+
+    返回值：
+    list: [(device, temperature, humidity, systime), ...]，依取樣先後排列
+          systime 為回推後的取樣時間字串（YYYYMMDDHHMMSS）
+          格式錯誤或讀取失敗（溫度、濕度為 null）的批次項目會略過
+    """
+    device = jsondata.get("Device")
+    batch = jsondata.get("Batch")
+    if batch is None:
+        # 單筆資料：有 Age 時回推取樣時間，沒有或為 -1（未知）時以收到的時間為準
+        age = jsondata.get("Age")
+        systime = getsystime_ago(age) if age is not None and age >= 0 else getsystime()
+        return [(device, jsondata.get("Temperature"), jsondata.get("Humidity"), systime)]
+
+    samples = []
+    for item in batch:
+        if not isinstance(item, list) or len(item) < 3:
+            continue  # 略過格式不符的項目
+        if item[1] is None or item[2] is None:
+            continue  # 略過感測器讀取失敗的樣本
+        samples.append((device, item[1], item[2], getsystime_ago(item[0] / 1000.0)))
+    return samples
+
+
+# ==================== 二進位精簡格式（PackLib.h）====================
+# 格式定義與 Simple_DHT_System2_MQTTBroker/PackLib.h 相同：
+#   標頭 9 位元組：識別碼 0xD1、版本、樣本數 N、MAC 位址 6 位元組
+#   樣本 8 位元組 × N：uint32 經過毫秒、int16 溫度×10、uint16 濕度×10（little-endian）
+#   讀取失敗（NaN）的溫度為 PACK_INVALID（-32768），濕度為 0x8000
+PACK_MAGIC = 0xD1
+PACK_VERSION = 1
+PACK_HEADER = struct.Struct("<BBB6s")
+PACK_SAMPLE = struct.Struct("<IhH")
+PACK_AGE_UNKNOWN = 0xFFFFFFFF
+PACK_INVALID = -32768  # 讀取失敗的數值（INT16_MIN），濕度欄位為無號數所以是 0x8000
+
+
+def unpack_frame(payload):
+    """
+    解析 PackLib.h 的二進位承載資料
+
+    參數：
+    payload (bytes): MQTT 收到的原始位元組
+
+    返回值：
+    list: [(device, temperature, humidity, systime), ...]，格式與 unpack_samples() 相同
+          device 還原成 "D8BFC0123456" 的形式（大寫、不含冒號），
+          與 Wifi.getMacAddress() 送出的 JSON Device 欄位及 get_mac_address() 相同
+          溫度或濕度為 PACK_INVALID（讀取失敗）的樣本會略過
+
+    例外：
+    ValueError: 識別碼、版本或長度不符
+    """
+    if len(payload) < PACK_HEADER.size:
+        raise ValueError("二進位資料長度不足")
+    magic, version, count, mac = PACK_HEADER.unpack_from(payload, 0)
+    if magic != PACK_MAGIC or version != PACK_VERSION:
+        raise ValueError("不支援的二進位格式：識別碼 %#x 版本 %d" % (magic, version))
+    if len(payload) < PACK_HEADER.size + count * PACK_SAMPLE.size:
+        raise ValueError("二進位資料長度與樣本數不符")
+    device = "".join("%02X" % b for b in bytearray(mac))
+
+    samples = []
+    for i in range(count):
+        age, t10, h10 = PACK_SAMPLE.unpack_from(payload, PACK_HEADER.size + i * PACK_SAMPLE.size)
+        if t10 == PACK_INVALID or h10 == PACK_INVALID & 0xFFFF:
+            continue  # 略過感測器讀取失敗的樣本
+        systime = getsystime() if age == PACK_AGE_UNKNOWN else getsystime_ago(age / 1000.0)
+        samples.append((device, t10 / 10.0, h10 / 10.0, systime))
+    return samples
+
+
+def decode_payload(payload):
+    """
+    解析裝置送來的承載資料，自動分辨二進位或 JSON 格式
+
+    參數：
+    payload (bytes): MQTT 收到的原始位元組（msg.payload）
+
+    返回值：
+    list: [(device, temperature, humidity, systime), ...]
+
+    說明：
+    JSON 一定以 '{' 開頭，第一個位元組是 0xD1 時才當成二進位格式解析
+    """
+    if len(payload) > 0 and bytearray(payload[:1])[0] == PACK_MAGIC:
+        return unpack_frame(payload)
+    return unpack_samples(json.loads(payload.decode("utf-8")))
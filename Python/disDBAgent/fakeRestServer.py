@@ -0,0 +1,153 @@
+"""
+假的 dataadd.php 端點與 MQTT 負載產生器 (fakeRestServer.py)
+功能：在本機測試 MQTT_Scribe_2_restfulAPI.py 的轉發能力，不必動到正式的雲端資料庫
+      1. 伺服器模式：模擬 dataadd.php，可設定回應延遲與失敗比例，並定期顯示每分鐘收到的筆數
+      2. 發布模式：以固定速率向 MQTT Broker 發布假的溫濕度資料
+作者：自動生成繁體中文註解版本
+日期：2026-10-17
+
+使用方式：
+  python fakeRestServer.py                 # 啟動假的 API 伺服器
+  python MQTT_Scribe_2_restfulAPI.py http://localhost:8890/bmduino/dhtdata/dataadd.php
+  python fakeRestServer.py --publish 3000  # 每分鐘發布 3000 則訊息（模擬 3000 個每分鐘上傳一次的節點）
+"""
+
+# ==================== 導入必要的套件 ====================
+
+# 匯入 HTTP 伺服器模組（Python 內建，不需另外安裝）
+# ThreadingHTTPServer 每個連線一個執行緒，才能同時服務轉發程式的多條 keep-alive 連線
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import urlparse, parse_qs
+import json
+import random
+import sys
+import threading
+import time
+
+# ==================== 伺服器設定 ====================
+
+SERVER_PORT = 8890  # 假 API 伺服器的通訊埠
+FAKE_LATENCY = 0.05  # 每個請求模擬的處理時間（秒），正式伺服器寫入資料庫約需數十毫秒
+FAKE_FAIL_RATE = 0.02  # 回應 503 的比例，用來測試轉發程式的重試
+STATS_INTERVAL = 10.0  # 每隔多少秒顯示一次收到的筆數
+
+# ==================== MQTT 發布設定（與 MQTT_Scribe_2_restfulAPI.py 相同） ====================
+
+broker_address = "broker.emqx.io"
+port = 1883
+topic_prefix = "/arduino/dht/"  # 轉發程式訂閱 /arduino/dht/#
+FAKE_DEVICES = 200  # 發布時輪流使用的假裝置數量
+
+# 收到的請求統計（多個執行緒同時累加，以 stats_lock 保護）
+stats_lock = threading.Lock()
+stats = {'ok': 0, 'fail': 0}
+
+
+class FakeDataAddHandler(BaseHTTPRequestHandler):
+    """
+    HTTP 請求處理類別
+
+    支援的路徑：
+    /bmduino/dhtdata/dataadd.php?MAC=..&T=..&H=..&systime=..
+    systime（取樣時間）可省略，MAC、T、H 齊全時等待 FAKE_LATENCY 秒後回應 200（依 FAKE_FAIL_RATE 比例回應 503）
+    """
+
+    # 使用 HTTP/1.1，讓轉發程式的 keep-alive 連線可以連續送出多個請求
+    protocol_version = "HTTP/1.1"
+
+    def do_GET(self):
+        url = urlparse(self.path)
+        query = parse_qs(url.query)
+        if not url.path.endswith("/dataadd.php"):
+            self.reply(404, "not found\n")
+            return
+        if not all(query.get(k, [""])[0] for k in ("MAC", "T", "H")):
+            self.reply(400, "bad request\n")
+            return
+        time.sleep(FAKE_LATENCY)
+        if random.random() < FAKE_FAIL_RATE:
+            with stats_lock:
+                stats['fail'] += 1
+            self.reply(503, "busy\n")
+            return
+        with stats_lock:
+            stats['ok'] += 1
+        self.reply(200, "OK\n")
+
+    def reply(self, code, text):
+        """送出純文字回應，並附上 Content-Length（keep-alive 連線依此判斷回應結束）"""
+        body = text.encode("utf-8")
+        self.send_response(code)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, format, *args):
+        """每分鐘數千筆請求時不逐筆顯示存取記錄，改由 stats_reporter() 定期顯示"""
+        pass
+
+
+def stats_reporter():
+    """每 STATS_INTERVAL 秒顯示一次收到的請求數與換算的每分鐘筆數"""
+    last = 0
+    while True:
+        time.sleep(STATS_INTERVAL)
+        with stats_lock:
+            total = stats['ok'] + stats['fail']
+            print("已收到 %d 筆（成功 %d、503 %d），速率 %.0f 筆/分" % (
+                total, stats['ok'], stats['fail'], (total - last) * 60.0 / STATS_INTERVAL))
+            last = total
+
+
+def publish(per_minute):
+    """
+    以固定速率向 MQTT Broker 發布假的溫濕度資料
+
+    參數：
+    per_minute (int): 每分鐘發布的訊息數量
+
+    說明：
+    資料格式與 Simple_DHT_System2_MQTTBroker 送出的單筆 JSON 相同，
+    裝置 MAC 由 FAKE_DEVICES 個假裝置輪流使用
+    """
+    import paho.mqtt.client as mqtt  # 只有發布模式需要 paho
+
+    client = mqtt.Client(mqtt.CallbackAPIVersion.VERSION2)
+    client.connect(broker_address, port, 60)
+    client.loop_start()
+
+    interval = 60.0 / per_minute
+    next_time = time.monotonic()
+    n = 0
+    print("開始發布：每分鐘 %d 則，主題 %s<MAC>" % (per_minute, topic_prefix))
+    while True:
+        mac = "FA%010X" % (n % FAKE_DEVICES)
+        payload = json.dumps({
+            "Device": mac,
+            "Temperature": round(random.uniform(20, 30), 1),
+            "Humidity": round(random.uniform(40, 90), 1),
+        })
+        client.publish(topic_prefix + mac, payload)
+        n += 1
+        if n % per_minute == 0:
+            print("已發布 %d 則" % n)
+        # 以絕對時間排程，發布本身的耗時不會累積成速率誤差
+        next_time += interval
+        delay = next_time - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+
+
+# ==================== 主程式 ====================
+
+if __name__ == "__main__":
+    if len(sys.argv) > 2 and sys.argv[1] == "--publish":
+        publish(int(sys.argv[2]))
+    else:
+        threading.Thread(target=stats_reporter, name="stats", daemon=True).start()
+        server = ThreadingHTTPServer(("", SERVER_PORT), FakeDataAddHandler)
+        print("假 API 伺服器已啟動，通訊埠：%d（延遲 %.3f 秒、失敗比例 %.0f%%）" % (
+            SERVER_PORT, FAKE_LATENCY, FAKE_FAIL_RATE * 100))
+        print("轉發端點：http://localhost:%d/bmduino/dhtdata/dataadd.php" % SERVER_PORT)
+        server.serve_forever()
@@ -26,13 +26,14 @@
  *        表示有按鍵事件發生。
  *    (4) readKeyValue() 回傳一個 16 位元的整數 (uint16_t)，
  *        每個位元代表一個按鍵的狀態 (1=按下，0=未按)。
- *    (5) CheckKey() 會掃描這 16 個位元，找出第一個被按下的按鍵，
+ *    (5) CheckKey() 以 __builtin_ctz() 找出編號最小的被按下按鍵，
  *        並回傳對應的字元；若無按鍵則回傳 '~'。
  * 
  * 5. 注意事項：
  *    - 中斷腳位 (INT) 需連接到 Arduino 的數位腳位 (本範例使用腳位 2)
  *    - I2C 介面使用 Wire (A4=SDA, A5=SCL)
- *    - 若同時按下多鍵，CheckKey() 只會回傳掃描到的第一個按鍵
+ *    - 若同時按下多鍵，CheckKey() 只會回傳掃描到的第一個按鍵；
+ *      需要按下/放開/長按事件或多鍵組合時改用 KeyEventLib.h（INT 腳中斷觸發）
  * ============================================================
  */
 
@@ -105,35 +106,18 @@ int readkeyvalue()
 //   - 若無按鍵或發生錯誤，回傳 '~' (波浪號，代表無效按鍵)
 char CheckKey()
 {
-    int readk ;           // 暫存讀取到的位元值 (0 或 1)
-    int keyend = 15 ;     // 按鍵陣列的最大索引值 (共 16 鍵，索引 0~15)
-    int keycount = 0 ;    // 迴圈計數器，用來掃描 16 個按鍵位置
-    
-    // 先呼叫 readkeyvalue() 檢查是否有按鍵被按下
+    int readk = readkeyvalue() ;   // 讀取一次按鍵矩陣資料 (16 位元)，無按鍵事件時為 -1
+
     // 若回傳 -1，表示沒有任何按鍵被按下，直接回傳 '~'
-    if (readkeyvalue() == -1)
+    if (readk == -1)
+        return '~' ;
+
+    // 若資料為 0，表示有事件但按鍵已全部放開 (例如剛放開按鍵)，同樣回傳 '~'
+    readkeypaddata = (uint16_t)readk ;
+    if (readkeypaddata == 0)
         return '~' ;
     
-    // 若有按鍵被按下，則讀取完整的按鍵矩陣資料 (16 位元)
-    readkeypaddata = BMK52.readKeyValue();
-    
-    // 逐位元掃描 (從 bit0 到 bit15)
-    while (keycount <= keyend)
-    {
-        // 使用 bitRead() 函式讀取 readkeypaddata 的第 keycount 個位元
-        // bitRead(數值, 位元位置) 會回傳 0 或 1
-        readk = bitRead(readkeypaddata, keycount);
-        
-        // 若該位元為 1，表示對應位置的按鍵被按下
-        if (readk == 1)
-        {
-            // 根據索引值回傳 KeyPad 陣列中定義的字元
-            return KeyPad[keycount];
-        }
-        keycount++;   // 繼續檢查下一個位元
-    }
-    
-    // 理論上不應該執行到這裡 (因為前面已確認有按鍵，但掃描卻沒找到)
-    // 若發生則回傳 '~' 代表錯誤或無效按鍵
-    return '~' ;
+    // 最低的 1 位元就是編號最小的按鍵 (bit0 → KeyPad[0])
+    // __builtin_ctz() 直接算出該位元的位置，不必逐位元掃描 16 次
+    return KeyPad[__builtin_ctz(readkeypaddata)];
 }
\ No newline at end of file
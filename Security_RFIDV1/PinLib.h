@@ -0,0 +1,177 @@
+// ================================================================
+// 檔案名稱：PinLib.h
+// 描述：密碼輸入與刷卡雙重驗證狀態機（不配置動態記憶體、固定容量）
+// 功能：門禁需同時具備「RFID 卡片」與「按鍵密碼」兩個因素才送出查詢
+//       - 先刷卡或先輸入密碼都可以，第二個因素須在 AUTH_WINDOW 毫秒內完成
+//       - 數字鍵輸入密碼，'*' 刪除最後一碼，'#' 送出；pinClear() 清除整串
+//       - 輸入中超過 PIN_KEY_TIMEOUT 毫秒沒有按鍵，已輸入的數字自動清除
+//       - 連續 AUTH_MAX_FAILS 次驗證失敗，鎖定 AUTH_LOCK_TIME 毫秒不接受輸入
+// 狀態：
+//   AUTH_IDLE ──刷卡──> AUTH_WAIT_PIN ──'#'──> AUTH_READY
+//   AUTH_IDLE ──'#'───> AUTH_WAIT_CARD ──刷卡─> AUTH_READY
+//   AUTH_READY ──authResult()──> AUTH_IDLE（或失敗過多時 AUTH_LOCKED）
+// 使用方式：
+//   按鍵事件呼叫 authKey()、讀到卡片呼叫 authSwipe()，週期性呼叫 authPoll() 處理逾時；
+//   狀態為 AUTH_READY 時以 authCard、pinCode 送出查詢，再以 authResult() 回報結果
+// ================================================================
+
+// ================================================================
+// =============== 設定常數區 ===============
+// ================================================================
+#define PIN_MIN_LEN 4              // 密碼最少位數，不足時按 '#' 視為輸入錯誤並清除
+#define PIN_MAX_LEN 8              // 密碼最多位數，超過的數字不接受
+#define PIN_KEY_TIMEOUT 10000      // 輸入中兩次按鍵的最長間隔（毫秒）
+#define PIN_BACK_KEY  '*'          // 刪除最後一碼
+#define PIN_ENTER_KEY '#'          // 送出密碼
+#define AUTH_WINDOW 20000          // 第一個因素到第二個因素的最長時間（毫秒）
+#define AUTH_MAX_FAILS 3           // 連續失敗幾次後鎖定
+#define AUTH_LOCK_TIME 30000       // 鎖定時間（毫秒）
+
+// 驗證狀態
+#define AUTH_IDLE      0           // 尚未刷卡也尚未送出密碼
+#define AUTH_WAIT_PIN  1           // 已刷卡，等待輸入密碼
+#define AUTH_WAIT_CARD 2           // 已送出密碼，等待刷卡
+#define AUTH_READY     3           // 兩個因素都已取得，等待送出查詢
+#define AUTH_LOCKED    4           // 失敗過多，暫停接受輸入
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+uint8_t authState = AUTH_IDLE;         // 目前狀態
+char pinBuffer[PIN_MAX_LEN + 1];       // 輸入中的密碼
+uint8_t pinLen = 0;                    // 輸入中的密碼位數
+unsigned long pinLastKey = 0;          // 最後一次按鍵的時間
+char pinCode[PIN_MAX_LEN + 1];         // 已送出的密碼（AUTH_WAIT_CARD、AUTH_READY 時有效）
+String authCard = "";                  // 已刷的卡號（AUTH_WAIT_PIN、AUTH_READY 時有效）
+unsigned long authSince = 0;           // 取得第一個因素（或開始鎖定）的時間
+uint8_t authFails = 0;                 // 連續失敗次數
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+void pinClear();                                       // 清除輸入中的密碼
+void authReset();                                      // 清除兩個因素，回到 AUTH_IDLE
+uint8_t authKey(char c, unsigned long now);            // 處理一個按鍵，回傳新狀態
+uint8_t authSwipe(String uid, unsigned long now);      // 處理一次刷卡，回傳新狀態
+uint8_t authPoll(unsigned long now);                   // 處理逾時與解除鎖定，回傳新狀態
+void authResult(bool pass, unsigned long now);         // 回報查詢結果
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：pinClear()
+// 功能：清除輸入中的密碼（連同記憶體內容，不留下已按的數字）
+// ---------------------------------------------------------------
+void pinClear()
+{
+    memset(pinBuffer, 0, sizeof(pinBuffer));
+    pinLen = 0;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：authReset()
+// 功能：清除輸入中的密碼、已送出的密碼與卡號，回到 AUTH_IDLE
+// 說明：失敗次數不清除，鎖定中呼叫也不會解除鎖定
+// ---------------------------------------------------------------
+void authReset()
+{
+    pinClear();
+    memset(pinCode, 0, sizeof(pinCode));
+    authCard = "";
+    if (authState != AUTH_LOCKED) authState = AUTH_IDLE;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：authKey()
+// 功能：處理一個按鍵
+// 參數：c - 按鍵字元；now - 目前的 millis()
+// 回傳：處理後的狀態
+// 說明：數字鍵加入密碼，PIN_BACK_KEY 刪除最後一碼，PIN_ENTER_KEY 送出，
+//       其他按鍵不處理；AUTH_READY 與 AUTH_LOCKED 時不接受按鍵
+// ---------------------------------------------------------------
+uint8_t authKey(char c, unsigned long now)
+{
+    if (authState == AUTH_READY || authState == AUTH_LOCKED) return authState;
+
+    if (c >= '0' && c <= '9') {
+        if (pinLen < PIN_MAX_LEN) pinBuffer[pinLen++] = c;
+        pinLastKey = now;
+    } else if (c == PIN_BACK_KEY) {
+        if (pinLen > 0) pinBuffer[--pinLen] = '\0';
+        pinLastKey = now;
+    } else if (c == PIN_ENTER_KEY) {
+        if (pinLen < PIN_MIN_LEN) {            // 位數不足，視為輸入錯誤
+            pinClear();
+            return authState;
+        }
+        memcpy(pinCode, pinBuffer, sizeof(pinCode));
+        pinClear();
+        if (authState == AUTH_WAIT_PIN) {
+            authState = AUTH_READY;
+        } else {                               // 先輸入密碼（或重新輸入）：等待刷卡
+            authState = AUTH_WAIT_CARD;
+            authSince = now;
+        }
+    }
+    return authState;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：authSwipe()
+// 功能：處理一次刷卡
+// 參數：uid - 卡號字串；now - 目前的 millis()
+// 回傳：處理後的狀態
+// 說明：已刷卡再刷另一張卡時以新卡為準，並重新計算 AUTH_WINDOW
+// ---------------------------------------------------------------
+uint8_t authSwipe(String uid, unsigned long now)
+{
+    if (authState == AUTH_READY || authState == AUTH_LOCKED) return authState;
+
+    authCard = uid;
+    if (authState == AUTH_WAIT_CARD) {
+        authState = AUTH_READY;
+    } else {
+        authState = AUTH_WAIT_PIN;
+        authSince = now;
+    }
+    return authState;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：authPoll()
+// 功能：處理按鍵逾時、AUTH_WINDOW 逾時與解除鎖定
+// 參數：now - 目前的 millis()
+// 回傳：處理後的狀態
+// ---------------------------------------------------------------
+uint8_t authPoll(unsigned long now)
+{
+    if (pinLen > 0 && now - pinLastKey >= PIN_KEY_TIMEOUT) pinClear();
+
+    if ((authState == AUTH_WAIT_PIN || authState == AUTH_WAIT_CARD)
+        && now - authSince >= AUTH_WINDOW) {
+        authReset();
+    } else if (authState == AUTH_LOCKED && now - authSince >= AUTH_LOCK_TIME) {
+        authFails = 0;
+        authState = AUTH_IDLE;
+    }
+    return authState;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：authResult()
+// 功能：回報 AUTH_READY 送出查詢的結果，清除兩個因素
+// 參數：pass - 是否通過；now - 目前的 millis()
+// 說明：通過時清除失敗次數；連續失敗 AUTH_MAX_FAILS 次時進入 AUTH_LOCKED
+// ---------------------------------------------------------------
+void authResult(bool pass, unsigned long now)
+{
+    authReset();
+    if (pass) {
+        authFails = 0;
+    } else if (++authFails >= AUTH_MAX_FAILS) {
+        authState = AUTH_LOCKED;
+        authSince = now;
+    }
+}
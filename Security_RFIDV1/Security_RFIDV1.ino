@@ -34,7 +34,13 @@
  *     - 檢查 Wi-Fi 連線狀態，若正常則呼叫 SendtoClouding() 將卡號傳送至雲端
  *       （雲端伺服器會回傳是否允許開門的指令，由 clouding.h 內部處理）
  *     - 若 Wi-Fi 連線異常，則不進行雲端查詢（此版本未加入錯誤重試機制）
- *     - 延遲 2 秒以避免重複讀取或過度頻繁的網路請求
+ *     - 讀到卡片後讀卡任務暫停 2 秒，避免重複讀取或過度頻繁的網路請求
+ *       （由 TaskLib.h 排程，暫停期間 loop() 不會被 delay() 卡住）
+ *     - AUTH_REQUIRE_PIN 為 1 時採雙重驗證：刷卡與按鍵密碼（'#' 送出）兩者都要，
+ *       順序不拘，須在 AUTH_WINDOW 內完成，才把卡號與密碼一起送到雲端查詢
+ *       （按鍵由 KeyEventLib.h 以 INT 腳中斷觸發讀取，快速輸入也不會漏鍵；
+ *        狀態機在 PinLib.h）。預設為 0：密碼會以明文出現在網址中，
+ *       伺服器端尚未比對密碼
  * 
  * 【4. 關鍵函式說明】
  * - initAll()：整體初始化，包含序列埠、LED 狀態、感測器模組
@@ -53,6 +59,8 @@
  * - OledLib.h：提供 OLED 顯示相關函式（initOled()、printText()、clearScreen()、
  *   drawPicture() 等）
  * - RFIDLib.h：提供 RFID 模組初始化與讀取 UID 的函式
+ * - 16keyLib.h / KeyEventLib.h：BMK52T016 16 鍵模組與中斷驅動的按鍵事件佇列
+ * - PinLib.h：密碼輸入與刷卡雙重驗證狀態機
  * - clouding.h：提供雲端通訊函式 SendtoClouding()，內部實作 HTTP GET 請求
  *   並根據回應控制繼電器動作
  * 
@@ -61,7 +69,8 @@
  * - Wi-Fi 的 SSID 與密碼需預先在 TCP.h 中定義（例如 #define WIFI_SSID "your_SSID"）
  * - 雲端伺服器的 URL 與參數設定需在 clouding.h 中完成
  * - 若 Wi-Fi 連線中斷，本程式目前不會自動重新連線，也無錯誤訊息顯示於 OLED
- * - 延遲 2 秒可能影響即時性，可視需求調整，但需避免雲端伺服器過度負載
+ * - 讀卡間隔 RFID_POLL_INTERVAL 與讀到卡片後的暫停時間 RFID_HOLD_TIME 可視需求調整，
+ *   但需避免雲端伺服器過度負載
  * - 本程式為展示基本功能，實際部署時建議加入更多錯誤處理與重試機制
  * 
  * 【7. 版本與修改記錄】
@@ -86,7 +95,28 @@ String MacData ;            // 儲存開發板的 MAC 位址字串（例如 "AA:
 #include "OledLib.h"        // 引入 OLED 顯示模組自訂函式庫，提供螢幕顯示相關函式
 #include "RFIDLib.h"        // 引入 RFID 讀卡模組函式庫，用於 BMC11T001 RFID 讀寫模組的通訊控制
 #include "clouding.h"       // 引入雲端通訊函式庫，提供 HTTP GET 方式將資料傳送至雲端伺服器的功能
-#include "16keyLib.h"       // 引入雲端通訊函式庫，提供 HTTP GET 方式將資料傳送至雲端伺服器的功能
+#include "16keyLib.h"       // 引入 BMK52T016 16 鍵按鍵模組函式庫
+#include "TaskLib.h"        // 協同式任務排程函式庫（取代 loop() 中的 delay()）
+#include "KeyEventLib.h"    // 中斷驅動的按鍵事件佇列（須在 16keyLib.h 與 TaskLib.h 之後）
+#include "PinLib.h"         // 密碼輸入與刷卡雙重驗證狀態機
+
+// ========================================
+// 任務排程設定（毫秒）
+// ========================================
+#define RFID_POLL_INTERVAL 200      // 讀卡任務：每 200 毫秒檢查一次是否有卡片靠近
+#define RFID_POLL_DEADLINE 200
+#define RFID_HOLD_TIME 2000         // 讀到卡片後暫停讀卡的時間，避免同一張卡重複送出
+#define AUTH_POLL_INTERVAL 500      // 驗證任務：每 500 毫秒檢查一次密碼與刷卡是否逾時
+#define AUTH_POLL_DEADLINE 500
+// 雙重驗證預設關閉：密碼以明文放在 HTTP GET 的網址中，requestpass.php 目前也不比對 PIN，
+// 開啟前伺服器端須先支援密碼驗證，且連線應改走 HTTPS
+#ifndef AUTH_REQUIRE_PIN
+#define AUTH_REQUIRE_PIN 0          // 1：刷卡 + 密碼雙重驗證；0：只刷卡（原本的行為）
+#endif
+int rfidTask = TASK_NONE;           // 讀卡任務編號
+KeyEvent keyev;                     // 從按鍵事件佇列取出的事件
+uint8_t authShown = AUTH_IDLE;      // OLED 上顯示的驗證狀態（與 authState 不同時重新顯示）
+uint8_t pinShown = 0;               // OLED 上顯示的密碼位數
 
 // ========================================
 // 函式前置宣告
@@ -101,6 +131,11 @@ void PrintSSIDonOLED(String ss);   // 在 OLED 螢幕上顯示 AP SSID 名稱
 void PrintIPonOLED(String ss);     // 在 OLED 螢幕上顯示取得的 IP 位址
 void PrintCardonOLED(String ss);   // 在 OLED 螢幕上顯示讀取到的 RFID 卡號
 void PrintmsgonOLED(String ss);    // 在 OLED 螢幕上顯示系統訊息或結果資訊
+void pollRFIDTask();               // 任務：檢查卡片並查詢雲端授權
+void pollAuthTask();               // 任務：處理密碼與刷卡逾時
+void handleKeyEvent(KeyEvent *ev); // 處理一個按鍵事件（輸入密碼）
+void checkAccess();                // 以卡號（與密碼）查詢雲端授權並回報結果
+void showAuthStatus();             // 在 OLED 第 6 行顯示驗證進度
 
 // ========================================
 // setup() 函式：Arduino 啟動時只執行一次
@@ -133,12 +168,37 @@ void setup()
   PrintMAConOLED(MacData);            // 在 OLED 螢幕上顯示 MAC 位址（第 0 行）
   //PrintSSIDonOLED(SSIDData);        // （註解狀態）可選擇性開啟，在 OLED 上顯示 AP SSID
   PrintIPonOLED(IPData);              // 在 OLED 螢幕上顯示取得的 IP 位址（第 2 行）
+
+  // 登錄讀卡任務，之後由 loop() 中的 taskRun() 依週期執行
+  rfidTask = taskAddPeriodic("rfid", pollRFIDTask, RFID_POLL_INTERVAL, RFID_POLL_DEADLINE);
+
+#if AUTH_REQUIRE_PIN
+  // 登錄讀鍵任務並啟用 BMK52T016 INT 腳中斷，按鍵變化時由 taskRun() 立即讀取
+  keyEventBegin(KeyPad);
+  taskAddPeriodic("auth", pollAuthTask, AUTH_POLL_INTERVAL, AUTH_POLL_DEADLINE);
+#endif
 }
 
 // ========================================
 // loop() 函式：Arduino 啟動後會重複執行此區塊的程式碼
 // ========================================
 void loop()
+{
+  taskRun();                          // 執行已到期的任務（讀卡任務、讀鍵任務）
+
+#if AUTH_REQUIRE_PIN
+  // 依序處理佇列中的按鍵事件（密碼輸入）
+  while (keyGet(&keyev))
+  {
+    handleKeyEvent(&keyev);
+  }
+#endif
+}
+
+// ========================================
+// pollRFIDTask()：讀卡任務，週期 RFID_POLL_INTERVAL
+// ========================================
+void pollRFIDTask()
 {
   // 檢查是否有 RFID 卡片靠近並成功讀取
   // checkReadRFIDSuccess() 回傳 true 表示偵測到卡片且讀取成功
@@ -153,23 +213,121 @@ void loop()
 
     PrintCardonOLED(uidStr);          // 在 OLED 螢幕上顯示讀取到的卡號（第 4 行）
 
-    // 檢查 Wi-Fi 連線狀態是否正常
-    // Wifi.getStatus() 回傳 true 表示 Wi-Fi 已連線且運作正常
-    if (Wifi.getStatus())
-    {
-      Serial.println("WIFI OK");      // 輸出 Wi-Fi 連線正常訊息至序列監控視窗
-      SendtoClouding();               // 呼叫 SendtoClouding() 函式，將感測資料（卡號）透過 HTTP 傳送至雲端伺服器
-    }
-    else
+#if AUTH_REQUIRE_PIN
+    // 雙重驗證：卡號交給狀態機，已輸入密碼時立即查詢，否則等待輸入密碼
+    if (authSwipe(uidStr, millis()) == AUTH_READY)
+      checkAccess();
+    showAuthStatus();
+#else
+    checkAccess();                    // 只刷卡：直接以卡號查詢
+#endif
+
+    // 暫停讀卡 RFID_HOLD_TIME 毫秒再繼續（取代原本的 delay(2000)）
+    // 避免重複讀取同一張卡片，或造成雲端伺服器過度負載
+    taskStart(rfidTask, RFID_HOLD_TIME);
+  }
+}
+
+// ========================================
+// pollAuthTask()：驗證任務，週期 AUTH_POLL_INTERVAL
+// 輸入中太久沒按鍵、第二個因素逾時、鎖定時間到，都由 authPoll() 處理
+// ========================================
+void pollAuthTask()
+{
+  authPoll(millis());
+  showAuthStatus();
+}
+
+// ========================================
+// handleKeyEvent()：處理一個按鍵事件
+//   單鍵按下：交給 authKey()（數字、'*' 刪除一碼、'#' 送出）
+//   長按 '*'：清除已輸入的全部數字
+//   按住 '*' 再按 '#'：取消整個驗證（連同已刷的卡）
+// ========================================
+void handleKeyEvent(KeyEvent *ev)
+{
+  char c = keyChar(ev->key);
+
+  if (ev->type == KEY_PRESS && keyChordCount(ev->chord) > 1)
+  {
+    // 多鍵組合不當作密碼輸入
+    if (ev->chord == ((1u << 12) | (1u << 14)))   // KeyPad[12] = '*'、KeyPad[14] = '#'
     {
-      // 若 Wi-Fi 連線異常，可在此處加入錯誤處理邏輯（例如顯示錯誤訊息）
-      // 本程式目前未實作此部分的處理
+      authReset();
+      PrintmsgonOLED("Cancel");
+      authShown = AUTH_IDLE;          // "Cancel" 留在畫面上，直到下一次輸入
+      pinShown = 0;
     }
+    return;
+  }
+
+  if (ev->type == KEY_LONG && c == PIN_BACK_KEY)
+  {
+    pinClear();
+  }
+  else if (ev->type == KEY_PRESS)
+  {
+    if (authKey(c, ev->time) == AUTH_READY)
+      checkAccess();
+  }
+  showAuthStatus();
+}
+
+// ========================================
+// checkAccess()：以卡號（與密碼）查詢雲端授權
+// 雙重驗證時卡號與密碼取自 PinLib.h，查詢後以 authResult() 回報結果
+// ========================================
+void checkAccess()
+{
+#if AUTH_REQUIRE_PIN
+  uidStr = authCard;
+  pinStr = String(pinCode);
+#endif
+  jsonresult = "";                    // 查詢失敗時不沿用上一次的結果
+
+  // 檢查 Wi-Fi 連線狀態是否正常
+  // Wifi.getStatus() 回傳 true 表示 Wi-Fi 已連線且運作正常
+  if (Wifi.getStatus())
+  {
+    Serial.println("WIFI OK");        // 輸出 Wi-Fi 連線正常訊息至序列監控視窗
+    SendtoClouding();                 // 呼叫 SendtoClouding() 函式，將卡號（與密碼）透過 HTTP 傳送至雲端伺服器
   }
+  else
+  {
+    PrintmsgonOLED("WiFi Fail");      // Wi-Fi 連線異常，顯示於 OLED
+  }
+
+#if AUTH_REQUIRE_PIN
+  pinStr = "";
+  if (jsonresult.length() > 0)
+    authResult(jsonresult == "Find", millis());
+  else
+    authReset();                      // 沒有取得結果（Wi-Fi 或伺服器異常），不計入失敗次數
+  authShown = AUTH_IDLE;              // SendtoClouding() 顯示的結果留在畫面上，直到下一次輸入
+  pinShown = 0;
+#endif
+}
 
-  // 延遲 2 秒鐘（2000 毫秒）再進行下一次的讀卡動作
-  // 避免因程式循環過快導致重複讀取同一張卡片，或造成雲端伺服器過度負載
-  delay(2000);
+// ========================================
+// showAuthStatus()：在 OLED 第 6 行顯示驗證進度（狀態或密碼位數改變時才更新）
+// ========================================
+void showAuthStatus()
+{
+  if (authState == authShown && pinLen == pinShown) return;
+  authShown = authState;
+  pinShown = pinLen;
+
+  String msg;
+  if (authState == AUTH_LOCKED)
+    msg = "Locked";
+  else if (authState == AUTH_WAIT_CARD)
+    msg = "Swipe card";
+  else
+  {
+    msg = (authState == AUTH_WAIT_PIN) ? "PIN " : "";
+    for (uint8_t i = 0; i < pinLen; i++) msg += '*';
+  }
+  PrintmsgonOLED(msg);
 }
 
 // ========================================
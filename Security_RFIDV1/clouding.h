@@ -99,6 +99,9 @@ String ServerURL = "http://iot.arduino.org.tw";  // 雲端伺服器的基礎網
 // dbagent：API 路徑與參數的格式字串
 // %s 為格式化的佔位符，會依序被 MacData 與 uidStr 取代
 #define dbagent "/bmduino/rfid/requestpass.php?MAC=%s&KEY=%s"
+// 雙重驗證（AUTH_REQUIRE_PIN 為 1）時另外附上按鍵密碼，供伺服器同時比對卡號與密碼；
+// 密碼為明文，requestpass.php 目前也不檢查 PIN，因此主程式預設不開啟
+#define dbagentpin "/bmduino/rfid/requestpass.php?MAC=%s&KEY=%s&PIN=%s"
 
 // ========================================
 // 全域變數定義
@@ -106,6 +109,7 @@ String ServerURL = "http://iot.arduino.org.tw";  // 雲端伺服器的基礎網
 char dbagentstr[300];              // sprintf() 組合字串時的暫存區，儲存完整的 API 路徑
 String connectstr;                 // 一個空的字串變數，後續用來動態組成完整的 RESTful 請求參數
 String uidStr = "";                // 儲存讀取到的 RFID 卡號字串（例如 "0079262864"）
+String pinStr = "";                // 雙重驗證的按鍵密碼，空字串表示只以卡號查詢
 String webresponse;                // 儲存 HTTP GET 請求後，伺服器回傳的原始回應字串
 String jsonresult;                 // 儲存解析後的 JSON 結果（例如 "Find" 或 "notFind"）
 
@@ -146,7 +150,10 @@ void SendtoClouding()
   // 使用 sprintf() 將 MacData 與 uidStr 填入 dbagent 的格式字串中
   // dbagentstr 會儲存完整路徑，例如：
   //   "/bmduino/rfid/checkpass.php?MAC=112233445566&KEY=0079262864"
-  sprintf(dbagentstr, dbagent, MacData.c_str(), uidStr.c_str());
+  if (pinStr.length() > 0)
+    sprintf(dbagentstr, dbagentpin, MacData.c_str(), uidStr.c_str(), pinStr.c_str());
+  else
+    sprintf(dbagentstr, dbagent, MacData.c_str(), uidStr.c_str());
   
   // 將組合好的路徑字串轉換為 String 型態，儲存於 connectstr
   connectstr = String(dbagentstr);
@@ -158,8 +165,11 @@ void SendtoClouding()
    * uidStr：讀取到的 RFID 卡號
    */
 
-  // 將組合好的參數字串輸出至序列監控視窗，用於除錯
-  Serial.println(connectstr);
+  // 將組合好的參數字串輸出至序列監控視窗，用於除錯（密碼以 **** 取代，不顯示在監控視窗）
+  if (pinStr.length() > 0)
+    Serial.println(connectstr.substring(0, connectstr.lastIndexOf("&PIN=")) + "&PIN=****");
+  else
+    Serial.println(connectstr);
 
   // ========================================
   // 步驟 2：檢查 Wi-Fi 連線狀態
@@ -1,6 +1,7 @@
 //溫溼度上傳到雲端後台
 #include <String.h>
 #include "TCP.h"  // 引入 TCP 控制邏輯相關函式與變數定義（應包含 WiFi 初始化、MAC 取得等）
+#include "StoreLib.h"  // 離線暫存函式庫（WiFi 斷線時保存樣本，恢復後補送）
 #include "clouding.h"  // http GET 使用的函式庫
 
 
@@ -23,6 +24,7 @@ void setup()
       Serial.println("---MAC Address----"); // 分隔線，美觀用途
   Serial.println(MacData); // 印出取得 連接上的SSID熱點之後閘道器IP位址
   randomSeed(analogRead(A0)); // 使用類比腳位產生隨機種子（可用任一未接線的腳位）
+  initStore();              // 載入離線暫存記錄區（保留上次斷電前未送出的樣本）
 //   if  (Wifi.getStatus())
 //  {
 //     Serial.println("WIFI OK") ;
@@ -32,20 +34,7 @@ void setup()
 
 void loop() 
 {
-if  (Wifi.getStatus())
- {
-    Serial.println("WIFI OK") ;
-    SendtoClouding() ;    //傳送感測資料到雲端
- }
- else
-  {
-    Serial.println("WIFI not OK，Reconnect WIFI") ;
-    initWiFi();              // 執行 WiFi 模組初始化與連線（定義於 TCP.h / BMC81M001.h）
-      MacData = GetMAC() ; //取得 MAC 位址字串
-    Serial.println("---MAC Address----"); // 分隔線，美觀用途
-    Serial.println(MacData); // 印出取得 連接上的SSID熱點之後閘道器IP位址
-    SendtoClouding() ;    //傳送感測資料到雲端
- }
+  SendtoClouding() ;    //保存感測資料，WiFi 正常時傳送到雲端（含離線期間的樣本）
   delay(120000) ;
 }
 
@@ -36,6 +36,7 @@ BMC81M001 Wifi(&Serial2); // 使用 BMduino 板上的硬體 Serial2 腳位控制
 
 
 void initWiFi() ; // 初始化 WiFi 自訂模組
+bool WifiOnline() ; //WiFi 已取得 IP 時傳回 true（AT+CIPSTATUS 為 2、3、4）
 String GetMAC() ; //取得 MAC 位址字串
 String GetSSID() ;  //取得 SSID熱點字串
 String GetIP()  ; //取得 連接上的SSID熱點之後由DHCP取得的IP ADDRESS
@@ -64,6 +65,16 @@ void initWiFi()   // 初始化 WiFi 自訂模組
 
 
 
+bool WifiOnline()   //WiFi 已取得 IP 時傳回 true
+{
+   // getStatus() 傳回 AT+CIPSTATUS 的狀態碼，失敗時為負值，永遠不會是 0，
+   // 不能直接當成 true/false 使用
+   // 2：已取得 IP，3：另有 TCP 連線，4：TCP 連線剛關閉（仍有 IP），5：未連上熱點
+   int status = Wifi.getStatus();
+   return status == WIFI_STATUS_GOT_IP || status == WIFI_STATUS_CONNETED ||
+          status == WIFI_STATUS_DISCONNETED;
+}
+
 String GetMAC()   //取得 SSID熱點字串
 {
    delay(500); // 等待模組穩定
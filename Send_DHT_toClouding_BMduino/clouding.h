@@ -29,50 +29,66 @@ float Tvalue=55, Hvalue=66; //用溫溼度
  */
 
 void SendtoClouding() ;    //傳送感測資料到雲端
+bool sendValues(float t, float h, long age) ;    //傳送一筆（可能是離線補送的）溫溼度資料
 
 void SendtoClouding()     //傳送感測資料到雲端
 {
    Tvalue = random(190, 281) / 10.0;  // random(190,281) 產生 190~280 的整數，除以10.0得到小數
   // 產生濕度（60 ~ 99）的隨機值
   Hvalue = random(600, 991) / 10.0;
+  // 連線正常時直接送出，不寫入 EEPROM；WiFi 斷線或送出失敗時
+  // 才寫入離線暫存記錄區（StoreLib.h），連線恢復後由最舊的開始分批補送
+
+ if  (!WifiOnline())   //WiFi 斷線時重新連線（WifiOnline() 定義於 TCP.h）
+ {
+    initWiFi();              // 執行 WiFi 模組初始化與連線（定義於 TCP.h / BMC81M001.h）
+      MacData = GetMAC() ; //取得 MAC 位址字串
+    Serial.println("---MAC Address----"); // 分隔線，美觀用途
+    Serial.println(MacData); // 印出取得 連接上的SSID熱點之後閘道器IP位址
+ }
+ if  (sendOrStore(sendValues, WifiOnline(), Tvalue, Hvalue) && storedCount() > 0)
+ {
+    int sent = forwardSamples(sendValues, STORE_BATCH_SIZE) ; //每次最多補送 STORE_BATCH_SIZE 筆
+    Serial.print("Forwarded:(") ;
+    Serial.print(sent) ;
+    Serial.print("), pending:(") ;
+    Serial.print(storedCount()) ;
+    Serial.print(")\n") ;
+ }
+}
+
+bool sendValues(float t, float h, long age)     //傳送一筆溫溼度資料到雲端，成功傳回 true
+{
   // 自訂函數，用來將感測器的資料（例如溫度和濕度）透過 HTTP GET 請求傳送到雲端伺服器。
 //http://iot.arduino.org.tw:8888/bigdata/dhtdata/dhDatatadd.php?MAC=AABBCCDDEEFF&T=34&H=34
 // host is  ==>iot.arduino.org.tw:8888
 //  app program is ==> bigdata/dhtdata/dhDatatadd.php
 //  App parameters ==> ?MAC=AABBCCDDEEFF&T=34&H=34
-          sprintf(dbagentstr,dbagent,MacData.c_str(),Tvalue,Hvalue) ;
+          sprintf(dbagentstr,dbagent,MacData.c_str(),t,h) ;
+          if (age > 0)    //補送資料：加上經過秒數 AGE，伺服器端可換算實際時間
+          {
+            sprintf(dbagentstr + strlen(dbagentstr), "&AGE=%ld", age) ;
+          }
           connectstr = String(dbagentstr) ;
           /*
           組成GET Format 的Resetful  的 Parameters 字串
           connectstr：動態組成 RESTful 請求的參數部分：
           MacData：設備的 MAC 位址（假設已在程式其他地方定義）。
-          Tvalue：溫度值，轉換成字串格式。
-          Hvalue：濕度值，轉換成字串格式。
+          t：溫度值，轉換成字串格式。
+          h：濕度值，轉換成字串格式。
+          age：資料產生至今的秒數（STORE_AGE_LIVE 即時資料與 STORE_AGE_UNKNOWN 未知都不加入，
+               伺服器端以收到的時間為準）。
           */
           
  Serial.println(connectstr) ;//將組合好的參數字串輸出到序列監控視窗，用於除錯
- 
- if  (Wifi.getStatus())
- {
+
     Wifi.http_begin(ServerURL,ServerPort,connectstr);//begin http get 
 
-    Wifi.http_get();//http get opration
+    int code = Wifi.http_get();//http get opration，傳回 HTTP 狀態碼
 
     Serial.println(Wifi.http_getString());//get http result
 
     Wifi.http_end(); //end of http get
 
- }
- else
- {
-    initWiFi();              // 執行 WiFi 模組初始化與連線（定義於 TCP.h / BMC81M001.h）
-      MacData = GetMAC() ; //取得 MAC 位址字串
-    Serial.println("---MAC Address----"); // 分隔線，美觀用途
-    Serial.println(MacData); // 印出取得 連接上的SSID熱點之後閘道器IP位址
-   Wifi.http_begin(ServerURL,ServerPort,connectstr);//begin http get 
-    Wifi.http_get();//http get opration
-    Serial.println(Wifi.http_getString());//get http result
-    Wifi.http_end(); //end of http get
- }
+    return code == 200 ;
 }
- 
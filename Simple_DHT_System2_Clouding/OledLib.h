@@ -23,9 +23,12 @@ uint8_t t = ' ';  // 宣告變數 t，初始化為空格字元
 // 創建 BMD31M090 顯示模組的物件，並使用 HW Wire 進行通訊
 //BMD31M090 BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire);
 BMD31M090     BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire1); //Please uncomment out this line of code if you use HW Wire1 on BMduino
+TwoWire *oledWire = &Wire1;   // updateScreen() 直接送出畫面緩衝區使用的 I2C 介面，須與上一行相同
 //BMD31M090     BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire2); //Please uncomment out this line of code if you use HW Wire1 on BMduino
 
 
+#include "OledFrame.h"   // 畫面緩衝區與只送出變動部分的更新（LIB/OledFrame）
+
 //----------自定義函式區宣告--------------
 void initOled() ;//初始化OLED12864，0.96吋OLED顯示模組 BMD31M090
 void drawPicture(int x,int y, const uint8_t *pp,int width, int height) ;
@@ -150,6 +153,8 @@ void initOled()  //OLED12832 物件初始化區
 {
   // 初始化 BMD31M090 顯示模組，使用 I2C 地址進行通訊
   BMD31.begin(BMD31M090_ADDRESS);
+  setFont(FontTable_8X16);   // BMD31 預設的字型，同步記錄字型大小
+  oledClearFrame();
   delay(100);  // 建議的初始化延遲
     Serial.println("init OLED12864 OK") ;
 
@@ -163,30 +168,33 @@ void setFont(const unsigned char* font)   //設定字形
     // FontTable_16X32：字體格式為 16×32
     // FontTable_32X64：字體格式為 32×64
     BMD31.setFont(font);  // 設定字型為 6x8
-}
-
-//----------顯示當前緩衝區的內容------------------
-void updateScreen()  //顯示當前緩衝區的內容   
-{
-  BMD31.display();  //顯示當前緩衝區的內容
+  // 記錄字型大小，printText() 依此記錄文字占用的欄
+  if (font == FontTable_6X8) { oledFontWidth = 6; oledFontPages = 1; }
+  else if (font == FontTable_16X32) { oledFontWidth = 16; oledFontPages = 4; }
+  else if (font == FontTable_32X64) { oledFontWidth = 32; oledFontPages = 8; }
+  else { oledFontWidth = 8; oledFontPages = 2; }
 }
 
 //--------指定位置印出文字函式--------
 void printText(int x,int y, String str)  //在xcolumn,y row位置，印出文字
 {
   BMD31.drawString((uint8_t)x, (uint8_t)y, (uint8_t*)str.c_str());
+  oledMarkText(x, y, str.c_str());   // 記錄文字占用的欄，updateScreen() 不會蓋掉文字
 }
 
 //-----------指定位置印出字元函式------------
 void printChar(int x,int y, char str)  //在xcolumn,y row位置，印出字元文字
 {
   BMD31.drawChar((uint8_t)x, (uint8_t)y, (uint8_t)str);
+  char text[2] = { str, 0 };
+  oledMarkText(x, y, text);
 }
 
 //--------指定位置印出整數-----------
 void printNumber(int x,int y, int num)  //在xcolumn,y row位置，印出整數
 {
   BMD31.drawNum((uint8_t)x, (uint8_t)y, (uint32_t)num,(uint8_t)(String(num).length()) );
+  oledMarkText(x, y, String(num).c_str());
 }
 
 //-----------指定位置印出浮點數-----------
@@ -204,8 +212,8 @@ void drawPoint(int x,int y,int pixelColor) //在xcolumn,y row位置，繪出一
     // 0 (pixelColor_BLACK)：像素顏色為黑
     // 1 (pixelColor_WHITE)：像素顏色為白
     // 2 (pixelColor_INVERSE)：像素顏色翻轉
-    BMD31.drawPixel((uint8_t)x, (uint8_t)y, (uint8_t)pixelColor) ;
-    BMD31.display();
+  oledSetPixel(x, y, pixelColor);
+  oledFlushIfImmediate();  // 立即模式只送出這一點所在的一個位元組
 }
 
 //---------在兩點畫一條直線------------
@@ -219,8 +227,19 @@ void drawLine(int x1,int y1,int x2,int y2,int pixelColor) //畫(x1,y1) - (x2,y2)
     //     0 (pixelColor_BLACK)：像素顏色為黑
     //     1 (pixelColor_WHITE)：像素顏色為白
     //     2 (pixelColor_INVERSE)：像素顏色翻轉
-  BMD31.drawLine((uint8_t)x1,(uint8_t)y1,(uint8_t)x2,(uint8_t)y2,(uint8_t)pixelColor) ;//畫(x1,y1) - (x2,y2) 的一條直線
-  BMD31.display();
+  // Bresenham 直線演算法，只用整數運算
+  int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+  int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+  int err = dx + dy;
+  while (true)
+  {
+    oledSetPixel(x1, y1, pixelColor);
+    if (x1 == x2 && y1 == y2) break;
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x1 += sx; }
+    if (e2 <= dx) { err += dx; y1 += sy; }
+  }
+  oledFlushIfImmediate();
 }
 
 //-----在一點畫一條width寬度的畫垂直線-------
@@ -233,8 +252,8 @@ void drawfastVline(int x,int y, int width, int pixelColor)  //在xcolumn,y row
     //     0 (pixelColor_BLACK)：像素顏色為黑
     //     1 (pixelColor_WHITE)：像素顏色為白
     //     2 (pixelColor_INVERSE)：像素顏色翻轉
-    BMD31.drawFastVLine((uint8_t)x,(uint8_t)y,(uint8_t)width,(uint8_t)pixelColor) ;//在xcolumn,y row位置，繪出width寬度的畫垂直線
-  BMD31.display();
+  for (int i = 0; i < width; i++) oledSetPixel(x, y + i, pixelColor);
+  oledFlushIfImmediate();
 }
 
  //---------在一點畫一條width寬度的畫水平線---------
@@ -247,8 +266,8 @@ void drawfastHline(int x,int y, int width, int pixelColor)  //在xcolumn,y row
     //     0 (pixelColor_BLACK)：像素顏色為黑
     //     1 (pixelColor_WHITE)：像素顏色為白
     //     2 (pixelColor_INVERSE)：像素顏色翻轉
-    BMD31.drawFastHLine((uint8_t)x,(uint8_t)y,(uint8_t)width,(uint8_t)pixelColor) ;//在xcolumn,y row位置，繪出width寬度的畫水平線
-  BMD31.display();
+  for (int i = 0; i < width; i++) oledSetPixel(x + i, y, pixelColor);
+  oledFlushIfImmediate();
 }
 
 //---------在一點畫一條width寬度的畫垂直線-------
@@ -261,8 +280,7 @@ void drawVline(int x,int y, int width, int pixelColor)  //在xcolumn,y row位置
     //     0 (pixelColor_BLACK)：像素顏色為黑
     //     1 (pixelColor_WHITE)：像素顏色為白
     //     2 (pixelColor_INVERSE)：像素顏色翻轉
-    BMD31.drawFastVLine((uint8_t)x,(uint8_t)y,(uint8_t)width,(uint8_t)pixelColor) ;//在xcolumn,y row位置，繪出width寬度的畫垂直線
-  BMD31.display();
+  drawfastVline(x, y, width, pixelColor);
 }
 
 //--------在一點畫一條width寬度的畫水平線----------
@@ -275,8 +293,7 @@ void drawHline(int x,int y, int width, int pixelColor)  //在xcolumn,y row位置
     //     0 (pixelColor_BLACK)：像素顏色為黑
     //     1 (pixelColor_WHITE)：像素顏色為白
     //     2 (pixelColor_INVERSE)：像素顏色翻轉
-    BMD31.drawFastHLine((uint8_t)x,(uint8_t)y,(uint8_t)width,(uint8_t)pixelColor) ;//在xcolumn,y row位置，繪出width寬度的畫水平線
-  BMD31.display();
+  drawfastHline(x, y, width, pixelColor);
 }
 
 //-------以兩點為對角的繪出一個矩形-------
@@ -290,11 +307,20 @@ void drawBox(int x1,int y1,int x2,int y2,int pixelColor) //畫(x1,y1) - (x2,y2)
     //     0 (pixelColor_BLACK)：像素顏色為黑
     //     1 (pixelColor_WHITE)：像素顏色為白
     //     2 (pixelColor_INVERSE)：像素顏色翻轉
-  BMD31.drawLine((uint8_t)x1,(uint8_t)y1,(uint8_t)x2,(uint8_t)y1,(uint8_t)pixelColor) ;//畫(x1,y1) - (x2,y1) 的一條直線
-  BMD31.drawLine((uint8_t)x2,(uint8_t)y1,(uint8_t)x2,(uint8_t)y2,(uint8_t)pixelColor) ;//畫(x2,y1) - (x2,y2) 的一條直線
-  BMD31.drawLine((uint8_t)x1,(uint8_t)y1,(uint8_t)x1,(uint8_t)y2,(uint8_t)pixelColor) ;//畫(x1,y1) - (x1,y2) 的一條直線
-  BMD31.drawLine((uint8_t)x1,(uint8_t)y2,(uint8_t)x2,(uint8_t)y2,(uint8_t)pixelColor) ;//畫(x1,y2) - (x2,y2) 的一條直線
-  BMD31.display();
+  // 四條邊先全部畫進緩衝區，再一次送出變動部分（反轉顏色時四個角只反轉一次）
+  if (x1 > x2) { int tmp = x1; x1 = x2; x2 = tmp; }
+  if (y1 > y2) { int tmp = y1; y1 = y2; y2 = tmp; }
+  for (int x = x1; x <= x2; x++)
+  {
+    oledSetPixel(x, y1, pixelColor);                  // 上邊線
+    if (y2 != y1) oledSetPixel(x, y2, pixelColor);    // 下邊線
+  }
+  for (int y = y1 + 1; y < y2; y++)
+  {
+    oledSetPixel(x1, y, pixelColor);                  // 左邊線
+    if (x2 != x1) oledSetPixel(x2, y, pixelColor);    // 右邊線
+  }
+  oledFlushIfImmediate();
 }
 
 //--------清除螢幕-----------
@@ -302,6 +328,7 @@ void clearScreen()    //清除螢幕
 {
   BMD31.clearDisplay(); //清除螢幕資訊
   BMD31.display();  //更新螢幕資訊到螢幕硬體
+  oledClearFrame();  // 螢幕已全部清除，畫面緩衝區與文字記錄同步清除
 }
 
 //-------在指定位置已設定長寬畫一張圖---------
@@ -316,9 +343,11 @@ void invdrawPicture(int x,int y, const uint8_t *pp,int width, int height) //使
     // 0 (pixelColor_BLACK)：像素顏色為黑
     // 1 (pixelColor_WHITE)：像素顏色為白
     // 2 (pixelColor_INVERSE)：像素顏色翻轉
-  BMD31.clearDisplay();
-  BMD31.drawBitmap((uint8_t)x, (uint8_t)y, pp, (uint8_t)width, (uint8_t)height, pixelColor_BLACK);//使用黑色畫一張圖
-  BMD31.display();
+  BMD31.clearDisplay();  // BMD31 的緩衝區也清除，之後 display() 不會蓋回舊畫面
+  oledClearFrame();
+  oledDrawBitmap(x, y, pp, width, height, pixelColor_BLACK);
+  for (uint8_t page = 0; page < OLED_PAGES; page++) oledMarkDirty(page, 0, BMD31M090_WIDTH - 1);  // 整個畫面重畫，文字也一併蓋掉
+  updateScreen();
 }
 
 //-------------在指定位置已設定長寬以黑色畫一張圖-------------
@@ -333,9 +362,11 @@ void drawPicture(int x,int y, const uint8_t *pp,int width, int height)  //使用
     // 0 (pixelColor_BLACK)：像素顏色為黑
     // 1 (pixelColor_WHITE)：像素顏色為白
     // 2 (pixelColor_INVERSE)：像素顏色翻轉
-  BMD31.clearDisplay();
-  BMD31.drawBitmap((uint8_t)x, (uint8_t)y, pp, (uint8_t)width, (uint8_t)height, pixelColor_WHITE);  //使用白色畫一張圖
-  BMD31.display();
+  BMD31.clearDisplay();  // BMD31 的緩衝區也清除，之後 display() 不會蓋回舊畫面
+  oledClearFrame();
+  oledDrawBitmap(x, y, pp, width, height, pixelColor_WHITE);
+  for (uint8_t page = 0; page < OLED_PAGES; page++) oledMarkDirty(page, 0, BMD31M090_WIDTH - 1);  // 整個畫面重畫，文字也一併蓋掉
+  updateScreen();
 }
 
 //----------設定省電模式降低亮度-------------
@@ -514,7 +545,7 @@ void test_drawString_6x8(void)  //顯示 6x8 字型字串
   BMD31.clearDisplay();  // 清除畫面
   BMD31.display();       // 更新顯示
 
-  BMD31.setFont(FontTable_6X8);  // 設定字型為 6x8
+  setFont(FontTable_6X8);  // 設定字型為 6x8
   uint8_t col = (128 - (6 * sizeof("Hello World!"))) / 2;  // 計算置中位置
 
   for (uint8_t row = 0; row < 8; row++)
@@ -530,7 +561,7 @@ void test_drawString_8x16(void) // 顯示 8x16 字型字串
   BMD31.clearDisplay();
   BMD31.display();
 
-  BMD31.setFont(FontTable_8X16);  // 設定字型為 8x16
+  setFont(FontTable_8X16);  // 設定字型為 8x16
   uint8_t col = (128 - (8 * sizeof("Hello World!"))) / 2;
 
   for (uint8_t row = 0; row < 8; row += 2)  // 每 2 行顯示一次
@@ -550,13 +581,13 @@ void test_drawString_drawChar_drawNum(void) // 同時顯示字串與字元與數
   /* Sequentially display ASCII ' ' (0x20/32) to ' ~' (0x7E/126) values for Font 6x8 & 8x16 */
   do
   {
-    BMD31.setFont(FontTable_6X8);
+    setFont(FontTable_6X8);
     BMD31.drawString(0, displayROW5, (u8*)"ASCII:");
     BMD31.drawString(63, displayROW5, (u8*)"CODE:");
     BMD31.drawChar(48, displayROW5, t);
     BMD31.drawNum(103, displayROW5, t, 3);
 
-    BMD31.setFont(FontTable_8X16);
+    setFont(FontTable_8X16);
     BMD31.drawString(0, displayROW6, (u8*)"ASCII:");
     BMD31.drawString(63, displayROW6, (u8*)"CODE:");
     BMD31.drawChar(48, displayROW6, t);
@@ -0,0 +1,266 @@
+// ================================================================
+// 檔案名稱：BatchLib.h
+// 描述：MQTT 批次發佈函式庫
+// 功能：把多筆溫溼度樣本收集成一個精簡的陣列承載資料，
+//       再以一次 AT+MQTTPUBRAW（Wifi.writeBytes()）送出
+//       - 收滿 N 筆或最舊樣本超過 T 毫秒時自動送出（可設定）
+//       - 也可以只用手動方式呼叫 batchFlush() 送出
+//       - 每秒取樣時可大幅減少 AT 指令往返與 Broker 負載
+// 承載資料格式（伺服器端 MQTT_Scribe_2_mySQL.py 會拆回單筆）：
+//   {"Device":"<MAC>","Batch":[[經過毫秒,溫度,濕度],...]}
+//   例如：{"Device":"E89F6D123456","Batch":[[2000,25.3,88.9],[1000,25.4,88.7],[0,25.4,88.6]]}
+// PAYLOAD_BINARY 為 1 時改用 PackLib.h 的二進位格式（每筆樣本 8 位元組）
+// 注意：需在 PackLib.h、MQTTLib.h、MetricsLib.h 之後引入（使用 MacData、PubTopicbuffer 與量測函式）
+// ================================================================
+
+// ================================================================
+// =============== 批次設定常數區 ===============
+// ================================================================
+#ifndef BATCH_CAPACITY
+#define BATCH_CAPACITY 32          // RAM 中最多保留的樣本數（每筆 8 位元組）
+#endif
+#ifndef BATCH_MAX_COUNT
+#define BATCH_MAX_COUNT 30         // 預設：收滿 30 筆就送出
+#endif
+#ifndef BATCH_MAX_AGE
+#define BATCH_MAX_AGE 30000        // 預設：最舊樣本超過 30 秒就送出
+#endif
+#define BATCH_DEVICE_MAX 20        // 裝置識別碼最大長度
+// 承載資料緩衝區：標頭與裝置識別碼最多 48 字元，每筆樣本最多 28 字元（[4294967295,-3276.8,6553.5],）
+#define BATCH_PAYLOAD_SIZE (48 + BATCH_CAPACITY * 28)
+
+// 送出條件（可用 | 組合）
+#define BATCH_FLUSH_MANUAL 0x00    // 只在呼叫 batchFlush() 時送出
+#define BATCH_FLUSH_COUNT  0x01    // 樣本數達到上限時送出
+#define BATCH_FLUSH_TIME   0x02    // 最舊樣本等待超過時間上限時送出
+
+// ================================================================
+// =============== 資料結構宣告區 ===============
+// ================================================================
+
+// 一筆批次樣本，溫溼度以 0.1 為單位的整數保存，節省 RAM 也不需要浮點格式化
+typedef struct
+{
+    uint32_t ms;         // 取樣時的 millis()
+    int16_t t;           // 溫度 × 10
+    uint16_t h;          // 濕度 × 10
+} BatchSample;
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+BatchSample batchSamples[BATCH_CAPACITY];      // 樣本環狀緩衝區
+uint8_t batchHead = 0;                         // 最舊樣本的位置
+uint8_t batchCount = 0;                        // 目前保留的樣本數
+uint8_t batchPolicy = BATCH_FLUSH_COUNT | BATCH_FLUSH_TIME;  // 送出條件
+uint8_t batchMaxCount = BATCH_MAX_COUNT;       // 樣本數上限
+unsigned long batchMaxAge = BATCH_MAX_AGE;     // 等待時間上限（毫秒）
+char batchBuffer[BATCH_PAYLOAD_SIZE];          // 承載資料緩衝區（不需轉譯，直接以 PUBRAW 送出）
+uint32_t batchPublished = 0;                   // 成功送出的批次數
+uint32_t batchDropped = 0;                     // 因緩衝區已滿而被丟棄的樣本數
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+void batchSetPolicy(uint8_t policy, uint8_t maxCount, unsigned long maxAge);  // 設定送出條件
+bool batchAdd(float t, float h);              // 加入一筆樣本，符合條件時自動送出
+bool batchPoll();                             // 檢查時間條件，在 loop() 中定期呼叫
+bool batchFlush();                            // 立即送出所有保留的樣本
+int  batchPending();                          // 尚未送出的樣本數
+int  batchEncode(char *buf, int size, const char *dev);  // 產生承載資料，傳回長度
+int  batchPack(uint8_t *buf, int size, const char *dev);  // 產生二進位承載資料，傳回長度
+char *appendTenths(char *p, long v);          // 以一位小數寫出 0.1 單位的整數
+char *appendNull(char *p);                    // 讀取失敗的數值寫成 null
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：batchSetPolicy()
+// 功能：設定批次送出的條件
+// 參數：
+//   - policy: BATCH_FLUSH_COUNT、BATCH_FLUSH_TIME 的組合，或 BATCH_FLUSH_MANUAL
+//   - maxCount: 樣本數上限（超過 BATCH_CAPACITY 時以 BATCH_CAPACITY 為準）
+//   - maxAge: 最舊樣本的等待時間上限（毫秒）
+// 傳回值：無
+// ---------------------------------------------------------------
+void batchSetPolicy(uint8_t policy, uint8_t maxCount, unsigned long maxAge)
+{
+    batchPolicy = policy;
+    batchMaxCount = maxCount == 0 || maxCount > BATCH_CAPACITY ? BATCH_CAPACITY : maxCount;
+    batchMaxAge = maxAge;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：batchAdd()
+// 功能：把一筆樣本加入批次，達到樣本數上限時立即送出
+// 參數：
+//   - t: 溫度值
+//   - h: 濕度值
+// 傳回值：本次有送出且成功時傳回 true
+// 說明：緩衝區已滿（例如斷線期間送不出去）時丟棄最舊的樣本，並累計 batchDropped
+// ---------------------------------------------------------------
+bool batchAdd(float t, float h)
+{
+    if (batchCount == BATCH_CAPACITY) {
+        batchHead = (batchHead + 1) % BATCH_CAPACITY;
+        batchCount--;
+        batchDropped++;
+    }
+    BatchSample *s = &batchSamples[(batchHead + batchCount) % BATCH_CAPACITY];
+    s->ms = millis();
+    // 四捨五入到 0.1，讀取失敗（NaN）時保存 PACK_INVALID
+    s->t = toTenths(t);
+    s->h = h < 0 ? 0 : (uint16_t)toTenths(h);
+    batchCount++;
+
+    if ((batchPolicy & BATCH_FLUSH_COUNT) && batchCount >= batchMaxCount) {
+        return batchFlush();
+    }
+    return batchPoll();
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：batchPoll()
+// 功能：最舊樣本等待超過 batchMaxAge 時送出批次
+// 參數：無
+// 傳回值：本次有送出且成功時傳回 true
+// ---------------------------------------------------------------
+bool batchPoll()
+{
+    if (!(batchPolicy & BATCH_FLUSH_TIME) || batchCount == 0) return false;
+    if (millis() - batchSamples[batchHead].ms < batchMaxAge) return false;
+    return batchFlush();
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：batchPending()
+// 功能：傳回尚未送出的樣本數
+// ---------------------------------------------------------------
+int batchPending()
+{
+    return batchCount;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：appendTenths()
+// 功能：把 0.1 單位的整數寫成一位小數的文字（例如 253 → "25.3"）
+// 參數：
+//   - p: 寫入位置
+//   - v: 數值 × 10
+// 傳回值：寫入後的下一個位置
+// ---------------------------------------------------------------
+char *appendTenths(char *p, long v)
+{
+    if (v < 0) {
+        *p++ = '-';
+        v = -v;
+    }
+    p += sprintf(p, "%ld.%d", v / 10, (int)(v % 10));
+    return p;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：appendNull()
+// 功能：讀取失敗的數值寫成 JSON 的 null
+// 參數：
+//   - p: 寫入位置
+// 傳回值：寫入後的下一個位置
+// ---------------------------------------------------------------
+char *appendNull(char *p)
+{
+    memcpy(p, "null", 4);
+    return p + 4;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：batchEncode()
+// 功能：把目前保留的樣本編碼成陣列承載資料
+// 參數：
+//   - buf: 輸出緩衝區
+//   - size: 緩衝區大小（至少 BATCH_PAYLOAD_SIZE）
+//   - dev: 裝置識別碼（MAC 位址）
+// 傳回值：承載資料長度，緩衝區不足或裝置識別碼過長時傳回 0
+// 說明：每筆樣本記錄「距今毫秒數」，伺服器端以收到的時間回推取樣時間
+// ---------------------------------------------------------------
+int batchEncode(char *buf, int size, const char *dev)
+{
+    if (size < BATCH_PAYLOAD_SIZE || strlen(dev) > BATCH_DEVICE_MAX) return 0;
+    uint32_t now = millis();
+    char *p = buf;
+    p += sprintf(p, "{\"Device\":\"%s\",\"Batch\":[", dev);
+    for (int i = 0; i < batchCount; i++) {
+        BatchSample *s = &batchSamples[(batchHead + i) % BATCH_CAPACITY];
+        if (i > 0) *p++ = ',';
+        p += sprintf(p, "[%lu,", (unsigned long)(now - s->ms));
+        p = s->t == PACK_INVALID ? appendNull(p) : appendTenths(p, s->t);
+        *p++ = ',';
+        p = s->h == (uint16_t)PACK_INVALID ? appendNull(p) : appendTenths(p, s->h);
+        *p++ = ']';
+    }
+    *p++ = ']';
+    *p++ = '}';
+    *p = '\0';
+    return p - buf;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：batchPack()
+// 功能：把目前保留的樣本編碼成 PackLib.h 的二進位格式
+// 參數：
+//   - buf: 輸出緩衝區（至少 PACK_SIZE(BATCH_CAPACITY)）
+//   - size: 緩衝區大小
+//   - dev: 裝置識別碼（MAC 位址）
+// 傳回值：資料長度
+// ---------------------------------------------------------------
+int batchPack(uint8_t *buf, int size, const char *dev)
+{
+    uint32_t now = millis();
+    int len = packBegin(buf, dev);
+    for (int i = 0; i < batchCount; i++) {
+        BatchSample *s = &batchSamples[(batchHead + i) % BATCH_CAPACITY];
+        len = packSample(buf, len, size, now - s->ms, s->t, s->h);
+    }
+    return len;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：batchFlush()
+// 功能：把所有保留的樣本以一次 AT+MQTTPUBRAW 送到 MQTT Broker
+// 參數：無
+// 傳回值：送出成功傳回 true（沒有樣本時傳回 false）
+// 說明：
+//   1. PUBRAW 以長度傳送原始位元組，承載資料不需要插入轉譯字元
+//   2. 送出失敗時樣本保留在緩衝區，下次再一起送出
+// ---------------------------------------------------------------
+bool batchFlush()
+{
+    if (batchCount == 0) return false;
+#if PAYLOAD_BINARY
+    int len = batchPack((uint8_t *)batchBuffer, sizeof(batchBuffer), MacData.c_str());
+#else
+    int len = batchEncode(batchBuffer, sizeof(batchBuffer), MacData.c_str());
+#endif
+    if (len == 0) return false;
+
+    Serial.print("Batch payload:(");
+    Serial.print(batchCount);
+    Serial.print(" samples, ");
+    Serial.print(len);
+    Serial.print(" bytes)\n");
+
+    unsigned long start = metricStart();
+    bool sent = Wifi.writeBytes((const char *)batchBuffer, len, PubTopicbuffer);
+    metricStop(metricHistogram("mqtt_pub"), start);
+    if (sent) {
+        batchCount = 0;
+        batchHead = 0;
+        batchPublished++;
+        showStatusonOled("MQTT OK");
+        return true;
+    }
+    metricInc(metricCounter("mqtt_pub_fail"));
+    showStatusonOled("MQTT Fail");
+    return false;
+}
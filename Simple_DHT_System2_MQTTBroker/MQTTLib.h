@@ -3,6 +3,7 @@
 // 描述：MQTT 通訊函式庫
 // 功能：提供與 MQTT Broker 連線、訊息發佈、JSON 資料處理等功能
 //       用於將溫溼度感測資料發送至 MQTT 伺服器
+// 注意：需在 MetricsLib.h 之後引入（記錄發佈時間與失敗次數）
 // ================================================================
 
 // ================================================================
@@ -49,8 +50,12 @@ String TopicT;                    // 用於暫存主題字串
 char PubTopicbuffer[200];         // 發佈主題緩衝區（字元陣列格式）
 char SubTopicbuffer[200];         // 訂閱主題緩衝區（字元陣列格式）
 
-String PayloadT;                  // 用於暫存承載資料（JSON 字串格式）
-char Payloadbuffer[250];          // 承載資料緩衝區（處理特殊字元用）
+char Payloadbuffer[250];          // 承載資料緩衝區（JSON 字串，已處理特殊字元）
+                                  // 直接交給 Wifi.writeString()，發佈時不配置動態記憶體
+
+#if PAYLOAD_BINARY
+uint8_t Packbuffer[PACK_SIZE(1)]; // 二進位承載資料緩衝區（PackLib.h 格式，不需轉譯）
+#endif
 
 char clintid[20];                 // MQTT Client ID 緩衝區
 
@@ -65,9 +70,9 @@ void printText(int x, int y, uint8_t *str);  // OLED 顯示函式（在 OledLib.
 void fillCID(String mm);                      // 產生動態 MQTT Client ID（基於 MAC 位址）
 void fillTopic(String mm);                    // 填入對應 MAC 位址的主題字串
 void insertBeforeChar(char *str, char target, char toInsert);  // 字串特殊字元處理
-void fillPayload(String dev, float d1, float d2);  // 根據 MAC 位址、溫度、濕度產生 JSON 承載資料
+void fillPayload(const char *dev, float d1, float d2, long age = 0);  // 根據 MAC 位址、溫度、濕度產生 JSON 承載資料
 void initMQTT();                             // 初始化 MQTT 伺服器連線
-void MQTTPublish();                           // 發佈訊息到 MQTT Broker
+bool publishValues(float t, float h, long age);  // 發佈一筆（可能是補送的）溫溼度資料
 void showStatusonOled(String ss);             // 在 OLED 上顯示狀態訊息
 
 // ================================================================
@@ -190,14 +195,16 @@ void insertBeforeChar(char *str, char target, char toInsert)
 //   - dev: 裝置 MAC 位址
 //   - d1: 溫度值（攝氏度）
 //   - d2: 濕度值（百分比）
+//   - age: 資料產生至今的秒數（離線補送時使用），0 表示即時資料不加入，
+//          負值表示經過時間未知，以 "Age":-1 送出
 // 傳回值：無
 // 說明：
 //   1. 使用 ArduinoJson 函式庫建立 JSON 物件
 //   2. 將資料填入 JSON 物件
-//   3. 序列化為字串格式
+//   3. 直接序列化到 Payloadbuffer（不經過 String）
 //   4. 處理特殊字元以符合 MQTT 傳輸要求
 // ---------------------------------------------------------------
-void fillPayload(String dev, float d1, float d2)
+void fillPayload(const char *dev, float d1, float d2, long age)
 {
     Serial.println("Fill Pay LOAD is Processing");
     
@@ -210,17 +217,21 @@ void fillPayload(String dev, float d1, float d2)
     doc["Device"] = dev;          // 加入裝置識別碼（MAC 位址）
     doc["Temperature"] = d1;      // 加入溫度值
     doc["Humidity"] = d2;         // 加入濕度值
+    if (age > 0) {
+        doc["Age"] = age;         // 補送資料：加入經過秒數，伺服器端可換算實際時間
+    } else if (age < 0) {
+        doc["Age"] = -1;          // 經過時間未知（上次開機的樣本），伺服器端不當成即時資料
+    } else {
+        doc.remove("Age");        // 即時資料：移除上一筆補送資料留下的欄位
+    }
     
-    // 步驟2：將 JSON 物件序列化為字串
-    // serializeJson() 將 JSON 物件轉換為字串格式
-    serializeJson(doc, PayloadT);
+    // 步驟2：將 JSON 物件序列化到字元陣列
+    // 保留一半空間給步驟3插入的反斜線（最壞情況每個字元都要轉譯）
+    serializeJson(doc, Payloadbuffer, sizeof(Payloadbuffer) / 2);
     
     // ------ 特殊字元處理 ------
     
-    // 步驟3：將 String 轉換為 char 陣列以進行字元處理
-    PayloadT.toCharArray(Payloadbuffer, PayloadT.length() + 1);
-    
-    // 步驟4：處理 JSON 字串中的特殊字元
+    // 步驟3：處理 JSON 字串中的特殊字元
     // 在雙引號前插入反斜線（將 " 轉為 \"）
     insertBeforeChar(Payloadbuffer, '\"', '\\');
     
@@ -228,12 +239,9 @@ void fillPayload(String dev, float d1, float d2)
     // 注意：此處理可能非必要，視 MQTT Broker 要求而定
     insertBeforeChar(Payloadbuffer, ',', '\\');
     
-    // 步驟5：將處理後的字元陣列轉回 String
-    PayloadT = String(Payloadbuffer);
-    
-    // 步驟6：序列埠輸出承載資料（用於偵錯）
+    // 步驟4：序列埠輸出承載資料（用於偵錯）
     Serial.print("Sending:(");
-    Serial.print(PayloadT);
+    Serial.print(Payloadbuffer);
     Serial.print(")\n");
 }
 
@@ -302,44 +310,71 @@ void initMQTT()
 }
 
 // ---------------------------------------------------------------
-// 函式名稱：MQTTPublish()
-// 功能：發佈感測資料到 MQTT Broker伺服器
-// 參數：無
-// 傳回值：無
+// 函式名稱：publishValues()
+// 功能：發佈一筆溫溼度資料到 MQTT Broker伺服器
+// 參數：
+//   - t: 溫度值
+//   - h: 濕度值
+//   - age: 資料產生至今的秒數，STORE_AGE_LIVE 表示即時資料，STORE_AGE_UNKNOWN 表示未知
+// 傳回值：發送成功傳回 true
 // 流程：
 //   1. 產生 JSON 感測資料文件
 //   2. 顯示發送資訊
 //   3. 透過 WiFi 模組發送資料
 //   4. 顯示發送結果狀態
+// 說明：
+//   1. 參數與 StoreLib.h 的 StoreSender 相同，可直接交給 forwardSamples() 補送離線資料
+//   2. PAYLOAD_BINARY 為 1 時改用 PackLib.h 的二進位格式，以 AT+MQTTPUBRAW 送出
 // ---------------------------------------------------------------
-void MQTTPublish()
+bool publishValues(float t, float h, long age)
 {
+#if PAYLOAD_BINARY
+    // 二進位格式：17 位元組，直接以長度傳送，不需要插入轉譯字元
+    int len = packValues(Packbuffer, sizeof(Packbuffer), MacData.c_str(), t, h, age);
+    Serial.print("Now packed payload:(");
+    Serial.print(PubTopicbuffer);
+    Serial.print("==>");
+    Serial.print(len);
+    Serial.print(" bytes)\n");
+    unsigned long start = metricStart();
+    bool sent = Wifi.writeBytes((const char *)Packbuffer, len, PubTopicbuffer);
+    metricStop(metricHistogram("mqtt_pub"), start);
+    if (!sent) metricInc(metricCounter("mqtt_pub_fail"));
+    showStatusonOled(sent ? "MQTT OK" : "MQTT Fail");
+    return sent;
+#else
     // 步驟1：產生 JSON 感測資料文件
-    // 參數：MAC 位址、溫度值、濕度值
-    fillPayload(MacData.c_str(), TValue, HValue);
+    // 參數：MAC 位址、溫度值、濕度值、經過秒數
+    fillPayload(MacData.c_str(), t, h, age);
     
     // 步驟2：顯示發送資訊（用於偵錯）
     Serial.print("Now payload:(");
     Serial.print(PubTopicbuffer);   // 顯示發佈主題
     Serial.print("==>");
-    Serial.print(PayloadT);         // 顯示感測資料文件
+    Serial.print(Payloadbuffer);    // 顯示感測資料文件
     Serial.print(")\n");
     
     // 步驟3：透過 WiFi 模組發送資料到 MQTT Broker
     // Wifi.writeString() 將感測資料文件發佈到指定主題
-    if (Wifi.writeString(PayloadT, String(PubTopicbuffer))) {
+    // 直接傳入字元陣列，驅動程式分段寫出，不會建立 String 副本
+    // 發佈時間與失敗次數記錄在 MetricsLib.h 的 mqtt_pub / mqtt_pub_fail
+    unsigned long start = metricStart();
+    bool sent = Wifi.writeString(Payloadbuffer, PubTopicbuffer);
+    metricStop(metricHistogram("mqtt_pub"), start);
+    if (sent) {
         // 發送成功
         Serial.println("Send String data sucess");  // 序列埠輸出成功訊息
         
         // 在 OLED 上顯示成功狀態
         showStatusonOled("MQTT OK");
-        
-        // 延遲一秒，避免過快發送
-        delay(1000);
+        return true;
     } else {
         // 發送失敗
+        metricInc(metricCounter("mqtt_pub_fail"));
         showStatusonOled("MQTT Fail");  // 在 OLED 上顯示失敗狀態
+        return false;
     }
+#endif
 }
 
 // ---------------------------------------------------------------
@@ -4,6 +4,15 @@
 // 功能：提供 BMD31M090 OLED 顯示模組（128x64）的完整控制功能
 //       包含文字顯示、圖形繪製、螢幕控制、捲動效果等
 // 通訊介面：I2C (Wire1)
+// 繪圖更新：drawPoint / drawLine / drawfastVline / drawfastHline / drawBox
+//       畫在共用程式庫 OledFrame（LIB/OledFrame）的畫面緩衝區，並記錄每一頁（8 列像素）變動的欄範圍，
+//       updateScreen() 只送出變動的部分，不再每畫一點就送出整個 1 KB 畫面
+//       - OLED_FLUSH_IMMEDIATE：每次繪圖後立即送出變動部分（預設，與原本行為相同）
+//       - OLED_FLUSH_MANUAL   ：批次繪圖，呼叫 updateScreen() 才送出
+//       - OLED_FLUSH_FRAMERATE：由 oledPoll() 依設定的間隔送出（限制更新頻率）
+//       省下的 I2C 頻寬留給同一匯流排上的溫溼度、繼電器、鍵盤模組
+//       drawPicture() 把點陣圖畫進同一個緩衝區，之後的點、線不會把圖蓋掉；
+//       文字由 BMD31 直接寫到螢幕，緩衝區記錄文字占用的欄，送出時跳過，不會蓋掉文字
 // ================================================================
 
 // ================================================================
@@ -51,6 +60,9 @@ uint8_t t = ' ';  // 全域變數 t，用於 ASCII 字元測試，初始化為
   3. &Wire2  - 第二組額外 I2C（如開發板支援）
 */
 BMD31M090 BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire1);
+TwoWire *oledWire = &Wire1;  // updateScreen() 直接送出畫面緩衝區使用的 I2C 介面，須與上一行相同
+
+#include "OledFrame.h"  // 畫面緩衝區與只送出變動部分的更新（LIB/OledFrame）
 
 // ================================================================
 // =============== 函式宣告區 ===============
@@ -60,7 +72,7 @@ BMD31M090 BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire1);
 void initOled();                    // 初始化 OLED 128x64 顯示模組
 void drawPicture(int x, int y, const uint8_t *pp, int width, int height);  // 繪製點陣圖
 void clearScreen();                 // 清除螢幕內容
-void updateScreen();                // 更新螢幕顯示（將緩衝區內容輸出到硬體）
+void updateScreen();                // 更新螢幕顯示（只送出變動的頁與欄）
 void setFont(const unsigned char* font);  // 設定顯示字型
 
 // ---------- 文字顯示函式 ----------
@@ -119,13 +131,16 @@ void test_dim();                         // 測試亮度調整
 // 傳回值：無
 // 流程：
 //   1. 呼叫 BMD31.begin() 初始化 OLED，傳入 I2C 地址
-//   2. 延遲 100ms 確保初始化完成
-//   3. 序列埠輸出初始化成功訊息
+//   2. 設定預設的 8x16 字型，清除畫面緩衝區與文字記錄
+//   3. 延遲 100ms 確保初始化完成
+//   4. 序列埠輸出初始化成功訊息
 // ---------------------------------------------------------------
 void initOled()
 {
     // 初始化 OLED 顯示模組，使用指定的 I2C 地址
     BMD31.begin(BMD31M090_ADDRESS);
+    setFont(FontTable_8X16);  // BMD31 預設的字型，同步記錄字型大小
+    oledClearFrame();
     
     // 建議的初始化延遲時間，確保硬體穩定
     delay(100);
@@ -144,22 +159,15 @@ void initOled()
 //     * FontTable_16X32: 16×32 像素字型（大字）
 //     * FontTable_32X64: 32×64 像素字型（特大）
 // 傳回值：無
+// 說明：同時記錄字型的寬度與高度，printText() 依此記錄文字占用的欄
 // ---------------------------------------------------------------
 void setFont(const unsigned char* font)
 {
     BMD31.setFont(font);
-}
-
-// ---------------------------------------------------------------
-// 函式名稱：updateScreen()
-// 功能：將顯示緩衝區的內容輸出到 OLED 硬體螢幕
-// 參數：無
-// 傳回值：無
-// 說明：所有繪圖操作都在記憶體緩衝區進行，需呼叫此函式才會實際顯示
-// ---------------------------------------------------------------
-void updateScreen()
-{
-    BMD31.display();
+    if (font == FontTable_6X8) { oledFontWidth = 6; oledFontPages = 1; }
+    else if (font == FontTable_16X32) { oledFontWidth = 16; oledFontPages = 4; }
+    else if (font == FontTable_32X64) { oledFontWidth = 32; oledFontPages = 8; }
+    else { oledFontWidth = 8; oledFontPages = 2; }
 }
 
 // ---------------------------------------------------------------
@@ -171,12 +179,14 @@ void updateScreen()
 //   - str: 要顯示的文字字串
 // 傳回值：無
 // 注意：座標系統以字元行為單位，不是像素
+//       文字直接寫到螢幕，並記錄占用的欄，updateScreen() 不會蓋掉文字
 // ---------------------------------------------------------------
 void printText(int x, int y, String str)
 {
     // 呼叫底層函式繪製字串
     // str.c_str() 將 String 轉換為 C 風格字串
     BMD31.drawString((uint8_t)x, (uint8_t)y, (uint8_t*)str.c_str());
+    oledMarkText(x, y, str.c_str());
 }
 
 // ---------------------------------------------------------------
@@ -190,7 +200,9 @@ void printText(int x, int y, String str)
 // ---------------------------------------------------------------
 void printChar(int x, int y, char str)
 {
+    char text[2] = { str, 0 };
     BMD31.drawChar((uint8_t)x, (uint8_t)y, (uint8_t)str);
+    oledMarkText(x, y, text);
 }
 
 // ---------------------------------------------------------------
@@ -207,6 +219,7 @@ void printNumber(int x, int y, int num)
 {
     // 參數說明：x, y, 數值, 數字位數
     BMD31.drawNum((uint8_t)x, (uint8_t)y, (uint32_t)num, (uint8_t)(String(num).length()));
+    oledMarkText(x, y, String(num).c_str());
 }
 
 // ---------------------------------------------------------------
@@ -239,8 +252,8 @@ void printFloat(int x, int y, float num)
 // ---------------------------------------------------------------
 void drawPoint(int x, int y, int pixelColor)
 {
-    BMD31.drawPixel((uint8_t)x, (uint8_t)y, (uint8_t)pixelColor);
-    BMD31.display();  // 立即更新顯示
+    oledSetPixel(x, y, pixelColor);
+    oledFlushIfImmediate();  // 立即模式只送出這一點所在的一個位元組
 }
 
 // ---------------------------------------------------------------
@@ -254,8 +267,18 @@ void drawPoint(int x, int y, int pixelColor)
 // ---------------------------------------------------------------
 void drawLine(int x1, int y1, int x2, int y2, int pixelColor)
 {
-    BMD31.drawLine((uint8_t)x1, (uint8_t)y1, (uint8_t)x2, (uint8_t)y2, (uint8_t)pixelColor);
-    BMD31.display();
+    // Bresenham 直線演算法，只用整數運算
+    int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+    int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    while (true) {
+        oledSetPixel(x1, y1, pixelColor);
+        if (x1 == x2 && y1 == y2) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x1 += sx; }
+        if (e2 <= dx) { err += dx; y1 += sy; }
+    }
+    oledFlushIfImmediate();
 }
 
 // ---------------------------------------------------------------
@@ -269,8 +292,8 @@ void drawLine(int x1, int y1, int x2, int y2, int pixelColor)
 // ---------------------------------------------------------------
 void drawfastVline(int x, int y, int width, int pixelColor)
 {
-    BMD31.drawFastVLine((uint8_t)x, (uint8_t)y, (uint8_t)width, (uint8_t)pixelColor);
-    BMD31.display();
+    for (int i = 0; i < width; i++) oledSetPixel(x, y + i, pixelColor);
+    oledFlushIfImmediate();
 }
 
 // ---------------------------------------------------------------
@@ -284,8 +307,8 @@ void drawfastVline(int x, int y, int width, int pixelColor)
 // ---------------------------------------------------------------
 void drawfastHline(int x, int y, int width, int pixelColor)
 {
-    BMD31.drawFastHLine((uint8_t)x, (uint8_t)y, (uint8_t)width, (uint8_t)pixelColor);
-    BMD31.display();
+    for (int i = 0; i < width; i++) oledSetPixel(x + i, y, pixelColor);
+    oledFlushIfImmediate();
 }
 
 // ---------------------------------------------------------------
@@ -296,19 +319,22 @@ void drawfastHline(int x, int y, int width, int pixelColor)
 //   - x2, y2: 矩形右下角座標
 //   - pixelColor: 線條顏色
 // 傳回值：無
-// 說明：透過繪製四條直線組成矩形框
+// 說明：四條邊先全部畫進緩衝區，再一次送出變動部分
+//       （反轉顏色時四個角只反轉一次）
 // ---------------------------------------------------------------
 void drawBox(int x1, int y1, int x2, int y2, int pixelColor)
 {
-    // 繪製上邊線
-    BMD31.drawLine((uint8_t)x1, (uint8_t)y1, (uint8_t)x2, (uint8_t)y1, (uint8_t)pixelColor);
-    // 繪製右邊線
-    BMD31.drawLine((uint8_t)x2, (uint8_t)y1, (uint8_t)x2, (uint8_t)y2, (uint8_t)pixelColor);
-    // 繪製左邊線
-    BMD31.drawLine((uint8_t)x1, (uint8_t)y1, (uint8_t)x1, (uint8_t)y2, (uint8_t)pixelColor);
-    // 繪製下邊線
-    BMD31.drawLine((uint8_t)x1, (uint8_t)y2, (uint8_t)x2, (uint8_t)y2, (uint8_t)pixelColor);
-    BMD31.display();
+    if (x1 > x2) { int tmp = x1; x1 = x2; x2 = tmp; }
+    if (y1 > y2) { int tmp = y1; y1 = y2; y2 = tmp; }
+    for (int x = x1; x <= x2; x++) {
+        oledSetPixel(x, y1, pixelColor);                  // 上邊線
+        if (y2 != y1) oledSetPixel(x, y2, pixelColor);    // 下邊線
+    }
+    for (int y = y1 + 1; y < y2; y++) {
+        oledSetPixel(x1, y, pixelColor);                  // 左邊線
+        if (x2 != x1) oledSetPixel(x2, y, pixelColor);    // 右邊線
+    }
+    oledFlushIfImmediate();
 }
 
 // ---------------------------------------------------------------
@@ -323,7 +349,8 @@ void drawBox(int x1, int y1, int x2, int y2, int pixelColor)
 void clearScreen()
 {
     BMD31.clearDisplay();  // 清除緩衝區
-    BMD31.display();       // 更新到硬體
+    BMD31.display();       // 更新到硬體（包含直接寫到螢幕的文字）
+    oledClearFrame();      // 畫面已全部清除，本函式庫的緩衝區與文字記錄同步清除
 }
 
 // ---------------------------------------------------------------
@@ -336,13 +363,18 @@ void clearScreen()
 //   - height: 圖片高度（像素）
 // 傳回值：無
 // 說明：先清除螢幕，再繪製白色圖片
+//       圖片畫進本函式庫的畫面緩衝區後整個畫面送出，
+//       之後的點、線、框畫在圖上，送出時不會把圖蓋掉
 // ---------------------------------------------------------------
 void drawPicture(int x, int y, const uint8_t *pp, int width, int height)
 {
-    BMD31.clearDisplay();
+    BMD31.clearDisplay();  // BMD31 的緩衝區也清除，之後 display() 不會蓋回舊畫面
+    oledClearFrame();
     // 繪製白色點陣圖
-    BMD31.drawBitmap((uint8_t)x, (uint8_t)y, pp, (uint8_t)width, (uint8_t)height, pixelColor_WHITE);
-    BMD31.display();
+    oledDrawBitmap(x, y, pp, width, height, pixelColor_WHITE);
+    // 整個畫面重畫，之前的文字也一併蓋掉
+    for (uint8_t page = 0; page < OLED_PAGES; page++) oledMarkDirty(page, 0, BMD31M090_WIDTH - 1);
+    updateScreen();
 }
 
 // ---------------------------------------------------------------
@@ -552,7 +584,7 @@ void test_drawString_6x8(void)
     BMD31.display();
     
     // 設定為 6x8 字型
-    BMD31.setFont(FontTable_6X8);
+    setFont(FontTable_6X8);
     
     // 計算置中位置
     uint8_t col = (128 - (6 * sizeof("Hello World!"))) / 2;
@@ -576,7 +608,7 @@ void test_drawString_8x16(void)
     BMD31.display();
     
     // 設定為 8x16 字型
-    BMD31.setFont(FontTable_8X16);
+    setFont(FontTable_8X16);
     
     // 計算置中位置
     uint8_t col = (128 - (8 * sizeof("Hello World!"))) / 2;
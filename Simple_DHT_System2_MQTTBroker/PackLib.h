@@ -0,0 +1,149 @@
+// ================================================================
+// 檔案名稱：PackLib.h
+// 描述：二進位精簡感測資料格式（packed frame）函式庫
+// 功能：把溫溼度樣本編碼成固定格式的位元組資料，
+//       以 Wifi.writeBytes()（AT+MQTTPUBRAW）或 writeDataTcp() 送出
+//       - 數值採 0.1 為單位的定點整數，編碼時四捨五入（Double2Str() 會截斷）
+//       - 以長度傳送原始位元組，不需要 insertBeforeChar() 逐字元轉譯
+//       - 單筆樣本 17 位元組，同樣內容的 JSON 轉譯後約 80 位元組
+// 格式（版本 1，多位元組數值一律 little-endian）：
+//   位移  長度  內容
+//   0     1     PACK_MAGIC（0xD1，JSON 一定以 '{' 開頭，伺服器端據此分辨格式）
+//   1     1     PACK_VERSION（1）
+//   2     1     樣本數 N
+//   3     6     裝置 MAC 位址（二進位）
+//   9     8×N   樣本：uint32 經過毫秒（0xFFFFFFFF 表示未知）、
+//                     int16 溫度 × 10、uint16 濕度 × 10
+//               讀取失敗（NaN）的溫度為 PACK_INVALID（-32768），濕度為 0x8000
+// 伺服器端解碼：Python/disDBAgent/commlib.py 的 decode_payload()
+// ================================================================
+
+// ================================================================
+// =============== 格式設定常數區 ===============
+// ================================================================
+#ifndef PAYLOAD_BINARY
+#define PAYLOAD_BINARY 0           // 1：MQTTLib.h / BatchLib.h 改用二進位格式發佈
+#endif
+#define PACK_MAGIC 0xD1            // 格式識別碼
+#define PACK_VERSION 1             // 格式版本，欄位改變時加 1
+#define PACK_HEADER_SIZE 9         // 標頭長度
+#define PACK_SAMPLE_SIZE 8         // 每筆樣本長度
+#define PACK_AGE_UNKNOWN 0xFFFFFFFFUL  // 經過時間未知（例如上次開機留下的樣本）
+#define PACK_INVALID INT16_MIN     // 讀取失敗（NaN）的數值，伺服器端略過這筆樣本
+#define PACK_SIZE(n) (PACK_HEADER_SIZE + (n) * PACK_SAMPLE_SIZE)  // N 筆樣本的資料長度
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+int  packBegin(uint8_t *buf, const char *mac);   // 寫入標頭，傳回目前長度
+int  packSample(uint8_t *buf, int len, int size, uint32_t ageMs, int16_t t10, uint16_t h10);  // 加入一筆樣本
+int  packValues(uint8_t *buf, int size, const char *mac, float t, float h, long age);  // 編碼單筆樣本
+int16_t toTenths(float v);                       // 浮點數四捨五入成 0.1 單位的整數
+uint8_t hexValue(char c);                        // 十六進位字元轉數值
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：toTenths()
+// 功能：把浮點數四捨五入成 0.1 單位的整數（例如 25.36 → 254）
+// 說明：NaN 傳回 PACK_INVALID，超出範圍時限制在 ±3276.7，
+//       浮點數超出 int16_t 範圍時直接轉型是未定義行為
+// ---------------------------------------------------------------
+int16_t toTenths(float v)
+{
+    if (isnan(v)) return PACK_INVALID;
+    v *= 10;
+    if (v >= INT16_MAX) return INT16_MAX;
+    if (v <= -INT16_MAX) return -INT16_MAX;
+    return (int16_t)(v < 0 ? v - 0.5 : v + 0.5);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：hexValue()
+// 功能：十六進位字元轉數值，非十六進位字元傳回 0
+// ---------------------------------------------------------------
+uint8_t hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return 0;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：packBegin()
+// 功能：寫入資料標頭（樣本數先設為 0）
+// 參數：
+//   - buf: 輸出緩衝區（至少 PACK_HEADER_SIZE 位元組）
+//   - mac: MAC 位址字串（如 "D8:BF:C0:12:34:56"，分隔字元可有可無）
+// 傳回值：目前資料長度（PACK_HEADER_SIZE）
+// ---------------------------------------------------------------
+int packBegin(uint8_t *buf, const char *mac)
+{
+    buf[0] = PACK_MAGIC;
+    buf[1] = PACK_VERSION;
+    buf[2] = 0;
+    // 每兩個十六進位字元組成一個位元組，略過冒號等分隔字元
+    int n = 0;
+    for (const char *p = mac; *p != '\0' && p[1] != '\0' && n < 6; ) {
+        if (*p == ':' || *p == '-') {
+            p++;
+            continue;
+        }
+        buf[3 + n++] = (hexValue(p[0]) << 4) | hexValue(p[1]);
+        p += 2;
+    }
+    while (n < 6) buf[3 + n++] = 0;
+    return PACK_HEADER_SIZE;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：packSample()
+// 功能：在資料尾端加入一筆樣本，並更新標頭的樣本數
+// 參數：
+//   - buf: packBegin() 寫過標頭的緩衝區
+//   - len: 目前資料長度
+//   - size: 緩衝區大小
+//   - ageMs: 取樣至今的毫秒數（PACK_AGE_UNKNOWN 表示未知）
+//   - t10: 溫度 × 10
+//   - h10: 濕度 × 10
+// 傳回值：新的資料長度，緩衝區不足或樣本數已達 255 時傳回原長度
+// ---------------------------------------------------------------
+int packSample(uint8_t *buf, int len, int size, uint32_t ageMs, int16_t t10, uint16_t h10)
+{
+    if (len + PACK_SAMPLE_SIZE > size || buf[2] == 255) return len;
+    uint8_t *p = buf + len;
+    p[0] = ageMs & 0xFF;
+    p[1] = (ageMs >> 8) & 0xFF;
+    p[2] = (ageMs >> 16) & 0xFF;
+    p[3] = (ageMs >> 24) & 0xFF;
+    p[4] = (uint16_t)t10 & 0xFF;
+    p[5] = ((uint16_t)t10 >> 8) & 0xFF;
+    p[6] = h10 & 0xFF;
+    p[7] = (h10 >> 8) & 0xFF;
+    buf[2]++;
+    return len + PACK_SAMPLE_SIZE;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：packValues()
+// 功能：把單筆溫溼度樣本編碼成完整的資料
+// 參數：
+//   - buf: 輸出緩衝區（至少 PACK_SIZE(1) 位元組）
+//   - size: 緩衝區大小
+//   - mac: MAC 位址字串
+//   - t: 溫度值
+//   - h: 濕度值
+//   - age: 取樣至今的秒數，0 表示即時資料，負值表示未知（與 StoreSender 相同）
+// 傳回值：資料長度
+// ---------------------------------------------------------------
+int packValues(uint8_t *buf, int size, const char *mac, float t, float h, long age)
+{
+    int len = packBegin(buf, mac);
+    // 補送資料以秒數換算成毫秒；經過時間未知或超過範圍時送出 PACK_AGE_UNKNOWN，
+    // 伺服器端不會把它當成剛取樣的資料
+    uint32_t ageMs = age < 0 || age >= 4294967L ? PACK_AGE_UNKNOWN : (uint32_t)age * 1000UL;
+    return packSample(buf, len, size, ageMs, toTenths(t), h < 0 ? 0 : toTenths(h));
+}
@@ -1,3 +1,31 @@
+// ================================================================
+// =============== 發送模式設定區 (Publish Mode) ===================
+// ================================================================
+// 0：每 2 分鐘取樣一次，每筆樣本各發佈一次（離線時存入 EEPROM 補送）
+// 1：每秒取樣一次，由 BatchLib.h 收集多筆後以一次 AT+MQTTPUBRAW 批次發佈
+#define BATCH_PUBLISH 0
+// 0：承載資料為 JSON 文字；1：PackLib.h 的二進位精簡格式（約小 3~5 倍，伺服器端需使用 decode_payload()）
+#define PAYLOAD_BINARY 0
+#if BATCH_PUBLISH
+#define SAMPLE_INTERVAL 1000     // 取樣間隔（毫秒）
+#else
+#define SAMPLE_INTERVAL 120000   // 取樣間隔（毫秒）
+#endif
+
+// ================================================================
+// =============== 任務排程設定區 (Task Schedule) ==================
+// ================================================================
+// 各任務的週期與可容許延遲（毫秒），由 TaskLib.h 排程
+#define SAMPLE_DEADLINE 1000          // 取樣任務：到期後 1 秒內要開始
+#define MQTT_RECV_INTERVAL 100        // 接收任務：每 100 毫秒檢查一次訂閱訊息
+#define MQTT_RECV_DEADLINE 100
+#define OLED_REFRESH_INTERVAL 200     // 顯示任務：最多每 200 毫秒送出一次畫面變動
+#define OLED_REFRESH_DEADLINE 200
+#define METRICS_POLL_INTERVAL 100     // 量測查詢任務：每 100 毫秒檢查序列埠是否送入 'm' / 'r'
+#define METRICS_POLL_DEADLINE 500
+#define HEALTH_INTERVAL 300000        // 健康訊息任務：每 5 分鐘把量測摘要發佈到 <發佈主題>/health
+#define HEALTH_DEADLINE 5000
+
 // ================================================================
 // =============== 全域變數宣告區 (Global Variables) ===============
 // ================================================================
@@ -6,6 +34,7 @@
 String MacData;   // 儲存目前裝置的 WiFi MAC Address（網路卡的唯一識別碼）
 String SSIDData;  // 儲存目前連線的 WiFi 熱點名稱 (SSID)
 String IPData;    // 儲存 WiFi 連線後由路由器分配的 IP 位址
+char HealthTopicbuffer[210];  // 健康訊息主題（發佈主題後加上 /health）
  
 // =============== 感測器資料全域變數宣告==================
 // 注意：以下變數應在 DHTLib.h 或其他地方宣告，這裡補充說明：
@@ -19,10 +48,15 @@ String IPData;    // 儲存 WiFi 連線後由路由器分配的 IP 位址
 // ------- 感測模組函式與外部函式引用宣告區 -----------
 #include <String.h>    // Arduino 內建字串處理函式庫（用於字串操作）
 #include "TCP.h"       // 引用 ESP-12F WiFi 模組 (BMCOM BMC81M001) 自訂模組（處理 WiFi 連線）
+#include "MetricsLib.h" // 執行期量測函式庫（計數器、量表、延遲分佈，序列埠查詢與 MQTT 健康訊息）
 #include "DHTLib.h"    // 自訂溫溼度感測模組函式庫（讀取 DHT 溫溼度感測器資料）
 #include "OledLib.h"   // 自訂 OLED 顯示模組函式庫（提供 OLED 初始化、文字繪製、清屏等功能）
+#include "PackLib.h"   // 二進位精簡格式函式庫（PAYLOAD_BINARY 為 1 時使用）
 #include "MQTTLib.h"   // MQTT 通訊協定函式庫（用於 MQTT 伺服器連線與訊息發佈）
 #include "commlib.h"   // 通訊函式庫（包含通用通訊功能）
+#include "StoreLib.h"  // 離線暫存函式庫（WiFi 斷線時保存樣本，恢復後補送）
+#include "BatchLib.h"  // 批次發佈函式庫（多筆樣本合併成一次 AT+MQTTPUBRAW）
+#include "TaskLib.h"   // 協同式任務排程函式庫（取代 loop() 中的 delay()）
 
 // ================================================================
 // =============== 自定義函式宣告區 (Function Declarations) =======
@@ -35,7 +69,7 @@ void initSensor();
 void initAll();
 
 // 函式宣告：初始化 WiFi 網路連線
-void INITWIFI();
+bool INITWIFI();
 
 // 函式宣告：顯示標題文字於 OLED 指定列（第一列通常為標題）
 void showTitleonOled(String ss, int row);
@@ -49,6 +83,13 @@ void showDeviceonOled(String ss, int row);
 // 函式宣告：顯示 WiFi 基本參數（MAC、SSID、IP）於序列埠
 void ShowWiFiInformation();
 
+// 任務函式宣告：由 taskRun() 依各自的週期呼叫
+void sampleTask();        // 讀取溫溼度、顯示並發佈（或存入批次）
+void mqttReceiveTask();   // 取出 MQTT 訂閱訊息
+void oledRefreshTask();   // 送出 OLED 畫面緩衝區的變動
+void metricsTask();       // 處理序列埠的量測查詢
+void healthTask();        // 發佈量測摘要（健康訊息）
+
 
 // ================================================================
 // ===================== setup() 函式 =============================
@@ -58,11 +99,13 @@ void ShowWiFiInformation();
 void setup() 
 {
     // 步驟1：初始化整體系統（序列埠、感測器等）
+    metricsBegin();  // 先開始量測，開機時的 WiFi / MQTT 連線也會記錄
     initAll();
     delay(200);  // 延遲200毫秒，確保系統穩定
     
     // 步驟2：顯示溫溼度感測器資訊（測試感測器是否正常）
     ShowDHTInformation();   // 印出溫溼度感測器產品所有資訊 
+    initStore();            // 載入離線暫存記錄區（保留上次斷電前未送出的樣本）
     
     // 步驟3：WiFi 連線處理
     INITWIFI();     // 初始化 WiFi 網路，並取得 SSID、IP 與 MAC 資料 
@@ -86,7 +129,17 @@ void setup()
     clearScreen();  // 清除螢幕
     showTitleonOled("Temp & Humid SyS", 0);  // 在第一列顯示系統標題
  
-    // 步驟6：序列埠輸出進入主迴圈訊息
+    // 步驟6：登錄任務，各自依週期與期限執行
+    // 畫面緩衝區改由顯示任務定期送出，連續繪圖只會送出一次
+    oledSetFlushMode(OLED_FLUSH_MANUAL, 0);
+    taskAddPeriodic("sample", sampleTask, SAMPLE_INTERVAL, SAMPLE_DEADLINE);
+    taskAddPeriodic("mqttRecv", mqttReceiveTask, MQTT_RECV_INTERVAL, MQTT_RECV_DEADLINE);
+    taskAddPeriodic("oled", oledRefreshTask, OLED_REFRESH_INTERVAL, OLED_REFRESH_DEADLINE);
+    taskAddPeriodic("metrics", metricsTask, METRICS_POLL_INTERVAL, METRICS_POLL_DEADLINE);
+    int health = taskAddPeriodic("health", healthTask, HEALTH_INTERVAL, HEALTH_DEADLINE);
+    taskStart(health, HEALTH_INTERVAL);  // 第一則健康訊息在開機 5 分鐘後送出
+
+    // 步驟7：序列埠輸出進入主迴圈訊息
     Serial.println("Enter Loop()");  // 表示系統初始化完成，開始主迴圈
 }
 
@@ -96,9 +149,25 @@ void setup()
 // 功能：Arduino 主迴圈，重複執行，實現主要系統功能
 
 void loop() 
+{
+    // 各項工作由 TaskLib.h 依自己的週期與期限執行，不再以 delay() 等待
+    taskRun();
+}
+
+// ================================================================
+// =============== 任務函式實作區 (Tasks) =========================
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：sampleTask()
+// 功能：讀取溫溼度並顯示，再發佈到 MQTT Broker（或放入批次）
+// 週期：SAMPLE_INTERVAL
+// ---------------------------------------------------------------
+void sampleTask()
 {
     // ---------- 步驟1：讀取並顯示溫溼度資料 ----------
-    // 從 DHT 感測器讀取濕度數值
+    // 從 DHT 感測器讀取濕度數值（讀取時間記錄在 dht_read）
+    unsigned long start = metricStart();
     HValue = readHumidity();  // 讀取濕度值（百分比）
     Serial.print("Humidity : ");
     Serial.print(HValue);     // 序列埠輸出濕度值
@@ -106,6 +175,8 @@ void loop()
     
     // 從 DHT 感測器讀取溫度數值
     TValue = readTemperature();  // 讀取溫度值（攝氏度）
+    metricStop(metricHistogram("dht_read"), start);
+    if (isnan(TValue) || isnan(HValue)) metricInc(metricCounter("dht_fail"));
     Serial.print("Temperature : ");
     Serial.print(TValue);        // 序列埠輸出溫度值
     Serial.println(" °C ");      // 溫度單位
@@ -114,23 +185,110 @@ void loop()
     showMsgonOled("Temp:" + String(TValue), 2);   // 在第2列顯示溫度
     showMsgonOled("Humid:" + String(HValue), 4);  // 在第4列顯示濕度
 
-    // ---------- 步驟2：檢查網路狀態並發送資料 ----------
-    
-    if (Wifi.getStatus() != 2)  // 判斷網路連線不正常（狀態不等於2）
+#if BATCH_PUBLISH
+    // ---------- 批次模式：樣本先放進 RAM，收滿 N 筆或超過 T 毫秒才送出 ----------
+    // 送不出去時樣本留在緩衝區；緩衝區滿了才檢查並重新連線 WiFi，
+    // 避免每秒都執行耗時的連線動作
+    if (!batchAdd(TValue, HValue) && batchPending() >= BATCH_CAPACITY &&
+        Wifi.getStatus() != 2)
+    {
+        INITWIFI();
+    }
+    metricSet(metricGauge("pending"), batchPending());
+    return;
+#endif
+
+    // ---------- 步驟2：檢查網路狀態，即時發送資料 ----------
+    // 連線正常時樣本直接發佈，不寫入 EEPROM；
+    // 只有 WiFi 斷線或發佈失敗時才寫入離線暫存記錄區（StoreLib.h），
+    // 連線恢復後依序補送，不會遺失。
+    // 每筆樣本只查詢一次 AT+CIPSTATUS，重新連線的結果直接由 INITWIFI() 傳回
+    bool online = Wifi.getStatus() == 2;  // 狀態 2：已取得 IP
+    if (!online)
     { 
         // 網路連線異常，重新初始化 WiFi
-        INITtWIFI();  // 重新連線 WiFi 網路
-        Serial.println("WIFI OK");  // 輸出 WiFi 重新連線成功訊息
-        MQTTPublish();  // 發送感測資料到 MQTT Broker
+        online = INITWIFI();  // 重新連線 WiFi 網路
     }
-    else  // 網路連線正常
+    if (sendOrStore(publishValues, online, TValue, HValue))
     {
         Serial.println("WIFI OK");  // 輸出 WiFi 連線正常訊息
-        MQTTPublish();  // 發送感測資料到 MQTT Broker
+        if (storedCount() > 0)
+        {
+            // 由最舊的樣本開始補送到 MQTT Broker（每次最多 STORE_BATCH_SIZE 筆）
+            int sent = forwardSamples(publishValues, STORE_BATCH_SIZE);
+            Serial.print("Forwarded:(");
+            Serial.print(sent);
+            Serial.print("), pending:(");
+            Serial.print(storedCount());
+            Serial.print(")\n");
+        }
+    }
+    else
+    {
+        Serial.println("WIFI fail, sample stored");  // 樣本已保存，等待下次補送
     }
+    metricSet(metricGauge("pending"), storedCount());
+}
 
-    // ---------- 步驟3：延遲等待 ----------
-    delay(120000);  // 延遲120秒（2分鐘）後再次執行迴圈
+// ---------------------------------------------------------------
+// 函式名稱：mqttReceiveTask()
+// 功能：取出模組送來的 MQTT 訂閱訊息並印出
+// 週期：MQTT_RECV_INTERVAL
+// 說明：readIotData() 只處理已收到的資料，沒有訊息時立即返回，不會阻塞其他任務
+// ---------------------------------------------------------------
+void mqttReceiveTask()
+{
+    String data, topic;
+    int len;
+    Wifi.readIotData(&data, &len, &topic);
+    if (len == 0) return;
+    metricInc(metricCounter("mqtt_recv"));
+    Serial.print("MQTT recv (");
+    Serial.print(topic);
+    Serial.print("):");
+    Serial.println(data);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：oledRefreshTask()
+// 功能：把畫面緩衝區中有變動的部分送到 OLED
+// 週期：OLED_REFRESH_INTERVAL
+// ---------------------------------------------------------------
+void oledRefreshTask()
+{
+    if (!oledIsDirty()) return;
+    uint32_t bytes = oledBytesSent;
+    unsigned long start = metricStart();
+    updateScreen();
+    metricStop(metricHistogram("oled_flush"), start);
+    metricAdd(metricCounter("oled_bytes"), oledBytesSent - bytes);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：metricsTask()
+// 功能：序列埠送入 'm' 時印出所有量測數值，'r' 時清除
+// 週期：METRICS_POLL_INTERVAL
+// ---------------------------------------------------------------
+void metricsTask()
+{
+    metricsSerialPoll();
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：healthTask()
+// 功能：把量測摘要發佈到 <發佈主題>/health，不必接上電腦就能比較各節點
+// 週期：HEALTH_INTERVAL
+// 說明：同時記錄任務排程的逾時總次數（task_late），找出被阻塞太久的節點
+// ---------------------------------------------------------------
+void healthTask()
+{
+    if (PubTopicbuffer[0] == 0) return;   // MQTT 尚未設定
+    long late = 0;
+    for (int i = 0; i < taskCount; i++) late += taskTable[i].late;
+    metricSet(metricGauge("task_late"), late);
+    snprintf(HealthTopicbuffer, sizeof(HealthTopicbuffer), "%s/health", PubTopicbuffer);
+    bool sent = metricsPublish(HealthTopicbuffer, MacData.c_str());
+    Serial.println(sent ? "Health sent" : "Health fail");
 }
 
 // ================================================================
@@ -178,13 +336,14 @@ void initAll()
 // 函式名稱：INITWIFI()
 // 功能：初始化 WiFi 網路連線
 // 參數：無
-// 傳回值：無
+// 傳回值：連線成功傳回 true
 // 備註：此函式封裝了 WiFi 初始化和資訊顯示的功能
 // ---------------------------------------------------------------
-void INITWIFI()
+bool INITWIFI()
 {
-    initWiFi();             // 連線 WiFi（實際連線動作）
-    ShowWiFiInformation();  // 顯示 MAC / SSID / IP（連線成功後顯示資訊）
+    bool connected = initWiFi();  // 連線 WiFi（實際連線動作）
+    ShowWiFiInformation();        // 顯示 MAC / SSID / IP（連線成功後顯示資訊）
+    return connected;
 }
 
 // ---------------------------------------------------------------
@@ -225,12 +384,16 @@ void ShowWiFiInformation()
 /*
 系統架構總結：
 1. 系統啟動流程：setup() → initAll() → 各模組初始化
-2. 主迴圈任務：讀取感測器資料 → OLED 顯示 → 網路狀態檢查 → MQTT 發送
-3. 網路恢復機制：當 WiFi 斷線時自動重新連線
-4. 資料發送間隔：每 2 分鐘發送一次感測資料
+2. 主迴圈任務：loop() 只呼叫 taskRun()，由 TaskLib.h 排程三個任務
+   - sampleTask：讀取感測器資料 → OLED 顯示 → 保存樣本 → 網路狀態檢查 → MQTT 發送
+   - mqttReceiveTask：每 100 毫秒取出訂閱訊息
+   - oledRefreshTask：每 200 毫秒送出畫面變動
+   - metricsTask / healthTask：序列埠送入 'm' 印出量測數值，每 5 分鐘發佈健康訊息
+3. 網路恢復機制：當 WiFi 斷線時自動重新連線，斷線期間的樣本存於 EEPROM，恢復後補送
+4. 資料發送間隔：每 2 分鐘發送一次感測資料（BATCH_PUBLISH 為 1 時每秒取樣、批次發送）
 
 注意事項：
-1. 延遲時間 120000ms（2分鐘）可依需求調整
+1. 取樣間隔 SAMPLE_INTERVAL（預設 120000ms）可依需求調整
 2. 需要確保 MQTT 伺服器地址和主題在 MQTTLib.h 中正確設定
 3. OLED 顯示函式需確保字串長度不超過顯示範圍
 4. WiFi 連線需要正確的 SSID 和密碼設定
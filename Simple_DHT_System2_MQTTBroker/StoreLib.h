@@ -0,0 +1,249 @@
+// ================================================================
+// 檔案名稱：StoreLib.h
+// 描述：感測資料離線暫存（store-and-forward）函式庫
+// 功能：WiFi 斷線時把溫溼度樣本寫入 EEPROM 的環狀記錄區，
+//       連線恢復後再依序分批送出，避免資料斷層
+//       - 連線正常時樣本直接送出（sendOrStore()），不寫入 EEPROM，
+//         只有斷線或送出失敗的樣本才進入記錄區
+//       - 記錄區滿了會覆蓋最舊的樣本（drop-oldest）
+//       - RAM 只使用一筆記錄加上記錄區標頭的空間
+//       - 定義 STORE_FILE_NAME 時改用檔案儲存（電腦端測試用）
+// ================================================================
+
+// ================================================================
+// =============== 函式庫引入區 ===============
+// ================================================================
+#ifdef STORE_FILE_NAME
+#include <stdio.h>       // 電腦端測試：以檔案模擬 EEPROM
+#else
+#include <EEPROM.h>      // 開發板：資料寫入 EEPROM，斷電不會遺失
+#endif
+
+// ================================================================
+// =============== 暫存設定常數區 ===============
+// ================================================================
+#ifndef STORE_CAPACITY
+#define STORE_CAPACITY 48        // 最多保留的樣本數（每筆 16 位元組）
+#endif
+#ifndef STORE_BASE_ADDRESS
+#define STORE_BASE_ADDRESS 0     // 記錄區在 EEPROM 中的起始位址
+#endif
+#ifndef STORE_BATCH_SIZE
+#define STORE_BATCH_SIZE 10      // 每次恢復連線時最多補送的樣本數
+#endif
+#define STORE_MAGIC 0x53544631   // 記錄區識別碼 "STF1"，不符時重新格式化
+
+// ================================================================
+// =============== 資料結構宣告區 ===============
+// ================================================================
+
+// 一筆溫溼度樣本
+// 沒有即時時鐘，時間以「開機序號 + 開機後秒數」表示，
+// 只有在同一次開機內才能換算出樣本的經過時間
+typedef struct
+{
+    uint16_t boot;       // 記錄時的開機序號
+    uint16_t reserved;   // 保留（對齊用）
+    uint32_t uptime;     // 記錄時的開機後秒數
+    float t;             // 溫度（攝氏度）
+    float h;             // 濕度（百分比）
+} SampleRecord;
+
+// 記錄區標頭，存在記錄區最前面
+typedef struct
+{
+    uint32_t magic;      // STORE_MAGIC
+    uint16_t boot;       // 開機序號，每次 initStore() 加 1
+    uint16_t head;       // 最舊樣本的位置
+    uint16_t count;      // 目前保留的樣本數
+    uint16_t capacity;   // 格式化時的容量
+    uint32_t dropped;    // 因記錄區已滿而被覆蓋的樣本總數
+} StoreHeader;
+
+// 送出一筆樣本的函式：溫度、濕度、經過秒數，成功傳回 true
+// 經過秒數為 STORE_AGE_LIVE 表示即時樣本，STORE_AGE_UNKNOWN 表示無法得知
+typedef bool (*StoreSender)(float t, float h, long age);
+#define STORE_AGE_LIVE     0L      // 即時樣本：剛取樣完成
+#define STORE_AGE_UNKNOWN  (-1L)   // 經過時間未知：上次開機留下的樣本，uptime 無法比較
+
+// ================================================================
+// =============== 全域變數宣告區 ===============
+// ================================================================
+StoreHeader storeHeader;         // 記錄區標頭（RAM 中的副本）
+
+// ================================================================
+// =============== 自訂函式宣告區 ===============
+// ================================================================
+void initStore();                                   // 載入或格式化記錄區
+void storeSample(float t, float h);                 // 寫入一筆樣本（滿了覆蓋最舊的）
+int  storedCount();                                 // 尚未送出的樣本數
+int  forwardSamples(StoreSender send, int maxBatch); // 依序送出最舊的樣本
+bool sendOrStore(StoreSender send, bool online, float t, float h); // 即時送出，失敗才寫入記錄區
+void storeRead(int address, void *data, int length);        // 讀取儲存區
+void storeWrite(int address, const void *data, int length); // 寫入儲存區
+
+// ================================================================
+// =============== 自訂函式實作區 ===============
+// ================================================================
+
+// ---------------------------------------------------------------
+// 函式名稱：storeRead() / storeWrite()
+// 功能：讀寫儲存區（EEPROM 或測試用檔案）
+// 參數：
+//   - address: 相對於 STORE_BASE_ADDRESS 的位址
+//   - data: 資料緩衝區
+//   - length: 位元組數
+// 說明：以 EEPROM.update() 只改寫內容不同的位元組，減少 EEPROM 磨損
+// ---------------------------------------------------------------
+void storeRead(int address, void *data, int length)
+{
+    uint8_t *p = (uint8_t *)data;
+#ifdef STORE_FILE_NAME
+    memset(p, 0xFF, length);     // 檔案不存在時等同於全新的 EEPROM
+    FILE *f = fopen(STORE_FILE_NAME, "rb");
+    if (f == NULL) return;
+    fseek(f, STORE_BASE_ADDRESS + address, SEEK_SET);
+    fread(p, 1, length, f);
+    fclose(f);
+#else
+    for (int i = 0; i < length; i++) {
+        p[i] = EEPROM.read(STORE_BASE_ADDRESS + address + i);
+    }
+#endif
+}
+
+void storeWrite(int address, const void *data, int length)
+{
+    const uint8_t *p = (const uint8_t *)data;
+#ifdef STORE_FILE_NAME
+    FILE *f = fopen(STORE_FILE_NAME, "r+b");
+    if (f == NULL) f = fopen(STORE_FILE_NAME, "w+b");
+    if (f == NULL) return;
+    fseek(f, STORE_BASE_ADDRESS + address, SEEK_SET);
+    fwrite(p, 1, length, f);
+    fclose(f);
+#else
+    for (int i = 0; i < length; i++) {
+        EEPROM.update(STORE_BASE_ADDRESS + address + i, p[i]);
+    }
+#endif
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：initStore()
+// 功能：載入記錄區標頭，識別碼或容量不符時重新格式化
+// 參數：無
+// 傳回值：無
+// 說明：開機時呼叫一次，上次斷電前未送出的樣本會保留下來
+// ---------------------------------------------------------------
+void initStore()
+{
+    storeRead(0, &storeHeader, sizeof(storeHeader));
+    if (storeHeader.magic != STORE_MAGIC || storeHeader.capacity != STORE_CAPACITY ||
+        storeHeader.head >= STORE_CAPACITY || storeHeader.count > STORE_CAPACITY) {
+        // 第一次使用或設定改變：清空記錄區
+        storeHeader.magic = STORE_MAGIC;
+        storeHeader.boot = 0;
+        storeHeader.head = 0;
+        storeHeader.count = 0;
+        storeHeader.capacity = STORE_CAPACITY;
+        storeHeader.dropped = 0;
+    }
+    storeHeader.boot++;          // 新的開機序號
+    storeWrite(0, &storeHeader, sizeof(storeHeader));
+
+    Serial.print("Store:(");
+    Serial.print(storeHeader.count);
+    Serial.print(" samples pending, ");
+    Serial.print(storeHeader.dropped);
+    Serial.print(" dropped)\n");
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：storeSample()
+// 功能：把一筆樣本加到記錄區尾端
+// 參數：
+//   - t: 溫度值
+//   - h: 濕度值
+// 傳回值：無
+// 說明：記錄區已滿時覆蓋最舊的樣本，並累計 dropped
+// ---------------------------------------------------------------
+void storeSample(float t, float h)
+{
+    SampleRecord r;
+    r.boot = storeHeader.boot;
+    r.reserved = 0;
+    r.uptime = millis() / 1000;
+    r.t = t;
+    r.h = h;
+
+    int slot = (storeHeader.head + storeHeader.count) % STORE_CAPACITY;
+    storeWrite(sizeof(StoreHeader) + slot * sizeof(SampleRecord), &r, sizeof(r));
+
+    if (storeHeader.count < STORE_CAPACITY) {
+        storeHeader.count++;
+    } else {
+        // 已滿：最舊的樣本剛被覆蓋
+        storeHeader.head = (storeHeader.head + 1) % STORE_CAPACITY;
+        storeHeader.dropped++;
+    }
+    storeWrite(0, &storeHeader, sizeof(storeHeader));
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：storedCount()
+// 功能：傳回尚未送出的樣本數
+// ---------------------------------------------------------------
+int storedCount()
+{
+    return storeHeader.count;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：forwardSamples()
+// 功能：由最舊的樣本開始依序送出，送出成功才從記錄區移除
+// 參數：
+//   - send: 送出一筆樣本的函式（例如 MQTT 發佈或 HTTP GET）
+//   - maxBatch: 本次最多送出的筆數
+// 傳回值：成功送出的筆數
+// 說明：
+//   1. 遇到送出失敗立即停止，剩下的樣本留待下次連線時再送
+//   2. 所有樣本送出後才更新一次標頭，減少 EEPROM 寫入次數
+// ---------------------------------------------------------------
+int forwardSamples(StoreSender send, int maxBatch)
+{
+    int sent = 0;
+    SampleRecord r;
+    uint32_t now = millis() / 1000;
+
+    while (storeHeader.count > 0 && sent < maxBatch) {
+        storeRead(sizeof(StoreHeader) + storeHeader.head * sizeof(SampleRecord), &r, sizeof(r));
+        // 同一次開機內的樣本才能算出經過時間
+        long age = r.boot == storeHeader.boot ? (long)(now - r.uptime) : STORE_AGE_UNKNOWN;
+        if (!send(r.t, r.h, age)) break;
+        storeHeader.head = (storeHeader.head + 1) % STORE_CAPACITY;
+        storeHeader.count--;
+        sent++;
+    }
+    if (sent > 0) storeWrite(0, &storeHeader, sizeof(storeHeader));
+    return sent;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：sendOrStore()
+// 功能：即時送出一筆樣本，離線或送出失敗時才寫入記錄區
+// 參數：
+//   - send: 送出一筆樣本的函式
+//   - online: 目前網路是否正常（離線時不嘗試送出）
+//   - t: 溫度值
+//   - h: 濕度值
+// 傳回值：true 已即時送出、false 已寫入記錄區等待補送
+// 說明：連線正常時完全不寫 EEPROM；記錄區中還有舊樣本時，
+//       送出成功後再呼叫 forwardSamples() 補送
+// ---------------------------------------------------------------
+bool sendOrStore(StoreSender send, bool online, float t, float h)
+{
+    if (online && send(t, h, STORE_AGE_LIVE)) return true;
+    storeSample(t, h);
+    return false;
+}
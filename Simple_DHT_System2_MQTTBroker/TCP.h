@@ -97,7 +97,7 @@ BMC81M001 Wifi(&Serial2);  // 使用 BMduino 的 Serial2 硬體序列埠
 // ================================================================
 
 // ---------- WiFi 初始化和控制函式 ----------
-void initWiFi();        // 初始化 WiFi 模組並連線到指定熱點
+bool initWiFi();        // 初始化 WiFi 模組並連線到指定熱點，連線成功傳回 true
 
 // ---------- 網路資訊取得函式 ----------
 String GetMAC();        // 取得 WiFi 模組的 MAC 位址（硬體唯一識別碼）
@@ -115,14 +115,14 @@ String ScanAP();        // 掃描附近可用的 WiFi 熱點
 // 函式名稱：initWiFi()
 // 功能：初始化 WiFi 模組並連線到指定的無線網路熱點
 // 參數：無
-// 傳回值：無
+// 傳回值：連線成功傳回 true（呼叫端不必再以 getStatus() 查詢）
 // 流程：
 //   1. 啟動 WiFi 模組
 //   2. 重設模組到初始狀態
 //   3. 嘗試連線到指定 SSID
 //   4. 顯示連線結果
 // ---------------------------------------------------------------
-void initWiFi()
+bool initWiFi()
 {
     // 步驟1：啟動 WiFi 模組
     // begin() 函式會初始化模組的內部設定和序列通訊
@@ -143,7 +143,8 @@ void initWiFi()
     // 步驟5：嘗試連線到指定的 WiFi 熱點
     // connectToAP() 參數：SSID（網路名稱）、PASS（密碼）
     // 回傳 true：連線成功，false：連線失敗
-    if (!Wifi.connectToAP(WIFI_SSID, WIFI_PASS)) {
+    bool connected = Wifi.connectToAP(WIFI_SSID, WIFI_PASS);
+    if (!connected) {
         // 連線失敗情況處理
         Serial.print("WIFI fail,");
         // 可能原因：
@@ -163,6 +164,7 @@ void initWiFi()
     // 步驟6：額外等待時間，確保網路連線穩定
     // 給路由器足夠時間完成 DHCP 和路由設定
     delay(500);
+    return connected;
 }
 
 // ---------------------------------------------------------------
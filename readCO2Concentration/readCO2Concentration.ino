@@ -1,44 +1,53 @@
 /*************************************************
 File: readCO2Concentration.ino
 Description: Get the CO2 concentration, unit:ppm
-Note: None
+Note: The module preheats in the background (about 60 seconds) and
+      is queried without waiting for its reply, so setup() returns
+      at once and loop() never stalls on the sensor.
 **************************************************/
 
-#include <BM25S3321-1.h>
+#include "CO2Lib.h" // BM25S3321-1.h, STA_PIN 22, CO2 on Serial1, background state machine
 
-#define STA_PIN 22 // Input pin
-// #define RX_PIN 2  // Simulate as RX pin
-// #define TX_PIN 3  // Simulate as TX pin
-uint16_t CO2Value = 0;
+#define PRINT_INTERVAL 2000 // ms between two printed readings
 
-// BM25S3321_1 CO2(STA_PIN, RX_PIN, TX_PIN); // Softeware serial:8->Input pin 2->RX pin, 3->TX pin
-
-/* BMduino-UNO */
-// BM25S3321_1 CO2(STA_PIN, &Serial); // Hardware serial: Serial
-BM25S3321_1 CO2(STA_PIN, &Serial1); // Hardware serial: Serial1
-// BM25S3321_1 CO2(STA_PIN, &Serial2); // Hardware serial: Serial2
-// BM25S3321_1 CO2(STA_PIN, &Serial3); // Hardware serial: Serial3
-// BM25S3321_1 CO2(STA_PIN, &Serial4); // Hardware serial: Serial4
+unsigned long lastPrint = 0;
 
 void setup()
 {
-  CO2.begin();        // Initialize module, baud rate: 9600bps
   Serial.begin(9600); // Initialize Serial, baud rate: 9600bps
-
-  Serial.println("Module preheating...(about 60 second)");
-  CO2.preheatCountdown(); // Wait for the End of module preheating.
-  Serial.println("End of module preheating.");
-  Serial.println();
-  Serial.println("Perform initial setup.");
-  // CO2.calibrateZeroPoint();
-  CO2.setRangeMax(5000);
+  initCO2();          // Initialize module (9600bps) and start preheating in the background
+  // Other modules (WiFi, OLED, MQTT ...) can be initialized here without waiting.
 }
 
 void loop()
 {
-  CO2Value = CO2.readCO2Value();
-  Serial.print("CO2: ");
-  Serial.print(CO2Value);
-  Serial.println(" ppm");
-  delay(2000);
-}
\ No newline at end of file
+  pollCO2(); // Preheat timer, range setup, query and reply parsing; never waits
+
+  if (millis() - lastPrint >= PRINT_INTERVAL)
+  {
+    lastPrint = millis();
+    switch (co2Status())
+    {
+    case CO2_STATUS_WARMING:
+      if (co2WarmupLeft() == 0)
+      {
+        Serial.println("CO2: preheated, waiting for the first reading");
+        break;
+      }
+      Serial.print("CO2: warming up, ");
+      Serial.print((co2WarmupLeft() + 999) / 1000);
+      Serial.println(" s left");
+      break;
+    case CO2_STATUS_VALID:
+      Serial.print("CO2: ");
+      Serial.print(readCO2());
+      Serial.println(" ppm");
+      break;
+    default:
+      Serial.print("CO2: ");
+      Serial.print(readCO2());
+      Serial.println(" ppm (stale, no reply from module)");
+      break;
+    }
+  }
+}
@@ -7,6 +7,10 @@ readKeyValue()：讀取當前按下的按鍵所對應的 16-bit 數值（每個
 
 BIN：將數值以二進位方式印出，方便觀察每個按鍵（bit）是否被觸發。
 keymask[] 與 readKey() 是整個模組的核心，透過 bitmask 技巧可以快速檢查是哪一顆鍵被按下。
+readKey() 以 __builtin_ctz() 取得最低的 1 位元，一次就能算出按鍵編號。
+
+readKey()/inputKey() 一次只看得到一顆鍵，需要按下/放開/長按或多鍵組合時
+改用 KeyEventLib.h 的事件佇列（INT 腳中斷觸發，不會因輪詢間隔漏鍵）。
 
 buttondelay[] 通常可用來設定每個按鍵的觸發靈敏度或去彈跳時間。
 
@@ -65,6 +69,7 @@ void initKeyPad() // 初始化 I2C 按鍵模組
 boolean setbuttondelay() // 設定每顆按鍵的延遲時間
 {
     BMK52.setThreshold(buttondelay); // 呼叫模組函式設定按鍵的觸發門檻
+    return true;
 }
 
 // 顯示每顆按鍵對應的掩碼值（以二進位格式列印）
@@ -90,13 +95,9 @@ int readKey()
     {
         rkey = BMK52.readKeyValue(); // 讀取 16-bit 的按鍵狀態
 
-        // 比對哪一個按鍵被按下
-        for (int i = 0; i < 16; i++)
-        {
-            // 使用 bit AND 與 keymask 比對特定按鍵是否為 1
-            if ((rkey & keymask[i]) == keymask[i])
-                return (i + 1); // 回傳被按下的按鍵編號（從 1 開始）
-        }
+        // 最低的 1 位元就是編號最小的按鍵，__builtin_ctz() 直接算出位置，不必逐一比對 keymask
+        if (rkey != 0)
+            return (__builtin_ctz(rkey) + 1); // 回傳被按下的按鍵編號（從 1 開始）
     }
     else
     {
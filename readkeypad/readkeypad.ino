@@ -11,25 +11,28 @@
        - 啟動序列埠通訊 (Baud rate: 9600)，用於將結果傳回電腦。
        - 初始化按鍵感測器，建立與 I2C 裝置的連線。
     2. 偵測流程：
-       - 程式會呼叫 inputKey() 函式，該函式會詢問按鍵模組目前狀態。
-       - 如果沒有任何按鍵被按下，函式會回傳字元 'E' (代表 Empty 或 Error)。
-       - 如果偵測到有效按鍵，則回傳該按鍵對應的字元（如 '1', '2', 'A', '#' 等）。
+       - 按鍵模組的 INT 腳有變化時觸發中斷，由 KeyEventLib.h 的讀鍵任務立即讀取狀態，
+         產生按下 (PRESS)、放開 (RELEASE)、長按 (LONG) 事件放入佇列。
+       - 不再每 200 毫秒輪詢一次，快速連按時每一次按壓都會留下事件。
     3. 結果輸出：
-       - 當讀取到的值不是 'E' 時，代表有使用者輸入，程式會將該字元透過 Serial 印出。
-    4. 節流機制：
-       - 程式最後包含 200 毫秒的延遲 (delay)，用來穩定讀取過程，防止因機械彈跳
-         (Debounce) 導致單次按壓觸發多次輸出的現象。
+       - loop() 取出佇列中的事件，依序印出事件種類與按鍵字元，
+         同時按住多顆鍵時一併印出組合（例如 "PRESS # (*+#)"）。
+    4. 去彈跳：
+       - 由按鍵模組依 setbuttondelay() 設定的門檻處理，程式端不需再延遲等待。
 ================================================================================
 */
 
 #include "KeypadLib.h"  // 引入自定義的按鍵矩陣函式庫，內含通訊與編碼轉換邏輯 [cite: 1]
+#include "TaskLib.h"    // 協同式任務排程函式庫（取代 loop() 中的 delay()）
+#include "KeyEventLib.h" // 中斷驅動的按鍵事件佇列（須在 KeypadLib.h 與 TaskLib.h 之後）
 
 //---------------------------------------------------------
 // 前置宣告函式與全域變數
 //---------------------------------------------------------
 void initSensor();   // 宣告初始化感測器的函式
 void initAll();      // 宣告初始化整體系統的函式
-char keycmd;         // 用來儲存目前從按鍵讀取到的字元命令（例如 '1' 或 'A'）
+void printKeyEvent(KeyEvent *ev);  // 宣告印出按鍵事件的函式
+KeyEvent keyev;      // 用來儲存目前從佇列取出的按鍵事件
 
 //---------------------------------------------------------
 // Arduino 標準設定區塊：只在電源開啟或重置時執行一次
@@ -37,6 +40,9 @@ char keycmd;         // 用來儲存目前從按鍵讀取到的字元命令（
 void setup() 
 {
   initAll();  // 呼叫自定義的初始化函式，準備好硬體環境
+
+  // 登錄讀鍵任務並啟用 INT 腳中斷，之後按鍵變化時由 taskRun() 立即讀取
+  keyEventBegin(keychar);
   
   // listkeymask(); // (除錯用) 若需要查看按鍵原始遮罩碼，可取消此行註解 [cite: 3]
 }
@@ -46,18 +52,39 @@ void setup()
 //---------------------------------------------------------
 void loop() 
 {
-  // 透過函式讀取按鍵值，並將回傳結果存入 keycmd 變數 [cite: 4]
-  keycmd = inputKey(); 
+  taskRun();  // 執行已到期的任務（中斷喚醒的讀鍵任務）
 
-  // 判斷邏輯：若 keycmd 不等於 'E'，代表真的有按鍵被按下
-  if (keycmd != 'E') 
+  // 依序取出佇列中的按鍵事件並印出 [cite: 4]
+  while (keyGet(&keyev))
   {
-    // 將按下的按鍵字元發送到序列監控視窗 (Serial Monitor) [cite: 5]
-    Serial.println(keycmd);
+    printKeyEvent(&keyev);
   }
+}
+
+//---------------------------------------------------------
+// 印出一個按鍵事件，例如 "PRESS 5"、"LONG *"、"PRESS # (*+#)"
+//---------------------------------------------------------
+void printKeyEvent(KeyEvent *ev)
+{
+  static const char *names[] = {"PRESS", "RELEASE", "LONG"};
+  Serial.print(names[ev->type]);
+  Serial.print(' ');
+  Serial.print(keyChar(ev->key));  // 將按鍵字元發送到序列監控視窗 (Serial Monitor) [cite: 5]
 
-  // 延遲 200 毫秒。這能有效防止按一下卻出現兩次字元的「連點」問題，也能降低 CPU 負擔
-  delay(200); 
+  // 同時按住多顆鍵時，列出整組按鍵（由 __builtin_ctz() 逐一取出）
+  if (keyChordCount(ev->chord) > 1)
+  {
+    uint16_t chord = ev->chord;
+    Serial.print(" (");
+    while (chord)
+    {
+      Serial.print(keyChar(keyFirst(chord)));
+      chord &= chord - 1;
+      if (chord) Serial.print('+');
+    }
+    Serial.print(')');
+  }
+  Serial.println();
 }
 
 //---------------------------------------------------------
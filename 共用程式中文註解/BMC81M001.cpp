@@ -21,6 +21,12 @@
   
   最後修改：2024年8月22日
   版本：V1.0.4
+  
+  對照說明：本檔為 V1.0.4 驅動程式的中文註解教學版本，只供閱讀，
+           不參與編譯。草稿碼實際使用的是 LIB/BMC81M001 共用程式庫
+           （V1.1.0），在本版之外另有 AT 指令佇列、串流式回應解析、
+           HTTP 持續連線與 Content-Length/chunked 解析、MQTT 批次送出，
+           以及 BMC81M001_config.h 的子系統開關，詳見 LIB/BMC81M001/README.md。
 -------------------------------------------------------------*/
 
 #include "variant.h"           // 引入開發板變體定義檔（BMduino 專用）
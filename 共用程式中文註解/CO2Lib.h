@@ -1,433 +0,0 @@
-/*
- * 檔案名稱：CO2Lib.h
- * 程式語言：Arduino C/C++
- * 檔案類型：標頭檔（Header File）- 二氧化碳感測器驅動程式庫
- * 
- * ========================================
- * 程式功能完整解說
- * ========================================
- * 
- * 【檔案概述】
- *   本檔案為 BM25S3321-1 二氧化碳（CO2）感測模組的驅動程式庫，
- *   提供完整的感測器初始化、預熱程序、量程設定、濃度讀取等功能。
- *   透過 UART 序列通訊介面，可精確讀取環境中的二氧化碳濃度，
- *   適用於室內空氣品質監測、通風控制、智慧農業、溫室種植等應用場景。
- * 
- * 【硬體規格】
- *   - 感測器模組：BM25S3321-1 CO2 感測模組
- *   - 感測原理：NDIR（非分散式紅外線）技術
- *   - 通訊介面：UART（通用非同步收發傳輸器）
- *   - 通訊速率：9600 bps（固定）
- *   - 量測範圍：0～2000 ppm 或 0～5000 ppm（可設定）
- *   - 工作電壓：3.3V 或 5V（依模組規格）
- *   - 狀態腳位：提供模組狀態指示（熱機中、量測中、就緒）
- * 
- * 【NDIR 感測原理說明】
- *   NDIR（Non-Dispersive Infrared，非分散式紅外線）是常見的 CO2 感測技術：
- *   
- *   1. 紅外線光源發射特定波長的紅外光（CO2 分子會吸收 4.26 μm 波長）
- *   2. 紅外光穿過氣體樣本到達接收器
- *   3. CO2 濃度越高，吸收的紅外光越多，接收到的光強度越低
- *   4. 透過檢測光強度的衰減量，計算出 CO2 濃度
- *   
- *   優點：精度高、穩定性好、使用壽命長
- *   缺點：需要預熱時間（約 60 秒）以穩定光源
- * 
- * 【主要功能】
- * 
- *   一、感測器初始化（initCO2）
- *       - 啟動 UART 通訊（9600 bps）
- *       - 執行預熱程序（約 60 秒）
- *       - 設定量測範圍（2000 ppm 或 5000 ppm）
- *       - 可選的零點校正功能
- * 
- *   二、濃度讀取（readCO2）
- *       - 發送查詢指令
- *       - 接收 UART 封包
- *       - 解析 CO2 濃度數據
- *       - 回傳 ppm 值
- * 
- * 【UART 通訊說明】
- *   UART（Universal Asynchronous Receiver/Transmitter）是非同步序列通訊：
- *   
- *   - 使用兩條線：TX（發送）、RX（接收）
- *   - 通訊速率固定為 9600 bps（位元/秒）
- *   - 數據格式：通常為 8 個數據位元、1 個停止位元、無奇偶校驗
- *   - 感測器回傳固定格式的封包，需進行解析
- * 
- * 【運作流程】
- * 
- *   初始化階段（initCO2）：
- *       1. 呼叫 CO2.begin() 初始化 UART 通訊
- *       2. 輸出預熱訊息至序列監控視窗
- *       3. 呼叫 CO2.preheatCountdown() 執行預熱程序
- *          - 此函式會阻塞程式約 60 秒
- *          - 內部進行光源穩定程序
- *       4. 可選的零點校正（預設註解，需在純淨空氣中執行）
- *       5. 呼叫 CO2.setRangeMax() 設定量測範圍
- * 
- *   濃度讀取階段（readCO2）：
- *       1. 呼叫 CO2.readCO2Value() 發送查詢指令
- *       2. 等待感測器回應（約 1-2 秒）
- *       3. 接收並解析 UART 封包
- *       4. 提取 CO2 濃度數據（單位：ppm）
- *       5. 傳回數值
- * 
- * 【量程設定說明】
- *   setRangeMax() 函式用於設定 CO2 最大量測範圍：
- *   
- *   - 2000 ppm：適合室內空調環境、辦公室、住宅
- *               量程較小，精度相對較高
- *   
- *   - 5000 ppm：適合一般室內環境、教室、會議室
- *               量程較大，可應對較高濃度情況
- *   
- *   CO2 濃度標準參考：
- *   - 350～450 ppm：戶外新鮮空氣
- *   - 400～1000 ppm：室內空氣品質良好
- *   - 1000～1500 ppm：空氣品質下降，需通風
- *   - 1500～2000 ppm：空氣品質不良，建議立即通風
- *   - > 2000 ppm：空氣品質極差，可能引起頭痛、嗜睡
- * 
- * 【全域變數說明】
- *   - STA_PIN：狀態腳位編號（22），用於連接感測器狀態輸出腳
- *   - CO2Value：儲存 CO2 濃度值（單位：ppm，型態 uint16_t）
- *   - CO2：BM25S3321_1 類別物件，用於與感測器通訊
- * 
- * 【相依函式庫】
- *   - BM25S3321-1.h：BM25S3321-1 CO2 感測器底層驅動函式庫
- * 
- * 【硬體接線說明】
- *   以 BMduino-UNO 為例（使用 Serial1）：
- *   
- *   CO2 模組    →    BMduino-UNO
- *   ---------------------------------
- *   VCC         →    5V 或 3.3V
- *   GND         →    GND
- *   TX（發送）  →    RX1（D1）← 注意：模組 TX 接開發板 RX
- *   RX（接收）  →    TX1（D0）← 注意：模組 RX 接開發板 TX
- *   STA（狀態） →    D22（GPIO 22）
- * 
- *   若使用其他序列埠（Serial2、Serial3、Serial4）：
- *   - Serial2：RX2（D17）、TX2（D16）
- *   - Serial3：RX3（D15）、TX3（D14）
- *   - Serial4：RX4（D19）、TX4（D18）
- * 
- * 【注意事項】
- *   1. 預熱程序非常重要：
- *      - 若不進行預熱，初期數據會「偏低」或「跳動」
- *      - 預熱時間約 60 秒，期間請勿讀取數據
- *      - 程式會阻塞 60 秒，請耐心等待
- * 
- *   2. 零點校正：
- *      - 必須在純淨戶外空氣（約 400 ppm CO2）條件下進行
- *      - 若誤按校正，感測器量測可能嚴重偏差
- *      - 預設為註解狀態，非必要請勿啟用
- * 
- *   3. 讀取頻率：
- *      - 建議讀取間隔不低於 2 秒
- *      - 過於頻繁讀取可能影響感測器精度與壽命
- * 
- *   4. 電源供應：
- *      - 確保電源穩定，波動可能影響讀數準確性
- *      - CO2 感測器功耗較高，建議使用外部電源
- * 
- *   5. 環境影響：
- *      - 溫度和氣壓變化會影響 CO2 讀數
- *      - 避免安裝在通風口或陽光直射處
- * 
- * 【使用範例】
- * 
- *   #include "CO2Lib.h"
- *   
- *   void setup() {
- *       Serial.begin(9600);      // 電腦監控用
- *       initCO2();               // 初始化 CO2 感測器
- *   }
- *   
- *   void loop() {
- *       CO2Value = readCO2();    // 讀取 CO2 濃度
- *       
- *       Serial.print("CO2 濃度: ");
- *       Serial.print(CO2Value);
- *       Serial.println(" ppm");
- *       
- *       // 根據濃度進行通風控制
- *       if (CO2Value > 1500) {
- *           digitalWrite(FAN_PIN, HIGH);  // 開啟風扇
- *       } else if (CO2Value < 1000) {
- *           digitalWrite(FAN_PIN, LOW);   // 關閉風扇
- *       }
- *       
- *       delay(2000);  // 等待 2 秒再讀取
- *   }
- * 
- * 【版本資訊】
- *   最後修改日期：2026年3月26日
- *   適用專案：二氧化碳濃度監測相關應用
- */
-
-/*
- * 二氧化碳偵測模組（BMCOM）BME58M332 獨立模組
- * 
- * ************************************************
- * 原始檔案名稱：readCO2Concentration.ino
- * 功能描述：讀取二氧化碳濃度（CO2 concentration），單位為 ppm
- * 適用硬體：BM25S3321-1 CO2 感測模組搭配 BMduino-UNO
- * 
- * 【程式功能摘要】
- * 模組 / 函式                功能說明
- * -----------------------------------------------------------
- * BM25S3321-1.h      CO2 感測器函式庫，負責 UART 封包解析
- * CO2.begin()        初始化 UART / 感測模組
- * preheatCountdown() 必要的預熱程序（約 60 秒）
- * setRangeMax()      設定 CO2 最大量測範圍（2000 / 5000 ppm）
- * readCO2Value()     回傳解析後的 CO2 濃度（ppm）
- * ************************************************
- */
-
-// ================================================================
-// =============== 外部函式庫引入區 ===============================
-// ================================================================
-
-// 匯入 BestModules 官方的 BM25S3321-1 CO2 感測器函式庫
-// 此模組以 UART（序列埠）方式回傳 CO2 濃度值
-// UART 速度固定為 9600 bps，回傳資料為已封裝好的協議格式
-#include <BM25S3321-1.h>
-
-// ================================================================
-// =============== 全域變數與巨集定義區 ===========================
-// ================================================================
-
-/*
- * 巨集名稱：STA_PIN
- * 功能說明：定義感測器狀態腳位的 GPIO 編號
- * 用途：連接 CO2 模組的 STA 腳位，用於讀取模組狀態
- *       （例如：預熱中、量測中、就緒狀態）
- * 數值：22（BMduino-UNO 的 D22 腳位）
- * 注意：可根據實際接線修改此腳位編號
- */
-#define STA_PIN 22  
-
-/*
- * 軟體序列埠（SoftwareSerial）接線定義
- * 若使用 SoftwareSerial，可取消註解下列腳位定義
- * 注意：SoftwareSerial 會佔用較多 CPU 資源，建議優先使用硬體序列埠
- */
-// #define RX_PIN 2   // CO2 Sensor → Arduino（資料輸入腳）
-// #define TX_PIN 3   // Arduino → CO2 Sensor（資料輸出腳）
-
-/*
- * 變數名稱：CO2Value
- * 資料型態：uint16_t（無號 16 位元整數，範圍 0～65535）
- * 功能說明：儲存讀取到的 CO2 濃度值
- * 單位：ppm（百萬分之一）
- * 量程範圍：0～2000 ppm 或 0～5000 ppm（依設定而定）
- */
-uint16_t CO2Value = 0;
-
-// ================================================================
-// =============== 感測元件物件實例化區 ===========================
-// ================================================================
-
-/*-------------------------------------------------------------
-   建立 CO2 感測模組物件
-   感測器支援硬體序列埠（HardwareSerial）與軟體序列埠（SoftwareSerial）
---------------------------------------------------------------*/
-
-// ▼ 軟體序列埠（SoftwareSerial）建立方式（已註解）：
-// BM25S3321_1 CO2(STA_PIN, RX_PIN, TX_PIN);
-// 適用於硬體序列埠不足的情況，但會佔用較多 CPU 資源
-
-// ▼ 硬體序列埠（HardwareSerial）建立方式（已註解）：
-// BM25S3321_1 CO2(STA_PIN, &Serial);    // 使用主序列埠（不建議，會與電腦監控衝突）
-// BM25S3321_1 CO2(STA_PIN, &Serial2);   // 使用 Serial2（需確認開發板支援）
-// BM25S3321_1 CO2(STA_PIN, &Serial3);   // 使用 Serial3（需確認開發板支援）
-// BM25S3321_1 CO2(STA_PIN, &Serial4);   // 使用 Serial4（需確認開發板支援）
-
-/*
- * 物件名稱：CO2
- * 類別：BM25S3321_1
- * 功能：建立 BM25S3321-1 CO2 感測器的控制物件
- * 
- * 建構函式參數說明：
- *   參數 1：STA_PIN - 狀態腳位編號，用於讀取模組狀態
- *   參數 2：&Serial1 - 使用的 UART 序列埠（本程式使用 Serial1）
- * 
- * 本程式採用 Serial1（BMduino-UNO 具備多組 UART）：
- *   - BMduino-UNO 的 Serial1 對應腳位：TX1 (D0)、RX1 (D1)
- *   - 建議使用硬體序列埠，效能較佳且穩定
- */
-BM25S3321_1 CO2(STA_PIN, &Serial1);
-
-// ================================================================
-// =============== 自訂函式宣告區 =================================
-// ================================================================
-
-/*
- * 函式名稱：initCO2()
- * 功能：初始化二氧化碳感測模組
- * 執行內容：
- *   - 啟動 UART 通訊
- *   - 執行預熱程序（約 60 秒）
- *   - 設定量測範圍
- * 參數：無
- * 傳回值：無
- */
-void initCO2();
-
-/*
- * 函式名稱：readCO2()
- * 功能：讀取 CO2 濃度（ppm）
- * 執行流程：
- *   - 發送查詢指令至感測器
- *   - 接收並解析 UART 封包
- *   - 回傳 CO2 濃度值
- * 參數：無
- * 傳回值：uint16_t - CO2 濃度（單位：ppm）
- */
-uint16_t readCO2();
-
-// ================================================================
-// =============== 自訂函式實作區 =================================
-// ================================================================
-
-/*-------------------------------------------------------------
-   自訂函式：初始化二氧化碳感測模組
-   功能：啟動 UART、執行預熱、設定量測範圍
-   
-   執行流程：
-     1. 初始化 UART 通訊（9600 bps）
-     2. 輸出預熱訊息
-     3. 執行預熱倒數程序（阻塞 60 秒）
-     4. 輸出預熱完成訊息
-     5. 設定量測範圍（5000 ppm）
-   
-   注意事項：
-     - 預熱程序非常重要，不可省略
-     - 零點校正需在純淨空氣中進行，預設註解
---------------------------------------------------------------*/
-void initCO2()
-{
-    // --------------------------------------------------------
-    // 步驟 1：初始化感測模組
-    // 功能：設定 UART 通訊參數，進行基本檢查
-    // begin() 會自動設定感測器與序列埠溝通的波特率：9600 bps
-    // --------------------------------------------------------
-    CO2.begin();  
-
-    // --------------------------------------------------------
-    // 步驟 2：輸出預熱訊息
-    // 告知使用者感測器正在預熱，約需 60 秒
-    // --------------------------------------------------------
-    Serial.println("Module preheating...(about 60 seconds)");
-    
-    /*
-     * ➤ 為何需要預熱？
-     * 
-     * CO2 感測器採用 NDIR（Non-Dispersive Infrared，非分散式紅外線）原理，
-     * 內部有紅外線光源與感測元件。為確保光源穩定、量測準確，
-     * 必須進行約 60 秒的預熱程序。
-     * 
-     * 若不預熱 → 初期數據會「偏低」或「跳動」。
-     * 
-     * 預熱程序的工作內容：
-     *   1. 穩定紅外線光源的輸出強度
-     *   2. 讓感測元件達到熱平衡
-     *   3. 建立穩定的參考基準值
-     */
-    
-    // --------------------------------------------------------
-    // 步驟 3：執行預熱倒數程序
-    // 此函式會阻塞程式約 60 秒，不需要手動寫 delay()
-    // 內部包含倒數計時顯示功能，可觀察預熱進度
-    // --------------------------------------------------------
-    CO2.preheatCountdown();  
-
-    // --------------------------------------------------------
-    // 步驟 4：輸出預熱完成訊息
-    // --------------------------------------------------------
-    Serial.println("End of module preheating.\n");
-    Serial.println("Perform initial setup.");
-
-    /*
-     * 步驟 5：（選用）零點校正
-     * 
-     * 必須在純淨戶外空氣（約 400 ppm CO2）條件下進行
-     * 若誤按校正 → 感測器量測可能嚴重偏差，因此預設關閉
-     * 
-     * 零點校正的原理：
-     *   在已知 CO2 濃度為 400 ppm 的環境中，
-     *   將當前讀數設定為基準值，後續測量以此為參考。
-     * 
-     * 使用時機：
-     *   - 初次安裝感測器時
-     *   - 感測器使用一段時間後（建議每 6-12 個月）
-     *   - 更換感測器位置後
-     */
-    // CO2.calibrateZeroPoint();
-
-    // --------------------------------------------------------
-    // 步驟 6：設定最大可量測範圍
-    // --------------------------------------------------------
-    CO2.setRangeMax(5000);
-    /*
-     * 設定最大可量測範圍的說明：
-     * 
-     *   setRangeMax(2000) → 設定量程為 2000 ppm
-     *      - 精度較高，適合室內空調環境、辦公室、住宅
-     *      - 量程較小，數據解析度較高
-     * 
-     *   setRangeMax(5000) → 設定量程為 5000 ppm
-     *      - 標準室內通用範圍
-     *      - 可應對較高濃度情況（如會議室多人聚集）
-     *      - 本程式採用此設定
-     * 
-     * 注意：設定後感測器會調整內部增益，以匹配所選量程
-     */
-}
-
-/*-------------------------------------------------------------
-   自訂函式：讀取 CO2 濃度（ppm）
-   功能：讀取感測器數據並回傳 CO2 濃度值
-   
-   執行流程：
-     1. 呼叫 readCO2Value() 函式
-     2. 函式向感測器傳送查詢指令
-     3. 感測器回傳「固定格式 UART 封包」
-     4. 函式解析封包中的 CO2 ppm 資料
-     5. 回傳整數（ppm）
-   
-   傳回值：uint16_t - CO2 濃度值（單位：ppm）
-   
-   注意事項：
-     - 呼叫前請確保感測器已完成預熱
-     - 讀取一次約需 1-2 秒
-     - 建議讀取間隔不低於 2 秒
---------------------------------------------------------------*/
-uint16_t readCO2()
-{
-    /*
-     * readCO2Value() 函式詳細流程：
-     * --------------------------------------------------------
-     * 1. 組裝查詢指令（固定格式）
-     * 2. 透過 UART 發送指令至感測器
-     * 3. 等待感測器回應（約 500ms - 1s）
-     * 4. 接收 UART 封包（固定長度）
-     * 5. 驗證封包格式與校驗碼
-     * 6. 從封包中提取 CO2 濃度數據
-     * 7. 轉換為 ppm 單位（整數）
-     * 8. 回傳數值
-     * --------------------------------------------------------
-     * 
-     * UART 封包格式範例（假設）：
-     *   [起始符號] [命令碼] [數據長度] [CO2 高位] [CO2 低位] [校驗碼] [結束符號]
-     *   
-     * 例如 CO2 濃度為 1234 ppm 時：
-     *   封包中可能包含 0x04 0xD2（即 0x04D2 = 1234）
-     */
-    
-    // 讀取 CO2 濃度值並直接傳回
-    // 傳回值範圍：0 ～ 設定的最大量程（2000 或 5000 ppm）
-    return CO2.readCO2Value();
-}
\ No newline at end of file
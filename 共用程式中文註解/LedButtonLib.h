@@ -17,11 +17,20 @@
  *      - 設定每顆按鈕的長按時間閥值
  * 
  *   2. 按鈕狀態讀取：
- *      - getAllButton()：取得所有串接按鈕的狀態，回傳字串格式
+ *      - ledButtonScan()：中斷後讀取一次全部按鈕，存成位元快照（btnShort / btnLong），
+ *        與上一次快照比較，只有狀態改變的按鈕會產生事件
+ *      - ledButtonNextEvent()：依序取出改變的按鈕（__builtin_ctz 直接取得編號），
+ *        不配置字串、不逐一比對，按鈕數量多時也不會變慢
+ *      - getAllButton() / getAllButtonStatus()：取得所有串接按鈕的狀態，回傳字串格式（相容舊程式）
  *      - getButton(btn) / getButtonStatus(btn)：取得指定編號按鈕的狀態
  *      - 狀態碼定義：0 = 無動作，1 = 短按，2 = 長按
  * 
- *   3. 中斷機制：
+ *   3. LED 控制：
+ *      - ledButtonSetLED() / ledButtonSetPattern() 只修改記憶體中的亮度表，
+ *        ledButtonFlush() 再以一次 I2C 傳輸寫入所有串接按鈕
+ *      - LEDBUTTON_HOST_LED 設為 1 時 LED 由程式控制，不隨按壓自動亮起
+ * 
+ *   4. 中斷機制：
  *      - 使用外部中斷 (FALLING edge) 偵測按鈕事件
  *      - 設定中斷旗標 (int_flag) 通知主程式處理
  *      - 避免在 ISR 中執行過多程式，確保系統響應速度
@@ -37,6 +46,8 @@
  * 修改紀錄：
  *   - 2025.03.27：加入詳細繁體中文註解與整體說明
  *   - 修正 getButton 與 getButtonStatus 函式的邏輯錯誤
+ *   - 2026.10.17：按鈕狀態改為位元快照與差異事件，實作 getAllButtonStatus()，
+ *     LED 亮度表一次寫入所有串接按鈕
  * ==================================================
  */
 
@@ -51,6 +62,11 @@
 #define intPin 22         // 設定外部中斷輸入腳位，使用 BMCOM1 (腳位 D22)
 //#define intPin 25       // 如果使用 BMCOM2，則改為腳位 D25
 
+#define LEDBUTTON_MAX 16   // 最多串接的按鈕數（快照以 16 位元表示，位元 0 = 第 1 顆）
+#define LEDBUTTON_HOST_LED 0   // 1：LED 由程式以 ledButtonFlush() 控制；0：按壓時 LED 自動亮起
+#define LED_OFF 0         // LED 熄滅的亮度值
+#define LED_ON 100        // LED 全亮的亮度值
+
 //----------感測物件建立區----------------
 // 建立 BMK22M131 類別物件 myButton，並指定 I2C 通道
 // 可依實際使用的 Wire, Wire1, Wire2 來決定使用哪組 I2C 腳位
@@ -66,12 +82,27 @@ uint8_t int_flag = 0;
 
 uint8_t MaxButton = 0;   // 用來儲存目前偵測到的 LED 按鈕模組數量
 uint8_t buttonStatus;    // 用來儲存單一按鈕的狀態（短按 / 長按）
-uint8_t BTstatus[17];    // 用來存放所有聯集（串接）按鈕的狀態，最多支援 16 顆按鈕
+uint8_t BTstatus[LEDBUTTON_MAX + 1];  // 用來存放所有聯集（串接）按鈕的狀態，最多支援 16 顆按鈕
+
+// 位元快照：位元 i 代表第 i+1 顆按鈕，兩個遮罩都為 0 表示無動作
+uint16_t btnShort = 0;     // 目前為短按的按鈕
+uint16_t btnLong = 0;      // 目前為長按的按鈕
+uint16_t btnChanged = 0;   // 與上一次快照相比狀態改變、尚未由 ledButtonNextEvent() 取出的按鈕
+
+// LED 亮度表：索引與 BTstatus 相同（1 ~ MaxButton），ledButtonFlush() 一次寫入
+uint8_t ledLevel[LEDBUTTON_MAX + 1];
+bool ledDirty = false;     // 亮度表是否有尚未寫入模組的變更
 
 //------------------ 函式宣告區 ------------------//
 void ButtonInt();                   // 外部中斷觸發後執行的函數
 void intLedButton();                // 初始化 LED 按鈕模組
-String getAllButtonStatus();        // 取得所有按鈕的即時狀態（原程式宣告但未實作）
+bool ledButtonScan();               // 有中斷時讀取全部按鈕並更新快照，回傳是否有按鈕改變
+bool ledButtonNextEvent(uint8_t *btn, uint8_t *status); // 取出下一個改變的按鈕與其狀態碼
+uint8_t ledButtonState(uint8_t btn);  // 由快照回傳第 btn 按鈕的狀態碼（不讀取模組）
+void ledButtonSetLED(uint8_t btn, uint8_t level);      // 設定第 btn 顆按鈕的 LED 亮度（寫入亮度表）
+void ledButtonSetPattern(uint16_t mask, uint8_t level); // mask 中的按鈕設為 level，其餘熄滅
+void ledButtonFlush();              // 以一次 I2C 傳輸將亮度表寫入所有串接按鈕
+String getAllButtonStatus();        // 由快照取得所有按鈕的狀態字串（不讀取模組）
 String getAllButton();              // 取得所有按鈕的狀態字串
 uint8_t getButton(uint8_t btn);     // 回傳第 btn 按鈕的狀態碼
 uint8_t getButtonStatus(uint8_t btn); // 回傳第 btn 按鈕的狀態碼（功能與 getButton 相同）
@@ -111,12 +142,13 @@ void intLedButton()
   myButton.begin();
 
   // 啟用 LED 按鈕模式（參數 1 表示開啟 LED 功能）
-  // 啟用後，按壓按鈕時對應的 LED 會亮起
-  myButton.ledButtonMode(1);
+  // 啟用後，按壓按鈕時對應的 LED 會亮起；LEDBUTTON_HOST_LED 為 1 時改由程式控制 LED
+  myButton.ledButtonMode(LEDBUTTON_HOST_LED ? 0 : 1);
 
   // 取得目前連接的 LED 按鈕模組數量
   // 支援多顆按鈕串接，系統會自動計算總數量
   MaxButton = myButton.getNumber();
+  if (MaxButton > LEDBUTTON_MAX) MaxButton = LEDBUTTON_MAX;  // 快照最多 16 顆
 
   // 確認模組是否成功連線，並輸出連線資訊到序列埠
   Serial.println("Check whether the module is connected, waiting...");
@@ -136,6 +168,138 @@ void intLedButton()
   }
 }
 
+//-------------------------
+// 有中斷時讀取全部按鈕並更新位元快照
+// 回傳值：true 表示有按鈕狀態改變（以 ledButtonNextEvent() 取出），false 表示沒有
+//
+// 說明：
+//   模組一次傳回全部按鈕的狀態碼（存入 BTstatus），轉成 btnShort / btnLong 兩個位元遮罩，
+//   與上一次的遮罩做 XOR 就得到改變的按鈕，未改變的按鈕不會產生事件。
+//   沒有中斷時立即返回，不佔用 I2C 匯流排。
+// 使用時機：主迴圈中定期呼叫
+//-------------------------
+bool ledButtonScan()
+{
+  if (!int_flag) return false;   // 沒有按鈕事件
+  int_flag = 0;                  // 重設旗標，讀取期間的新中斷會再設定一次
+
+  // 從模組讀取所有按鈕的狀態，BTstatus[i] 為第 i 顆按鈕的狀態碼（i 從 1 開始）
+  myButton.getButtonStatus(BTstatus);
+
+  uint16_t nowShort = 0;
+  uint16_t nowLong = 0;
+  for (uint8_t i = 1; i <= MaxButton; i++)
+  {
+    uint16_t bit = (uint16_t)1 << (i - 1);
+    if (BTstatus[i] == 1) nowShort |= bit;
+    else if (BTstatus[i] == 2) nowLong |= bit;
+  }
+
+  btnChanged |= (nowShort ^ btnShort) | (nowLong ^ btnLong);
+  btnShort = nowShort;
+  btnLong = nowLong;
+  return btnChanged != 0;
+}
+
+//-------------------------
+// 取出下一個狀態改變的按鈕（編號小的先取出）
+// 參數 btn：傳回按鈕編號（從 1 開始）
+// 參數 status：傳回新的狀態碼（0 = 無動作，1 = 短按，2 = 長按）
+// 回傳值：true 表示取出一個事件，false 表示沒有尚未處理的改變
+//
+// 使用方式：
+//   if (ledButtonScan())
+//     while (ledButtonNextEvent(&btn, &st)) { ... }
+//-------------------------
+bool ledButtonNextEvent(uint8_t *btn, uint8_t *status)
+{
+  if (btnChanged == 0) return false;
+  uint8_t i = __builtin_ctz(btnChanged);   // 最低的 1 位元就是編號最小的改變按鈕
+  btnChanged &= btnChanged - 1;            // 清除該位元
+  *btn = i + 1;
+  *status = ledButtonState(i + 1);
+  return true;
+}
+
+//-------------------------
+// 由快照回傳第 btn 按鈕的狀態碼（不讀取模組）
+// 參數 btn：按鈕編號（從 1 開始）
+// 回傳值：0x00 未按下 / 0x01 短按 / 0x02 長按；編號超出範圍時回傳 0x00
+//-------------------------
+uint8_t ledButtonState(uint8_t btn)
+{
+  if (btn < 1 || btn > MaxButton) return 0x00;
+  uint16_t bit = (uint16_t)1 << (btn - 1);
+  if (btnLong & bit) return 0x02;
+  if (btnShort & bit) return 0x01;
+  return 0x00;
+}
+
+//-------------------------
+// 設定第 btn 顆按鈕的 LED 亮度（只寫入亮度表，ledButtonFlush() 時才送出）
+// 參數 btn：按鈕編號（從 1 開始）
+// 參數 level：亮度（LED_OFF ~ LED_ON）
+//-------------------------
+void ledButtonSetLED(uint8_t btn, uint8_t level)
+{
+  if (btn < 1 || btn > MaxButton) return;
+  if (ledLevel[btn] != level)
+  {
+    ledLevel[btn] = level;
+    ledDirty = true;
+  }
+}
+
+//-------------------------
+// 以位元遮罩設定 LED 圖樣：mask 中的按鈕設為 level，其餘熄滅
+// 參數 mask：位元 i 代表第 i+1 顆按鈕（例如 btnShort 可讓短按的按鈕亮起）
+// 參數 level：亮度（LED_OFF ~ LED_ON）
+//-------------------------
+void ledButtonSetPattern(uint16_t mask, uint8_t level)
+{
+  for (uint8_t i = 1; i <= MaxButton; i++)
+  {
+    ledButtonSetLED(i, (mask & ((uint16_t)1 << (i - 1))) ? level : LED_OFF);
+  }
+}
+
+//-------------------------
+// 將亮度表寫入所有串接按鈕
+// 說明：使用模組函式庫的陣列版本，所有按鈕的亮度在同一次 I2C 傳輸中送出，
+//       不必每顆按鈕各傳一次；亮度表沒有變更時不傳輸
+//-------------------------
+void ledButtonFlush()
+{
+  if (!ledDirty) return;
+  ledLevel[0] = MaxButton;             // 索引 0 放按鈕數量，與 BTstatus 的排列相同
+  myButton.setLEDBrightness(ledLevel);
+  ledDirty = false;
+}
+
+//-------------------------
+// 將快照轉成狀態字串（內部使用）
+// 一次配置字串，不逐字元串接
+//-------------------------
+String ledButtonString()
+{
+  char buf[LEDBUTTON_MAX + 1];
+  for (uint8_t i = 1; i <= MaxButton; i++)
+  {
+    buf[i - 1] = '0' + ledButtonState(i);
+  }
+  buf[MaxButton] = '\0';
+  return String(buf);
+}
+
+//-------------------------
+// 由快照取得所有按鈕的狀態字串（不讀取模組）
+// 回傳值：每顆按鈕一個字元（第 1 顆到第 MaxButton 顆），'0' 無動作、'1' 短按、'2' 長按
+//-------------------------
+String getAllButtonStatus()
+{
+  return ledButtonString();
+}
+
 //-------------------------
 // 取得所有聯集（串接）按鈕的狀態
 // 回傳一個字串，內容為每個按鈕的狀態碼（從第 1 顆到第 MaxButton 顆）
@@ -143,41 +307,23 @@ void intLedButton()
 //   '0'：無動作（按鈕未被按下）
 //   '1'：短按（按壓時間小於長按閥值）
 //   '2'：長按（按壓時間大於或等於長按閥值）
+// 沒有按鈕事件時回傳空字串
 //
 // 使用時機：主迴圈中定期呼叫，檢查是否有按鈕事件發生
+// 只需要知道哪些按鈕改變時，改用 ledButtonScan() / ledButtonNextEvent()，不必比對字串
 //-------------------------
 String getAllButton() 
 {
-  String tmp = "";   // 用來累加所有按鈕狀態的字串
-
-  // 當中斷旗標被設定為 1（表示有按鈕事件發生）
-  if (int_flag) 
-  {
-    int_flag = 0;  // 重設旗標，避免重複觸發（一次事件只處理一次）
-
-    // 從模組讀取所有按鈕的狀態，存入 BTstatus 陣列
-    // BTstatus[i] 代表第 i 顆按鈕的狀態（i 從 0 開始）
-    // 注意：陣列索引 0 可能對應第 1 顆按鈕，實際使用時需確認
-    buttonStatus = myButton.getButtonStatus(BTstatus);
+  // 當中斷旗標未設定（沒有按鈕事件）時回傳空字串
+  if (!int_flag) return "";
 
-    // 將所有按鈕狀態轉成字串並累加
-    // 從索引 1 開始（跳過第 0 顆），因為第 0 顆可能對應第一顆按鈕
-    for(int i = 1 ; i <= MaxButton; i++)  
-    {
-      // 將數值轉換為字元後加入字串
-      // 例如：BTstatus[1]=1 時，會加入 '1'
-      tmp.concat(BTstatus[i]);  
-    }
-  }  
+  ledButtonScan();                 // 讀取所有按鈕並更新快照
+  String tmp = ledButtonString();  // 將快照轉成字串
 
   // 將按鈕狀態輸出到序列埠監控視窗（方便除錯）
-  // 若無按鈕事件，tmp 為空字串，不輸出
-  if (tmp.length() > 0)
-  {
-    Serial.print("All Button:(") ;
-    Serial.print(tmp) ;
-    Serial.print(")\n") ;
-  }
+  Serial.print("All Button:(") ;
+  Serial.print(tmp) ;
+  Serial.print(")\n") ;
 
   return tmp;   // 回傳所有按鈕狀態的字串
 }
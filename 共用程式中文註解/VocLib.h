@@ -39,6 +39,13 @@
  *   │    - SayString()：播放指定語音（單段或兩段連續）                 │
  *   │    - sayText()：播放語音表中指定索引的語音                       │
  *   ├─────────────────────────────────────────────────────────────────┤
+ *   │ 3a. 非阻塞語音佇列（不會卡住 loop()）                            │
+ *   │    - voiceSay() / voiceSayNumber() / voiceSayFloat()：排入語音   │
+ *   │    - voiceSayPhrase()：依片語樣板排入（如「現在溫度 N 攝氏度」）  │
+ *   │    - voiceSayTemperature() / voiceSayHumidity()：溫濕度播報      │
+ *   │    - voicePoll()：在 loop() 中呼叫，上一段播完才送出下一段       │
+ *   │    - voiceIsBusy() / voiceWait() / voiceClear()                  │
+ *   ├─────────────────────────────────────────────────────────────────┤
  *   │ 4. 輸入控制層                                                   │
  *   │    - getBoardKey()：讀取模組板載按鍵狀態                         │
  *   │    - DisplayVoiceStatus()：顯示播放狀態（LED 控制）              │
@@ -63,6 +70,9 @@
  *   │    - SayTemperature("25.5")：播報溫度                            │
  *   │    - SpeakStringNumber("123.45")：念出數字                       │
  *   │    - play(voice_table[0])：播放第一段語音                        │
+ *   │    以上 Say 系列函式會等到念完才返回；若播報期間仍要讀感測器、    │
+ *   │    處理網路，改用 voiceSayTemperature(23.5) 等函式排入佇列，     │
+ *   │    並在 loop() 中持續呼叫 voicePoll()                            │
  *   └─────────────────────────────────────────────────────────────────┘
  * 
  * 語音編號說明（voice_table 索引對應）：
@@ -87,6 +97,7 @@
  * 建立日期：2025.03.27
  * 修改紀錄：
  *   - 2025.03.27：加入詳細繁體中文註解與整體說明
+ *   - 2026.10.17：加入非阻塞語音佇列，數字與片語直接編成語音索引，不再逐字配置 String
  * ==================================================
  */
 
@@ -140,6 +151,43 @@ const uint8_t voice_table[VOICE_TOTAL_NUMBER] = {
     VOC_31, VOC_32, VOC_33, VOC_34, VOC_35, VOC_36, VOC_37, VOC_38
 };
 
+// ================================================================
+// =============== 語音佇列設定區 ===============
+// ================================================================
+
+// 佇列中的每一個元素是一個 voice_table 索引（0 ~ VOICE_TOTAL_NUMBER-1），
+// 或是下列控制碼；一句「現在溫度 負 2 3 點 5 攝氏度」只佔 7 個元素
+#define VOICE_QUEUE_SIZE 32       // 佇列容量（元素數），一次排入放不下的整句會被拒絕
+#define VOICE_ARG  0xFD           // 片語樣板中插入數字的位置（只用在樣板，不會進佇列）
+#define VOICE_GAP  0xFE           // 停頓 VOICE_GAP_TIME 毫秒
+#define VOICE_END  0xFF           // 片語樣板結尾
+
+#define VOICE_POLL_INTERVAL 10    // voicePoll() 最短每 10ms 詢問一次模組狀態（每次詢問都要經過通訊介面）
+#define VOICE_START_TIMEOUT 100   // 送出 play() 後等待模組回報忙碌的時間，逾時重送
+#define VOICE_START_RETRY 3       // 重送次數，用完仍未開始播放就跳過這一段
+#define VOICE_GAP_TIME 300        // VOICE_GAP 的停頓時間（毫秒）
+
+// voicePoll() 的狀態
+#define VOICE_IDLE 0              // 沒有正在處理的語音，可以送出下一段
+#define VOICE_STARTING 1          // 已送出 play()，等待模組開始播放
+#define VOICE_PLAYING 2           // 模組播放中，等待播完
+#define VOICE_PAUSE 3             // VOICE_GAP 停頓中
+
+// 常用片語樣板：VOICE_ARG 的位置會換成數字的語音
+const uint8_t PHRASE_TEMPERATURE[] = { VOC_14, VOICE_ARG, VOC_16, VOICE_END }; // 現在溫度 N 攝氏度
+const uint8_t PHRASE_HUMIDITY[]    = { VOC_15, VOICE_ARG, VOC_17, VOICE_END }; // 現在濕度 N 百分比
+
+uint8_t voiceQueue[VOICE_QUEUE_SIZE];   // 環狀佇列
+uint8_t voiceHead = 0;                  // 下一個要播放的元素位置
+uint8_t voiceCount = 0;                 // 佇列中的元素數
+uint8_t voiceState = VOICE_IDLE;        // voicePoll() 目前狀態
+uint8_t voiceCurrent = 0;               // 正在播放的 voice_table 索引
+uint8_t voiceRetry = 0;                 // 目前這一段已重送 play() 的次數
+bool voiceLedOn = false;                // 佇列播放期間點亮模組 LED
+unsigned long voiceStateTime = 0;       // 進入目前狀態的時間
+unsigned long voiceLastPoll = 0;        // 上一次詢問模組狀態的時間
+unsigned long voiceDropped = 0;         // 因佇列放不下而被拒絕的語句數
+
 // ================================================================
 // =============== 狀態變數區 ===============
 // ================================================================
@@ -211,6 +259,22 @@ void SayHumidity(String snum);       // 播放「現在濕度 + 數值 + 單位
 void SayString(uint8_t vv);          // 播放一段文字（單一語音）
 void SayString(uint8_t vv, uint8_t vv2); // 連續播放兩段文字（兩段語音）
 
+// ---------- 非阻塞語音佇列 ----------
+bool voiceSay(uint8_t num);                          // 排入 voice_table 中一段語音
+bool voiceSayNumber(const char *snum);               // 排入數字字串（可含小數點與負號）
+bool voiceSayInt(long value);                        // 排入整數
+bool voiceSayFloat(float value, uint8_t decimals);   // 排入浮點數（小數 decimals 位）
+bool voiceSayPhrase(const uint8_t *phrase, const char *snum); // 依片語樣板排入
+bool voiceSayTemperature(float value);               // 排入「現在溫度 N 攝氏度」
+bool voiceSayHumidity(float value);                  // 排入「現在濕度 N 百分比」
+void voicePoll();                                    // 在 loop() 中呼叫：依序送出佇列中的語音
+bool voiceIsBusy();                                  // 佇列中還有語音或正在播放
+void voiceWait();                                    // 等到佇列播完（阻塞）
+void voiceClear();                                   // 清空佇列並停止播放
+int voiceCompileNumber(const char *snum, uint8_t *out, int room); // 數字字串 → 語音索引
+void voiceFormatFloat(float value, uint8_t decimals, char *buf);  // 浮點數 → 數字字串（不使用 String）
+bool voiceEnqueue(const uint8_t *codes, int n);      // 整句放入佇列（放不下就全部拒絕）
+
 // ================================================================
 // =============== 自定義函式內容程式區 ===============
 // ================================================================
@@ -510,7 +574,7 @@ void setVoiceLed(uint8_t status)
 // 流程說明：
 //   1. 檢查數字是否在 0~9 範圍內
 //   2. 等待前一段語音播放完畢
-//   3. 播放對應數字的語音
+//   3. 播放對應數字的語音，念完才返回
 // 
 // 注意事項：
 //   若傳入數字超出範圍，會在序列埠顯示錯誤訊息
@@ -524,19 +588,12 @@ void saynumber(int num)
         return;
     }
 
-    // 步驟2：等待前一段語音播放完畢
-    // 避免語音重疊
-    if (isPlaying())
-        while (isPlaying());
-
-    // 步驟3：播放對應數字語音
-    // voice_table[num] 內存放的是對應數字的 VOC_xx 常數
+    // 步驟2、3：voice_table[num] 內存放的是對應數字的 VOC_xx 常數
     // 例如：num=0 → voice_table[0] = VOC_1（數字0的語音）
     //       num=1 → voice_table[1] = VOC_2（數字1的語音）
-    while (!isPlaying())
-    {
-        play(voice_table[num]);
-    }
+    voiceWait();
+    voiceSay(num);
+    voiceWait();
 }
 
 // ---------------------------------------------------------------
@@ -574,20 +631,13 @@ boolean checknum(String ss)
 // 
 // 說明：
 //   此函式會從 voice_table 中取出對應的語音編號並播放
-//   播放前會等待前一段語音結束
+//   播放前會等待前一段語音結束，念完才返回
 // ---------------------------------------------------------------
 void sayText(uint8_t num)
 {
-    // 步驟1：等待前一段語音播放完畢
-    if (isPlaying())
-        while (isPlaying());
-
-    // 步驟2：在模組閒置時開始播放指定語音
-    while (!isPlaying())
-    {
-        // 播放 voice_table[num] 對應的 VOC_xx
-        play(voice_table[num]);
-    }
+    voiceWait();
+    voiceSay(num);
+    voiceWait();
 }
 
 // ---------------------------------------------------------------
@@ -602,33 +652,16 @@ void sayText(uint8_t num)
 //   - 數字：0~9
 //   - 小數點：「.」→ 念出「點」
 //   - 負號：「-」→ 念出「負」
+// 
+// 說明：
+//   整串先由 voiceCompileNumber() 轉成語音索引再一次排入佇列，
+//   不會逐字元產生 String；念完才返回
 // ---------------------------------------------------------------
 void SpeakStringNumber(String snum)
 {
-    if (snum.length() == 0)
-        return; // 空字串不處理
-
-    int le = snum.length();
-    String cc;
-
-    for (int i = 0; i < le; i++)
-    {
-        cc = snum.substring(i, i + 1); // 依序取出每一個字元
-
-        if (checknum(cc))
-        {
-            // 若是 0~9 數字，轉成 int 之後呼叫 saynumber()
-            saynumber(cc.toInt());
-        }
-        else
-        {
-            // 若是非數字，處理小數點與負號
-            if (cc == ".")
-                sayText(VOC_11); // VOC_11 對應「點」
-            if (cc == "-")
-                sayText(VOC_12); // VOC_12 對應「負」
-        }
-    }
+    voiceWait();
+    voiceSayNumber(snum.c_str());
+    voiceWait();
 }
 
 // ---------------------------------------------------------------
@@ -638,14 +671,12 @@ void SpeakStringNumber(String snum)
 // 傳回值：無
 // 
 // 說明：
-//   播放前會點亮 LED，播放完成後熄滅 LED
+//   播放期間 LED 亮起（由 voicePoll() 控制），播放完成後熄滅
 //   適合在系統啟動時使用
 // ---------------------------------------------------------------
 void SayHello()
 {
-    setVoiceLed(1);        // 亮 LED 表示正在播放提示
     sayText(VOC_13);       // 播放「開頭文字或歡迎字」（實際內容由語音檔決定）
-    setVoiceLed(0);        // 播放完畢後熄滅 LED
 }
 
 // ---------------------------------------------------------------
@@ -660,16 +691,14 @@ void SayHello()
 //   3. 逐位念出溫度數值（支援小數點）
 //   4. 播放「攝氏度」（VOC_16）
 //   5. 熄滅 LED
+//   整句依 PHRASE_TEMPERATURE 一次排入佇列，念完才返回；
+//   不想等待時改用 voiceSayTemperature()
 // ---------------------------------------------------------------
 void SayTemperature(String snum)
 {
-    setVoiceLed(1);          // 亮 LED
-
-    sayText(VOC_14);         // 播放「現在溫度」或類似提示
-    SpeakStringNumber(snum); // 逐位念出數字（可含小數點與負號）
-    sayText(VOC_16);         // 播放「攝氏度」或單位語音
-
-    setVoiceLed(0);          // 熄滅 LED
+    voiceWait();
+    voiceSayPhrase(PHRASE_TEMPERATURE, snum.c_str());
+    voiceWait();
 }
 
 // ---------------------------------------------------------------
@@ -684,16 +713,14 @@ void SayTemperature(String snum)
 //   3. 逐位念出濕度數值（支援小數點）
 //   4. 播放「百分比」（VOC_17）
 //   5. 熄滅 LED
+//   整句依 PHRASE_HUMIDITY 一次排入佇列，念完才返回；
+//   不想等待時改用 voiceSayHumidity()
 // ---------------------------------------------------------------
 void SayHumidity(String snum)
 {
-    setVoiceLed(1);          // 亮 LED
-
-    sayText(VOC_15);         // 播放「現在濕度」或類似提示
-    SpeakStringNumber(snum); // 念出數字
-    sayText(VOC_17);         // 播放「百分比」或其他單位
-
-    setVoiceLed(0);          // 熄滅 LED
+    voiceWait();
+    voiceSayPhrase(PHRASE_HUMIDITY, snum.c_str());
+    voiceWait();
 }
 
 // ---------------------------------------------------------------
@@ -703,13 +730,11 @@ void SayHumidity(String snum)
 // 傳回值：無
 // 
 // 說明：
-//   播放前點亮 LED，播放完成後熄滅 LED
+//   播放期間 LED 亮起，播放完成後熄滅
 // ---------------------------------------------------------------
 void SayString(uint8_t vv)
 {
-    setVoiceLed(1);    // 播放期間 LED 亮
     sayText(vv);       // 依傳入之語音代碼（或索引）播放
-    setVoiceLed(0);    // 播放完成 LED 滅
 }
 
 // ---------------------------------------------------------------
@@ -729,12 +754,397 @@ void SayString(uint8_t vv)
 // ---------------------------------------------------------------
 void SayString(uint8_t vv, uint8_t vv2)
 {
-    setVoiceLed(1);    // 播放期間 LED 亮
+    // 第一段、停頓 0.3 秒（VOICE_GAP）、第二段
+    const uint8_t codes[] = { vv, VOICE_GAP, vv2 };
+    voiceWait();
+    voiceEnqueue(codes, 3);
+    voiceWait();
+}
+
+// ================================================================
+// =============== 非阻塞語音佇列 ===============
+// ================================================================
+// 使用方式：
+//   void loop()
+//   {
+//       voicePoll();                       // 每次 loop() 都呼叫，立即返回
+//       if (按下播報鍵)
+//           voiceSayTemperature(TValue);   // 排入整句後立即返回
+//       ...讀感測器、處理網路...
+//   }
+// 使用 TaskLib.h 時可登錄為任務：
+//   taskAddPeriodic("voice", voicePoll, VOICE_POLL_INTERVAL, VOICE_POLL_INTERVAL);
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceCompileNumber()
+// 功能：把數字字串轉成語音索引（0~9 → 數字語音，「.」→ VOC_11，「-」→ VOC_12）
+// 參數：snum - 數字字串，例如 "-23.5"
+//       out - 存放語音索引的陣列
+//       room - out 的可用元素數
+// 傳回值：int - 寫入的元素數；放不下時回傳 -1
+// 
+// 說明：
+//   其他字元（空白、單位符號等）略過，與原本 SpeakStringNumber() 相同
+// ---------------------------------------------------------------
+int voiceCompileNumber(const char *snum, uint8_t *out, int room)
+{
+    int n = 0;
+    for (const char *p = snum; *p != '\0'; p++)
+    {
+        uint8_t code;
+        if (*p >= '0' && *p <= '9')
+            code = *p - '0';    // voice_table[0~9] 為數字 0~9
+        else if (*p == '.')
+            code = VOC_11;      // 「點」
+        else if (*p == '-')
+            code = VOC_12;      // 「負」
+        else
+            continue;
+        if (n >= room)
+            return -1;
+        out[n++] = code;
+    }
+    return n;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceFormatFloat()
+// 功能：將浮點數轉成數字字串（不使用 String，也不需要 dtostrf()）
+// 參數：value - 數值
+//       decimals - 小數位數（0~3，超過以 3 計）
+//       buf - 輸出緩衝區，至少 16 位元組
+// 傳回值：無
+// 
+// 說明：
+//   依小數位數四捨五入，例如 (23.46, 1) → "23.5"、(-0.04, 1) → "0.0"
+// ---------------------------------------------------------------
+void voiceFormatFloat(float value, uint8_t decimals, char *buf)
+{
+    if (decimals > 3)
+        decimals = 3;
+    unsigned long scale = 1;
+    for (uint8_t i = 0; i < decimals; i++)
+        scale *= 10;
+
+    bool negative = value < 0;
+    if (negative)
+        value = -value;
+    if (value > 999999.0)
+        value = 999999.0;    // 語音念不完的數值一律以上限處理
+    unsigned long scaled = (unsigned long)(value * scale + 0.5);
+    if (scaled == 0)
+        negative = false;    // 不念「負零」
+
+    // 由個位數往前填，再反轉
+    char tmp[16];
+    int n = 0;
+    for (uint8_t i = 0; i < decimals; i++)
+    {
+        tmp[n++] = '0' + scaled % 10;
+        scaled /= 10;
+    }
+    if (decimals > 0)
+        tmp[n++] = '.';
+    do
+    {
+        tmp[n++] = '0' + scaled % 10;
+        scaled /= 10;
+    } while (scaled > 0);
+    if (negative)
+        tmp[n++] = '-';
+
+    for (int i = 0; i < n; i++)
+        buf[i] = tmp[n - 1 - i];
+    buf[n] = '\0';
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceEnqueue()
+// 功能：把一整句語音索引放進佇列
+// 參數：codes - voice_table 索引或 VOICE_GAP
+//       n - 元素數
+// 傳回值：bool - true：已排入；false：佇列放不下（整句都不排入，voiceDropped 加一）
+// 
+// 說明：
+//   整句一起判斷，不會只念出半句；超出 voice_table 範圍的索引略過
+// ---------------------------------------------------------------
+bool voiceEnqueue(const uint8_t *codes, int n)
+{
+    if (n > VOICE_QUEUE_SIZE - voiceCount)
+    {
+        voiceDropped++;
+        return false;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        if (codes[i] >= VOICE_TOTAL_NUMBER && codes[i] != VOICE_GAP)
+            continue;
+        voiceQueue[(voiceHead + voiceCount) % VOICE_QUEUE_SIZE] = codes[i];
+        voiceCount++;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceSay()
+// 功能：排入 voice_table 中第 num 筆語音（立即返回）
+// 參數：num - 語音表索引（0~37）或 VOC_xx 常數
+// 傳回值：bool - 是否已排入
+// ---------------------------------------------------------------
+bool voiceSay(uint8_t num)
+{
+    return voiceEnqueue(&num, 1);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceSayNumber()
+// 功能：排入數字字串的語音（立即返回）
+// 參數：snum - 數字字串，例如 "23.5"、"-10"
+// 傳回值：bool - 是否已排入
+// ---------------------------------------------------------------
+bool voiceSayNumber(const char *snum)
+{
+    return voiceSayPhrase(NULL, snum);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceSayInt()
+// 功能：排入整數的語音（立即返回）
+// 參數：value - 整數，例如 -12
+// 傳回值：bool - 是否已排入
+// ---------------------------------------------------------------
+bool voiceSayInt(long value)
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%ld", value);
+    return voiceSayNumber(buf);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceSayFloat()
+// 功能：排入浮點數的語音（立即返回）
+// 參數：value - 數值
+//       decimals - 小數位數（0~3）
+// 傳回值：bool - 是否已排入
+// ---------------------------------------------------------------
+bool voiceSayFloat(float value, uint8_t decimals)
+{
+    char buf[16];
+    voiceFormatFloat(value, decimals, buf);
+    return voiceSayNumber(buf);
+}
 
-    sayText(vv);       // 先播放第一段語音
-    delay(300);        // 兩段語音之間留 0.3 秒間隔
-    sayText(vv2);      // 播放第二段語音
-    setVoiceLed(0);    // 播放完成 LED 滅
+// ---------------------------------------------------------------
+// 函式名稱：voiceSayPhrase()
+// 功能：依片語樣板排入一整句語音（立即返回）
+// 參數：phrase - 以 VOICE_END 結尾的樣板，例如 PHRASE_TEMPERATURE；
+//                NULL 表示只有數字
+//       snum - 填入 VOICE_ARG 位置的數字字串（樣板中沒有 VOICE_ARG 時可為 NULL）
+// 傳回值：bool - 是否已排入
+// 
+// 範例：
+//   const uint8_t PHRASE_ALARM[] = { VOC_38, VOICE_GAP, VOC_38, VOICE_END };
+//   voiceSayPhrase(PHRASE_ALARM, NULL);
+//   voiceSayPhrase(PHRASE_TEMPERATURE, "23.5");  // 現在溫度 2 3 點 5 攝氏度
+// ---------------------------------------------------------------
+bool voiceSayPhrase(const uint8_t *phrase, const char *snum)
+{
+    // 先在堆疊上編好整句，放得下才一次排入
+    uint8_t codes[VOICE_QUEUE_SIZE];
+    int n = 0;
+    const uint8_t argOnly[] = { VOICE_ARG, VOICE_END };
+    if (phrase == NULL)
+        phrase = argOnly;
+
+    for (const uint8_t *p = phrase; *p != VOICE_END; p++)
+    {
+        if (*p == VOICE_ARG)
+        {
+            if (snum == NULL)
+                continue;
+            int m = voiceCompileNumber(snum, &codes[n], VOICE_QUEUE_SIZE - n);
+            if (m < 0)
+            {
+                voiceDropped++;
+                return false;
+            }
+            n += m;
+        }
+        else
+        {
+            if (n >= VOICE_QUEUE_SIZE)
+            {
+                voiceDropped++;
+                return false;
+            }
+            codes[n++] = *p;
+        }
+    }
+    return voiceEnqueue(codes, n);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceSayTemperature()
+// 功能：排入「現在溫度 N 攝氏度」（N 取小數一位，立即返回）
+// 參數：value - 溫度
+// 傳回值：bool - 是否已排入
+// ---------------------------------------------------------------
+bool voiceSayTemperature(float value)
+{
+    char buf[16];
+    voiceFormatFloat(value, 1, buf);
+    return voiceSayPhrase(PHRASE_TEMPERATURE, buf);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceSayHumidity()
+// 功能：排入「現在濕度 N 百分比」（N 取小數一位，立即返回）
+// 參數：value - 濕度
+// 傳回值：bool - 是否已排入
+// ---------------------------------------------------------------
+bool voiceSayHumidity(float value)
+{
+    char buf[16];
+    voiceFormatFloat(value, 1, buf);
+    return voiceSayPhrase(PHRASE_HUMIDITY, buf);
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voicePoll()
+// 功能：推進語音佇列，必須在 loop() 中持續呼叫
+// 參數：無
+// 傳回值：無
+// 
+// 流程說明：
+//   VOICE_IDLE     → 佇列有語音且模組閒置：送出 play()，進入 VOICE_STARTING
+//   VOICE_STARTING → 模組回報忙碌：進入 VOICE_PLAYING；
+//                    VOICE_START_TIMEOUT 內未開始：重送，VOICE_START_RETRY 次後跳過
+//   VOICE_PLAYING  → 模組不再忙碌：回到 VOICE_IDLE，同一次呼叫就送出下一段
+//   VOICE_PAUSE    → VOICE_GAP_TIME 到：回到 VOICE_IDLE
+// 
+// 注意事項：
+//   每次呼叫最多詢問模組一次，且間隔至少 VOICE_POLL_INTERVAL，
+//   不會像原本的 while (isPlaying()); 一樣佔住整個 loop()
+// ---------------------------------------------------------------
+void voicePoll()
+{
+    unsigned long now = millis();
+    if (now - voiceLastPoll < VOICE_POLL_INTERVAL)
+        return;
+    voiceLastPoll = now;
+
+    bool checked = false;    // 這次已經詢問過模組，且模組閒置
+    switch (voiceState)
+    {
+    case VOICE_STARTING:
+        if (isPlaying())
+        {
+            voiceState = VOICE_PLAYING;
+            return;
+        }
+        if (now - voiceStateTime < VOICE_START_TIMEOUT)
+            return;
+        if (voiceRetry < VOICE_START_RETRY)
+        {
+            voiceRetry++;
+            play(voice_table[voiceCurrent]);
+            voiceStateTime = now;
+            return;
+        }
+        voiceState = VOICE_IDLE;    // 模組始終沒有開始播放，跳過這一段
+        checked = true;
+        break;
+    case VOICE_PLAYING:
+        if (isPlaying())
+            return;
+        voiceState = VOICE_IDLE;
+        checked = true;
+        break;
+    case VOICE_PAUSE:
+        if (now - voiceStateTime < VOICE_GAP_TIME)
+            return;
+        voiceState = VOICE_IDLE;
+        break;
+    }
+
+    // ---------- VOICE_IDLE：送出下一段 ----------
+    if (voiceCount == 0)
+    {
+        if (voiceLedOn)
+        {
+            setVoiceLed(BMV31T001_LED_OFF);
+            voiceLedOn = false;
+        }
+        return;
+    }
+    // 草稿碼直接以 play() 播放的語音還沒結束時先等待
+    if (!checked && isPlaying())
+        return;
+
+    uint8_t code = voiceQueue[voiceHead];
+    voiceHead = (voiceHead + 1) % VOICE_QUEUE_SIZE;
+    voiceCount--;
+    voiceStateTime = now;
+    if (code == VOICE_GAP)
+    {
+        voiceState = VOICE_PAUSE;
+        return;
+    }
+    if (!voiceLedOn)
+    {
+        setVoiceLed(BMV31T001_LED_ON);
+        voiceLedOn = true;
+    }
+    voiceCurrent = code;
+    voiceRetry = 0;
+    play(voice_table[code]);
+    voiceState = VOICE_STARTING;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceIsBusy()
+// 功能：判斷佇列是否還有語音未播完
+// 參數：無
+// 傳回值：bool - true：佇列中還有語音或正在播放
+// ---------------------------------------------------------------
+bool voiceIsBusy()
+{
+    return voiceCount > 0 || voiceState != VOICE_IDLE;
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceWait()
+// 功能：持續呼叫 voicePoll() 直到佇列播完（阻塞）
+// 參數：無
+// 傳回值：無
+// 
+// 說明：
+//   供 sayText()、SayTemperature() 等原有函式保持「念完才返回」的行為；
+//   loop() 中需要同時處理其他工作時不要呼叫
+// ---------------------------------------------------------------
+void voiceWait()
+{
+    while (voiceIsBusy())
+        voicePoll();
+}
+
+// ---------------------------------------------------------------
+// 函式名稱：voiceClear()
+// 功能：清空佇列並停止目前的語音
+// 參數：無
+// 傳回值：無
+// ---------------------------------------------------------------
+void voiceClear()
+{
+    voiceCount = 0;
+    if (voiceState == VOICE_STARTING || voiceState == VOICE_PLAYING)
+        playstop();
+    voiceState = VOICE_IDLE;
+    if (voiceLedOn)
+    {
+        setVoiceLed(BMV31T001_LED_OFF);
+        voiceLedOn = false;
+    }
 }
 
 // ================================================================
@@ -762,6 +1172,8 @@ void SayString(uint8_t vv, uint8_t vv2)
    - 播放前可先呼叫 isPlaying() 確認模組空閒
    - 避免在播放中再次呼叫 play() 造成語音重疊
    - 循環播放模式需要手動呼叫 playstop() 才能停止
+   - Say 系列函式念完才返回；播報時仍要處理感測器或網路，
+     請改用 voiceSay 系列函式並在 loop() 中呼叫 voicePoll()
 
 5. 音量設定：
    - 音量範圍 0~11，0 為靜音，11 為最大
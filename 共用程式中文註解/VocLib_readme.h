@@ -41,6 +41,7 @@
   | 狀態    | `isPlaying()`, `DisplayVoiceStatus()`             | 偵測是否正在播放       |
   | 輸出    | `saynumber()`, `sayText()`, `SpeakStringNumber()` | 將數字或句子以語音方式念出  |
   | 設定    | `setVolume()`, `setVoicePower()`, `setVoiceLed()` | 控制音量、電源、LED 狀態 |
+  | 佇列    | `voiceSay()`, `voiceSayNumber()`, `voiceSayPhrase()`, `voicePoll()` | 排入語音後立即返回，由 loop() 依序播放 |
   
 -------------------------------------------------------------*/
 